@@ -10,6 +10,8 @@
 #include "EndOfDayDialog.h"
 #include <QMessageBox>
 #include <QApplication>
+#include <QMenu>
+#include <QInputDialog>
 #include <QDebug>
 
 Actions::Actions(MainWindow *mainWindow, QObject *parent)
@@ -129,16 +131,61 @@ void Actions::runQuickGameDiagnostic()
     QMessageBox::information(m_mainWindow, "QG Diagnostic", "Quick game diagnostic feature coming soon");
 }
 
+void Actions::quickSearch(const QString &text, const QPoint &globalPos)
+{
+    const QVector<SearchHit> hits = DatabaseManager::instance()->search(text);
+    if (hits.isEmpty()) {
+        QMessageBox::information(m_mainWindow, "Search", QString("Nothing found for \"%1\".").arg(text.trimmed()));
+        return;
+    }
+    
+    QMenu menu(m_mainWindow);
+    for (int i = 0; i < hits.size(); ++i) {
+        const SearchHit &hit = hits[i];
+        QString kind = "Bowler";
+        if (hit.kind == SearchHit::Team) {
+            kind = "Team";
+        } else if (hit.kind == SearchHit::CalendarEvent) {
+            kind = "Booking";
+        }
+        
+        QString label = QString("%1: %2").arg(kind, hit.title);
+        if (!hit.detail.isEmpty()) {
+            label += "  -  " + hit.detail;
+        }
+        menu.addAction(label)->setData(i);
+    }
+    
+    QAction *chosen = menu.exec(globalPos);
+    if (!chosen) {
+        return;
+    }
+    
+    // Open the screen that manages the hit
+    switch (hits[chosen->data().toInt()].kind) {
+    case SearchHit::Bowler:
+        showBowlerManagementDialog();
+        break;
+    case SearchHit::Team:
+        showTeamManagementDialog();
+        break;
+    case SearchHit::CalendarEvent:
+        calendar();
+        break;
+    }
+}
+
 void Actions::endOfDay()
 {
-    // Get lane server from main window
-    LaneServer *laneServer = m_mainWindow->findChild<LaneServer*>();
-    if (!laneServer) {
+    // In-process lane server, or the remote one's lanes through the console hub
+    LaneServer *laneServer = m_mainWindow->laneServer();
+    ConsoleClient *consoleClient = m_mainWindow->consoleClient();
+    if (!laneServer && !(consoleClient && consoleClient->isAttached())) {
         QMessageBox::warning(m_mainWindow, "Error", "Lane server not available.");
         return;
     }
     
-    EndOfDayDialog dialog(laneServer, m_mainWindow);
+    EndOfDayDialog dialog(laneServer, consoleClient, m_mainWindow);
     int result = dialog.exec();
     
     if (result == QDialog::Accepted) {
@@ -146,6 +193,43 @@ void Actions::endOfDay()
     }
 }
 
+void Actions::announce()
+{
+    LaneServer *laneServer = m_mainWindow->laneServer();
+    ConsoleClient *consoleClient = m_mainWindow->consoleClient();
+    if (!laneServer && !(consoleClient && consoleClient->isAttached())) {
+        QMessageBox::warning(m_mainWindow, "Error", "Lane server not available.");
+        return;
+    }
+    
+    // Every lane, or only the lanes bowling one league, e.g. for its tournament start
+    const QVector<LeagueData> leagues = DatabaseManager::instance()->getAllLeagues();
+    QStringList targets = {"All lanes"};
+    for (const LeagueData &league : leagues) {
+        targets << league.name;
+    }
+    bool ok = false;
+    const QString target = QInputDialog::getItem(m_mainWindow, "Announcement", "Show on:", targets, 0, false, &ok);
+    if (!ok) {
+        return;
+    }
+    const QString text = QInputDialog::getText(m_mainWindow, "Announcement", "Message:", QLineEdit::Normal,
+                                               QString(), &ok).trimmed();
+    if (!ok || text.isEmpty()) {
+        return;
+    }
+    
+    const int index = targets.indexOf(target);
+    const int leagueId = index > 0 ? leagues[index - 1].id : 0;
+    if (laneServer) {
+        const BroadcastStats stats = laneServer->announce(leagueId > 0 ? LaneGroup::league(leagueId) : LaneGroup::all(), text);
+        QMessageBox::information(m_mainWindow, "Announcement",
+                                 QString("Announcement shown on %1 lane(s).").arg(stats.recipients));
+    } else if (consoleClient->announce(text, leagueId)) {
+        QMessageBox::information(m_mainWindow, "Announcement", "Announcement sent to the server's lanes.");
+    }
+}
+
 void Actions::showQuickGameDialog()
 {
     QuickGameDialog dialog(m_mainWindow);
@@ -225,10 +309,7 @@ void Actions::sendGameToLane(int laneId, const QString &gameType, const QJsonObj
     commandData["type"] = gameType;
     commandData["data"] = gameData;
     
-    // Get LaneServer from mainWindow and call directly
-    LaneServer *laneServer = m_mainWindow->findChild<LaneServer*>();
-    if (laneServer) {
-        laneServer->onLaneCommand(commandData);
+    if (m_mainWindow->dispatchLaneCommand(commandData)) {
         QMessageBox::information(m_mainWindow, "Game Started", 
                                QString("Game started on lane %1").arg(laneId));
     } else {
@@ -6,6 +6,7 @@
 #include <QDialog>
 #include <QJsonObject>
 #include <QDateTime>
+#include <QPoint>
 
 class MainWindow;
 
@@ -31,7 +32,11 @@ public slots:
     void testLaneConnection();
     void runQuickGameDiagnostic();
     void endOfDay();
+    void announce();
     void onDatabaseBrowserClicked();
+    
+    // Front-desk search over bowlers, teams and bookings; hits pop up at globalPos
+    void quickSearch(const QString &text, const QPoint &globalPos);
 
 private:
     void showQuickGameDialog();
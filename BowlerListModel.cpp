@@ -0,0 +1,283 @@
+﻿// BowlerListModel.cpp
+#include "BowlerListModel.h"
+#include <algorithm>
+#include <iterator>
+
+namespace {
+
+const QChar FIELD_SEPARATOR(0x1f);
+
+} // namespace
+
+// BowlerSearchIndex
+
+quint64 BowlerSearchIndex::trigramKey(const QChar *chars)
+{
+    return (static_cast<quint64>(chars[0].unicode()) << 32)
+         | (static_cast<quint64>(chars[1].unicode()) << 16)
+         | static_cast<quint64>(chars[2].unicode());
+}
+
+void BowlerSearchIndex::clear()
+{
+    m_haystacks.clear();
+    m_trigramRows.clear();
+}
+
+void BowlerSearchIndex::build(const QVector<BowlerInfo> &bowlers)
+{
+    clear();
+    m_haystacks.reserve(bowlers.size());
+
+    for (int row = 0; row < bowlers.size(); ++row) {
+        const BowlerInfo &bowler = bowlers[row];
+
+        QString haystack = bowler.firstName + ' ' + bowler.lastName
+                         + FIELD_SEPARATOR + bowler.phone
+                         + FIELD_SEPARATOR + bowler.address;
+        if (bowler.average > 0) {
+            haystack += FIELD_SEPARATOR + QString::number(bowler.average);
+        }
+        haystack = haystack.toLower();
+        m_haystacks.append(haystack);
+
+        // Rows are added in order, so checking the last entry keeps lists unique and sorted
+        for (int i = 0; i + 3 <= haystack.size(); ++i) {
+            QVector<int> &rows = m_trigramRows[trigramKey(haystack.constData() + i)];
+            if (rows.isEmpty() || rows.last() != row) {
+                rows.append(row);
+            }
+        }
+    }
+}
+
+QVector<bool> BowlerSearchIndex::match(const QString &text) const
+{
+    const QString needle = text.trimmed().toLower();
+    QVector<bool> matches(m_haystacks.size(), needle.isEmpty());
+    if (needle.isEmpty()) {
+        return matches;
+    }
+
+    if (needle.size() < 3) {
+        for (int row = 0; row < m_haystacks.size(); ++row) {
+            matches[row] = m_haystacks[row].contains(needle);
+        }
+        return matches;
+    }
+
+    QVector<const QVector<int>*> postings;
+    for (int i = 0; i + 3 <= needle.size(); ++i) {
+        auto it = m_trigramRows.constFind(trigramKey(needle.constData() + i));
+        if (it == m_trigramRows.constEnd()) {
+            return matches; // No bowler contains this trigram
+        }
+        postings.append(&it.value());
+    }
+
+    // Intersect from the rarest trigram up
+    std::sort(postings.begin(), postings.end(), [](const QVector<int> *a, const QVector<int> *b) {
+        return a->size() < b->size();
+    });
+
+    QVector<int> candidates = *postings.first();
+    for (int i = 1; i < postings.size() && !candidates.isEmpty(); ++i) {
+        QVector<int> narrowed;
+        std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                              postings[i]->constBegin(), postings[i]->constEnd(),
+                              std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+    }
+
+    // Trigrams can match out of order, so confirm the substring
+    for (int row : candidates) {
+        matches[row] = m_haystacks[row].contains(needle);
+    }
+    return matches;
+}
+
+// BowlerListModel
+
+BowlerListModel::BowlerListModel(const QVector<Column> &columns, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_columns(columns)
+{
+}
+
+QVector<BowlerInfo> BowlerListModel::fromBowlerData(const QVector<BowlerData> &bowlers)
+{
+    QVector<BowlerInfo> result;
+    result.reserve(bowlers.size());
+
+    for (const BowlerData &data : bowlers) {
+        BowlerInfo bowler;
+        bowler.id = data.id;
+        bowler.firstName = data.firstName;
+        bowler.lastName = data.lastName;
+        bowler.sex = data.sex;
+        bowler.average = data.average;
+        bowler.birthday = data.birthday;
+        bowler.over18 = data.over18;
+        bowler.phone = data.phone;
+        bowler.address = data.address;
+        bowler.teams = data.teams;
+        result.append(bowler);
+    }
+
+    return result;
+}
+
+void BowlerListModel::setBowlers(const QVector<BowlerInfo> &bowlers)
+{
+    beginResetModel();
+    m_bowlers = bowlers;
+    m_searchIndex.build(m_bowlers);
+    endResetModel();
+}
+
+int BowlerListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_bowlers.size();
+}
+
+int BowlerListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant BowlerListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_bowlers.size() || index.column() >= m_columns.size()) {
+        return QVariant();
+    }
+
+    const BowlerInfo &bowler = m_bowlers[index.row()];
+
+    if (role == BowlerIdRole) {
+        return bowler.id;
+    }
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+
+    switch (m_columns[index.column()]) {
+    case IdColumn:
+        return bowler.id;
+    case NameColumn:
+        return bowler.firstName + ' ' + bowler.lastName;
+    case SexColumn:
+        return bowler.sex;
+    case AverageColumn:
+        return bowler.average > 0 ? QString::number(bowler.average) : QString("N/A");
+    case AgeColumn:
+        return bowler.over18 ? "Adult" : "Youth";
+    case PhoneColumn:
+        return bowler.phone.isEmpty() ? QString("N/A") : bowler.phone;
+    case SummaryColumn:
+        return QString("%1 %2 - Avg: %3")
+               .arg(bowler.firstName)
+               .arg(bowler.lastName)
+               .arg(bowler.average > 0 ? QString::number(bowler.average) : "N/A");
+    }
+
+    return QVariant();
+}
+
+QVariant BowlerListModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole || section >= m_columns.size()) {
+        return QVariant();
+    }
+
+    switch (m_columns[section]) {
+    case IdColumn:      return "ID";
+    case NameColumn:    return "Name";
+    case SexColumn:     return "Sex";
+    case AverageColumn: return "Average";
+    case AgeColumn:     return "Age";
+    case PhoneColumn:   return "Phone";
+    case SummaryColumn: return "Bowler";
+    }
+
+    return QVariant();
+}
+
+// BowlerFilterProxyModel
+
+BowlerFilterProxyModel::BowlerFilterProxyModel(QObject *parent)
+    : QSortFilterProxyModel(parent)
+{
+    // Keep search results in step with the source rows
+    connect(this, &QAbstractProxyModel::sourceModelChanged, this, [this]() {
+        disconnect(m_sourceResetConnection);
+        if (sourceModel()) {
+            m_sourceResetConnection = connect(sourceModel(), &QAbstractItemModel::modelReset,
+                                              this, &BowlerFilterProxyModel::refresh);
+        }
+        refresh();
+    });
+}
+
+void BowlerFilterProxyModel::setSearchText(const QString &text)
+{
+    if (text == m_searchText) {
+        return;
+    }
+    m_searchText = text;
+    refresh();
+}
+
+void BowlerFilterProxyModel::setSexFilter(const QString &sex)
+{
+    m_sexFilter = (sex == "All") ? QString() : sex;
+    invalidateFilter();
+}
+
+void BowlerFilterProxyModel::setAgeFilter(int ageFilter)
+{
+    m_ageFilter = ageFilter;
+    invalidateFilter();
+}
+
+void BowlerFilterProxyModel::setAverageRange(int minAverage, int maxAverage)
+{
+    m_minAverage = minAverage;
+    m_maxAverage = maxAverage;
+    invalidateFilter();
+}
+
+void BowlerFilterProxyModel::setExcludedIds(const QSet<int> &bowlerIds)
+{
+    m_excludedIds = bowlerIds;
+    invalidateFilter();
+}
+
+void BowlerFilterProxyModel::refresh()
+{
+    BowlerListModel *model = qobject_cast<BowlerListModel*>(sourceModel());
+    m_searchMatches = model ? model->searchIndex().match(m_searchText) : QVector<bool>();
+    invalidateFilter();
+}
+
+bool BowlerFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    Q_UNUSED(sourceParent)
+
+    BowlerListModel *model = qobject_cast<BowlerListModel*>(sourceModel());
+    if (!model || sourceRow >= m_searchMatches.size() || !m_searchMatches[sourceRow]) {
+        return false;
+    }
+
+    const BowlerInfo &bowler = model->bowlerAt(sourceRow);
+
+    if (!m_excludedIds.isEmpty() && m_excludedIds.contains(bowler.id)) {
+        return false;
+    }
+    if (!m_sexFilter.isEmpty() && bowler.sex != m_sexFilter) {
+        return false;
+    }
+    if ((m_ageFilter == 1 && !bowler.over18) || (m_ageFilter == 2 && bowler.over18)) {
+        return false;
+    }
+    return bowler.average >= m_minAverage && bowler.average <= m_maxAverage;
+}
@@ -0,0 +1,101 @@
+﻿// BowlerListModel.h
+#ifndef BOWLERLISTMODEL_H
+#define BOWLERLISTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include "NewBowlerDialog.h"
+#include "DatabaseManager.h"
+
+// Lowercased search text per bowler plus trigram posting lists, built once
+// when the bowler list is loaded. Queries of three or more characters only
+// verify rows that contain every trigram of the query.
+class BowlerSearchIndex
+{
+public:
+    void build(const QVector<BowlerInfo> &bowlers);
+    void clear();
+
+    // One flag per row; all true for an empty query
+    QVector<bool> match(const QString &text) const;
+
+private:
+    static quint64 trigramKey(const QChar *chars);
+
+    QVector<QString> m_haystacks;                   // Name, phone, address, average
+    QHash<quint64, QVector<int>> m_trigramRows;     // Trigram -> ascending row numbers
+};
+
+class BowlerListModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        IdColumn,
+        NameColumn,
+        SexColumn,
+        AverageColumn,
+        AgeColumn,
+        PhoneColumn,
+        SummaryColumn       // "First Last - Avg: 180"
+    };
+
+    static const int BowlerIdRole = Qt::UserRole;
+
+    explicit BowlerListModel(const QVector<Column> &columns, QObject *parent = nullptr);
+
+    static QVector<BowlerInfo> fromBowlerData(const QVector<BowlerData> &bowlers);
+
+    void setBowlers(const QVector<BowlerInfo> &bowlers);
+    const QVector<BowlerInfo> &bowlers() const { return m_bowlers; }
+    const BowlerInfo &bowlerAt(int row) const { return m_bowlers[row]; }
+    const BowlerSearchIndex &searchIndex() const { return m_searchIndex; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QVector<Column> m_columns;
+    QVector<BowlerInfo> m_bowlers;
+    BowlerSearchIndex m_searchIndex;
+};
+
+// Filters a BowlerListModel by search text, sex, age, average and excluded ids.
+// Search results come from the model's index, so each row test is a lookup.
+class BowlerFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit BowlerFilterProxyModel(QObject *parent = nullptr);
+
+    void setSearchText(const QString &text);
+    void setSexFilter(const QString &sex);          // "All" or empty disables
+    void setAgeFilter(int ageFilter);               // 0 = all, 1 = adults, 2 = youth
+    void setAverageRange(int minAverage, int maxAverage);
+    void setExcludedIds(const QSet<int> &bowlerIds);
+
+    // Re-runs the search after the source model reloads
+    void refresh();
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    QString m_searchText;
+    QVector<bool> m_searchMatches;
+    QString m_sexFilter;
+    int m_ageFilter = 0;
+    int m_minAverage = 0;
+    int m_maxAverage = 300;
+    QSet<int> m_excludedIds;
+    QMetaObject::Connection m_sourceResetConnection;
+};
+
+#endif // BOWLERLISTMODEL_H
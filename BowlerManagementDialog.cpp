@@ -163,16 +163,22 @@ void BowlerManagementDialog::setupLeftPane()
     
     m_leftLayout->addWidget(filtersGroup);
     
-    // Bowlers tree
-    m_bowlersTree = new QTreeWidget;
-    m_bowlersTree->setStyleSheet("QTreeWidget { "
+    // Bowlers view - only visible rows are ever materialised
+    m_bowlersModel = new BowlerListModel({BowlerListModel::IdColumn, BowlerListModel::NameColumn,
+                                          BowlerListModel::SexColumn, BowlerListModel::AverageColumn,
+                                          BowlerListModel::AgeColumn, BowlerListModel::PhoneColumn}, this);
+    m_bowlersProxy = new BowlerFilterProxyModel(this);
+    m_bowlersProxy->setSourceModel(m_bowlersModel);
+    
+    m_bowlersView = new QTreeView;
+    m_bowlersView->setStyleSheet("QTreeView { "
                                 "background-color: #1a1a1a; "
                                 "color: white; "
                                 "border: 1px solid #333; "
                                 "selection-background-color: #4A90E2; "
                                 "font-size: 11px; "
                                 "} "
-                                "QTreeWidget::item { "
+                                "QTreeView::item { "
                                 "padding: 3px; "
                                 "} "
                                 "QHeaderView::section { "
@@ -181,21 +187,20 @@ void BowlerManagementDialog::setupLeftPane()
                                 "border: 1px solid #555; "
                                 "padding: 4px; "
                                 "}");
-    
-    QStringList headers;
-    headers << "ID" << "Name" << "Sex" << "Average" << "Age" << "Phone";
-    m_bowlersTree->setHeaderLabels(headers);
-    m_bowlersTree->header()->setStretchLastSection(false);
-    m_bowlersTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents); // ID
-    m_bowlersTree->header()->setSectionResizeMode(1, QHeaderView::Stretch);           // Name
-    m_bowlersTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents); // Sex
-    m_bowlersTree->header()->setSectionResizeMode(3, QHeaderView::ResizeToContents); // Average
-    m_bowlersTree->header()->setSectionResizeMode(4, QHeaderView::ResizeToContents); // Age
-    m_bowlersTree->header()->setSectionResizeMode(5, QHeaderView::ResizeToContents); // Phone
-    
-    connect(m_bowlersTree, &QTreeWidget::currentItemChanged,
+    m_bowlersView->setRootIsDecorated(false);
+    m_bowlersView->setUniformRowHeights(true);
+    m_bowlersView->setModel(m_bowlersProxy);
+    m_bowlersView->header()->setStretchLastSection(false);
+    m_bowlersView->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents); // ID
+    m_bowlersView->header()->setSectionResizeMode(1, QHeaderView::Stretch);           // Name
+    m_bowlersView->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents); // Sex
+    m_bowlersView->header()->setSectionResizeMode(3, QHeaderView::ResizeToContents); // Average
+    m_bowlersView->header()->setSectionResizeMode(4, QHeaderView::ResizeToContents); // Age
+    m_bowlersView->header()->setSectionResizeMode(5, QHeaderView::ResizeToContents); // Phone
+    
+    connect(m_bowlersView->selectionModel(), &QItemSelectionModel::currentChanged,
             this, &BowlerManagementDialog::onBowlerSelectionChanged);
-    m_leftLayout->addWidget(m_bowlersTree);
+    m_leftLayout->addWidget(m_bowlersView);
     
     // Refresh button
     m_refreshBtn = new QPushButton("Refresh List");
@@ -331,8 +336,7 @@ void BowlerManagementDialog::setupRightPane()
 
 void BowlerManagementDialog::onBowlerSelectionChanged()
 {
-    QTreeWidgetItem *currentItem = m_bowlersTree->currentItem();
-    bool hasSelection = currentItem != nullptr;
+    bool hasSelection = m_bowlersView->currentIndex().isValid();
     
     m_editBowlerBtn->setEnabled(hasSelection);
     m_deleteBowlerBtn->setEnabled(hasSelection);
@@ -440,62 +444,13 @@ void BowlerManagementDialog::onRefreshClicked()
 
 void BowlerManagementDialog::updateBowlersList()
 {
-    QString searchFilter = m_searchEdit->text().toLower();
-    QString sexFilter = m_sexFilterCombo->currentText();
-    QString ageFilter = m_ageFilterCombo->currentText();
-    int minAverage = m_minAverageSpinner->value();
-    int maxAverage = m_maxAverageSpinner->value();
-    
-    m_bowlersTree->clear();
-    m_bowlerIdMap.clear();
-    
-    int rowIndex = 0;
-    for (const BowlerInfo &bowler : m_bowlers) {
-        // Apply search filter
-        if (!searchFilter.isEmpty()) {
-            QString fullName = QString("%1 %2").arg(bowler.firstName).arg(bowler.lastName).toLower();
-            QString phone = bowler.phone.toLower();
-            QString address = bowler.address.toLower();
-            
-            if (!fullName.contains(searchFilter) && 
-                !phone.contains(searchFilter) && 
-                !address.contains(searchFilter)) {
-                continue;
-            }
-        }
-        
-        // Apply sex filter
-        if (sexFilter != "All" && bowler.sex != sexFilter) {
-            continue;
-        }
-        
-        // Apply age filter
-        if (ageFilter != "All") {
-            if ((ageFilter == "Adult (18+)" && !bowler.over18) ||
-                (ageFilter == "Youth (<18)" && bowler.over18)) {
-                continue;
-            }
-        }
-        
-        // Apply average filter
-        if (bowler.average < minAverage || bowler.average > maxAverage) {
-            continue;
-        }
-        
-        QTreeWidgetItem *item = new QTreeWidgetItem(m_bowlersTree);
-        item->setText(0, QString::number(bowler.id));
-        item->setText(1, QString("%1 %2").arg(bowler.firstName).arg(bowler.lastName));
-        item->setText(2, bowler.sex);
-        item->setText(3, bowler.average > 0 ? QString::number(bowler.average) : "N/A");
-        item->setText(4, bowler.over18 ? "Adult" : "Youth");
-        item->setText(5, bowler.phone.isEmpty() ? "N/A" : bowler.phone);
-        
-        m_bowlerIdMap[rowIndex] = bowler.id;
-        rowIndex++;
-    }
+    m_bowlersProxy->setSearchText(m_searchEdit->text());
+    m_bowlersProxy->setSexFilter(m_sexFilterCombo->currentText());
+    m_bowlersProxy->setAgeFilter(m_ageFilterCombo->currentIndex());
+    m_bowlersProxy->setAverageRange(m_minAverageSpinner->value(), m_maxAverageSpinner->value());
     
     // Update details if current selection is no longer valid
-    if (!m_bowlersTree->currentItem()) {
+    if (!m_bowlersView->currentIndex().isValid()) {
         updateBowlerDetails();
     }
 }
@@ -599,47 +554,17 @@ void BowlerManagementDialog::showEditBowlerDialog()
 
 BowlerInfo BowlerManagementDialog::getSelectedBowler()
 {
-    QTreeWidgetItem *currentItem = m_bowlersTree->currentItem();
-    if (!currentItem) return BowlerInfo();
-    
-    int currentRow = m_bowlersTree->indexOfTopLevelItem(currentItem);
-    if (!m_bowlerIdMap.contains(currentRow)) return BowlerInfo();
+    QModelIndex current = m_bowlersProxy->mapToSource(m_bowlersView->currentIndex());
+    if (!current.isValid()) return BowlerInfo();
     
-    int bowlerId = m_bowlerIdMap[currentRow];
-    for (const BowlerInfo &bowler : m_bowlers) {
-        if (bowler.id == bowlerId) {
-            return bowler;
-        }
-    }
-    
-    return BowlerInfo();
+    return m_bowlersModel->bowlerAt(current.row());
 }
 
 void BowlerManagementDialog::loadBowlersFromDatabase()
 {
     DatabaseManager* db = DatabaseManager::instance();
-    QVector<BowlerData> dbBowlers = db->getAllBowlers();
-    
-    m_bowlers.clear();
-    
-    // Convert BowlerData to BowlerInfo
-    for (const BowlerData& dbBowler : dbBowlers) {
-        BowlerInfo bowler;
-        bowler.id = dbBowler.id;
-        bowler.firstName = dbBowler.firstName;
-        bowler.lastName = dbBowler.lastName;
-        bowler.sex = dbBowler.sex;
-        bowler.average = dbBowler.average;
-        bowler.birthday = dbBowler.birthday;
-        bowler.over18 = dbBowler.over18;
-        bowler.phone = dbBowler.phone;
-        bowler.address = dbBowler.address;
-        
-        // TODO: Load team memberships from database
-        // bowler.teams = db->getBowlerTeams(bowler.id);
-        
-        m_bowlers.append(bowler);
-    }
+    
+    m_bowlersModel->setBowlers(BowlerListModel::fromBowlerData(db->getAllBowlers()));
 }
 
 // Static method for selecting bowlers
@@ -647,25 +572,7 @@ QVector<BowlerInfo> BowlerManagementDialog::selectBowlersDialog(const QVector<Bo
 {
     // Load all bowlers from database
     DatabaseManager* db = DatabaseManager::instance();
-    QVector<BowlerData> dbBowlers = db->getAllBowlers();
-
-    QVector<BowlerInfo> allBowlers;
-    
-    // Convert BowlerData to BowlerInfo
-    for (const BowlerData& dbBowler : dbBowlers) {
-        BowlerInfo bowler;
-        bowler.id = dbBowler.id;
-        bowler.firstName = dbBowler.firstName;
-        bowler.lastName = dbBowler.lastName;
-        bowler.sex = dbBowler.sex;
-        bowler.average = dbBowler.average;
-        bowler.birthday = dbBowler.birthday;
-        bowler.over18 = dbBowler.over18;
-        bowler.phone = dbBowler.phone;
-        bowler.address = dbBowler.address;
-        
-        allBowlers.append(bowler);
-    }
+    QVector<BowlerInfo> allBowlers = BowlerListModel::fromBowlerData(db->getAllBowlers());
     
     BowlerSelectionDialog dialog(allBowlers, excludeBowlers, parent);
     if (dialog.exec() == QDialog::Accepted) {
@@ -680,8 +587,6 @@ BowlerSelectionDialog::BowlerSelectionDialog(const QVector<BowlerInfo> &availabl
                                            const QVector<BowlerInfo> &excludeBowlers,
                                            QWidget *parent)
     : QDialog(parent)
-    , m_allBowlers(availableBowlers)
-    , m_excludeBowlers(excludeBowlers)
 {
     setupUI();
     setWindowTitle("Select Bowlers");
@@ -695,7 +600,13 @@ BowlerSelectionDialog::BowlerSelectionDialog(const QVector<BowlerInfo> &availabl
     int y = (screenGeometry.height() - height()) / 2;
     move(x, y);
     
-    updateAvailableBowlers();
+    QSet<int> excludedIds;
+    for (const BowlerInfo &bowler : excludeBowlers) {
+        excludedIds.insert(bowler.id);
+    }
+    m_bowlersProxy->setExcludedIds(excludedIds);
+    m_bowlersModel->setBowlers(availableBowlers);
+    updateSelectedCount();
 }
 
 void BowlerSelectionDialog::setupUI()
@@ -741,15 +652,21 @@ void BowlerSelectionDialog::setupUI()
     listLabel->setStyleSheet("QLabel { color: white; font-weight: bold; }");
     m_mainLayout->addWidget(listLabel);
     
-    m_availableBowlersTree = new QTreeWidget;
-    m_availableBowlersTree->setStyleSheet("QTreeWidget { "
+    m_bowlersModel = new BowlerListModel({BowlerListModel::IdColumn, BowlerListModel::NameColumn,
+                                          BowlerListModel::SexColumn, BowlerListModel::AverageColumn,
+                                          BowlerListModel::PhoneColumn}, this);
+    m_bowlersProxy = new BowlerFilterProxyModel(this);
+    m_bowlersProxy->setSourceModel(m_bowlersModel);
+    
+    m_availableBowlersView = new QTreeView;
+    m_availableBowlersView->setStyleSheet("QTreeView { "
                                          "background-color: #1a1a1a; "
                                          "color: white; "
                                          "border: 1px solid #333; "
                                          "selection-background-color: #4A90E2; "
                                          "font-size: 11px; "
                                          "} "
-                                         "QTreeWidget::item { "
+                                         "QTreeView::item { "
                                          "padding: 3px; "
                                          "} "
                                          "QHeaderView::section { "
@@ -758,21 +675,21 @@ void BowlerSelectionDialog::setupUI()
                                          "border: 1px solid #555; "
                                          "padding: 4px; "
                                          "}");
-    
-    QStringList headers;
-    headers << "ID" << "Name" << "Sex" << "Average" << "Phone";
-    m_availableBowlersTree->setHeaderLabels(headers);
-    m_availableBowlersTree->header()->setStretchLastSection(false);
-    m_availableBowlersTree->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents); // ID
-    m_availableBowlersTree->header()->setSectionResizeMode(1, QHeaderView::Stretch);           // Name
-    m_availableBowlersTree->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents); // Sex
-    m_availableBowlersTree->header()->setSectionResizeMode(3, QHeaderView::ResizeToContents); // Average
-    m_availableBowlersTree->header()->setSectionResizeMode(4, QHeaderView::ResizeToContents); // Phone
-    
-    m_availableBowlersTree->setSelectionMode(QAbstractItemView::MultiSelection);
-    connect(m_availableBowlersTree, &QTreeWidget::itemSelectionChanged, 
+    m_availableBowlersView->setRootIsDecorated(false);
+    m_availableBowlersView->setUniformRowHeights(true);
+    m_availableBowlersView->setModel(m_bowlersProxy);
+    m_availableBowlersView->header()->setStretchLastSection(false);
+    m_availableBowlersView->header()->setSectionResizeMode(0, QHeaderView::ResizeToContents); // ID
+    m_availableBowlersView->header()->setSectionResizeMode(1, QHeaderView::Stretch);           // Name
+    m_availableBowlersView->header()->setSectionResizeMode(2, QHeaderView::ResizeToContents); // Sex
+    m_availableBowlersView->header()->setSectionResizeMode(3, QHeaderView::ResizeToContents); // Average
+    m_availableBowlersView->header()->setSectionResizeMode(4, QHeaderView::ResizeToContents); // Phone
+    
+    m_availableBowlersView->setSelectionMode(QAbstractItemView::MultiSelection);
+    m_availableBowlersView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    connect(m_availableBowlersView->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &BowlerSelectionDialog::updateSelectedCount);
-    m_mainLayout->addWidget(m_availableBowlersTree);
+    m_mainLayout->addWidget(m_availableBowlersView);
     
     // Selection buttons
     QHBoxLayout *selectionLayout = new QHBoxLayout;
@@ -846,19 +763,10 @@ void BowlerSelectionDialog::setupUI()
 QVector<BowlerInfo> BowlerSelectionDialog::getSelectedBowlers() const
 {
     QVector<BowlerInfo> selectedBowlers;
-    QList<QTreeWidgetItem*> selectedItems = m_availableBowlersTree->selectedItems();
-    
-    for (QTreeWidgetItem* item : selectedItems) {
-        int row = m_availableBowlersTree->indexOfTopLevelItem(item);
-        if (m_bowlerIdMap.contains(row)) {
-            int bowlerId = m_bowlerIdMap[row];
-            for (const BowlerInfo &bowler : m_allBowlers) {
-                if (bowler.id == bowlerId) {
-                    selectedBowlers.append(bowler);
-                    break;
-                }
-            }
-        }
+    const QModelIndexList selectedRows = m_availableBowlersView->selectionModel()->selectedRows();
+    
+    for (const QModelIndex &index : selectedRows) {
+        selectedBowlers.append(m_bowlersModel->bowlerAt(m_bowlersProxy->mapToSource(index).row()));
     }
     
     return selectedBowlers;
@@ -866,18 +774,18 @@ QVector<BowlerInfo> BowlerSelectionDialog::getSelectedBowlers() const
 
 void BowlerSelectionDialog::onSearchTextChanged(const QString &text)
 {
-    Q_UNUSED(text)
-    updateAvailableBowlers();
+    m_bowlersProxy->setSearchText(text);
+    updateSelectedCount();
 }
 
 void BowlerSelectionDialog::onSelectAllClicked()
 {
-    m_availableBowlersTree->selectAll();
+    m_availableBowlersView->selectAll();
 }
 
 void BowlerSelectionDialog::onDeselectAllClicked()
 {
-    m_availableBowlersTree->clearSelection();
+    m_availableBowlersView->clearSelection();
 }
 
 void BowlerSelectionDialog::onSaveClicked()
@@ -896,56 +804,9 @@ void BowlerSelectionDialog::onCancelClicked()
     reject();
 }
 
-void BowlerSelectionDialog::updateAvailableBowlers()
-{
-    QString searchFilter = m_searchEdit->text().toLower();
-    
-    m_availableBowlersTree->clear();
-    m_bowlerIdMap.clear();
-    
-    // Create set of excluded bowler IDs for fast lookup
-    QSet<int> excludedIds;
-    for (const BowlerInfo &bowler : m_excludeBowlers) {
-        excludedIds.insert(bowler.id);
-    }
-    
-    int rowIndex = 0;
-    for (const BowlerInfo &bowler : m_allBowlers) {
-        // Skip excluded bowlers
-        if (excludedIds.contains(bowler.id)) {
-            continue;
-        }
-        
-        // Apply search filter
-        if (!searchFilter.isEmpty()) {
-            QString fullName = QString("%1 %2").arg(bowler.firstName).arg(bowler.lastName).toLower();
-            QString phone = bowler.phone.toLower();
-            QString average = QString::number(bowler.average);
-            
-            if (!fullName.contains(searchFilter) && 
-                !phone.contains(searchFilter) && 
-                !average.contains(searchFilter)) {
-                continue;
-            }
-        }
-        
-        QTreeWidgetItem *item = new QTreeWidgetItem(m_availableBowlersTree);
-        item->setText(0, QString::number(bowler.id));
-        item->setText(1, QString("%1 %2").arg(bowler.firstName).arg(bowler.lastName));
-        item->setText(2, bowler.sex);
-        item->setText(3, bowler.average > 0 ? QString::number(bowler.average) : "N/A");
-        item->setText(4, bowler.phone.isEmpty() ? "N/A" : bowler.phone);
-        
-        m_bowlerIdMap[rowIndex] = bowler.id;
-        rowIndex++;
-    }
-    
-    updateSelectedCount();
-}
-
 void BowlerSelectionDialog::updateSelectedCount()
 {
-    int selectedCount = m_availableBowlersTree->selectedItems().size();
+    int selectedCount = m_availableBowlersView->selectionModel()->selectedRows().size();
     m_selectedCountLabel->setText(QString("Selected: %1").arg(selectedCount));
     m_saveBtn->setEnabled(selectedCount > 0);
 }
\ No newline at end of file
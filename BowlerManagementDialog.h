@@ -6,7 +6,7 @@
 #include <QHBoxLayout>
 #include <QGridLayout>
 #include <QSplitter>
-#include <QTreeWidget>
+#include <QTreeView>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
@@ -23,6 +23,7 @@
 #include <QAbstractItemView>
 #include "NewBowlerDialog.h"
 #include "DatabaseManager.h"
+#include "BowlerListModel.h"
 
 class MainWindow;
 
@@ -70,7 +71,7 @@ private:
     QComboBox *m_ageFilterCombo;
     QSpinBox *m_minAverageSpinner;
     QSpinBox *m_maxAverageSpinner;
-    QTreeWidget *m_bowlersTree;
+    QTreeView *m_bowlersView;
     QPushButton *m_refreshBtn;
     
     // Right pane - Actions and details
@@ -88,8 +89,8 @@ private:
     QPushButton *m_closeBtn;
     
     // Data
-    QVector<BowlerInfo> m_bowlers;
-    QMap<int, int> m_bowlerIdMap; // Maps tree row to bowler ID
+    BowlerListModel *m_bowlersModel;
+    BowlerFilterProxyModel *m_bowlersProxy;
 };
 
 // Dialog for selecting multiple bowlers (used by team management)
@@ -114,23 +115,20 @@ private slots:
 
 private:
     void setupUI();
-    void updateAvailableBowlers();
     
-    QVector<BowlerInfo> m_allBowlers;
-    QVector<BowlerInfo> m_excludeBowlers;
     QVBoxLayout *m_mainLayout;
     QHBoxLayout *m_searchLayout;
     QHBoxLayout *m_buttonLayout;
     
     QLineEdit *m_searchEdit;
-    QTreeWidget *m_availableBowlersTree;
+    QTreeView *m_availableBowlersView;
+    BowlerListModel *m_bowlersModel;
+    BowlerFilterProxyModel *m_bowlersProxy;
     QLabel *m_selectedCountLabel;
     QPushButton *m_selectAllBtn;
     QPushButton *m_deselectAllBtn;
     QPushButton *m_saveBtn;
     QPushButton *m_cancelBtn;
-    
-    QMap<int, int> m_bowlerIdMap; // Maps tree row to bowler ID
 };
 
 #endif // BOWLERMANAGEMENTDIALOG_H
\ No newline at end of file
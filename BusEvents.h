@@ -0,0 +1,44 @@
+﻿// BusEvents.h
+#ifndef BUSEVENTS_H
+#define BUSEVENTS_H
+
+#include <QString>
+#include <QJsonObject>
+#include "EventBus.h"
+
+// Events carried by EventBus. Each names its channel; laneId/leagueId come
+// from BusEvent.
+
+struct LaneStatusEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::Lanes;
+    int status = 0;                     // LaneStatus
+};
+
+// The game a lane was given; gameType is empty once the lane is cleared
+struct LaneGameEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::Lanes;
+    QString gameType;
+    QJsonObject gameData;
+};
+
+struct GameDataEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::Games;
+    QJsonObject gameData;
+};
+
+struct GameCompletedEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::Games;
+    QString gameType;
+    QJsonObject data;
+};
+
+struct StandingsChangedEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::League;
+};
+
+struct LeagueEventCompletedEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::League;
+    int eventId = 0;
+};
+
+#endif // BUSEVENTS_H
@@ -570,6 +570,18 @@ void CalendarDialog::setupBookingForm()
                                          "QPushButton:hover { background-color: #138496; }");
     connect(m_checkAvailabilityBtn, &QPushButton::clicked, this, &CalendarDialog::onCheckAvailabilityClicked);
     
+    m_findLanesBtn = new QPushButton("Find Lanes");
+    m_findLanesBtn->setStyleSheet("QPushButton { "
+                                 "background-color: #6f42c1; "
+                                 "color: white; "
+                                 "border: none; "
+                                 "padding: 8px 12px; "
+                                 "border-radius: 3px; "
+                                 "font-weight: bold; "
+                                 "} "
+                                 "QPushButton:hover { background-color: #5a2d91; }");
+    connect(m_findLanesBtn, &QPushButton::clicked, this, &CalendarDialog::onFindLanesClicked);
+    
     m_saveBookingBtn = new QPushButton("Save Booking");
     m_saveBookingBtn->setStyleSheet("QPushButton { "
                                    "background-color: #28a745; "
@@ -594,6 +606,7 @@ void CalendarDialog::setupBookingForm()
     connect(m_clearFormBtn, &QPushButton::clicked, this, &CalendarDialog::clearBookingForm);
     
     formButtonLayout->addWidget(m_checkAvailabilityBtn);
+    formButtonLayout->addWidget(m_findLanesBtn);
     formButtonLayout->addWidget(m_saveBookingBtn);
     formButtonLayout->addWidget(m_clearFormBtn);
     
@@ -751,10 +764,171 @@ void CalendarDialog::onCheckAvailabilityClicked()
                           .arg(conflict.endTime.toString("h:mm AP"));
         }
         
+        // Suggest the next opening on this lane before closing time
+        QDateTime closing(date, QTime(m_endHour, 0));
+        if (m_endHour <= m_startHour) {
+            closing = closing.addDays(1);
+        }
+        QDateTime nextFree = m_dbManager->findFirstFreeSlot(QDateTime(date, startTime),
+                                                            closing.addSecs(-duration * 60),
+                                                            duration, QVector<int>{laneId});
+        if (nextFree.isValid()) {
+            conflictMsg += QString("\nNext opening on lane %1: %2 at %3")
+                          .arg(laneId)
+                          .arg(nextFree.date().toString("MMMM d"))
+                          .arg(nextFree.time().toString("h:mm AP"));
+        } else {
+            conflictMsg += QString("\nLane %1 has no opening of this length before closing.").arg(laneId);
+        }
+        
         QMessageBox::warning(this, "Booking Conflict", conflictMsg);
     }
 }
 
+void CalendarDialog::onFindLanesClicked()
+{
+    QDialog dialog(this);
+    dialog.setWindowTitle("Find Lanes");
+    dialog.setStyleSheet("QDialog { background-color: #2a2a2a; } "
+                         "QLabel, QCheckBox { color: white; } "
+                         "QSpinBox, QDateEdit, QTimeEdit, QListWidget { "
+                         "background-color: #333; color: white; border: 1px solid #555; padding: 4px; }");
+    dialog.resize(520, 520);
+    
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    QGridLayout *form = new QGridLayout;
+    layout->addLayout(form);
+    
+    QSpinBox *partySpinner = new QSpinBox;
+    partySpinner->setRange(1, 200);
+    partySpinner->setValue(qMax(12, m_bowlerCountSpinner->value()));
+    QSpinBox *perLaneSpinner = new QSpinBox;
+    perLaneSpinner->setRange(1, 8);
+    perLaneSpinner->setValue(6);
+    QSpinBox *durationSpinner = new QSpinBox;
+    durationSpinner->setRange(30, 480);
+    durationSpinner->setSingleStep(30);
+    durationSpinner->setValue(m_durationSpinner->value());
+    QDateEdit *fromDateEdit = new QDateEdit(m_dateEdit->date());
+    fromDateEdit->setCalendarPopup(true);
+    QSpinBox *daysSpinner = new QSpinBox;
+    daysSpinner->setRange(1, 90);
+    daysSpinner->setValue(14);
+    QTimeEdit *windowStartEdit = new QTimeEdit(QTime(m_startHour, 0));
+    windowStartEdit->setDisplayFormat("hh:mm AP");
+    QTimeEdit *windowEndEdit = new QTimeEdit(QTime(m_endHour, 0));
+    windowEndEdit->setDisplayFormat("hh:mm AP");
+    QTimeEdit *preferredEdit = new QTimeEdit(m_startTimeEdit->time());
+    preferredEdit->setDisplayFormat("hh:mm AP");
+    QCheckBox *adjacentCheck = new QCheckBox("Lanes must be side by side");
+    
+    int row = 0;
+    form->addWidget(new QLabel("Party Size:"), row, 0);
+    form->addWidget(partySpinner, row++, 1);
+    form->addWidget(new QLabel("Bowlers per Lane:"), row, 0);
+    form->addWidget(perLaneSpinner, row++, 1);
+    form->addWidget(new QLabel("Duration (min):"), row, 0);
+    form->addWidget(durationSpinner, row++, 1);
+    form->addWidget(new QLabel("From Date:"), row, 0);
+    form->addWidget(fromDateEdit, row++, 1);
+    form->addWidget(new QLabel("Days to Search:"), row, 0);
+    form->addWidget(daysSpinner, row++, 1);
+    form->addWidget(new QLabel("Earliest Start:"), row, 0);
+    form->addWidget(windowStartEdit, row++, 1);
+    form->addWidget(new QLabel("Finish By:"), row, 0);
+    form->addWidget(windowEndEdit, row++, 1);
+    form->addWidget(new QLabel("Preferred Start:"), row, 0);
+    form->addWidget(preferredEdit, row++, 1);
+    form->addWidget(adjacentCheck, row++, 0, 1, 2);
+    
+    QLabel *summaryLabel = new QLabel;
+    layout->addWidget(summaryLabel);
+    QListWidget *resultsList = new QListWidget;
+    layout->addWidget(resultsList, 1);
+    
+    QDialogButtonBox *buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+    buttons->button(QDialogButtonBox::Ok)->setText("Use Selected");
+    layout->addWidget(buttons);
+    connect(buttons, &QDialogButtonBox::accepted, &dialog, &QDialog::accept);
+    connect(buttons, &QDialogButtonBox::rejected, &dialog, &QDialog::reject);
+    connect(resultsList, &QListWidget::itemDoubleClicked, &dialog, &QDialog::accept);
+    
+    QVector<LaneBlock> blocks;
+    QVector<int> allLanes;
+    for (int lane = 1; lane <= m_totalLanes; ++lane) {
+        allLanes.append(lane);
+    }
+    
+    // Searches run against the in-memory calendar index, so results refresh on every edit
+    auto runSearch = [&]() {
+        LaneSearchRequest request;
+        request.partySize = partySpinner->value();
+        request.bowlersPerLane = perLaneSpinner->value();
+        request.durationMinutes = durationSpinner->value();
+        request.fromDate = fromDateEdit->date();
+        request.toDate = request.fromDate.addDays(daysSpinner->value() - 1);
+        request.windowStart = windowStartEdit->time();
+        request.windowEnd = windowEndEdit->time();
+        request.preferredStart = preferredEdit->time();
+        request.requireAdjacent = adjacentCheck->isChecked();
+        request.laneIds = allLanes;
+        
+        blocks = m_dbManager->findLaneBlocks(request);
+        
+        resultsList->clear();
+        for (const LaneBlock &block : blocks) {
+            QStringList laneNames;
+            for (int laneId : block.laneIds) {
+                laneNames.append(QString::number(laneId));
+            }
+            resultsList->addItem(QString("%1  %2 - %3  Lanes %4%5")
+                                 .arg(block.start.date().toString("ddd MMM d"))
+                                 .arg(block.start.time().toString("h:mm AP"))
+                                 .arg(block.end.time().toString("h:mm AP"))
+                                 .arg(laneNames.join(", "))
+                                 .arg(block.adjacent ? "" : "  (split)"));
+        }
+        if (!blocks.isEmpty()) {
+            resultsList->setCurrentRow(0);
+        }
+        
+        summaryLabel->setText(QString("%1 lane(s) needed - %2 option(s) found")
+                              .arg(LaneFinder::lanesNeeded(request))
+                              .arg(blocks.size()));
+    };
+    
+    connect(partySpinner, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, runSearch);
+    connect(perLaneSpinner, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, runSearch);
+    connect(durationSpinner, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, runSearch);
+    connect(daysSpinner, QOverload<int>::of(&QSpinBox::valueChanged), &dialog, runSearch);
+    connect(fromDateEdit, &QDateEdit::dateChanged, &dialog, runSearch);
+    connect(windowStartEdit, &QTimeEdit::timeChanged, &dialog, runSearch);
+    connect(windowEndEdit, &QTimeEdit::timeChanged, &dialog, runSearch);
+    connect(preferredEdit, &QTimeEdit::timeChanged, &dialog, runSearch);
+    connect(adjacentCheck, &QCheckBox::toggled, &dialog, runSearch);
+    runSearch();
+    
+    if (dialog.exec() != QDialog::Accepted || resultsList->currentRow() < 0) {
+        return;
+    }
+    
+    // Fill the booking form with the first lane; the rest are listed in the details
+    const LaneBlock &block = blocks[resultsList->currentRow()];
+    QStringList laneNames;
+    for (int laneId : block.laneIds) {
+        laneNames.append(QString::number(laneId));
+    }
+    
+    m_dateEdit->setDate(block.start.date());
+    m_startTimeEdit->setTime(block.start.time());
+    m_durationSpinner->setValue(durationSpinner->value());
+    m_laneCombo->setCurrentIndex(m_laneCombo->findData(block.laneIds.first()));
+    m_bowlerCountSpinner->setValue(qMin(perLaneSpinner->value(), m_bowlerCountSpinner->maximum()));
+    m_additionalDetailsEdit->append(QString("Group of %1 on lanes %2")
+                                    .arg(partySpinner->value())
+                                    .arg(laneNames.join(", ")));
+}
+
 void CalendarDialog::onEditEventClicked()
 {
     if (m_hasSelectedEvent) {
@@ -29,6 +29,7 @@
 #include <QGroupBox>
 #include <QCheckBox>
 #include <QSettings>
+#include <QDialogButtonBox>
 #include "DatabaseManager.h"
 #include "LeagueScheduleDialog.h"
 
@@ -53,6 +54,7 @@ private slots:
     void onEditEventClicked();
     void onDeleteEventClicked();
     void onCheckAvailabilityClicked();
+    void onFindLanesClicked();
     void onLaneFilterChanged();
     void updateDailySchedule();
     void updateMonthCalendar();
@@ -160,6 +162,7 @@ private:
     QPushButton *m_saveBookingBtn;
     QPushButton *m_clearFormBtn;
     QPushButton *m_checkAvailabilityBtn;
+    QPushButton *m_findLanesBtn;
     QPushButton *m_closeBtn;
     
     // Current state
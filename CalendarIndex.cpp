@@ -0,0 +1,248 @@
+﻿// CalendarIndex.cpp
+#include "CalendarIndex.h"
+#include <QSet>
+#include <QMutexLocker>
+#include <algorithm>
+
+namespace {
+
+const qint64 MINUTES_PER_DAY = 24 * 60;
+
+bool startsBefore(const CalendarBooking &booking, qint64 start)
+{
+    return booking.start < start;
+}
+
+} // namespace
+
+qint64 CalendarIndex::toMinutes(const QDate &date, const QTime &time)
+{
+    return date.toJulianDay() * MINUTES_PER_DAY + time.hour() * 60 + time.minute();
+}
+
+QDateTime CalendarIndex::fromMinutes(qint64 minutes)
+{
+    QDate date = QDate::fromJulianDay(minutes / MINUTES_PER_DAY);
+    int minuteOfDay = static_cast<int>(minutes % MINUTES_PER_DAY);
+    return QDateTime(date, QTime(minuteOfDay / 60, minuteOfDay % 60));
+}
+
+CalendarBooking CalendarIndex::makeBooking(int eventId, int laneId, const QDate &date,
+                                           const QTime &startTime, const QTime &endTime)
+{
+    CalendarBooking booking;
+    booking.eventId = eventId;
+    booking.laneId = laneId;
+    booking.start = toMinutes(date, startTime);
+    booking.end = toMinutes(date, endTime);
+
+    // An end before the start means the booking runs past midnight; an end
+    // equal to the start is left empty rather than read as 24 hours
+    if (booking.end < booking.start) {
+        booking.end += MINUTES_PER_DAY;
+    }
+    return booking;
+}
+
+void CalendarIndex::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_lanes.clear();
+    m_eventLanes.clear();
+}
+
+void CalendarIndex::insert(const CalendarBooking &booking)
+{
+    remove(booking.eventId);
+    if (!booking.isValid()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    LaneTree &lane = m_lanes[booking.laneId];
+    auto pos = std::upper_bound(lane.bookings.begin(), lane.bookings.end(), booking,
+                                [](const CalendarBooking &a, const CalendarBooking &b) {
+                                    return a.start < b.start;
+                                });
+    lane.bookings.insert(pos, booking);
+    lane.dirty = true;
+
+    m_eventLanes.insert(booking.eventId, booking.laneId);
+}
+
+bool CalendarIndex::remove(int eventId)
+{
+    QMutexLocker locker(&m_mutex);
+    auto laneIt = m_eventLanes.find(eventId);
+    if (laneIt == m_eventLanes.end()) {
+        return false;
+    }
+
+    LaneTree &lane = m_lanes[laneIt.value()];
+    for (int i = 0; i < lane.bookings.size(); ++i) {
+        if (lane.bookings[i].eventId == eventId) {
+            lane.bookings.remove(i);
+            lane.dirty = true;
+            break;
+        }
+    }
+
+    m_eventLanes.erase(laneIt);
+    return true;
+}
+
+bool CalendarIndex::contains(int eventId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_eventLanes.contains(eventId);
+}
+
+int CalendarIndex::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_eventLanes.size();
+}
+
+bool CalendarIndex::isFree(int laneId, qint64 start, qint64 end, int excludeEventId) const
+{
+    QMutexLocker locker(&m_mutex);
+    return !overlapping(laneId, start, end, excludeEventId, nullptr);
+}
+
+QVector<int> CalendarIndex::conflicts(int laneId, qint64 start, qint64 end, int excludeEventId) const
+{
+    QVector<CalendarBooking> found;
+    {
+        QMutexLocker locker(&m_mutex);
+        overlapping(laneId, start, end, excludeEventId, &found);
+    }
+
+    QVector<int> eventIds;
+    eventIds.reserve(found.size());
+    for (const CalendarBooking &booking : found) {
+        eventIds.append(booking.eventId);
+    }
+    return eventIds;
+}
+
+QVector<CalendarBooking> CalendarIndex::bookings(int laneId, qint64 start, qint64 end) const
+{
+    QMutexLocker locker(&m_mutex);
+    QVector<CalendarBooking> found;
+    overlapping(laneId, start, end, -1, &found);
+    return found;
+}
+
+qint64 CalendarIndex::firstFreeSlot(const QVector<int> &laneIds, int laneCount, int durationMinutes,
+                                    qint64 from, qint64 latestStart, QVector<int> *freeLanes) const
+{
+    if (laneCount <= 0 || laneCount > laneIds.size() || durationMinutes <= 0 || latestStart < from) {
+        return -1;
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    // The earliest feasible start is either 'from' or the moment some booking
+    // on one of the lanes ends, so those are the only candidates worth testing.
+    QSet<qint64> candidateSet;
+    candidateSet.insert(from);
+    for (int laneId : laneIds) {
+        QVector<CalendarBooking> found;
+        overlapping(laneId, from, latestStart + durationMinutes, -1, &found);
+        for (const CalendarBooking &booking : qAsConst(found)) {
+            if (booking.end > from && booking.end <= latestStart) {
+                candidateSet.insert(booking.end);
+            }
+        }
+    }
+
+    QVector<qint64> candidates = candidateSet.values().toVector();
+    std::sort(candidates.begin(), candidates.end());
+
+    QVector<int> chosen;
+    for (qint64 start : candidates) {
+        chosen.clear();
+        for (int laneId : laneIds) {
+            if (!overlapping(laneId, start, start + durationMinutes, -1, nullptr)) {
+                chosen.append(laneId);
+                if (chosen.size() == laneCount) {
+                    if (freeLanes) {
+                        *freeLanes = chosen;
+                    }
+                    return start;
+                }
+            }
+        }
+    }
+
+    return -1;
+}
+
+bool CalendarIndex::overlapping(int laneId, qint64 start, qint64 end, int excludeEventId,
+                                QVector<CalendarBooking> *out) const
+{
+    auto laneIt = m_lanes.find(laneId);
+    if (laneIt == m_lanes.end() || laneIt->bookings.isEmpty() || end <= start) {
+        return false;
+    }
+
+    LaneTree &lane = laneIt.value();
+    if (lane.dirty) {
+        lane.rebuild();
+    }
+
+    // Only bookings starting before 'end' can overlap; the tree prunes the
+    // ones among them that finish at or before 'start'.
+    int limit = std::lower_bound(lane.bookings.constBegin(), lane.bookings.constEnd(), end, startsBefore)
+                - lane.bookings.constBegin();
+    if (limit == 0) {
+        return false;
+    }
+
+    return lane.collect(0, 0, lane.bookings.size() - 1, limit, start, excludeEventId, out);
+}
+
+void CalendarIndex::LaneTree::rebuild()
+{
+    maxEnd.fill(0, bookings.size() * 4);
+    if (!bookings.isEmpty()) {
+        build(0, 0, bookings.size() - 1);
+    }
+    dirty = false;
+}
+
+qint64 CalendarIndex::LaneTree::build(int node, int lo, int hi)
+{
+    if (lo == hi) {
+        maxEnd[node] = bookings[lo].end;
+    } else {
+        int mid = (lo + hi) / 2;
+        maxEnd[node] = qMax(build(2 * node + 1, lo, mid), build(2 * node + 2, mid + 1, hi));
+    }
+    return maxEnd[node];
+}
+
+bool CalendarIndex::LaneTree::collect(int node, int lo, int hi, int limit, qint64 start,
+                                      int excludeEventId, QVector<CalendarBooking> *out) const
+{
+    if (lo >= limit || maxEnd[node] <= start) {
+        return false;
+    }
+
+    if (lo == hi) {
+        if (bookings[lo].eventId == excludeEventId) {
+            return false;
+        }
+        if (out) {
+            out->append(bookings[lo]);
+        }
+        return true;
+    }
+
+    int mid = (lo + hi) / 2;
+    bool found = collect(2 * node + 1, lo, mid, limit, start, excludeEventId, out);
+    if (found && !out) {
+        return true;
+    }
+    return collect(2 * node + 2, mid + 1, hi, limit, start, excludeEventId, out) || found;
+}
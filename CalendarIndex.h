@@ -0,0 +1,72 @@
+﻿// CalendarIndex.h
+#ifndef CALENDARINDEX_H
+#define CALENDARINDEX_H
+
+#include <QVector>
+#include <QHash>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include <QMutex>
+
+struct CalendarBooking {
+    int eventId = 0;
+    int laneId = 0;
+    qint64 start = 0;   // Minutes since Julian day 0
+    qint64 end = 0;     // Exclusive
+
+    bool isValid() const { return end > start; }
+};
+
+// In-memory per-lane interval trees over calendar bookings.
+// Times are absolute minutes, so a booking whose end time is before its start
+// time runs past midnight and conflicts with early bookings the next day.
+// All methods lock, so worker threads may query while the GUI thread books.
+class CalendarIndex
+{
+public:
+    static qint64 toMinutes(const QDate &date, const QTime &time);
+    static QDateTime fromMinutes(qint64 minutes);
+    // An end equal to the start gives an invalid (empty) booking
+    static CalendarBooking makeBooking(int eventId, int laneId, const QDate &date,
+                                       const QTime &startTime, const QTime &endTime);
+
+    void clear();
+    void insert(const CalendarBooking &booking);    // Replaces an existing booking with the same id; invalid ones are dropped
+    bool remove(int eventId);
+    bool contains(int eventId) const;
+    int size() const;
+
+    bool isFree(int laneId, qint64 start, qint64 end, int excludeEventId = -1) const;
+    QVector<int> conflicts(int laneId, qint64 start, qint64 end, int excludeEventId = -1) const;
+    QVector<CalendarBooking> bookings(int laneId, qint64 start, qint64 end) const;
+
+    // Earliest start in [from, latestStart] at which laneCount of laneIds are all
+    // free for durationMinutes, or -1 if there is none. The chosen lanes are
+    // written to freeLanes in laneIds order.
+    qint64 firstFreeSlot(const QVector<int> &laneIds, int laneCount, int durationMinutes,
+                         qint64 from, qint64 latestStart, QVector<int> *freeLanes = nullptr) const;
+
+private:
+    // Bookings sorted by start, with an implicit balanced tree of max end times
+    // over that order. Rebuilt lazily on the first query after a change.
+    struct LaneTree {
+        QVector<CalendarBooking> bookings;
+        QVector<qint64> maxEnd;
+        bool dirty = false;
+
+        void rebuild();
+        qint64 build(int node, int lo, int hi);
+        bool collect(int node, int lo, int hi, int limit, qint64 start, int excludeEventId,
+                     QVector<CalendarBooking> *out) const;
+    };
+
+    bool overlapping(int laneId, qint64 start, qint64 end, int excludeEventId,
+                     QVector<CalendarBooking> *out) const;   // Caller holds m_mutex
+
+    mutable QMutex m_mutex;         // Guards both maps, including the lazy rebuilds
+    mutable QHash<int, LaneTree> m_lanes;
+    QHash<int, int> m_eventLanes;   // Event id -> lane id
+};
+
+#endif // CALENDARINDEX_H
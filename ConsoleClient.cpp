@@ -0,0 +1,246 @@
+﻿// ConsoleClient.cpp
+#include "ConsoleClient.h"
+#include "BusEvents.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDebug>
+
+ConsoleClient::ConsoleClient(const QString &name, QObject *parent)
+    : QObject(parent)
+    , m_name(name)
+    , m_sharedKey(qEnvironmentVariable("BOWLING_CONSOLE_KEY"))
+    , m_port(0)
+    , m_socket(new QTcpSocket(this))
+    , m_reconnectTimer(new QTimer(this))
+    , m_sequence(-1)
+{
+    m_reconnectTimer->setSingleShot(true);
+    m_reconnectTimer->setInterval(RECONNECT_INTERVAL);
+
+    connect(m_socket, &QTcpSocket::connected, this, &ConsoleClient::onConnected);
+    connect(m_socket, &QTcpSocket::disconnected, this, &ConsoleClient::onDisconnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &ConsoleClient::onReadyRead);
+    connect(m_socket, &QAbstractSocket::errorOccurred, this, [this](QAbstractSocket::SocketError) {
+        qWarning() << "Console connection error:" << m_socket->errorString();
+        if (!m_host.isEmpty() && m_socket->state() == QAbstractSocket::UnconnectedState) {
+            m_reconnectTimer->start();
+        }
+    });
+    connect(m_reconnectTimer, &QTimer::timeout, this, [this]() {
+        m_socket->connectToHost(m_host, m_port);
+    });
+}
+
+void ConsoleClient::connectToServer(const QString &host, quint16 port)
+{
+    m_host = host;
+    m_port = port;
+    m_socket->abort();
+    m_socket->connectToHost(m_host, m_port);
+}
+
+void ConsoleClient::disconnectFromServer()
+{
+    m_host.clear();
+    m_reconnectTimer->stop();
+    m_socket->disconnectFromHost();
+}
+
+bool ConsoleClient::sendCommand(const QJsonObject &command)
+{
+    if (!isAttached()) {
+        qWarning() << "Console not attached, command dropped";
+        return false;
+    }
+    send("console_command", command);
+    return true;
+}
+
+bool ConsoleClient::requestLaneShutdown()
+{
+    if (!isAttached()) {
+        qWarning() << "Console not attached, lane shutdown not requested";
+        return false;
+    }
+    send("console_shutdown_lanes", QJsonObject());
+    return true;
+}
+
+bool ConsoleClient::announce(const QString &text, int leagueId)
+{
+    if (!isAttached()) {
+        qWarning() << "Console not attached, announcement not sent";
+        return false;
+    }
+    QJsonObject data;
+    data["text"] = text;
+    if (leagueId > 0) {
+        data["league_id"] = leagueId;
+    }
+    send("console_announce", data);
+    return true;
+}
+
+void ConsoleClient::send(const QString &type, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    m_socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n");
+}
+
+void ConsoleClient::subscribe()
+{
+    m_sequence = -1;
+    QJsonObject data;
+    data["name"] = m_name;
+    data["key"] = m_sharedKey;
+    send("console_subscribe", data);
+}
+
+void ConsoleClient::onConnected()
+{
+    qDebug() << "Console connected to" << m_host << m_port;
+    subscribe();
+}
+
+void ConsoleClient::onDisconnected()
+{
+    const bool wasAttached = isAttached();
+    m_sequence = -1;
+    if (wasAttached) {
+        emit detached();
+    }
+    if (!m_host.isEmpty()) {
+        m_reconnectTimer->start();
+    }
+}
+
+void ConsoleClient::onReadyRead()
+{
+    while (m_socket->canReadLine()) {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(m_socket->readLine(), &error);
+        if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+            qWarning() << "Console JSON parse error:" << error.errorString();
+            continue;
+        }
+
+        const QJsonObject message = doc.object();
+        const QString type = message["type"].toString();
+        if (type == "console_snapshot") {
+            applySnapshot(message["data"].toObject());
+        } else if (type == "console_delta") {
+            applyDelta(message["data"].toObject());
+        } else if (type == "console_notice") {
+            emit notice(message["data"].toObject());
+        } else if (type == "console_shutdown_result") {
+            const QJsonObject data = message["data"].toObject();
+            QVector<int> failed;
+            for (const QJsonValue &value : data["failed"].toArray()) {
+                failed.append(value.toInt());
+            }
+            emit lanesShutdown(data["lanes"].toInt(), failed);
+        } else if (type == "console_announce_result") {
+            emit announced(message["data"].toObject()["recipients"].toInt());
+        } else if (type == "console_rejected") {
+            // Retrying with the same key would only be rejected again
+            const QString reason = message["data"].toObject()["reason"].toString();
+            qWarning() << "Console rejected by" << m_host << ":" << reason;
+            disconnectFromServer();
+            emit rejected(reason);
+            return;
+        }
+    }
+}
+
+void ConsoleClient::applySnapshot(const QJsonObject &data)
+{
+    const QJsonArray lanes = data["lanes"].toArray();
+    QMap<int, LaneView> previous = m_lanes;
+    m_lanes.clear();
+
+    EventBus *bus = EventBus::instance();
+    for (const QJsonValue &value : lanes) {
+        const QJsonObject lane = value.toObject();
+        const int laneId = lane["lane_id"].toInt();
+        LaneView &view = m_lanes[laneId];
+        view.status = lane["status"].toInt();
+        view.game = lane["game"].toObject();
+
+        // After a reconnect only what actually moved is republished
+        const LaneView before = previous.value(laneId);
+        if (before.status != view.status) {
+            LaneStatusEvent event;
+            event.laneId = laneId;
+            event.status = view.status;
+            bus->publish(event);
+        }
+        if (before.game != view.game && !view.game.isEmpty()) {
+            GameDataEvent event;
+            event.laneId = laneId;
+            event.gameData = view.game;
+            bus->publish(event);
+        }
+    }
+
+    const bool wasAttached = isAttached();
+    m_sequence = static_cast<qint64>(data["seq"].toDouble());
+    if (!wasAttached) {
+        emit attached(m_lanes.size());
+    }
+}
+
+void ConsoleClient::applyDelta(const QJsonObject &data)
+{
+    if (!isAttached()) {
+        return; // Waiting for the snapshot
+    }
+
+    const qint64 sequence = static_cast<qint64>(data["seq"].toDouble());
+    if (sequence != m_sequence + 1) {
+        qWarning() << "Console missed deltas" << m_sequence + 1 << "to" << sequence - 1 << ", resubscribing";
+        subscribe();
+        return;
+    }
+    m_sequence = sequence;
+
+    EventBus *bus = EventBus::instance();
+    for (const QJsonValue &value : data["lanes"].toArray()) {
+        const QJsonObject lane = value.toObject();
+        const int laneId = lane["lane_id"].toInt();
+        LaneView &view = m_lanes[laneId];
+
+        if (lane.contains("status")) {
+            view.status = lane["status"].toInt();
+            LaneStatusEvent event;
+            event.laneId = laneId;
+            event.status = view.status;
+            bus->publish(event);
+        }
+
+        // Removals first, a field dropped and set again in one delta ends up set
+        if (lane.contains("removed") || lane.contains("game")) {
+            for (const QJsonValue &key : lane["removed"].toArray()) {
+                view.game.remove(key.toString());
+            }
+            const QJsonObject changed = lane["game"].toObject();
+            for (auto it = changed.constBegin(); it != changed.constEnd(); ++it) {
+                view.game[it.key()] = it.value();
+            }
+
+            GameDataEvent event;
+            event.laneId = laneId;
+            event.gameData = view.game;
+            bus->publish(event);
+        }
+
+        if (lane.contains("completed")) {
+            GameCompletedEvent event;
+            event.laneId = laneId;
+            event.gameType = lane["completed"].toString();
+            event.data = view.game;
+            bus->publish(event);
+        }
+    }
+}
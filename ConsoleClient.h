@@ -0,0 +1,76 @@
+﻿// ConsoleClient.h
+#ifndef CONSOLECLIENT_H
+#define CONSOLECLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QMap>
+#include <QJsonObject>
+#include <QVector>
+#include <QTcpSocket>
+#include <QTimer>
+
+// Console side of ConsoleHub. Keeps every lane's state from the snapshot and
+// deltas and republishes it on the local EventBus as LaneStatusEvent,
+// GameDataEvent and GameCompletedEvent, so a window subscribed on the bus
+// behaves the same attached to a remote bowlingd as with an in-process
+// LaneServer. Reconnects on its own and resubscribes on a sequence gap.
+// Subscribes with the hub's shared key, BOWLING_CONSOLE_KEY unless set.
+class ConsoleClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConsoleClient(const QString &name, QObject *parent = nullptr);
+
+    void setSharedKey(const QString &key) { m_sharedKey = key; }
+    void connectToServer(const QString &host, quint16 port);
+    void disconnectFromServer();
+    bool isAttached() const { return m_sequence >= 0; }
+
+    // Same shape as LaneServer::onLaneCommand
+    bool sendCommand(const QJsonObject &command);
+
+    // End of Day on the server's lanes; answered by lanesShutdown()
+    bool requestLaneShutdown();
+
+    // Shown on the lanes bowling leagueId, or every lane; answered by announced()
+    bool announce(const QString &text, int leagueId = 0);
+
+signals:
+    void attached(int laneCount);
+    void detached();
+    void rejected(const QString &reason);
+    void notice(const QJsonObject &message);
+    void lanesShutdown(int laneCount, const QVector<int> &failedLanes);
+    void announced(int recipients);
+
+private slots:
+    void onConnected();
+    void onDisconnected();
+    void onReadyRead();
+
+private:
+    struct LaneView {
+        int status = -1;
+        QJsonObject game;
+    };
+
+    void send(const QString &type, const QJsonObject &data);
+    void subscribe();
+    void applySnapshot(const QJsonObject &data);
+    void applyDelta(const QJsonObject &data);
+
+    static constexpr int RECONNECT_INTERVAL = 3000;
+
+    QString m_name;
+    QString m_sharedKey;
+    QString m_host;
+    quint16 m_port;
+    QTcpSocket *m_socket;
+    QTimer *m_reconnectTimer;
+    qint64 m_sequence;                  // -1 until a snapshot has been applied
+    QMap<int, LaneView> m_lanes;
+};
+
+#endif // CONSOLECLIENT_H
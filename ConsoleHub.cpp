@@ -0,0 +1,381 @@
+﻿// ConsoleHub.cpp
+#include "ConsoleHub.h"
+#include "BusEvents.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QPointer>
+#include <QFutureWatcher>
+#include <QDebug>
+
+namespace {
+
+QByteArray encodeFrame(const QString &type, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+} // namespace
+
+ConsoleHub::ConsoleHub(LaneServer *laneServer, QObject *parent)
+    : QObject(parent)
+    , m_laneServer(laneServer)
+    , m_server(new QTcpServer(this))
+    , m_sharedKey(qEnvironmentVariable("BOWLING_CONSOLE_KEY"))
+    , m_flushScheduled(false)
+    , m_sequence(0)
+    , m_snapshotSequence(-1)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &ConsoleHub::onNewConnection);
+
+    EventBus *bus = EventBus::instance();
+    bus->subscribe<LaneStatusEvent>(this, BusFilter::any(), [this](const LaneStatusEvent &event) {
+        laneStatusChanged(event.laneId, event.status);
+    });
+    bus->subscribe<GameDataEvent>(this, BusFilter::any(), [this](const GameDataEvent &event) {
+        laneGameChanged(event.laneId, event.gameData);
+    });
+    bus->subscribe<GameCompletedEvent>(this, BusFilter::any(), [this](const GameCompletedEvent &event) {
+        laneGameCompleted(event.laneId, event.gameType);
+    });
+}
+
+ConsoleHub::~ConsoleHub()
+{
+    close();
+}
+
+bool ConsoleHub::listen(quint16 port)
+{
+    // Without a key only consoles on this machine can reach the lanes
+    const QHostAddress address = m_sharedKey.isEmpty() ? QHostAddress(QHostAddress::LocalHost)
+                                                       : QHostAddress(QHostAddress::Any);
+    if (m_server->listen(address, port)) {
+        qDebug() << "Console hub listening on" << address.toString() << "port" << port;
+        return true;
+    }
+    qWarning() << "Console hub failed to listen on port" << port << ":" << m_server->errorString();
+    return false;
+}
+
+void ConsoleHub::close()
+{
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+    for (auto it = m_consoles.begin(); it != m_consoles.end(); ++it) {
+        it.key()->disconnect(this);
+        it.key()->disconnectFromHost();
+        it.key()->deleteLater();
+    }
+    m_consoles.clear();
+}
+
+void ConsoleHub::notify(const QJsonObject &message)
+{
+    const QByteArray frame = encodeFrame("console_notice", message);
+    for (auto it = m_consoles.constBegin(); it != m_consoles.constEnd(); ++it) {
+        if (it.value().subscribed) {
+            it.key()->write(frame);
+        }
+    }
+}
+
+void ConsoleHub::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, this, &ConsoleHub::onConsoleDisconnected);
+        connect(socket, &QTcpSocket::readyRead, this, &ConsoleHub::onConsoleDataReady);
+        m_consoles.insert(socket, Console());
+        qDebug() << "Console connected from" << socket->peerAddress().toString();
+    }
+}
+
+void ConsoleHub::onConsoleDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    qDebug() << "Console" << m_consoles.value(socket).name << "disconnected";
+    m_consoles.remove(socket);
+    socket->deleteLater();
+}
+
+void ConsoleHub::onConsoleDataReady()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    while (socket->canReadLine()) {
+        QJsonParseError error;
+        QJsonDocument doc = QJsonDocument::fromJson(socket->readLine(), &error);
+        if (error.error != QJsonParseError::NoError) {
+            qWarning() << "Console JSON parse error:" << error.errorString();
+            continue;
+        }
+        if (doc.isObject()) {
+            processMessage(socket, doc.object());
+        }
+    }
+}
+
+void ConsoleHub::processMessage(QTcpSocket *socket, const QJsonObject &message)
+{
+    const QString type = message["type"].toString();
+    const QJsonObject data = message["data"].toObject();
+
+    if (type == "console_subscribe") {
+        if (!m_sharedKey.isEmpty() && data["key"].toString() != m_sharedKey) {
+            reject(socket, "bad_key");
+            return;
+        }
+        subscribe(socket, data["name"].toString());
+    } else if (type == "console_command" || type == "console_shutdown_lanes" || type == "console_announce") {
+        if (!m_consoles.value(socket).subscribed) {
+            qWarning() << "Ignoring" << type << "from unsubscribed console" << socket->peerAddress().toString();
+            return;
+        }
+        if (type == "console_command") {
+            m_laneServer->onLaneCommand(data);
+        } else if (type == "console_announce") {
+            announce(socket, data);
+        } else {
+            shutdownLanes(socket);
+        }
+    } else if (type == "heartbeat") {
+        QJsonObject response;
+        response["status"] = "ok";
+        response["seq"] = m_sequence;
+        socket->write(encodeFrame("heartbeat_response", response));
+    } else {
+        qWarning() << "Unknown console message type:" << type;
+    }
+}
+
+void ConsoleHub::subscribe(QTcpSocket *socket, const QString &name)
+{
+    // Flush first so the snapshot is exactly the state at m_sequence and the
+    // console picks up from the next delta
+    if (!m_pending.isEmpty()) {
+        flush();
+    }
+
+    Console &console = m_consoles[socket];
+    console.name = name.isEmpty() ? socket->peerAddress().toString() : name;
+    console.subscribed = true;
+
+    socket->write(snapshotFrame());
+    qDebug() << "Console" << console.name << "subscribed at seq" << m_sequence;
+}
+
+void ConsoleHub::reject(QTcpSocket *socket, const QString &reason)
+{
+    qWarning() << "Rejecting console from" << socket->peerAddress().toString() << ":" << reason;
+    QJsonObject data;
+    data["reason"] = reason;
+    socket->write(encodeFrame("console_rejected", data));
+    socket->disconnectFromHost();
+}
+
+void ConsoleHub::shutdownLanes(QTcpSocket *socket)
+{
+    // Same acked batch as the in-process End of Day; the result goes back to
+    // the console that asked, if it is still connected
+    const QVector<int> lanes = m_laneServer->connectedLanes();
+    QPointer<QTcpSocket> requester(socket);
+    auto reply = [requester](int laneCount, const QVector<int> &failedLanes) {
+        if (!requester) {
+            return;
+        }
+        QJsonArray failed;
+        for (int laneId : failedLanes) {
+            failed.append(laneId);
+        }
+        QJsonObject data;
+        data["lanes"] = laneCount;
+        data["failed"] = failed;
+        requester->write(encodeFrame("console_shutdown_result", data));
+    };
+
+    if (lanes.isEmpty()) {
+        reply(0, QVector<int>());
+        return;
+    }
+
+    auto *watcher = new QFutureWatcher<LaneBatchResult>(this);
+    connect(watcher, &QFutureWatcherBase::finished, this, [watcher, reply, lanes]() {
+        reply(lanes.size(), watcher->result().failed);
+        watcher->deleteLater();
+    });
+    watcher->setFuture(m_laneServer->shutdownLanes(lanes));
+    qDebug() << "Console" << m_consoles.value(socket).name << "shutting down" << lanes.size() << "lanes";
+}
+
+void ConsoleHub::announce(QTcpSocket *socket, const QJsonObject &data)
+{
+    const QString text = data["text"].toString().trimmed();
+    if (text.isEmpty()) {
+        qWarning() << "Ignoring empty announcement from console" << m_consoles.value(socket).name;
+        return;
+    }
+
+    LaneGroup group = LaneGroup::all();
+    if (data.contains("lane_ids")) {
+        QVector<int> laneIds;
+        for (const QJsonValue &value : data["lane_ids"].toArray()) {
+            laneIds.append(value.toInt());
+        }
+        group = LaneGroup::lanes(laneIds);
+    } else if (data["league_id"].toInt() > 0) {
+        group = LaneGroup::league(data["league_id"].toInt());
+    }
+
+    const BroadcastStats stats = m_laneServer->announce(group, text);
+    QJsonObject result;
+    result["recipients"] = stats.recipients;
+    socket->write(encodeFrame("console_announce_result", result));
+    qDebug() << "Console" << m_consoles.value(socket).name << "announced to" << stats.recipients << "lanes";
+}
+
+QByteArray ConsoleHub::snapshotFrame()
+{
+    // Consoles subscribing between two deltas share one serialisation
+    if (m_snapshotSequence == m_sequence) {
+        return m_snapshot;
+    }
+
+    QJsonArray lanes;
+    for (auto it = m_lanes.constBegin(); it != m_lanes.constEnd(); ++it) {
+        QJsonObject lane;
+        lane["lane_id"] = it.key();
+        lane["status"] = it.value().status;
+        lane["game"] = it.value().game;
+        lanes.append(lane);
+    }
+
+    QJsonObject data;
+    data["seq"] = m_sequence;
+    data["lanes"] = lanes;
+    m_snapshot = encodeFrame("console_snapshot", data);
+    m_snapshotSequence = m_sequence;
+    return m_snapshot;
+}
+
+void ConsoleHub::laneStatusChanged(int laneId, int status)
+{
+    LaneView &view = m_lanes[laneId];
+    if (view.status == status) {
+        return;
+    }
+    view.status = status;
+    m_pending[laneId]["status"] = status;
+    scheduleFlush();
+}
+
+void ConsoleHub::laneGameChanged(int laneId, const QJsonObject &game)
+{
+    LaneView &view = m_lanes[laneId];
+    QJsonObject &entry = m_pending[laneId];
+    QJsonObject changed = entry["game"].toObject();
+    QJsonArray removed = entry["removed"].toArray();
+
+    for (auto it = game.constBegin(); it != game.constEnd(); ++it) {
+        if (view.game.value(it.key()) != it.value()) {
+            changed[it.key()] = it.value();
+        }
+    }
+    for (auto it = view.game.constBegin(); it != view.game.constEnd(); ++it) {
+        if (!game.contains(it.key())) {
+            changed.remove(it.key());
+            removed.append(it.key());
+        }
+    }
+    view.game = game;
+
+    if (!changed.isEmpty()) {
+        entry["game"] = changed;
+    }
+    if (!removed.isEmpty()) {
+        entry["removed"] = removed;
+    }
+    if (entry.isEmpty()) {
+        m_pending.remove(laneId);
+        return;
+    }
+    scheduleFlush();
+}
+
+void ConsoleHub::laneGameCompleted(int laneId, const QString &gameType)
+{
+    m_pending[laneId]["completed"] = gameType;
+    scheduleFlush();
+}
+
+void ConsoleHub::scheduleFlush()
+{
+    if (m_flushScheduled) {
+        return;
+    }
+    m_flushScheduled = true;
+
+    // Everything the bus delivers this tick goes out as one delta
+    QTimer::singleShot(0, this, [this]() {
+        flush();
+    });
+}
+
+void ConsoleHub::flush()
+{
+    m_flushScheduled = false;
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QJsonArray lanes;
+    for (auto it = m_pending.constBegin(); it != m_pending.constEnd(); ++it) {
+        QJsonObject lane = it.value();
+        lane["lane_id"] = it.key();
+        lanes.append(lane);
+    }
+    m_pending.clear();
+    m_sequence++;
+
+    BroadcastStats stats;
+    QElapsedTimer timer;
+    timer.start();
+    QJsonObject data;
+    data["seq"] = m_sequence;
+    data["lanes"] = lanes;
+    const QByteArray frame = encodeFrame("console_delta", data);
+    stats.serializeNs = timer.nsecsElapsed();
+    stats.frameBytes = frame.size();
+
+    timer.restart();
+    QVector<QTcpSocket *> stalled;
+    for (auto it = m_consoles.constBegin(); it != m_consoles.constEnd(); ++it) {
+        if (!it.value().subscribed) {
+            continue;
+        }
+        QTcpSocket *socket = it.key();
+        if (socket->bytesToWrite() > MAX_BACKLOG_BYTES) {
+            stalled.append(socket);
+            continue;
+        }
+        socket->write(frame);
+        stats.recipients++;
+    }
+    stats.writeNs = timer.nsecsElapsed();
+    m_lastDelta = stats;
+
+    // It reconnects and resubscribes for a snapshot
+    for (QTcpSocket *socket : stalled) {
+        qWarning() << "Dropping console" << m_consoles.value(socket).name << "with"
+                   << socket->bytesToWrite() << "bytes unsent";
+        socket->abort();
+    }
+}
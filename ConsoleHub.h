@@ -0,0 +1,104 @@
+﻿// ConsoleHub.h
+#ifndef CONSOLEHUB_H
+#define CONSOLEHUB_H
+
+#include <QObject>
+#include <QString>
+#include <QMap>
+#include <QHash>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "LaneServer.h"
+
+// Serves front-desk, office and bar consoles. Messages are newline-delimited
+// JSON {"type", "data"} like the lane protocol, on their own port.
+//
+//   console -> hub   console_subscribe      {name, key}
+//                    console_command        {lane_id, command | type, ...} as LaneServer::onLaneCommand
+//                    console_shutdown_lanes End of Day: every connected lane, with acks
+//                    console_announce       {text, league_id? | lane_ids?} shown on those lanes, else all
+//                    heartbeat
+//   hub -> console   console_snapshot       {seq, lanes: [{lane_id, status, game}]}
+//                    console_delta          {seq, lanes: [{lane_id, status?, game?, removed?, completed?}]}
+//                    console_notice         league notifications, outside the sequence
+//                    console_shutdown_result {lanes, failed: [lane_id]}
+//                    console_announce_result {recipients}
+//                    console_rejected       {reason}, then the hub hangs up
+//                    heartbeat_response
+//
+// Consoles can drive the lanes, so the hub only listens on loopback unless
+// a shared key is set (BOWLING_CONSOLE_KEY, or setSharedKey() before
+// listen()); then it listens on every interface and a console_subscribe
+// without the key is rejected. Nothing but heartbeats is accepted before a
+// console has subscribed.
+//
+// A delta carries, per lane, only the status if it changed and the top-level
+// game fields that changed or were removed since the previous delta. Lane
+// traffic arriving in one event-loop tick becomes one delta, serialised once
+// and handed to every console as the same buffer. A console that sees a gap
+// in seq resubscribes and gets a fresh snapshot; one that stops reading is
+// dropped instead of buffering without bound.
+class ConsoleHub : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit ConsoleHub(LaneServer *laneServer, QObject *parent = nullptr);
+    ~ConsoleHub();
+
+    void setSharedKey(const QString &key) { m_sharedKey = key; }
+    bool listen(quint16 port);
+    void close();
+
+    // Serialised once and written to every subscribed console
+    void notify(const QJsonObject &message);
+
+    int consoleCount() const { return m_consoles.size(); }
+    qint64 sequence() const { return m_sequence; }
+    BroadcastStats lastDeltaStats() const { return m_lastDelta; }
+
+private slots:
+    void onNewConnection();
+    void onConsoleDisconnected();
+    void onConsoleDataReady();
+
+private:
+    struct LaneView {
+        int status = static_cast<int>(LaneStatus::Unknown);
+        QJsonObject game;
+    };
+
+    struct Console {
+        QString name;
+        bool subscribed = false;        // Only once the key has been checked
+    };
+
+    void processMessage(QTcpSocket *socket, const QJsonObject &message);
+    void subscribe(QTcpSocket *socket, const QString &name);
+    void reject(QTcpSocket *socket, const QString &reason);
+    void shutdownLanes(QTcpSocket *socket);
+    void announce(QTcpSocket *socket, const QJsonObject &data);
+    void laneStatusChanged(int laneId, int status);
+    void laneGameChanged(int laneId, const QJsonObject &game);
+    void laneGameCompleted(int laneId, const QString &gameType);
+    void scheduleFlush();
+    void flush();
+    QByteArray snapshotFrame();
+
+    static constexpr qint64 MAX_BACKLOG_BYTES = 4 * 1024 * 1024;
+
+    LaneServer *m_laneServer;
+    QTcpServer *m_server;
+    QString m_sharedKey;
+    QHash<QTcpSocket *, Console> m_consoles;
+    QMap<int, LaneView> m_lanes;        // State as of m_sequence plus anything pending
+    QMap<int, QJsonObject> m_pending;   // laneId -> delta entry for the next flush
+    bool m_flushScheduled;
+    qint64 m_sequence;
+    QByteArray m_snapshot;              // Cached for m_snapshotSequence
+    qint64 m_snapshotSequence;
+    BroadcastStats m_lastDelta;
+};
+
+#endif // CONSOLEHUB_H
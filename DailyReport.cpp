@@ -0,0 +1,358 @@
+﻿// DailyReport.cpp
+#include "DailyReport.h"
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSettings>
+#include <QVector>
+#include <QPair>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const QString DB_DATETIME_FORMAT = "yyyy-MM-dd hh:mm:ss";
+
+QString dayStart(const QDate &date)
+{
+    return QDateTime(date, QTime(0, 0)).toString(DB_DATETIME_FORMAT);
+}
+
+QString csvField(const QString &value)
+{
+    if (value.contains(',') || value.contains('"') || value.contains('\n')) {
+        return '"' + QString(value).replace("\"", "\"\"") + '"';
+    }
+    return value;
+}
+
+QString money(double amount)
+{
+    return QString("$%1").arg(amount, 0, 'f', 2);
+}
+
+// Both read one day of games through the created_at index
+const QString DAY_FINGERPRINT_SQL = QueryPlanAudit::statement("DailyReportEngine::fingerprint",
+    "SELECT COUNT(*), MAX(id) FROM games WHERE created_at >= ? AND created_at < ?");
+const QString DAY_GAMES_SQL = QueryPlanAudit::statement("DailyReportEngine::aggregate",
+    "SELECT lane_id, game_type, bowler_id, bowler_name, score, started_at, created_at "
+    "FROM games WHERE created_at >= ? AND created_at < ?");
+
+} // namespace
+
+// RateCard
+
+RateCard RateCard::load()
+{
+    RateCard rates;
+    QSettings settings;
+    settings.beginGroup("rates");
+    rates.defaultPricePerGame = settings.value("default_game", rates.defaultPricePerGame).toDouble();
+    rates.shoeRental = settings.value("shoe_rental", rates.shoeRental).toDouble();
+
+    settings.beginGroup("game_types");
+    for (const QString &gameType : settings.childKeys()) {
+        rates.pricePerGame[gameType] = settings.value(gameType).toDouble();
+    }
+    settings.endGroup();
+
+    settings.endGroup();
+    return rates;
+}
+
+void RateCard::save() const
+{
+    QSettings settings;
+    settings.beginGroup("rates");
+    settings.setValue("default_game", defaultPricePerGame);
+    settings.setValue("shoe_rental", shoeRental);
+
+    settings.remove("game_types");
+    settings.beginGroup("game_types");
+    for (auto it = pricePerGame.constBegin(); it != pricePerGame.constEnd(); ++it) {
+        settings.setValue(it.key(), it.value());
+    }
+    settings.endGroup();
+
+    settings.endGroup();
+}
+
+// DailyReportEngine
+
+DailyReportData DailyReportEngine::report(const QSqlDatabase &database, const QDate &date, const RateCard &rates)
+{
+    int gameCount = 0;
+    qint64 lastGameId = 0;
+    bool probed = fingerprint(database, date, &gameCount, &lastGameId);
+
+    auto it = m_cache.find(date);
+    if (!probed || it == m_cache.end() || it->gameCount != gameCount || it->lastGameId != lastGameId) {
+        CachedReport cached;
+        cached.data = aggregate(database, date);
+        cached.gameCount = gameCount;
+        cached.lastGameId = lastGameId;
+        it = m_cache.insert(date, cached);
+    }
+
+    // Rates can change between calls, so revenue is applied to the cached counts
+    DailyReportData result = it->data;
+    applyRates(result, rates);
+    return result;
+}
+
+void DailyReportEngine::invalidate(const QDate &date)
+{
+    m_cache.remove(date);
+}
+
+void DailyReportEngine::clear()
+{
+    m_cache.clear();
+}
+
+bool DailyReportEngine::fingerprint(const QSqlDatabase &database, const QDate &date,
+                                    int *gameCount, qint64 *lastGameId)
+{
+    QSqlQuery query(database);
+    query.prepare(DAY_FINGERPRINT_SQL);
+    query.addBindValue(dayStart(date));
+    query.addBindValue(dayStart(date.addDays(1)));
+
+    if (!query.exec() || !query.next()) {
+        qWarning() << "Failed to check daily report cache:" << query.lastError().text();
+        return false;
+    }
+
+    *gameCount = query.value(0).toInt();
+    *lastGameId = query.value(1).toLongLong();
+    return true;
+}
+
+DailyReportData DailyReportEngine::aggregate(const QSqlDatabase &database, const QDate &date)
+{
+    DailyReportData report;
+    report.date = date;
+    report.generatedAt = QDateTime::currentDateTime();
+
+    // created_at is indexed, so this reads only the day's rows however much history there is
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+    query.prepare(DAY_GAMES_SQL);
+    query.addBindValue(dayStart(date));
+    query.addBindValue(dayStart(date.addDays(1)));
+
+    if (!query.exec()) {
+        qWarning() << "Failed to load games for daily report:" << query.lastError().text();
+        return report;
+    }
+
+    struct BowlerDay {
+        QString name;
+        int total = 0;
+    };
+    QHash<QString, BowlerDay> bowlers;
+    QMap<int, QVector<QPair<QDateTime, QDateTime>>> laneIntervals;
+    qint64 totalPins = 0;
+
+    while (query.next()) {
+        const int laneId = query.value(0).toInt();
+        const QString gameType = query.value(1).toString();
+        const int bowlerId = query.value(2).toInt();
+        const QString bowlerName = query.value(3).toString();
+        const int score = query.value(4).toInt();
+
+        report.totalGames++;
+        report.gamesByType[gameType]++;
+        totalPins += score;
+
+        LaneDayStats &lane = report.lanes[laneId];
+        lane.games++;
+        lane.pins += score;
+
+        if (score > report.highGame) {
+            report.highGame = score;
+            report.highGameBowler = bowlerName;
+        }
+
+        // Walk-in bowlers have no id, so fall back to the name they bowled under
+        QString key = bowlerId > 0 ? QString::number(bowlerId) : QString("%1:%2").arg(laneId).arg(bowlerName.toLower());
+        BowlerDay &bowler = bowlers[key];
+        bowler.name = bowlerName;
+        bowler.total += score;
+
+        QDateTime started = QDateTime::fromString(query.value(5).toString(), DB_DATETIME_FORMAT);
+        QDateTime ended = QDateTime::fromString(query.value(6).toString(), DB_DATETIME_FORMAT);
+        if (started.isValid() && ended > started) {
+            laneIntervals[laneId].append(qMakePair(started, ended));
+        }
+    }
+
+    report.totalBowlers = bowlers.size();
+    if (report.totalGames > 0) {
+        report.averageScore = static_cast<double>(totalPins) / report.totalGames;
+    }
+
+    for (const BowlerDay &bowler : bowlers) {
+        if (bowler.total > report.highSeries) {
+            report.highSeries = bowler.total;
+            report.highSeriesBowler = bowler.name;
+        }
+    }
+
+    // Every bowler in a game has a row, so merge overlapping times before summing
+    for (auto it = laneIntervals.begin(); it != laneIntervals.end(); ++it) {
+        QVector<QPair<QDateTime, QDateTime>> &intervals = it.value();
+        std::sort(intervals.begin(), intervals.end());
+
+        qint64 seconds = 0;
+        QDateTime runStart = intervals.first().first;
+        QDateTime runEnd = intervals.first().second;
+        for (const auto &interval : intervals) {
+            if (interval.first > runEnd) {
+                seconds += runStart.secsTo(runEnd);
+                runStart = interval.first;
+            }
+            runEnd = qMax(runEnd, interval.second);
+        }
+        seconds += runStart.secsTo(runEnd);
+
+        report.lanes[it.key()].minutesInUse = static_cast<int>(seconds / 60);
+    }
+
+    return report;
+}
+
+void DailyReportEngine::applyRates(DailyReportData &report, const RateCard &rates)
+{
+    report.revenueByType.clear();
+    report.totalRevenue = 0.0;
+
+    for (auto it = report.gamesByType.constBegin(); it != report.gamesByType.constEnd(); ++it) {
+        double revenue = it.value() * rates.priceFor(it.key());
+        report.revenueByType[it.key()] = revenue;
+        report.totalRevenue += revenue;
+    }
+
+    report.shoeRevenue = report.totalBowlers * rates.shoeRental;
+    report.totalRevenue += report.shoeRevenue;
+}
+
+QString DailyReportEngine::toText(const DailyReportData &report)
+{
+    QString text;
+
+    text += "=====================================\n";
+    text += "       CENTRE BOWLING DAILY REPORT\n";
+    text += "=====================================\n";
+    text += QString("Date: %1\n").arg(report.date.toString("dddd, MMMM dd, yyyy"));
+    text += QString("Time: %1\n\n").arg(report.generatedAt.toString("hh:mm:ss"));
+
+    text += "GAME STATISTICS:\n";
+    text += "-------------------------------------\n";
+    text += QString("Total Games Played: %1\n").arg(report.totalGames);
+    for (auto it = report.gamesByType.constBegin(); it != report.gamesByType.constEnd(); ++it) {
+        text += QString("  - %1: %2\n").arg(it.key()).arg(it.value());
+    }
+    text += QString("Total Bowlers: %1\n").arg(report.totalBowlers);
+    text += QString("Average Score: %1\n").arg(report.averageScore, 0, 'f', 1);
+    text += QString("High Game: %1 (%2)\n").arg(report.highGame).arg(report.highGameBowler);
+    text += QString("High Series: %1 (%2)\n\n").arg(report.highSeries).arg(report.highSeriesBowler);
+
+    text += "LANE UTILIZATION:\n";
+    text += "-------------------------------------\n";
+    if (report.lanes.isEmpty()) {
+        text += "No games recorded\n";
+    }
+    for (auto it = report.lanes.constBegin(); it != report.lanes.constEnd(); ++it) {
+        text += QString("Lane %1: %2 games, %3h %4m in use\n")
+                .arg(it.key())
+                .arg(it.value().games)
+                .arg(it.value().minutesInUse / 60)
+                .arg(it.value().minutesInUse % 60, 2, 10, QChar('0'));
+    }
+    text += "\n";
+
+    text += "REVENUE SUMMARY:\n";
+    text += "-------------------------------------\n";
+    for (auto it = report.revenueByType.constBegin(); it != report.revenueByType.constEnd(); ++it) {
+        text += QString("%1: %2\n").arg(it.key(), money(it.value()));
+    }
+    text += QString("Shoe Rentals: %1\n").arg(money(report.shoeRevenue));
+    text += QString("Total Revenue: %1\n\n").arg(money(report.totalRevenue));
+
+    text += "=====================================\n";
+    text += "Report generated at: " + report.generatedAt.toString("hh:mm:ss") + "\n";
+
+    return text;
+}
+
+QString DailyReportEngine::toCsv(const DailyReportData &report)
+{
+    QStringList lines;
+
+    lines << "Metric,Value";
+    lines << QString("Date,%1").arg(report.date.toString(Qt::ISODate));
+    lines << QString("Total games,%1").arg(report.totalGames);
+    lines << QString("Total bowlers,%1").arg(report.totalBowlers);
+    lines << QString("Average score,%1").arg(report.averageScore, 0, 'f', 1);
+    lines << QString("High game,%1,%2").arg(report.highGame).arg(csvField(report.highGameBowler));
+    lines << QString("High series,%1,%2").arg(report.highSeries).arg(csvField(report.highSeriesBowler));
+    lines << QString("Shoe rentals,%1").arg(report.shoeRevenue, 0, 'f', 2);
+    lines << QString("Total revenue,%1").arg(report.totalRevenue, 0, 'f', 2);
+    lines << "";
+
+    lines << "Game type,Games,Revenue";
+    for (auto it = report.gamesByType.constBegin(); it != report.gamesByType.constEnd(); ++it) {
+        lines << QString("%1,%2,%3").arg(csvField(it.key())).arg(it.value())
+                 .arg(report.revenueByType.value(it.key()), 0, 'f', 2);
+    }
+    lines << "";
+
+    lines << "Lane,Games,Pins,Minutes in use";
+    for (auto it = report.lanes.constBegin(); it != report.lanes.constEnd(); ++it) {
+        lines << QString("%1,%2,%3,%4").arg(it.key()).arg(it.value().games)
+                 .arg(it.value().pins).arg(it.value().minutesInUse);
+    }
+
+    return lines.join("\n") + "\n";
+}
+
+QString DailyReportEngine::toHtml(const DailyReportData &report)
+{
+    QString html;
+    html += QString("<h2>Centre Bowling Daily Report</h2><p>%1</p>")
+            .arg(report.date.toString("dddd, MMMM dd, yyyy"));
+
+    html += "<h3>Games</h3><table border='1' cellpadding='4' cellspacing='0'>";
+    html += QString("<tr><td>Total games</td><td>%1</td></tr>").arg(report.totalGames);
+    for (auto it = report.gamesByType.constBegin(); it != report.gamesByType.constEnd(); ++it) {
+        html += QString("<tr><td>%1</td><td>%2</td></tr>").arg(it.key().toHtmlEscaped()).arg(it.value());
+    }
+    html += QString("<tr><td>Total bowlers</td><td>%1</td></tr>").arg(report.totalBowlers);
+    html += QString("<tr><td>Average score</td><td>%1</td></tr>").arg(report.averageScore, 0, 'f', 1);
+    html += QString("<tr><td>High game</td><td>%1 (%2)</td></tr>")
+            .arg(report.highGame).arg(report.highGameBowler.toHtmlEscaped());
+    html += QString("<tr><td>High series</td><td>%1 (%2)</td></tr>")
+            .arg(report.highSeries).arg(report.highSeriesBowler.toHtmlEscaped());
+    html += "</table>";
+
+    html += "<h3>Lane Utilization</h3><table border='1' cellpadding='4' cellspacing='0'>";
+    html += "<tr><th>Lane</th><th>Games</th><th>Pins</th><th>Minutes in use</th></tr>";
+    for (auto it = report.lanes.constBegin(); it != report.lanes.constEnd(); ++it) {
+        html += QString("<tr><td>%1</td><td>%2</td><td>%3</td><td>%4</td></tr>")
+                .arg(it.key()).arg(it.value().games).arg(it.value().pins).arg(it.value().minutesInUse);
+    }
+    html += "</table>";
+
+    html += "<h3>Revenue</h3><table border='1' cellpadding='4' cellspacing='0'>";
+    for (auto it = report.revenueByType.constBegin(); it != report.revenueByType.constEnd(); ++it) {
+        html += QString("<tr><td>%1</td><td>%2</td></tr>").arg(it.key().toHtmlEscaped(), money(it.value()));
+    }
+    html += QString("<tr><td>Shoe rentals</td><td>%1</td></tr>").arg(money(report.shoeRevenue));
+    html += QString("<tr><td><b>Total</b></td><td><b>%1</b></td></tr>").arg(money(report.totalRevenue));
+    html += "</table>";
+
+    html += QString("<p>Generated %1</p>").arg(report.generatedAt.toString("yyyy-MM-dd hh:mm:ss"));
+
+    return html;
+}
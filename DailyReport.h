@@ -0,0 +1,81 @@
+﻿// DailyReport.h
+#ifndef DAILYREPORT_H
+#define DAILYREPORT_H
+
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QHash>
+#include <QDate>
+#include <QDateTime>
+#include <QSqlDatabase>
+
+// Prices used to turn game counts into revenue; stored under "rates/" in QSettings
+struct RateCard {
+    QMap<QString, double> pricePerGame;     // game_type -> price
+    double defaultPricePerGame = 15.0;
+    double shoeRental = 4.0;                // Charged once per bowler per day
+
+    double priceFor(const QString &gameType) const { return pricePerGame.value(gameType, defaultPricePerGame); }
+
+    static RateCard load();
+    void save() const;
+};
+
+struct LaneDayStats {
+    int games = 0;
+    int pins = 0;
+    int minutesInUse = 0;   // Union of game start/end times on the lane
+};
+
+struct DailyReportData {
+    QDate date;
+    int totalGames = 0;
+    QMap<QString, int> gamesByType;
+    int totalBowlers = 0;
+    double averageScore = 0.0;
+    int highGame = 0;
+    QString highGameBowler;
+    int highSeries = 0;                     // Best total of one bowler's games that day
+    QString highSeriesBowler;
+    QMap<int, LaneDayStats> lanes;
+
+    // Filled from the rate card
+    QMap<QString, double> revenueByType;
+    double shoeRevenue = 0.0;
+    double totalRevenue = 0.0;
+
+    QDateTime generatedAt;
+};
+
+// Builds a DailyReportData from the games table with one indexed range scan
+// and aggregates it in memory. Results are cached per date and revalidated
+// with a COUNT/MAX(id) probe over the same range, so reopening the report at
+// closing time only recomputes when games were added since.
+class DailyReportEngine
+{
+public:
+    DailyReportData report(const QSqlDatabase &database, const QDate &date, const RateCard &rates);
+    void invalidate(const QDate &date);
+    void clear();
+
+    static QString toText(const DailyReportData &report);
+    static QString toCsv(const DailyReportData &report);
+    static QString toHtml(const DailyReportData &report);
+    static bool toPdf(const DailyReportData &report, const QString &filePath); // DailyReportPdf.cpp, GUI only
+
+private:
+    struct CachedReport {
+        DailyReportData data;
+        int gameCount = 0;
+        qint64 lastGameId = 0;
+    };
+
+    static bool fingerprint(const QSqlDatabase &database, const QDate &date, int *gameCount, qint64 *lastGameId);
+    static DailyReportData aggregate(const QSqlDatabase &database, const QDate &date);
+    static void applyRates(DailyReportData &report, const RateCard &rates);
+
+    QHash<QDate, CachedReport> m_cache;
+};
+
+#endif // DAILYREPORT_H
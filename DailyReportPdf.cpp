@@ -0,0 +1,23 @@
+﻿// DailyReportPdf.cpp
+// PDF export needs QtGui, so it is built into the GUI only and bowling_core
+// keeps to Core/Network/Sql.
+#include "DailyReport.h"
+#include <QTextDocument>
+#include <QPdfWriter>
+#include <QPageSize>
+#include <QFileInfo>
+
+bool DailyReportEngine::toPdf(const DailyReportData &report, const QString &filePath)
+{
+    {
+        QPdfWriter writer(filePath);
+        writer.setPageSize(QPageSize(QPageSize::A4));
+        writer.setTitle(QString("Daily Report %1").arg(report.date.toString(Qt::ISODate)));
+
+        QTextDocument document;
+        document.setHtml(toHtml(report));
+        document.print(&writer);
+    }
+
+    return QFileInfo(filePath).size() > 0;
+}
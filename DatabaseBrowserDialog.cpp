@@ -4,6 +4,7 @@
 DatabaseBrowserDialog::DatabaseBrowserDialog(QWidget *parent)
     : QDialog(parent)
     , m_dbManager(DatabaseManager::instance())
+    , m_resultModel(new QueryResultModel(getDatabasePath(), this))
 {
     setupUI();
     setWindowTitle("Database Browser & Inspector");
@@ -82,19 +83,35 @@ void DatabaseBrowserDialog::setupUI()
     m_queryEdit->setPlaceholderText("Enter SQL query (e.g., SELECT * FROM bowlers LIMIT 10)");
     m_rightLayout->addWidget(m_queryEdit);
     
+    QHBoxLayout *queryButtonsLayout = new QHBoxLayout;
     m_executeBtn = new QPushButton("Execute Query");
     m_executeBtn->setStyleSheet("QPushButton { padding: 8px 16px; background-color: #007bff; color: white; }");
     connect(m_executeBtn, &QPushButton::clicked, this, &DatabaseBrowserDialog::onExecuteQueryClicked);
-    m_rightLayout->addWidget(m_executeBtn);
+    queryButtonsLayout->addWidget(m_executeBtn, 1);
+    
+    m_cancelQueryBtn = new QPushButton("Cancel");
+    m_cancelQueryBtn->setStyleSheet("QPushButton { padding: 8px 16px; }");
+    m_cancelQueryBtn->setEnabled(false);
+    connect(m_cancelQueryBtn, &QPushButton::clicked, this, &DatabaseBrowserDialog::onCancelQueryClicked);
+    queryButtonsLayout->addWidget(m_cancelQueryBtn);
+    m_rightLayout->addLayout(queryButtonsLayout);
     
     QLabel *resultsHeader = new QLabel("RESULTS");
     resultsHeader->setStyleSheet("QLabel { font-weight: bold; font-size: 14px; margin: 20px 0 10px 0; }");
     m_rightLayout->addWidget(resultsHeader);
     
-    m_dataTable = new QTableWidget;
-    m_dataTable->setAlternatingRowColors(true);
-    m_dataTable->setSelectionBehavior(QAbstractItemView::SelectRows);
-    m_rightLayout->addWidget(m_dataTable);
+    // Rows arrive a page at a time from a worker connection as the view scrolls
+    m_dataView = new QTableView;
+    m_dataView->setModel(m_resultModel);
+    m_dataView->setAlternatingRowColors(true);
+    m_dataView->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_rightLayout->addWidget(m_dataView);
+    
+    connect(m_resultModel, &QueryResultModel::columnsLoaded, this, &DatabaseBrowserDialog::onQueryColumnsLoaded);
+    connect(m_resultModel, &QueryResultModel::pageLoaded, this, &DatabaseBrowserDialog::onQueryPageLoaded);
+    connect(m_resultModel, &QueryResultModel::statementFinished, this, &DatabaseBrowserDialog::onStatementFinished);
+    connect(m_resultModel, &QueryResultModel::queryFailed, this, &DatabaseBrowserDialog::onQueryFailed);
+    connect(m_resultModel, &QueryResultModel::runningChanged, m_cancelQueryBtn, &QPushButton::setEnabled);
     
     m_recordCountLabel = new QLabel("No data loaded");
     m_rightLayout->addWidget(m_recordCountLabel);
@@ -142,24 +159,50 @@ void DatabaseBrowserDialog::loadTables()
         return;
     }
     
+    QStringList tableNames;
     while (query.next()) {
-        QString tableName = query.value(0).toString();
-        
-        QSqlQuery countQuery(QString("SELECT COUNT(*) FROM %1").arg(tableName));
-        int recordCount = 0;
-        if (countQuery.exec() && countQuery.next()) {
-            recordCount = countQuery.value(0).toInt();
-        }
-        
+        tableNames.append(query.value(0).toString());
+    }
+    
+    QMap<QString, qint64> recordCounts = approximateRowCounts(tableNames);
+    
+    for (const QString &tableName : tableNames) {
         QTreeWidgetItem *item = new QTreeWidgetItem(m_tablesTree);
         item->setText(0, tableName);
-        item->setText(1, QString::number(recordCount));
+        item->setText(1, recordCounts.contains(tableName) ? QString("~%1").arg(recordCounts[tableName]) : "?");
         item->setData(0, Qt::UserRole, tableName);
     }
     
     m_tablesTree->resizeColumnToContents(0);
 }
 
+QMap<QString, qint64> DatabaseBrowserDialog::approximateRowCounts(const QStringList &tables)
+{
+    // COUNT(*) walks every page of a table; these read one index entry instead
+    QMap<QString, qint64> counts;
+    QSqlQuery query;
+    
+    // Row estimates recorded by ANALYZE, when it has been run
+    if (tables.contains("sqlite_stat1") && query.exec("SELECT tbl, stat FROM sqlite_stat1")) {
+        while (query.next()) {
+            qint64 rows = query.value(1).toString().section(' ', 0, 0).toLongLong();
+            counts[query.value(0).toString()] = qMax(counts.value(query.value(0).toString()), rows);
+        }
+    }
+    
+    // Otherwise the highest rowid, which overstates tables that have had deletes
+    for (const QString &table : tables) {
+        if (counts.contains(table)) {
+            continue;
+        }
+        if (query.exec(QString("SELECT MAX(rowid) FROM \"%1\"").arg(table)) && query.next()) {
+            counts[table] = query.value(0).toLongLong();
+        }
+    }
+    
+    return counts;
+}
+
 void DatabaseBrowserDialog::onTableSelected()
 {
     QTreeWidgetItem *item = m_tablesTree->currentItem();
@@ -169,62 +212,56 @@ void DatabaseBrowserDialog::onTableSelected()
     m_currentTable = tableName;
     
     loadTableData(tableName);
-    m_queryEdit->setText(QString("SELECT * FROM %1 LIMIT 100").arg(tableName));
+    m_queryEdit->setText(QString("SELECT * FROM %1").arg(tableName));
 }
 
 void DatabaseBrowserDialog::loadTableData(const QString &tableName)
 {
-    showQueryResult(QString("SELECT * FROM %1 LIMIT 100").arg(tableName));
+    m_recordCountLabel->setText(QString("Loading %1...").arg(tableName));
+    m_resultModel->browseTable(tableName);
 }
 
 void DatabaseBrowserDialog::showQueryResult(const QString &queryText)
 {
-    QSqlQuery query(queryText);
-    
-    if (!query.exec()) {
-        QMessageBox::critical(this, "Query Error", 
-                            QString("Query failed: %1").arg(query.lastError().text()));
-        return;
-    }
-    
-    m_dataTable->clear();
-    m_dataTable->setRowCount(0);
-    m_dataTable->setColumnCount(0);
-    
-    QSqlRecord record = query.record();
-    int columnCount = record.count();
-    
-    if (columnCount == 0) {
+    m_recordCountLabel->setText("Running query...");
+    m_resultModel->setQuery(queryText);
+}
+
+void DatabaseBrowserDialog::onQueryColumnsLoaded()
+{
+    m_dataView->resizeColumnsToContents();
+}
+
+void DatabaseBrowserDialog::onQueryPageLoaded(int totalRows, bool complete, qint64 elapsedMs)
+{
+    // A part-read query keeps its cursor, and a read lock, until cancelled
+    m_cancelQueryBtn->setEnabled(!complete);
+    if (m_resultModel->columnCount() == 0) {
         m_recordCountLabel->setText("Query executed successfully (no results)");
-        return;
-    }
-    
-    m_dataTable->setColumnCount(columnCount);
-    QStringList headers;
-    for (int i = 0; i < columnCount; ++i) {
-        headers << record.fieldName(i);
-    }
-    m_dataTable->setHorizontalHeaderLabels(headers);
-    
-    int row = 0;
-    while (query.next()) {
-        m_dataTable->insertRow(row);
-        
-        for (int col = 0; col < columnCount; ++col) {
-            QVariant value = query.value(col);
-            QString displayValue = value.isNull() ? "[NULL]" : value.toString();
-            
-            QTableWidgetItem *item = new QTableWidgetItem(displayValue);
-            if (value.isNull()) {
-                item->setForeground(QColor("#999"));
-            }
-            m_dataTable->setItem(row, col, item);
-        }
-        row++;
+    } else if (complete) {
+        m_recordCountLabel->setText(QString("Showing all %1 records (%2 ms)").arg(totalRows).arg(elapsedMs));
+    } else {
+        m_recordCountLabel->setText(QString("Showing %1 records, scroll for more (%2 ms)").arg(totalRows).arg(elapsedMs));
     }
-    
-    m_dataTable->resizeColumnsToContents();
-    m_recordCountLabel->setText(QString("Showing %1 records").arg(row));
+}
+
+void DatabaseBrowserDialog::onStatementFinished(int rowsAffected, qint64 elapsedMs)
+{
+    m_recordCountLabel->setText(QString("Query executed successfully (%1 rows affected, %2 ms)")
+                                .arg(qMax(0, rowsAffected)).arg(elapsedMs));
+}
+
+void DatabaseBrowserDialog::onQueryFailed(const QString &error)
+{
+    m_recordCountLabel->setText("Query failed");
+    QMessageBox::critical(this, "Query Error", QString("Query failed: %1").arg(error));
+}
+
+void DatabaseBrowserDialog::onCancelQueryClicked()
+{
+    m_resultModel->cancel();
+    m_cancelQueryBtn->setEnabled(false);
+    m_recordCountLabel->setText(QString("Cancelled after %1 records").arg(m_resultModel->rowCount()));
 }
 
 void DatabaseBrowserDialog::onRefreshClicked()
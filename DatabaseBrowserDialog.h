@@ -7,7 +7,7 @@
 #include <QHBoxLayout>
 #include <QSplitter>
 #include <QTreeWidget>
-#include <QTableWidget>
+#include <QTableView>
 #include <QTextEdit>
 #include <QPushButton>
 #include <QLabel>
@@ -24,7 +24,9 @@
 #include <QFileInfo>
 #include <QDesktopServices>
 #include <QUrl>
+#include <QMap>
 #include "DatabaseManager.h"
+#include "QueryResultModel.h"
 
 class DatabaseBrowserDialog : public QDialog
 {
@@ -37,6 +39,11 @@ private slots:
     void onTableSelected();
     void onRefreshClicked();
     void onExecuteQueryClicked();
+    void onCancelQueryClicked();
+    void onQueryColumnsLoaded();
+    void onQueryPageLoaded(int totalRows, bool complete, qint64 elapsedMs);
+    void onStatementFinished(int rowsAffected, qint64 elapsedMs);
+    void onQueryFailed(const QString &error);
     void onCopyPathClicked();
     void onOpenLocationClicked();
 
@@ -46,6 +53,7 @@ private:
     void loadTables();
     void loadTableData(const QString &tableName);
     void showQueryResult(const QString &query);
+    QMap<QString, qint64> approximateRowCounts(const QStringList &tables);
     QString getDatabasePath();
     
     DatabaseManager *m_dbManager;
@@ -66,7 +74,9 @@ private:
     QVBoxLayout *m_rightLayout;
     QTextEdit *m_queryEdit;
     QPushButton *m_executeBtn;
-    QTableWidget *m_dataTable;
+    QPushButton *m_cancelQueryBtn;
+    QTableView *m_dataView;
+    QueryResultModel *m_resultModel;
     QLabel *m_recordCountLabel;
     
     QPushButton *m_closeBtn;
@@ -1,12 +1,164 @@
 ﻿#include "DatabaseManager.h"
+#include "SchemaMigrator.h"
+#include "QueryPlanAudit.h"
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QDebug>
 #include <QDateTime>
 #include <QStandardPaths>
 #include <QDir>
+#include <QRegularExpression>
 
 DatabaseManager* DatabaseManager::m_instance = nullptr;
+QString DatabaseManager::m_dataDirectory;
+
+namespace {
+
+// Every fixed statement, registered for --audit-queries; lists that read a
+// whole table say so
+const QString BOWLER_COLUMNS = "id, first_name, last_name, sex, avg, address, phone, birthday, over_18, created_at";
+
+const QString ALL_BOWLERS_SQL = QueryPlanAudit::statement("DatabaseManager::getAllBowlers",
+    "SELECT " + BOWLER_COLUMNS + " FROM bowlers ORDER BY last_name, first_name",
+    "lists every bowler");
+const QString FILTERED_BOWLERS_SQL = QueryPlanAudit::statement("DatabaseManager::getAllBowlers",
+    "SELECT " + BOWLER_COLUMNS + " FROM bowlers WHERE LOWER(first_name) LIKE ? OR LOWER(last_name) LIKE ? "
+    "ORDER BY last_name, first_name",
+    "substring match on names, see search() for the indexed lookup");
+const QString BOWLER_BY_ID_SQL = QueryPlanAudit::statement("DatabaseManager::getBowlerById",
+    "SELECT " + BOWLER_COLUMNS + " FROM bowlers WHERE id = ?");
+const QString ADD_BOWLER_SQL = QueryPlanAudit::statement("DatabaseManager::addBowler", R"(
+        INSERT INTO bowlers (first_name, last_name, sex, avg, address, phone, birthday, over_18)
+        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+const QString UPDATE_BOWLER_SQL = QueryPlanAudit::statement("DatabaseManager::updateBowler", R"(
+        UPDATE bowlers 
+        SET first_name = ?, last_name = ?, sex = ?, avg = ?, address = ?, phone = ?, birthday = ?, over_18 = ?
+        WHERE id = ?
+    )");
+const QString DELETE_BOWLER_MEMBERSHIPS_SQL = QueryPlanAudit::statement("DatabaseManager::deleteBowler",
+    "DELETE FROM team_bowlers WHERE bowler_id = ?");
+const QString DELETE_BOWLER_SQL = QueryPlanAudit::statement("DatabaseManager::deleteBowler",
+    "DELETE FROM bowlers WHERE id = ?");
+const QString BOWLER_TEAMS_SQL = QueryPlanAudit::statement("DatabaseManager::getBowlerTeams", R"(
+        SELECT t.name 
+        FROM teams t
+        JOIN team_bowlers tb ON t.id = tb.team_id
+        WHERE tb.bowler_id = ?
+        ORDER BY t.name
+    )");
+const QString ALL_TEAMS_SQL = QueryPlanAudit::statement("DatabaseManager::getAllTeams",
+    "SELECT id, name, created_at FROM teams ORDER BY name",
+    "lists every team");
+const QString TEAM_BOWLER_COUNT_SQL = QueryPlanAudit::statement("DatabaseManager::getAllTeams",
+    "SELECT COUNT(*) FROM team_bowlers WHERE team_id = ?");
+const QString TEAM_BY_ID_SQL = QueryPlanAudit::statement("DatabaseManager::getTeamById",
+    "SELECT id, name, created_at FROM teams WHERE id = ?");
+const QString ADD_TEAM_SQL = QueryPlanAudit::statement("DatabaseManager::addTeam",
+    "INSERT INTO teams (name) VALUES (?)");
+const QString UPDATE_TEAM_SQL = QueryPlanAudit::statement("DatabaseManager::updateTeam",
+    "UPDATE teams SET name = ? WHERE id = ?");
+const QString DELETE_TEAM_SQL = QueryPlanAudit::statement("DatabaseManager::deleteTeam",
+    "DELETE FROM teams WHERE id = ?");
+const QString ALL_LEAGUES_SQL = QueryPlanAudit::statement("DatabaseManager::getAllLeagues",
+    "SELECT id, name, created_at FROM leagues ORDER BY name",
+    "lists every league");
+const QString LEAGUE_TEAM_COUNT_SQL = QueryPlanAudit::statement("DatabaseManager::getAllLeagues",
+    "SELECT COUNT(*) FROM league_teams WHERE league_id = ?");
+const QString LEAGUE_BY_ID_SQL = QueryPlanAudit::statement("DatabaseManager::getLeagueById",
+    "SELECT id, name, created_at FROM leagues WHERE id = ?");
+const QString ADD_LEAGUE_SQL = QueryPlanAudit::statement("DatabaseManager::addLeague",
+    "INSERT INTO leagues (name) VALUES (?)");
+const QString UPDATE_LEAGUE_SQL = QueryPlanAudit::statement("DatabaseManager::updateLeague",
+    "UPDATE leagues SET name = ? WHERE id = ?");
+const QString DELETE_LEAGUE_SQL = QueryPlanAudit::statement("DatabaseManager::deleteLeague",
+    "DELETE FROM leagues WHERE id = ?");
+const QString SEARCH_SQL = QueryPlanAudit::statement("DatabaseManager::search", R"(
+            SELECT rowid, title, detail, bm25(search_index, 10.0, 1.0) AS score
+            FROM search_index
+            WHERE search_index MATCH ?
+            ORDER BY score
+            LIMIT ?
+        )");
+// Without FTS5: the same entries search_index would hold, so both paths
+// match on the same columns
+const QString LIKE_SEARCH_SQL = QueryPlanAudit::statement("DatabaseManager::search",
+    "WITH entries(id, title, detail) AS (" + SchemaMigrator::searchRows() + ") "
+    "SELECT id, title, detail, 0 AS score FROM entries WHERE LOWER(title || ' ' || detail) LIKE ? LIMIT ?",
+    "substring fallback when SQLite has no FTS5");
+const QString ALL_EVENTS_SQL = QueryPlanAudit::statement("DatabaseManager::getAllCalendarEvents", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        ORDER BY date, start_time
+    )", "lists every booking");
+const QString EVENTS_FOR_DATE_SQL = QueryPlanAudit::statement("DatabaseManager::getCalendarEventsForDate", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        WHERE date = ?
+        ORDER BY start_time, lane_id
+    )");
+const QString EVENTS_FOR_MONTH_SQL = QueryPlanAudit::statement("DatabaseManager::getCalendarEventsForMonth", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        WHERE date >= ? AND date <= ?
+        ORDER BY date, start_time, lane_id
+    )");
+const QString EVENT_BY_ID_SQL = QueryPlanAudit::statement("DatabaseManager::getCalendarEventById", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        WHERE id = ?
+    )");
+const QString ADD_EVENT_SQL = QueryPlanAudit::statement("DatabaseManager::addCalendarEvent", R"(
+        INSERT INTO calendar_events (
+            date, start_time, end_time, lane_id, event_type, title, description,
+            contact_name, contact_phone, contact_email, bowler_count, additional_details,
+            league_id, team_id
+        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
+    )");
+const QString UPDATE_EVENT_SQL = QueryPlanAudit::statement("DatabaseManager::updateCalendarEvent", R"(
+        UPDATE calendar_events SET
+            date = ?, start_time = ?, end_time = ?, lane_id = ?, event_type = ?,
+            title = ?, description = ?, contact_name = ?, contact_phone = ?,
+            contact_email = ?, bowler_count = ?, additional_details = ?,
+            league_id = ?, team_id = ?, updated_at = CURRENT_TIMESTAMP
+        WHERE id = ?
+    )");
+const QString DELETE_EVENT_SQL = QueryPlanAudit::statement("DatabaseManager::deleteCalendarEvent",
+    "DELETE FROM calendar_events WHERE id = ?");
+const QString CALENDAR_INDEX_SQL = QueryPlanAudit::statement("DatabaseManager::ensureCalendarIndex",
+    "SELECT id, date, start_time, end_time, lane_id FROM calendar_events",
+    "loads every booking into the in-memory index once");
+const QString EVENTS_BY_IDS_SQL = QueryPlanAudit::statement("DatabaseManager::getConflictingEvents", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        WHERE id IN (%1)
+        ORDER BY date, start_time
+    )");
+const QString EVENTS_FOR_RANGE_SQL = QueryPlanAudit::statement("DatabaseManager::getCalendarEventsForDateRange", R"(
+        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
+               contact_name, contact_phone, contact_email, bowler_count, additional_details,
+               league_id, team_id, created_at, updated_at
+        FROM calendar_events
+        WHERE date >= ? AND date <= ?
+        ORDER BY date, start_time, lane_id
+    )");
+const QString RECORD_GAME_SQL = QueryPlanAudit::statement("DatabaseManager::recordGames",
+    "INSERT INTO games (lane_id, bowler_id, bowler_name, league_id, game_type, game_number, "
+    "score, frames_json, started_at, created_at) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+const QString FIRST_GAME_SQL = QueryPlanAudit::statement("DatabaseManager::rebuildRollups",
+    "SELECT MIN(created_at) FROM games");
+
+} // namespace
 
 DatabaseManager* DatabaseManager::instance()
 {
@@ -16,6 +168,11 @@ DatabaseManager* DatabaseManager::instance()
     return m_instance;
 }
 
+void DatabaseManager::setDataDirectory(const QString &path)
+{
+    m_dataDirectory = path;
+}
+
 DatabaseManager::DatabaseManager(QObject *parent)
     : QObject(parent)
 {
@@ -30,7 +187,8 @@ DatabaseManager::~DatabaseManager()
 bool DatabaseManager::initializeDatabase()
 {
     // Create database in application data directory
-    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString dataDir = m_dataDirectory.isEmpty() ? QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)
+                                                : m_dataDirectory;
     QDir().mkpath(dataDir);
     QString dbPath = dataDir + "/bowling.db";
     
@@ -78,111 +236,32 @@ void DatabaseManager::closeDatabase()
 
 bool DatabaseManager::createTables()
 {
-    QSqlQuery query(m_database);
-    
-    // Create bowlers table
-    QString createBowlersTable = R"(
-        CREATE TABLE IF NOT EXISTS bowlers (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            first_name TEXT NOT NULL,
-            last_name TEXT NOT NULL,
-            sex TEXT DEFAULT 'Male',
-            avg INTEGER DEFAULT 0,
-            address TEXT,
-            phone TEXT,
-            birthday TEXT,
-            over_18 INTEGER DEFAULT 1,
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createBowlersTable)) {
-        qCritical() << "Failed to create bowlers table:" << query.lastError().text();
-        return false;
-    }
-    
-    // Create teams table
-    QString createTeamsTable = R"(
-        CREATE TABLE IF NOT EXISTS teams (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT UNIQUE NOT NULL,
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createTeamsTable)) {
-        qCritical() << "Failed to create teams table:" << query.lastError().text();
-        return false;
-    }
-    
-    // Create team_bowlers junction table
-    QString createTeamBowlersTable = R"(
-        CREATE TABLE IF NOT EXISTS team_bowlers (
-            team_id INTEGER,
-            bowler_id INTEGER,
-            PRIMARY KEY (team_id, bowler_id),
-            FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE CASCADE,
-            FOREIGN KEY (bowler_id) REFERENCES bowlers(id) ON DELETE CASCADE
-        )
-    )";
-    
-    if (!query.exec(createTeamBowlersTable)) {
-        qCritical() << "Failed to create team_bowlers table:" << query.lastError().text();
-        return false;
-    }
-    
-    // Create leagues table
-    QString createLeaguesTable = R"(
-        CREATE TABLE IF NOT EXISTS leagues (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            name TEXT UNIQUE NOT NULL,
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
-        )
-    )";
-    
-    if (!query.exec(createLeaguesTable)) {
-        qCritical() << "Failed to create leagues table:" << query.lastError().text();
+    // All DDL lives in SchemaMigrator; an up-to-date database skips straight past it
+    if (!migrateSchema()) {
         return false;
     }
     
-    // Create league_teams junction table
-    QString createLeagueTeamsTable = R"(
-        CREATE TABLE IF NOT EXISTS league_teams (
-            league_id INTEGER,
-            team_id INTEGER,
-            PRIMARY KEY (league_id, team_id),
-            FOREIGN KEY (league_id) REFERENCES leagues(id) ON DELETE CASCADE,
-            FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE CASCADE
-        )
-    )";
-    
-    if (!query.exec(createLeagueTeamsTable)) {
-        qCritical() << "Failed to create league_teams table:" << query.lastError().text();
-        return false;
-    }
-    
-    // CREATE CALENDAR EVENTS TABLE - This was missing!
-    if (!createCalendarEventsTable()) {
-        return false;
-    }
+    // Full-text search is optional; without FTS5 the migration leaves it out
+    setFullTextSearch(true);
     
-    qDebug() << "All database tables created successfully";
+    qDebug() << "Database schema is at version" << SchemaMigrator(m_database).currentVersion();
     return true;
 }
+
+bool DatabaseManager::migrateSchema()
+{
+    SchemaMigrator migrator(m_database);
+    return migrator.migrate();
+}
+
 QVector<BowlerData> DatabaseManager::getAllBowlers(const QString &searchFilter)
 {
     QVector<BowlerData> bowlers;
     QSqlQuery query(m_database);
     
-    QString sql = "SELECT id, first_name, last_name, sex, avg, address, phone, birthday, over_18, created_at FROM bowlers";
-    
-    if (!searchFilter.isEmpty()) {
-        sql += " WHERE LOWER(first_name) LIKE ? OR LOWER(last_name) LIKE ?";
-    }
-    
-    sql += " ORDER BY last_name, first_name";
-    
-    query.prepare(sql);
+    // Matches anywhere in a name, as it always has; search() is the indexed
+    // prefix lookup for the quick search
+    query.prepare(searchFilter.isEmpty() ? ALL_BOWLERS_SQL : FILTERED_BOWLERS_SQL);
     
     if (!searchFilter.isEmpty()) {
         QString filter = "%" + searchFilter.toLower() + "%";
@@ -222,7 +301,7 @@ BowlerData DatabaseManager::getBowlerById(int id)
     BowlerData bowler;
     QSqlQuery query(m_database);
     
-    query.prepare("SELECT id, first_name, last_name, sex, avg, address, phone, birthday, over_18, created_at FROM bowlers WHERE id = ?");
+    query.prepare(BOWLER_BY_ID_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -253,10 +332,7 @@ int DatabaseManager::addBowler(const BowlerData &bowler)
 {
     QSqlQuery query(m_database);
     
-    query.prepare(R"(
-        INSERT INTO bowlers (first_name, last_name, sex, avg, address, phone, birthday, over_18)
-        VALUES (?, ?, ?, ?, ?, ?, ?, ?)
-    )");
+    query.prepare(ADD_BOWLER_SQL);
     
     query.addBindValue(bowler.firstName);
     query.addBindValue(bowler.lastName);
@@ -281,11 +357,7 @@ bool DatabaseManager::updateBowler(const BowlerData &bowler)
 {
     QSqlQuery query(m_database);
     
-    query.prepare(R"(
-        UPDATE bowlers 
-        SET first_name = ?, last_name = ?, sex = ?, avg = ?, address = ?, phone = ?, birthday = ?, over_18 = ?
-        WHERE id = ?
-    )");
+    query.prepare(UPDATE_BOWLER_SQL);
     
     query.addBindValue(bowler.firstName);
     query.addBindValue(bowler.lastName);
@@ -311,7 +383,7 @@ bool DatabaseManager::deleteBowler(int id)
     QSqlQuery query(m_database);
     
     // First remove from all teams
-    query.prepare("DELETE FROM team_bowlers WHERE bowler_id = ?");
+    query.prepare(DELETE_BOWLER_MEMBERSHIPS_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -320,7 +392,7 @@ bool DatabaseManager::deleteBowler(int id)
     }
     
     // Then delete the bowler
-    query.prepare("DELETE FROM bowlers WHERE id = ?");
+    query.prepare(DELETE_BOWLER_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -337,13 +409,7 @@ QStringList DatabaseManager::getBowlerTeams(int bowlerId)
     QStringList teams;
     QSqlQuery query(m_database);
     
-    query.prepare(R"(
-        SELECT t.name 
-        FROM teams t
-        JOIN team_bowlers tb ON t.id = tb.team_id
-        WHERE tb.bowler_id = ?
-        ORDER BY t.name
-    )");
+    query.prepare(BOWLER_TEAMS_SQL);
     
     query.addBindValue(bowlerId);
     
@@ -364,7 +430,7 @@ QVector<TeamData> DatabaseManager::getAllTeams()
     QVector<TeamData> teams;
     QSqlQuery query(m_database);
     
-    if (!query.exec("SELECT id, name, created_at FROM teams ORDER BY name")) {
+    if (!query.exec(ALL_TEAMS_SQL)) {
         qCritical() << "Failed to get teams:" << query.lastError().text();
         return teams;
     }
@@ -377,7 +443,7 @@ QVector<TeamData> DatabaseManager::getAllTeams()
         
         // Get bowler count for this team
         QSqlQuery countQuery(m_database);
-        countQuery.prepare("SELECT COUNT(*) FROM team_bowlers WHERE team_id = ?");
+        countQuery.prepare(TEAM_BOWLER_COUNT_SQL);
         countQuery.addBindValue(team.id);
         
         if (countQuery.exec() && countQuery.next()) {
@@ -395,7 +461,7 @@ TeamData DatabaseManager::getTeamById(int id)
     TeamData team;
     QSqlQuery query(m_database);
     
-    query.prepare("SELECT id, name, created_at FROM teams WHERE id = ?");
+    query.prepare(TEAM_BY_ID_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -416,7 +482,7 @@ int DatabaseManager::addTeam(const QString &name)
 {
     QSqlQuery query(m_database);
     
-    query.prepare("INSERT INTO teams (name) VALUES (?)");
+    query.prepare(ADD_TEAM_SQL);
     query.addBindValue(name);
     
     if (!query.exec()) {
@@ -433,7 +499,7 @@ bool DatabaseManager::updateTeam(const TeamData &team)
 {
     QSqlQuery query(m_database);
     
-    query.prepare("UPDATE teams SET name = ? WHERE id = ?");
+    query.prepare(UPDATE_TEAM_SQL);
     query.addBindValue(team.name);
     query.addBindValue(team.id);
     
@@ -451,7 +517,7 @@ bool DatabaseManager::deleteTeam(int id)
     QSqlQuery query(m_database);
     
     // Team_bowlers entries will be automatically deleted due to CASCADE
-    query.prepare("DELETE FROM teams WHERE id = ?");
+    query.prepare(DELETE_TEAM_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -468,7 +534,7 @@ QVector<LeagueData> DatabaseManager::getAllLeagues()
     QVector<LeagueData> leagues;
     QSqlQuery query(m_database);
     
-    if (!query.exec("SELECT id, name, created_at FROM leagues ORDER BY name")) {
+    if (!query.exec(ALL_LEAGUES_SQL)) {
         qCritical() << "Failed to get leagues:" << query.lastError().text();
         return leagues;
     }
@@ -481,7 +547,7 @@ QVector<LeagueData> DatabaseManager::getAllLeagues()
         
         // Get team count for this league
         QSqlQuery countQuery(m_database);
-        countQuery.prepare("SELECT COUNT(*) FROM league_teams WHERE league_id = ?");
+        countQuery.prepare(LEAGUE_TEAM_COUNT_SQL);
         countQuery.addBindValue(league.id);
         
         if (countQuery.exec() && countQuery.next()) {
@@ -499,7 +565,7 @@ LeagueData DatabaseManager::getLeagueById(int id)
     LeagueData league;
     QSqlQuery query(m_database);
     
-    query.prepare("SELECT id, name, created_at FROM leagues WHERE id = ?");
+    query.prepare(LEAGUE_BY_ID_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -520,7 +586,7 @@ int DatabaseManager::addLeague(const QString &name)
 {
     QSqlQuery query(m_database);
     
-    query.prepare("INSERT INTO leagues (name) VALUES (?)");
+    query.prepare(ADD_LEAGUE_SQL);
     query.addBindValue(name);
     
     if (!query.exec()) {
@@ -537,7 +603,7 @@ bool DatabaseManager::updateLeague(const LeagueData &league)
 {
     QSqlQuery query(m_database);
     
-    query.prepare("UPDATE leagues SET name = ? WHERE id = ?");
+    query.prepare(UPDATE_LEAGUE_SQL);
     query.addBindValue(league.name);
     query.addBindValue(league.id);
     
@@ -555,7 +621,7 @@ bool DatabaseManager::deleteLeague(int id)
     QSqlQuery query(m_database);
     
     // League_teams entries will be automatically deleted due to CASCADE
-    query.prepare("DELETE FROM leagues WHERE id = ?");
+    query.prepare(DELETE_LEAGUE_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -568,46 +634,67 @@ bool DatabaseManager::deleteLeague(int id)
 }
 
 
-bool DatabaseManager::createCalendarEventsTable()
+QString DatabaseManager::fullTextQuery(const QString &text) const
+{
+    // Every word must match as a prefix; quoting keeps FTS5 syntax out of user input
+    const QStringList words = text.split(QRegularExpression("[\\W_]+"), Qt::SkipEmptyParts);
+    
+    QStringList terms;
+    for (const QString &word : words) {
+        terms.append(QString("\"%1\"*").arg(word));
+    }
+    return terms.join(" AND ");
+}
+
+void DatabaseManager::setFullTextSearch(bool enabled)
+{
+    m_fullTextSearch = enabled && m_database.tables().contains("search_index");
+}
+
+QVector<SearchHit> DatabaseManager::search(const QString &text, int limit)
 {
+    QVector<SearchHit> hits;
     QSqlQuery query(m_database);
     
-    QString createCalendarEventsTable = R"(
-        CREATE TABLE IF NOT EXISTS calendar_events (
-            id INTEGER PRIMARY KEY AUTOINCREMENT,
-            date TEXT NOT NULL,
-            start_time TEXT NOT NULL,
-            end_time TEXT NOT NULL,
-            lane_id INTEGER NOT NULL,
-            event_type TEXT NOT NULL DEFAULT 'Open Bowling',
-            title TEXT NOT NULL,
-            description TEXT,
-            contact_name TEXT NOT NULL,
-            contact_phone TEXT NOT NULL,
-            contact_email TEXT,
-            bowler_count INTEGER DEFAULT 1,
-            additional_details TEXT,
-            league_id INTEGER DEFAULT 0,
-            team_id INTEGER DEFAULT 0,
-            created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-            updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
-            FOREIGN KEY (league_id) REFERENCES leagues(id) ON DELETE SET NULL,
-            FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE SET NULL
-        )
-    )";
-    
-    if (!query.exec(createCalendarEventsTable)) {
-        qCritical() << "Failed to create calendar_events table:" << query.lastError().text();
-        return false;
+    if (m_fullTextSearch) {
+        QString matchQuery = fullTextQuery(text);
+        if (matchQuery.isEmpty()) {
+            return hits;
+        }
+        
+        // Titles (names) weigh ten times more than details
+        query.prepare(SEARCH_SQL);
+        query.addBindValue(matchQuery);
+        query.addBindValue(limit);
+    } else {
+        QString filter = "%" + text.trimmed().toLower() + "%";
+        if (filter == "%%") {
+            return hits;
+        }
+        
+        query.prepare(LIKE_SEARCH_SQL);
+        query.addBindValue(filter);
+        query.addBindValue(limit);
+    }
+    
+    if (!query.exec()) {
+        qCritical() << "Search failed:" << query.lastError().text();
+        return hits;
     }
     
-    // Create indexes for better performance
-    query.exec("CREATE INDEX IF NOT EXISTS idx_calendar_events_date ON calendar_events(date)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_calendar_events_lane_date ON calendar_events(lane_id, date)");
-    query.exec("CREATE INDEX IF NOT EXISTS idx_calendar_events_date_time ON calendar_events(date, start_time, end_time)");
+    while (query.next()) {
+        qint64 rowId = query.value(0).toLongLong();
+        
+        SearchHit hit;
+        hit.kind = static_cast<SearchHit::Kind>(rowId % 4);
+        hit.id = static_cast<int>(rowId / 4);
+        hit.title = query.value(1).toString();
+        hit.detail = query.value(2).toString().simplified();
+        hit.score = query.value(3).toDouble();
+        hits.append(hit);
+    }
     
-    qDebug() << "Calendar events table created successfully";
-    return true;
+    return hits;
 }
 
 QVector<CalendarEventData> DatabaseManager::getAllCalendarEvents()
@@ -615,15 +702,7 @@ QVector<CalendarEventData> DatabaseManager::getAllCalendarEvents()
     QVector<CalendarEventData> events;
     QSqlQuery query(m_database);
     
-    QString sql = R"(
-        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
-               contact_name, contact_phone, contact_email, bowler_count, additional_details,
-               league_id, team_id, created_at, updated_at
-        FROM calendar_events
-        ORDER BY date, start_time
-    )";
-    
-    if (!query.exec(sql)) {
+    if (!query.exec(ALL_EVENTS_SQL)) {
         qCritical() << "Failed to get all calendar events:" << query.lastError().text();
         return events;
     }
@@ -659,16 +738,7 @@ QVector<CalendarEventData> DatabaseManager::getCalendarEventsForDate(const QDate
     QVector<CalendarEventData> events;
     QSqlQuery query(m_database);
     
-    QString sql = R"(
-        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
-               contact_name, contact_phone, contact_email, bowler_count, additional_details,
-               league_id, team_id, created_at, updated_at
-        FROM calendar_events
-        WHERE date = ?
-        ORDER BY start_time, lane_id
-    )";
-    
-    query.prepare(sql);
+    query.prepare(EVENTS_FOR_DATE_SQL);
     query.addBindValue(date.toString(Qt::ISODate));
     
     if (!query.exec()) {
@@ -710,16 +780,7 @@ QVector<CalendarEventData> DatabaseManager::getCalendarEventsForMonth(int year,
     QDate startDate(year, month, 1);
     QDate endDate = startDate.addMonths(1).addDays(-1);
     
-    QString sql = R"(
-        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
-               contact_name, contact_phone, contact_email, bowler_count, additional_details,
-               league_id, team_id, created_at, updated_at
-        FROM calendar_events
-        WHERE date >= ? AND date <= ?
-        ORDER BY date, start_time, lane_id
-    )";
-    
-    query.prepare(sql);
+    query.prepare(EVENTS_FOR_MONTH_SQL);
     query.addBindValue(startDate.toString(Qt::ISODate));
     query.addBindValue(endDate.toString(Qt::ISODate));
     
@@ -759,15 +820,7 @@ CalendarEventData DatabaseManager::getCalendarEventById(int id)
     CalendarEventData event;
     QSqlQuery query(m_database);
     
-    QString sql = R"(
-        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
-               contact_name, contact_phone, contact_email, bowler_count, additional_details,
-               league_id, team_id, created_at, updated_at
-        FROM calendar_events
-        WHERE id = ?
-    )";
-    
-    query.prepare(sql);
+    query.prepare(EVENT_BY_ID_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -800,17 +853,14 @@ CalendarEventData DatabaseManager::getCalendarEventById(int id)
 
 int DatabaseManager::addCalendarEvent(const CalendarEventData &event)
 {
-    QSqlQuery query(m_database);
+    if (event.startTime == event.endTime) {
+        qWarning() << "Refusing calendar event with no duration on lane" << event.laneId << event.date;
+        return -1;
+    }
     
-    QString sql = R"(
-        INSERT INTO calendar_events (
-            date, start_time, end_time, lane_id, event_type, title, description,
-            contact_name, contact_phone, contact_email, bowler_count, additional_details,
-            league_id, team_id
-        ) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)
-    )";
+    QSqlQuery query(m_database);
     
-    query.prepare(sql);
+    query.prepare(ADD_EVENT_SQL);
     query.addBindValue(event.date.toString(Qt::ISODate));
     query.addBindValue(event.startTime.toString("hh:mm:ss"));
     query.addBindValue(event.endTime.toString("hh:mm:ss"));
@@ -832,24 +882,24 @@ int DatabaseManager::addCalendarEvent(const CalendarEventData &event)
     }
     
     int newId = query.lastInsertId().toInt();
+    if (m_calendarIndexLoaded) {
+        m_calendarIndex.insert(CalendarIndex::makeBooking(newId, event.laneId, event.date,
+                                                          event.startTime, event.endTime));
+    }
     qDebug() << "Added calendar event with ID:" << newId;
     return newId;
 }
 
 bool DatabaseManager::updateCalendarEvent(const CalendarEventData &event)
 {
-    QSqlQuery query(m_database);
+    if (event.startTime == event.endTime) {
+        qWarning() << "Refusing calendar event" << event.id << "with no duration";
+        return false;
+    }
     
-    QString sql = R"(
-        UPDATE calendar_events SET
-            date = ?, start_time = ?, end_time = ?, lane_id = ?, event_type = ?,
-            title = ?, description = ?, contact_name = ?, contact_phone = ?,
-            contact_email = ?, bowler_count = ?, additional_details = ?,
-            league_id = ?, team_id = ?, updated_at = CURRENT_TIMESTAMP
-        WHERE id = ?
-    )";
+    QSqlQuery query(m_database);
     
-    query.prepare(sql);
+    query.prepare(UPDATE_EVENT_SQL);
     query.addBindValue(event.date.toString(Qt::ISODate));
     query.addBindValue(event.startTime.toString("hh:mm:ss"));
     query.addBindValue(event.endTime.toString("hh:mm:ss"));
@@ -871,6 +921,10 @@ bool DatabaseManager::updateCalendarEvent(const CalendarEventData &event)
         return false;
     }
     
+    if (m_calendarIndexLoaded) {
+        m_calendarIndex.insert(CalendarIndex::makeBooking(event.id, event.laneId, event.date,
+                                                          event.startTime, event.endTime));
+    }
     qDebug() << "Updated calendar event with ID:" << event.id;
     return true;
 }
@@ -879,7 +933,7 @@ bool DatabaseManager::deleteCalendarEvent(int id)
 {
     QSqlQuery query(m_database);
     
-    query.prepare("DELETE FROM calendar_events WHERE id = ?");
+    query.prepare(DELETE_EVENT_SQL);
     query.addBindValue(id);
     
     if (!query.exec()) {
@@ -887,6 +941,7 @@ bool DatabaseManager::deleteCalendarEvent(int id)
         return false;
     }
     
+    m_calendarIndex.remove(id);
     qDebug() << "Deleted calendar event with ID:" << id;
     return true;
 }
@@ -894,102 +949,227 @@ bool DatabaseManager::deleteCalendarEvent(int id)
 bool DatabaseManager::isLaneAvailable(const QDate &date, const QTime &startTime, const QTime &endTime, 
                                      int laneId, int excludeEventId)
 {
+    if (!ensureCalendarIndex()) {
+        return false;
+    }
+    
+    CalendarBooking booking = CalendarIndex::makeBooking(excludeEventId, laneId, date, startTime, endTime);
+    return m_calendarIndex.isFree(laneId, booking.start, booking.end, excludeEventId);
+}
+
+QVector<CalendarEventData> DatabaseManager::getConflictingEvents(const QDate &date, const QTime &startTime, 
+                                                                const QTime &endTime, int laneId, int excludeEventId)
+{
+    QVector<CalendarEventData> conflicts;
+    if (!ensureCalendarIndex()) {
+        return conflicts;
+    }
+    
+    CalendarBooking booking = CalendarIndex::makeBooking(excludeEventId, laneId, date, startTime, endTime);
+    QVector<int> eventIds = m_calendarIndex.conflicts(laneId, booking.start, booking.end, excludeEventId);
+    if (eventIds.isEmpty()) {
+        return conflicts;
+    }
+    
+    // Only the handful of overlapping rows are read back from the database
+    QStringList placeholders;
+    for (int i = 0; i < eventIds.size(); ++i) {
+        placeholders.append("?");
+    }
+    
     QSqlQuery query(m_database);
+    query.prepare(EVENTS_BY_IDS_SQL.arg(placeholders.join(", ")));
     
-    QString sql = R"(
-        SELECT COUNT(*) FROM calendar_events
-        WHERE date = ? AND lane_id = ? AND id != ?
-        AND (
-            (start_time < ? AND end_time > ?) OR
-            (start_time < ? AND end_time > ?) OR
-            (start_time >= ? AND end_time <= ?)
-        )
-    )";
-    
-    query.prepare(sql);
-    query.addBindValue(date.toString(Qt::ISODate));
-    query.addBindValue(laneId);
-    query.addBindValue(excludeEventId);
-    query.addBindValue(endTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(endTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(endTime.toString("hh:mm:ss"));
+    for (int eventId : eventIds) {
+        query.addBindValue(eventId);
+    }
     
     if (!query.exec()) {
-        qCritical() << "Failed to check lane availability:" << query.lastError().text();
+        qCritical() << "Failed to get conflicting events:" << query.lastError().text();
+        return conflicts;
+    }
+    
+    while (query.next()) {
+        conflicts.append(readCalendarEvent(query));
+    }
+    
+    return conflicts;
+}
+
+QDateTime DatabaseManager::findFirstFreeSlot(const QDateTime &from, const QDateTime &latestStart, int durationMinutes,
+                                             const QVector<int> &laneIds, int laneCount,
+                                             QVector<int> *freeLanes)
+{
+    if (!ensureCalendarIndex()) {
+        return QDateTime();
+    }
+    
+    qint64 start = m_calendarIndex.firstFreeSlot(laneIds, laneCount, durationMinutes,
+                                                 CalendarIndex::toMinutes(from.date(), from.time()),
+                                                 CalendarIndex::toMinutes(latestStart.date(), latestStart.time()),
+                                                 freeLanes);
+    return start < 0 ? QDateTime() : CalendarIndex::fromMinutes(start);
+}
+
+QVector<LaneBlock> DatabaseManager::findLaneBlocks(const LaneSearchRequest &request)
+{
+    if (!ensureCalendarIndex()) {
+        return QVector<LaneBlock>();
+    }
+    
+    return LaneFinder::search(m_calendarIndex, request);
+}
+
+bool DatabaseManager::ensureCalendarIndex()
+{
+    if (m_calendarIndexLoaded) {
+        return true;
+    }
+    
+    QSqlQuery query(m_database);
+    if (!query.exec(CALENDAR_INDEX_SQL)) {
+        qCritical() << "Failed to load calendar index:" << query.lastError().text();
         return false;
     }
     
-    if (query.next()) {
-        int conflictCount = query.value(0).toInt();
-        return conflictCount == 0;
+    m_calendarIndex.clear();
+    while (query.next()) {
+        m_calendarIndex.insert(CalendarIndex::makeBooking(
+            query.value(0).toInt(), query.value(4).toInt(),
+            QDate::fromString(query.value(1).toString(), Qt::ISODate),
+            QTime::fromString(query.value(2).toString(), "hh:mm:ss"),
+            QTime::fromString(query.value(3).toString(), "hh:mm:ss")));
     }
     
-    return false;
+    m_calendarIndexLoaded = true;
+    qDebug() << "Loaded" << m_calendarIndex.size() << "bookings into calendar index";
+    return true;
 }
 
-QVector<CalendarEventData> DatabaseManager::getConflictingEvents(const QDate &date, const QTime &startTime, 
-                                                                const QTime &endTime, int laneId, int excludeEventId)
+QVector<CalendarEventData> DatabaseManager::getCalendarEventsForDateRange(const QDate &startDate, const QDate &endDate)
 {
-    QVector<CalendarEventData> conflicts;
+    QVector<CalendarEventData> events;
     QSqlQuery query(m_database);
     
-    QString sql = R"(
-        SELECT id, date, start_time, end_time, lane_id, event_type, title, description,
-               contact_name, contact_phone, contact_email, bowler_count, additional_details,
-               league_id, team_id, created_at, updated_at
-        FROM calendar_events
-        WHERE date = ? AND lane_id = ? AND id != ?
-        AND (
-            (start_time < ? AND end_time > ?) OR
-            (start_time < ? AND end_time > ?) OR
-            (start_time >= ? AND end_time <= ?)
-        )
-        ORDER BY start_time
-    )";
-    
-    query.prepare(sql);
-    query.addBindValue(date.toString(Qt::ISODate));
-    query.addBindValue(laneId);
-    query.addBindValue(excludeEventId);
-    query.addBindValue(endTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(endTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(startTime.toString("hh:mm:ss"));
-    query.addBindValue(endTime.toString("hh:mm:ss"));
+    query.prepare(EVENTS_FOR_RANGE_SQL);
+    query.addBindValue(startDate.toString(Qt::ISODate));
+    query.addBindValue(endDate.toString(Qt::ISODate));
     
     if (!query.exec()) {
-        qCritical() << "Failed to get conflicting events:" << query.lastError().text();
-        return conflicts;
+        qCritical() << "Failed to get calendar events for date range:" << query.lastError().text();
+        return events;
     }
     
     while (query.next()) {
-        CalendarEventData event;
-        event.id = query.value("id").toInt();
-        event.date = QDate::fromString(query.value("date").toString(), Qt::ISODate);
-        event.startTime = QTime::fromString(query.value("start_time").toString(), "hh:mm:ss");
-        event.endTime = QTime::fromString(query.value("end_time").toString(), "hh:mm:ss");
-        event.laneId = query.value("lane_id").toInt();
-        event.eventType = query.value("event_type").toString();
-        event.title = query.value("title").toString();
-        event.description = query.value("description").toString();
-        event.contactName = query.value("contact_name").toString();
-        event.contactPhone = query.value("contact_phone").toString();
-        event.contactEmail = query.value("contact_email").toString();
-        event.bowlerCount = query.value("bowler_count").toInt();
-        event.additionalDetails = query.value("additional_details").toString();
-        event.leagueId = query.value("league_id").toInt();
-        event.teamId = query.value("team_id").toInt();
-        event.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
-        event.updatedAt = QDateTime::fromString(query.value("updated_at").toString(), Qt::ISODate);
+        events.append(readCalendarEvent(query));
+    }
+    
+    return events;
+}
+
+CalendarEventData DatabaseManager::readCalendarEvent(const QSqlQuery &query) const
+{
+    CalendarEventData event;
+    event.id = query.value("id").toInt();
+    event.date = QDate::fromString(query.value("date").toString(), Qt::ISODate);
+    event.startTime = QTime::fromString(query.value("start_time").toString(), "hh:mm:ss");
+    event.endTime = QTime::fromString(query.value("end_time").toString(), "hh:mm:ss");
+    event.laneId = query.value("lane_id").toInt();
+    event.eventType = query.value("event_type").toString();
+    event.title = query.value("title").toString();
+    event.description = query.value("description").toString();
+    event.contactName = query.value("contact_name").toString();
+    event.contactPhone = query.value("contact_phone").toString();
+    event.contactEmail = query.value("contact_email").toString();
+    event.bowlerCount = query.value("bowler_count").toInt();
+    event.additionalDetails = query.value("additional_details").toString();
+    event.leagueId = query.value("league_id").toInt();
+    event.teamId = query.value("team_id").toInt();
+    event.createdAt = QDateTime::fromString(query.value("created_at").toString(), Qt::ISODate);
+    event.updatedAt = QDateTime::fromString(query.value("updated_at").toString(), Qt::ISODate);
+    return event;
+}
+
+bool DatabaseManager::recordGames(const QVector<GameRecord> &games)
+{
+    if (games.isEmpty()) {
+        return true;
+    }
+    
+    QSqlQuery query(m_database);
+    query.prepare(RECORD_GAME_SQL);
+    
+    // Local time, so a day's games fall in one created_at range for the report
+    const QString format = "yyyy-MM-dd hh:mm:ss";
+    
+    m_database.transaction();
+    for (const GameRecord &game : games) {
+        QDateTime completedAt = game.completedAt.isValid() ? game.completedAt : QDateTime::currentDateTime();
+        
+        query.addBindValue(game.laneId);
+        query.addBindValue(game.bowlerId > 0 ? QVariant(game.bowlerId) : QVariant());
+        query.addBindValue(game.bowlerName);
+        query.addBindValue(game.leagueId > 0 ? QVariant(game.leagueId) : QVariant());
+        query.addBindValue(game.gameType);
+        query.addBindValue(game.gameNumber);
+        query.addBindValue(game.score);
+        query.addBindValue(game.framesJson);
+        query.addBindValue(game.startedAt.isValid() ? QVariant(game.startedAt.toString(format)) : QVariant());
+        query.addBindValue(completedAt.toString(format));
         
-        conflicts.append(event);
+        if (!query.exec()) {
+            qCritical() << "Failed to record game:" << query.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+        m_reportEngine.invalidate(completedAt.date());
     }
     
-    return conflicts;
+    if (!m_database.commit()) {
+        qCritical() << "Failed to commit games:" << m_database.lastError().text();
+        m_database.rollback();
+        return false;
+    }
+    
+    return true;
+}
+
+DailyReportData DatabaseManager::getDailyReport(const QDate &date, const RateCard &rates)
+{
+    return m_reportEngine.report(m_database, date, rates);
+}
+
+RollupRebuildResult DatabaseManager::rebuildRollups(const QDate &from, const QDate &to, int threadCount)
+{
+    QDate first = from;
+    QDate last = to.isValid() ? to : QDate::currentDate();
+    
+    // No start date means all recorded history
+    if (!first.isValid()) {
+        QSqlQuery query(m_database);
+        if (query.exec(FIRST_GAME_SQL) && query.next() && !query.value(0).isNull()) {
+            first = QDate::fromString(query.value(0).toString().left(10), Qt::ISODate);
+        } else {
+            first = last;
+        }
+    }
+    
+    return RollupBuilder::rebuild(m_database, first, last, threadCount);
+}
+
+QMap<int, RollupTotals> DatabaseManager::getLaneTotals(const QDate &from, const QDate &to)
+{
+    return RollupBuilder::laneTotals(m_database, from, to);
+}
+
+RollupTotals DatabaseManager::getBowlerTotals(int bowlerId, const QDate &from, const QDate &to)
+{
+    return RollupBuilder::bowlerTotals(m_database, bowlerId, from, to);
+}
+
+QMap<QDate, RollupTotals> DatabaseManager::getLeagueWeekTotals(int leagueId, const QDate &from, const QDate &to)
+{
+    return RollupBuilder::leagueWeeks(m_database, leagueId, from, to);
 }
 
 QVector<int> DatabaseManager::addLeagueSchedule(int leagueId, const QString &leagueName, 
@@ -997,57 +1177,104 @@ QVector<int> DatabaseManager::addLeagueSchedule(int leagueId, const QString &lea
                                                int durationMinutes, int frequencyDays, int numberOfWeeks,
                                                const QVector<int> &laneIds, const QString &contactName,
                                                const QString &contactPhone, const QString &contactEmail,
-                                               const QString &additionalDetails)
+                                               const QString &additionalDetails,
+                                               QVector<ScheduleConflict> *conflicts)
 {
     QVector<int> createdEventIds;
     QTime endTime = startTime.addSecs(durationMinutes * 60);
     
+    if (numberOfWeeks <= 0 || laneIds.isEmpty()) {
+        return createdEventIds;
+    }
+    if (durationMinutes <= 0 || durationMinutes >= 24 * 60) {
+        qWarning() << "League nights must last between 1 minute and 24 hours, not" << durationMinutes;
+        return createdEventIds;
+    }
+    
+    // Conflicts are answered from the in-memory index rather than per-row queries
+    if (!ensureCalendarIndex()) {
+        return createdEventIds;
+    }
+    
     m_database.transaction(); // Start transaction for all events
     
-    try {
-        for (int week = 0; week < numberOfWeeks; ++week) {
-            QDate eventDate = startDate.addDays(week * frequencyDays);
+    QSqlQuery insert(m_database);
+    insert.prepare(ADD_EVENT_SQL);
+    
+    // Values shared by every row
+    insert.bindValue(1, startTime.toString("hh:mm:ss"));
+    insert.bindValue(2, endTime.toString("hh:mm:ss"));
+    insert.bindValue(4, "League");
+    insert.bindValue(7, contactName);
+    insert.bindValue(8, contactPhone);
+    insert.bindValue(9, contactEmail);
+    insert.bindValue(10, 4); // Default for league
+    insert.bindValue(11, additionalDetails);
+    insert.bindValue(12, leagueId);
+    insert.bindValue(13, 0);
+    
+    int conflictCount = 0;
+    
+    for (int week = 0; week < numberOfWeeks; ++week) {
+        QDate eventDate = startDate.addDays(week * frequencyDays);
+        QString dateText = eventDate.toString(Qt::ISODate);
+        QString description = QString("Week %1 of %2").arg(week + 1).arg(numberOfWeeks);
+        
+        for (int laneId : laneIds) {
+            CalendarBooking booking = CalendarIndex::makeBooking(0, laneId, eventDate, startTime, endTime);
+            
+            // Check for conflicts
+            QVector<int> overlapping = m_calendarIndex.conflicts(laneId, booking.start, booking.end);
+            if (!overlapping.isEmpty()) {
+                ++conflictCount;
+                if (conflicts) {
+                    ScheduleConflict conflict;
+                    conflict.date = eventDate;
+                    conflict.laneId = laneId;
+                    conflict.weekNumber = week + 1;
+                    conflict.conflictingEventIds = overlapping;
+                    conflicts->append(conflict);
+                }
+                continue;
+            }
             
-            for (int laneId : laneIds) {
-                // Check for conflicts
-                if (!isLaneAvailable(eventDate, startTime, endTime, laneId)) {
-                    qWarning() << "Conflict detected for" << leagueName << "on" << eventDate.toString() 
-                              << "lane" << laneId << "- skipping";
-                    continue;
+            insert.bindValue(0, dateText);
+            insert.bindValue(3, laneId);
+            insert.bindValue(5, QString("%1 - Week %2 - Lane %3").arg(leagueName).arg(week + 1).arg(laneId));
+            insert.bindValue(6, description);
+            
+            if (!insert.exec()) {
+                qCritical() << "Failed to add league event:" << insert.lastError().text();
+                m_database.rollback();
+                for (int eventId : createdEventIds) {
+                    m_calendarIndex.remove(eventId);
                 }
-                
-                // Create event
-                CalendarEventData event;
-                event.date = eventDate;
-                event.startTime = startTime;
-                event.endTime = endTime;
-                event.laneId = laneId;
-                event.eventType = "League";
-                event.title = QString("%1 - Week %2 - Lane %3").arg(leagueName).arg(week + 1).arg(laneId);
-                event.description = QString("Week %1 of %2").arg(week + 1).arg(numberOfWeeks);
-                event.contactName = contactName;
-                event.contactPhone = contactPhone;
-                event.contactEmail = contactEmail;
-                event.bowlerCount = 4; // Default for league
-                event.additionalDetails = additionalDetails;
-                event.leagueId = leagueId;
-                event.teamId = 0;
-                
-                int eventId = addCalendarEvent(event);
-                if (eventId > 0) {
-                    createdEventIds.append(eventId);
+                if (conflicts) {
+                    conflicts->clear();
                 }
+                return QVector<int>();
             }
+            
+            booking.eventId = insert.lastInsertId().toInt();
+            createdEventIds.append(booking.eventId);
+            m_calendarIndex.insert(booking);
+        }
+    }
+    
+    if (!m_database.commit()) { // Commit all events
+        qCritical() << "Error creating league schedule:" << m_database.lastError().text();
+        m_database.rollback();
+        for (int eventId : createdEventIds) {
+            m_calendarIndex.remove(eventId);
         }
-        
-        m_database.commit(); // Commit all events
-        qDebug() << "Successfully created" << createdEventIds.size() << "league events for" << leagueName;
-        
-    } catch (const std::exception &e) {
-        m_database.rollback(); // Rollback on error
-        qCritical() << "Error creating league schedule:" << e.what();
         createdEventIds.clear();
+        return createdEventIds;
     }
     
+    if (conflictCount > 0) {
+        qWarning() << "Skipped" << conflictCount << "conflicting lane bookings for" << leagueName;
+    }
+    qDebug() << "Successfully created" << createdEventIds.size() << "league events for" << leagueName;
+    
     return createdEventIds;
-}
\ No newline at end of file
+}
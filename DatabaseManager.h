@@ -11,6 +11,10 @@
 #include <QDate>
 #include <QTime>
 #include <QDateTime>
+#include "CalendarIndex.h"
+#include "LaneFinder.h"
+#include "DailyReport.h"
+#include "RollupBuilder.h"
 
 struct BowlerData {
     int id;
@@ -67,19 +71,58 @@ struct CalendarEventData {
     CalendarEventData() = default;
 };
 
+// One hit from DatabaseManager::search()
+struct SearchHit {
+    enum Kind {
+        Bowler = 1,
+        Team = 2,
+        CalendarEvent = 3
+    };
+    
+    Kind kind = Bowler;
+    int id = 0;
+    QString title;
+    QString detail;
+    double score = 0.0;  // bm25 rank, lower is better
+};
+
+// A league night that could not be booked because the lane was already taken
+struct ScheduleConflict {
+    QDate date;
+    int laneId = 0;
+    int weekNumber = 0;
+    QVector<int> conflictingEventIds;
+};
+
+// One bowler's completed game, as stored in the games table
+struct GameRecord {
+    int laneId = 0;
+    int bowlerId = 0;        // 0 for walk-in bowlers
+    QString bowlerName;
+    int leagueId = 0;
+    QString gameType;        // "quick_game" or "league_game"
+    int gameNumber = 1;
+    int score = 0;
+    QString framesJson;
+    QDateTime startedAt;
+    QDateTime completedAt;
+};
+
 class DatabaseManager : public QObject
 {
     Q_OBJECT
 
 public:
     static DatabaseManager* instance();
+    static void setDataDirectory(const QString &path);  // Before the first instance(); default AppDataLocation
     
     bool initializeDatabase();
+    bool migrateSchema();   // Applies pending SchemaMigrator versions (PRAGMA user_version)
     bool backupDatabase(const QString& backupPath);
     void closeDatabase();
     
     // Bowler operations
-    QVector<BowlerData> getAllBowlers(const QString &searchFilter = "");
+    QVector<BowlerData> getAllBowlers(const QString &searchFilter = "");   // Filter matches anywhere in a name
     BowlerData getBowlerById(int id);
     int addBowler(const BowlerData &bowler);
     bool updateBowler(const BowlerData &bowler);
@@ -115,6 +158,25 @@ public:
                         int laneId, int excludeEventId = -1);
     QVector<CalendarEventData> getConflictingEvents(const QDate &date, const QTime &startTime, 
                                                    const QTime &endTime, int laneId, int excludeEventId = -1);
+    QDateTime findFirstFreeSlot(const QDateTime &from, const QDateTime &latestStart, int durationMinutes,
+                                const QVector<int> &laneIds, int laneCount = 1,
+                                QVector<int> *freeLanes = nullptr);
+    QVector<LaneBlock> findLaneBlocks(const LaneSearchRequest &request);
+    
+    // Quick search across bowlers, teams and calendar events
+    QVector<SearchHit> search(const QString &text, int limit = 20);
+    bool hasFullTextSearch() const { return m_fullTextSearch; }
+    void setFullTextSearch(bool enabled);   // Off uses the LIKE fallback, as without FTS5
+    
+    // Completed games and the end of day report built from them
+    bool recordGames(const QVector<GameRecord> &games);
+    DailyReportData getDailyReport(const QDate &date, const RateCard &rates = RateCard::load());
+    
+    // Daily/weekly rollups for reports spanning months or seasons
+    RollupRebuildResult rebuildRollups(const QDate &from = QDate(), const QDate &to = QDate(), int threadCount = 0);
+    QMap<int, RollupTotals> getLaneTotals(const QDate &from, const QDate &to);
+    RollupTotals getBowlerTotals(int bowlerId, const QDate &from, const QDate &to);
+    QMap<QDate, RollupTotals> getLeagueWeekTotals(int leagueId, const QDate &from, const QDate &to);
     
     // League schedule integration
     QVector<int> addLeagueSchedule(int leagueId, const QString &leagueName, 
@@ -122,17 +184,31 @@ public:
                                   int durationMinutes, int frequencyDays, int numberOfWeeks,
                                   const QVector<int> &laneIds, const QString &contactName,
                                   const QString &contactPhone, const QString &contactEmail = "",
-                                  const QString &additionalDetails = "");
+                                  const QString &additionalDetails = "",
+                                  QVector<ScheduleConflict> *conflicts = nullptr);
 
 private:
     explicit DatabaseManager(QObject *parent = nullptr);
     ~DatabaseManager();
     
     bool createTables();
-    bool createCalendarEventsTable();
+    QString fullTextQuery(const QString &text) const;
+    CalendarEventData readCalendarEvent(const QSqlQuery &query) const;
+    bool ensureCalendarIndex();
     
     static DatabaseManager* m_instance;
+    static QString m_dataDirectory;
     QSqlDatabase m_database;
+    
+    // Lane bookings for availability checks, loaded on first use
+    CalendarIndex m_calendarIndex;
+    bool m_calendarIndexLoaded = false;
+    
+    // False when the SQLite build lacks FTS5; searches fall back to LIKE
+    bool m_fullTextSearch = false;
+    
+    // Per-day report cache, dropped for a day when games are recorded on it
+    DailyReportEngine m_reportEngine;
 };
 
 #endif // DATABASEMANAGER_H
\ No newline at end of file
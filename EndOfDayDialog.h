@@ -14,38 +14,36 @@
 #include <QTimer>
 #include <QJsonObject>
 #include <QVector>
+#include <QFileDialog>
+#include <QFile>
+#include <QTextStream>
+#include <QFutureWatcher>
+#include "DailyReport.h"
+#include "LaneCommandBatch.h"
+#include "ConsoleClient.h"
 
 class LaneServer;
 class DatabaseManager;
 
-struct EndOfDayStats {
-    int totalGamesPlayed = 0;
-    int quickGames = 0;
-    int leagueGames = 0;
-    int totalBowlers = 0;
-    double averageScore = 0.0;
-    int highGame = 0;
-    QString highGameBowler;
-    int totalRevenue = 0;
-    QVector<int> activeLanes;
-    QMap<int, int> gamesPerLane;
-};
-
 class EndOfDayDialog : public QDialog
 {
     Q_OBJECT
 
 public:
-    explicit EndOfDayDialog(LaneServer *laneServer, QWidget *parent = nullptr);
+    // One of laneServer and consoleClient; attached consoles have the
+    // server shut its lanes down
+    EndOfDayDialog(LaneServer *laneServer, ConsoleClient *consoleClient, QWidget *parent = nullptr);
 
 private slots:
     void onGenerateReportClicked();
+    void onExportReportClicked();
     void onShutdownAllLanesClicked();
     void onBackupDatabaseClicked();
     void onCloseSystemClicked();
     void onCancelClicked();
-    void onLaneShutdownComplete(int laneId);
-    void updateProgress();
+    void onLaneShutdownProgress(int completed);
+    void onLaneShutdownFinished();
+    void onRemoteLanesShutdown(int laneCount, const QVector<int> &failedLanes);
 
 private:
     void setupUI();
@@ -53,10 +51,10 @@ private:
     void shutdownAllLanes();
     void backupDatabase();
     void closeSystem();
-    EndOfDayStats calculateDailyStats();
-    QString formatReportText(const EndOfDayStats &stats);
+    void showShutdownResult(int laneCount, const QVector<int> &failedLanes);
     
     LaneServer *m_laneServer;
+    ConsoleClient *m_consoleClient;
     DatabaseManager *m_dbManager;
     
     // UI Components
@@ -66,6 +64,8 @@ private:
     QGroupBox *m_statsGroup;
     QTextEdit *m_reportText;
     QPushButton *m_generateReportBtn;
+    QPushButton *m_exportReportBtn;
+    DailyReportData m_currentReport;
     
     // Shutdown section
     QGroupBox *m_shutdownGroup;
@@ -83,19 +83,19 @@ private:
     QPushButton *m_cancelBtn;
     
     // State tracking
-    QVector<int> m_pendingShutdowns;
-    QTimer *m_progressTimer;
+    QFutureWatcher<LaneBatchResult> *m_shutdownWatcher;
     int m_totalShutdownSteps;
     int m_completedSteps;
     bool m_shutdownInProgress;
 };
 
 // Implementation
-EndOfDayDialog::EndOfDayDialog(LaneServer *laneServer, QWidget *parent)
+EndOfDayDialog::EndOfDayDialog(LaneServer *laneServer, ConsoleClient *consoleClient, QWidget *parent)
     : QDialog(parent)
     , m_laneServer(laneServer)
+    , m_consoleClient(consoleClient)
     , m_dbManager(DatabaseManager::instance())
-    , m_progressTimer(new QTimer(this))
+    , m_shutdownWatcher(new QFutureWatcher<LaneBatchResult>(this))
     , m_totalShutdownSteps(0)
     , m_completedSteps(0)
     , m_shutdownInProgress(false)
@@ -115,7 +115,14 @@ EndOfDayDialog::EndOfDayDialog(LaneServer *laneServer, QWidget *parent)
     // Generate initial report
     generateDailyReport();
     
-    connect(m_progressTimer, &QTimer::timeout, this, &EndOfDayDialog::updateProgress);
+    connect(m_shutdownWatcher, &QFutureWatcherBase::progressValueChanged,
+            this, &EndOfDayDialog::onLaneShutdownProgress);
+    connect(m_shutdownWatcher, &QFutureWatcherBase::finished,
+            this, &EndOfDayDialog::onLaneShutdownFinished);
+    if (m_consoleClient) {
+        connect(m_consoleClient, &ConsoleClient::lanesShutdown,
+                this, &EndOfDayDialog::onRemoteLanesShutdown);
+    }
 }
 
 void EndOfDayDialog::setupUI()
@@ -163,8 +170,22 @@ void EndOfDayDialog::setupUI()
                                       "}");
     connect(m_generateReportBtn, &QPushButton::clicked, this, &EndOfDayDialog::onGenerateReportClicked);
     
+    m_exportReportBtn = new QPushButton("Export Report...");
+    m_exportReportBtn->setStyleSheet("QPushButton { "
+                                    "background-color: #4B5563; "
+                                    "color: white; "
+                                    "border: none; "
+                                    "padding: 8px 16px; "
+                                    "border-radius: 4px; "
+                                    "}");
+    connect(m_exportReportBtn, &QPushButton::clicked, this, &EndOfDayDialog::onExportReportClicked);
+    
+    QHBoxLayout *reportButtonsLayout = new QHBoxLayout;
+    reportButtonsLayout->addWidget(m_generateReportBtn);
+    reportButtonsLayout->addWidget(m_exportReportBtn);
+    
     statsLayout->addWidget(m_reportText);
-    statsLayout->addWidget(m_generateReportBtn);
+    statsLayout->addLayout(reportButtonsLayout);
     
     m_mainLayout->addWidget(m_statsGroup);
     
@@ -270,97 +291,53 @@ void EndOfDayDialog::setupUI()
 
 void EndOfDayDialog::generateDailyReport()
 {
-    EndOfDayStats stats = calculateDailyStats();
-    QString reportText = formatReportText(stats);
-    m_reportText->setPlainText(reportText);
+    // Cached per day by DatabaseManager; only recomputed when games were added
+    m_currentReport = m_dbManager->getDailyReport(QDate::currentDate());
+    m_reportText->setPlainText(DailyReportEngine::toText(m_currentReport));
 }
 
-EndOfDayStats EndOfDayDialog::calculateDailyStats()
+void EndOfDayDialog::onGenerateReportClicked()
 {
-    EndOfDayStats stats;
-    
-    // This would query the database for today's statistics
-    // For now, using sample data structure
-    
-    QDate today = QDate::currentDate();
-    
-    // Query database for today's games
-    QSqlQuery query;
-    query.prepare("SELECT COUNT(*) as total_games, "
-                 "SUM(CASE WHEN game_type = 'quick_game' THEN 1 ELSE 0 END) as quick_games, "
-                 "SUM(CASE WHEN game_type = 'league_game' THEN 1 ELSE 0 END) as league_games "
-                 "FROM games WHERE DATE(created_at) = ?");
-    query.addBindValue(today.toString("yyyy-MM-dd"));
-    
-    if (query.exec() && query.next()) {
-        stats.totalGamesPlayed = query.value("total_games").toInt();
-        stats.quickGames = query.value("quick_games").toInt();
-        stats.leagueGames = query.value("league_games").toInt();
-    }
-    
-    // Calculate other statistics
-    // Sample data for demonstration
-    stats.totalBowlers = 45;
-    stats.averageScore = 142.5;
-    stats.highGame = 287;
-    stats.highGameBowler = "John Smith";
-    stats.totalRevenue = 1250; // Would calculate from pricing
-    
-    // Active lanes (get from lane server)
-    for (int i = 1; i <= 8; ++i) {
-        stats.activeLanes.append(i);
-        stats.gamesPerLane[i] = 3 + (i % 4); // Sample data
-    }
-    
-    return stats;
+    generateDailyReport();
+    QMessageBox::information(this, "Report Updated", "Daily report has been refreshed with current data.");
 }
 
-QString EndOfDayDialog::formatReportText(const EndOfDayStats &stats)
+void EndOfDayDialog::onExportReportClicked()
 {
-    QString report;
-    QDate today = QDate::currentDate();
-    QTime now = QTime::currentTime();
-    
-    report += "=====================================\n";
-    report += "       CENTRE BOWLING DAILY REPORT\n";
-    report += "=====================================\n";
-    report += QString("Date: %1\n").arg(today.toString("dddd, MMMM dd, yyyy"));
-    report += QString("Time: %1\n\n").arg(now.toString("hh:mm:ss"));
-    
-    report += "GAME STATISTICS:\n";
-    report += "-------------------------------------\n";
-    report += QString("Total Games Played: %1\n").arg(stats.totalGamesPlayed);
-    report += QString("  - Quick Games: %1\n").arg(stats.quickGames);
-    report += QString("  - League Games: %1\n").arg(stats.leagueGames);
-    report += QString("Total Bowlers: %1\n").arg(stats.totalBowlers);
-    report += QString("Average Score: %1\n").arg(stats.averageScore, 0, 'f', 1);
-    report += QString("High Game: %1 (%2)\n\n").arg(stats.highGame).arg(stats.highGameBowler);
-    
-    report += "LANE UTILIZATION:\n";
-    report += "-------------------------------------\n";
-    for (int laneId : stats.activeLanes) {
-        int gamesCount = stats.gamesPerLane.value(laneId, 0);
-        report += QString("Lane %1: %2 games\n").arg(laneId).arg(gamesCount);
+    QString defaultName = QString("daily_report_%1").arg(m_currentReport.date.toString("yyyyMMdd"));
+    QString selectedFilter;
+    QString filePath = QFileDialog::getSaveFileName(this, "Export Daily Report", defaultName,
+                                                    "PDF (*.pdf);;CSV (*.csv);;Text (*.txt)", &selectedFilter);
+    if (filePath.isEmpty()) {
+        return;
     }
-    report += "\n";
     
-    report += "REVENUE SUMMARY:\n";
-    report += "-------------------------------------\n";
-    report += QString("Estimated Revenue: $%1\n").arg(stats.totalRevenue);
-    report += QString("Games Revenue: $%1\n").arg(stats.totalGamesPlayed * 15); // $15 per game estimate
-    report += QString("Shoe Rentals: $%1\n").arg(stats.totalBowlers * 4); // $4 per rental estimate
-    report += "\n";
-    
-    report += "=====================================\n";
-    report += "Report generated at: " + QDateTime::currentDateTime().toString("hh:mm:ss") + "\n";
+    bool success = false;
+    if (selectedFilter.startsWith("PDF") || filePath.endsWith(".pdf", Qt::CaseInsensitive)) {
+        if (!filePath.endsWith(".pdf", Qt::CaseInsensitive)) {
+            filePath += ".pdf";
+        }
+        success = DailyReportEngine::toPdf(m_currentReport, filePath);
+    } else {
+        bool csv = selectedFilter.startsWith("CSV") || filePath.endsWith(".csv", Qt::CaseInsensitive);
+        QString extension = csv ? ".csv" : ".txt";
+        if (!filePath.endsWith(extension, Qt::CaseInsensitive)) {
+            filePath += extension;
+        }
+        
+        QFile file(filePath);
+        if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            QTextStream out(&file);
+            out << (csv ? DailyReportEngine::toCsv(m_currentReport) : DailyReportEngine::toText(m_currentReport));
+            success = true;
+        }
+    }
     
-    return report;
-}
-
-void EndOfDayDialog::onGenerateReportClicked()
-{
-    generateDailyReport();
-    QMessageBox::information(this, "Report Updated", "Daily report has been refreshed with current data.");
+    if (success) {
+        QMessageBox::information(this, "Report Exported", QString("Daily report saved to:\n%1").arg(filePath));
+    } else {
+        QMessageBox::warning(this, "Export Failed", QString("Could not write %1").arg(filePath));
+    }
 }
 
 void EndOfDayDialog::onShutdownAllLanesClicked()
@@ -423,9 +400,24 @@ void EndOfDayDialog::shutdownAllLanes()
     m_shutdownInProgress = true;
     m_completedSteps = 0;
     
-    // Calculate total steps
-    EndOfDayStats stats = calculateDailyStats();
-    m_totalShutdownSteps = stats.activeLanes.size();
+    // Attached: the server runs the same acked shutdown and reports back
+    if (!m_laneServer) {
+        if (!m_consoleClient || !m_consoleClient->requestLaneShutdown()) {
+            QMessageBox::warning(this, "Not Connected", "This console is not attached to the lane server.");
+            m_shutdownInProgress = false;
+            return;
+        }
+        m_progressBar->setVisible(true);
+        m_progressBar->setRange(0, 0);
+        m_progressLabel->setText("Shutting down lanes on the server...");
+        m_shutdownAllBtn->setEnabled(false);
+        m_closeSystemBtn->setEnabled(false);
+        return;
+    }
+    
+    // Every lane still connected to the server gets a shutdown command
+    QVector<int> activeLanes = m_laneServer->connectedLanes();
+    m_totalShutdownSteps = activeLanes.size();
     
     if (m_totalShutdownSteps == 0) {
         QMessageBox::information(this, "No Active Lanes", "All lanes are already shutdown.");
@@ -443,53 +435,67 @@ void EndOfDayDialog::shutdownAllLanes()
     m_shutdownAllBtn->setEnabled(false);
     m_closeSystemBtn->setEnabled(false);
     
-    // Start shutdown process
-    m_pendingShutdowns = stats.activeLanes;
-    
-    // Connect to lane server signals for shutdown completion
-    connect(m_laneServer, &LaneServer::laneShutdown,
-            this, &EndOfDayDialog::onLaneShutdownComplete);
-    
-    // Send shutdown commands to all active lanes
-    for (int laneId : stats.activeLanes) {
-        QJsonObject shutdownData;
-        shutdownData["lane_id"] = laneId;
-        shutdownData["command"] = "shutdown";
-        
-        // Send via the lane server
-        QTimer::singleShot(laneId * 500, [this, shutdownData]() {
-            if (m_laneServer) {
-                m_laneServer->onLaneCommand(shutdownData);
-            }
-        });
-    }
-    
-    // Start progress update timer
-    m_progressTimer->start(500);
+    // Lanes are shut down in parallel; each has an ack deadline and is retried before it counts as failed
+    m_shutdownWatcher->setFuture(m_laneServer->shutdownLanes(activeLanes));
 }
 
-void EndOfDayDialog::onLaneShutdownComplete(int laneId)
+void EndOfDayDialog::onLaneShutdownProgress(int completed)
 {
-    m_pendingShutdowns.removeOne(laneId);
-    m_completedSteps++;
+    m_completedSteps = completed;
     
     m_progressBar->setValue(m_completedSteps);
     m_progressLabel->setText(QString("Shutting down lanes... (%1/%2)")
                             .arg(m_completedSteps).arg(m_totalShutdownSteps));
-    
-    if (m_pendingShutdowns.isEmpty()) {
-        // All lanes shutdown complete
-        m_progressTimer->stop();
-        m_progressLabel->setText("All lanes shutdown complete!");
+}
+
+void EndOfDayDialog::onLaneShutdownFinished()
+{
+    LaneBatchResult result = m_shutdownWatcher->result();
+    showShutdownResult(m_totalShutdownSteps, result.failed);
+}
+
+void EndOfDayDialog::onRemoteLanesShutdown(int laneCount, const QVector<int> &failedLanes)
+{
+    if (!m_shutdownInProgress) {
+        return; // Another console's End of Day
+    }
+    if (laneCount == 0) {
+        m_progressBar->setVisible(false);
         m_shutdownInProgress = false;
-        
-        // Re-enable buttons
         m_shutdownAllBtn->setEnabled(true);
         m_closeSystemBtn->setEnabled(true);
-        
+        QMessageBox::information(this, "No Active Lanes", "All lanes are already shutdown.");
+        return;
+    }
+    m_progressBar->setRange(0, laneCount);
+    showShutdownResult(laneCount, failedLanes);
+}
+
+void EndOfDayDialog::showShutdownResult(int laneCount, const QVector<int> &failedLanes)
+{
+    m_progressBar->setValue(laneCount);
+    m_shutdownInProgress = false;
+    
+    // Re-enable buttons
+    m_shutdownAllBtn->setEnabled(true);
+    m_closeSystemBtn->setEnabled(true);
+    
+    if (failedLanes.isEmpty()) {
+        m_progressLabel->setText("All lanes shutdown complete!");
         QMessageBox::information(this, "Shutdown Complete", 
                                "All active lanes have been shutdown successfully.");
+        return;
+    }
+    
+    QStringList lanes;
+    for (int laneId : failedLanes) {
+        lanes << QString::number(laneId);
     }
+    m_progressLabel->setText(QString("%1 of %2 lanes did not respond")
+                            .arg(failedLanes.size()).arg(laneCount));
+    QMessageBox::warning(this, "Shutdown Incomplete",
+                        QString("These lanes did not acknowledge the shutdown command:\n%1\n\n"
+                                "Check them before leaving.").arg(lanes.join(", ")));
 }
 
 void EndOfDayDialog::backupDatabase()
@@ -568,15 +574,4 @@ void EndOfDayDialog::closeSystem()
     });
 }
 
-void EndOfDayDialog::updateProgress()
-{
-    // Update progress display during shutdown
-    if (m_shutdownInProgress && !m_pendingShutdowns.isEmpty()) {
-        // Show current shutdown status
-        QString status = QString("Shutting down lanes: %1 remaining")
-                        .arg(m_pendingShutdowns.size());
-        m_progressLabel->setText(status);
-    }
-}
-
 #endif // ENDOFDAYDIALOG_H
\ No newline at end of file
@@ -1,10 +1,254 @@
 ﻿// EventBus.cpp
 #include "EventBus.h"
+#include <QCoreApplication>
+#include <QThread>
+#include <QMutexLocker>
+#include <QMetaObject>
 
-EventBus::EventBus(QObject *parent) : QObject(parent) {}
+EventBus *EventBus::m_instance = nullptr;
 
-bool EventBus::publish(const QString &channel, const QString &event, const QJsonObject &data)
+EventBus::EventBus(QObject *parent)
+    : QObject(parent)
+    , m_head(&m_stub)
+    , m_tail(&m_stub)
+    , m_flushScheduled(0)
+    , m_nextSubscriptionId(1)
+    , m_published(0)
+    , m_delivered(0)
+    , m_flushes(0)
+    , m_crossThreadBatches(0)
 {
-    emit eventReceived(channel, event, data);
-    return true;
-}
\ No newline at end of file
+}
+
+EventBus::~EventBus()
+{
+    while (Node *node = pop()) {
+        delete node;
+    }
+    if (m_instance == this) {
+        m_instance = nullptr;
+    }
+}
+
+EventBus *EventBus::instance()
+{
+    if (!m_instance) {
+        m_instance = new EventBus();
+        // Freed with the application, after every subscriber's window is gone
+        qAddPostRoutine([]() { delete m_instance; });
+    }
+    return m_instance;
+}
+
+void EventBus::enqueue(const void *type, BusChannel channel, EventPtr event)
+{
+    Node *node = new Node;
+    node->type = type;
+    node->channel = channel;
+    node->event = std::move(event);
+    push(node);
+    m_published.fetchAndAddRelaxed(1);
+
+    // Only the first publish since the last flush posts one
+    if (m_flushScheduled.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+}
+
+void EventBus::push(Node *node)
+{
+    // Multi-producer, single-consumer (Vyukov): one atomic swap, then link
+    node->next.storeRelaxed(nullptr);
+    Node *previous = m_head.fetchAndStoreOrdered(node);
+    previous->next.storeRelease(node);
+}
+
+EventBus::Node *EventBus::pop()
+{
+    Node *tail = m_tail;
+    Node *next = tail->next.loadAcquire();
+
+    if (tail == &m_stub) {
+        if (!next) {
+            return nullptr;
+        }
+        m_tail = next;
+        tail = next;
+        next = next->next.loadAcquire();
+    }
+
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+
+    // A producer has swapped the head but not linked yet; pick it up next flush
+    if (tail != m_head.loadAcquire()) {
+        return nullptr;
+    }
+
+    push(&m_stub);
+    next = tail->next.loadAcquire();
+    if (next) {
+        m_tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+int EventBus::subscribeChannel(QObject *context, BusChannel channel, const BusFilter &filter,
+                               std::function<void(const BusEvent &)> handler)
+{
+    return addSubscription(context, nullptr, channel, filter, std::move(handler));
+}
+
+int EventBus::addSubscription(QObject *context, const void *type, BusChannel channel, const BusFilter &filter,
+                              std::function<void(const BusEvent &)> handler)
+{
+    Subscription subscription;
+    subscription.type = type;
+    subscription.filter = filter;
+    subscription.context = context;
+    subscription.handler = std::move(handler);
+
+    {
+        QMutexLocker locker(&m_subscriptionMutex);
+        subscription.id = m_nextSubscriptionId++;
+        if (type) {
+            m_byType[type].append(subscription);
+        } else {
+            m_byChannel[static_cast<int>(channel)].append(subscription);
+        }
+    }
+
+    const int id = subscription.id;
+    if (context) {
+        connect(context, &QObject::destroyed, this, [this, id]() { unsubscribe(id); });
+    }
+    return id;
+}
+
+void EventBus::unsubscribe(int subscriptionId)
+{
+    QMutexLocker locker(&m_subscriptionMutex);
+
+    auto remove = [subscriptionId](QVector<Subscription> &subscriptions) {
+        for (int i = 0; i < subscriptions.size(); ++i) {
+            if (subscriptions[i].id == subscriptionId) {
+                subscriptions.remove(i);
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (QVector<Subscription> &subscriptions : m_byType) {
+        if (remove(subscriptions)) {
+            return;
+        }
+    }
+    for (QVector<Subscription> &subscriptions : m_byChannel) {
+        if (remove(subscriptions)) {
+            return;
+        }
+    }
+}
+
+BusStats EventBus::stats() const
+{
+    QMutexLocker locker(&m_subscriptionMutex);
+    BusStats stats;
+    stats.published = m_published.loadRelaxed();
+    stats.delivered = m_delivered;
+    stats.flushes = m_flushes;
+    stats.crossThreadBatches = m_crossThreadBatches;
+    return stats;
+}
+
+void EventBus::flush()
+{
+    // Cleared first, so anything published while draining schedules the next flush
+    m_flushScheduled.storeRelease(0);
+
+    QVector<Node *> batch;
+    while (Node *node = pop()) {
+        batch.append(node);
+    }
+    if (m_head.loadAcquire() != m_tail && m_flushScheduled.testAndSetOrdered(0, 1)) {
+        QMetaObject::invokeMethod(this, "flush", Qt::QueuedConnection);
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    // Match under the lock, deliver outside it so handlers may subscribe
+    struct Delivery {
+        QPointer<QObject> context;
+        std::function<void(const BusEvent &)> handler;
+        QVector<EventPtr> events;
+    };
+    QHash<int, Delivery> deliveries;
+    QVector<int> order;
+
+    {
+        QMutexLocker locker(&m_subscriptionMutex);
+        for (Node *node : batch) {
+            auto match = [&](const QVector<Subscription> &subscriptions) {
+                for (const Subscription &subscription : subscriptions) {
+                    if (!subscription.filter.matches(*node->event)) {
+                        continue;
+                    }
+                    auto delivery = deliveries.find(subscription.id);
+                    if (delivery == deliveries.end()) {
+                        delivery = deliveries.insert(subscription.id,
+                                                     {subscription.context, subscription.handler, {}});
+                        order.append(subscription.id);
+                    }
+                    delivery->events.append(node->event);
+                }
+            };
+
+            // Only subscribers of this type or channel are looked at
+            auto typed = m_byType.constFind(node->type);
+            if (typed != m_byType.constEnd()) {
+                match(typed.value());
+            }
+            auto channel = m_byChannel.constFind(static_cast<int>(node->channel));
+            if (channel != m_byChannel.constEnd()) {
+                match(channel.value());
+            }
+        }
+        m_flushes++;
+    }
+    qDeleteAll(batch);
+
+    quint64 delivered = 0;
+    quint64 crossThread = 0;
+    for (int id : order) {
+        const Delivery &delivery = deliveries[id];
+        if (!delivery.context) {
+            continue;
+        }
+        delivered += delivery.events.size();
+
+        if (delivery.context->thread() == QThread::currentThread()) {
+            for (const EventPtr &event : delivery.events) {
+                delivery.handler(*event);
+            }
+        } else {
+            // One queued call per subscriber, not one per event
+            const std::function<void(const BusEvent &)> handler = delivery.handler;
+            const QVector<EventPtr> events = delivery.events;
+            QMetaObject::invokeMethod(delivery.context, [handler, events]() {
+                for (const EventPtr &event : events) {
+                    handler(*event);
+                }
+            }, Qt::QueuedConnection);
+            crossThread++;
+        }
+    }
+
+    QMutexLocker locker(&m_subscriptionMutex);
+    m_delivered += delivered;
+    m_crossThreadBatches += crossThread;
+}
@@ -3,18 +3,144 @@
 #define EVENTBUS_H
 
 #include <QObject>
-#include <QJsonObject>
+#include <QPointer>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QAtomicPointer>
+#include <QAtomicInt>
+#include <functional>
+#include <memory>
 
+enum class BusChannel {
+    Lanes,          // Connection and status changes
+    Games,          // Scores as lanes report them
+    League,         // Events, standings, statistics
+    System
+};
+
+// Base of every event on the bus. Concrete events (see BusEvents.h) add their
+// own fields and a static `channel`; laneId and leagueId are 0 when they do
+// not apply and are what subscriptions filter on.
+struct BusEvent {
+    virtual ~BusEvent() = default;
+    int laneId = 0;
+    int leagueId = 0;
+};
+
+struct BusFilter {
+    int laneId = 0;                 // 0 = every lane
+    int leagueId = 0;               // 0 = every league
+
+    static BusFilter any() { return BusFilter(); }
+    static BusFilter lane(int id) { BusFilter filter; filter.laneId = id; return filter; }
+    static BusFilter league(int id) { BusFilter filter; filter.leagueId = id; return filter; }
+
+    bool matches(const BusEvent &event) const
+    {
+        return (laneId == 0 || laneId == event.laneId) && (leagueId == 0 || leagueId == event.leagueId);
+    }
+};
+
+struct BusStats {
+    quint64 published = 0;
+    quint64 delivered = 0;
+    quint64 flushes = 0;
+    quint64 crossThreadBatches = 0;
+};
+
+// Typed publish/subscribe between LaneServer, LeagueManager and the UI.
+//
+// publish() may be called from any thread: the event goes onto a lock-free
+// multi-producer queue and the first publish after a flush schedules one
+// flush on the bus's thread. A flush drains everything queued since the last
+// one and delivers each subscriber its matching events in order - directly
+// when the subscriber lives on the bus's thread, otherwise as one queued call
+// per subscriber carrying the whole batch. Subscriptions end when their
+// context object is destroyed.
 class EventBus : public QObject
 {
     Q_OBJECT
 
 public:
     explicit EventBus(QObject *parent = nullptr);
-    bool publish(const QString &channel, const QString &event, const QJsonObject &data);
+    ~EventBus();
+
+    static EventBus *instance();
+
+    template <typename T>
+    void publish(const T &event)
+    {
+        enqueue(typeKey<T>(), T::channel, std::make_shared<T>(event));
+    }
+
+    // Events of one type
+    template <typename T>
+    int subscribe(QObject *context, const BusFilter &filter, std::function<void(const T &)> handler)
+    {
+        return addSubscription(context, typeKey<T>(), T::channel, filter,
+                               [handler](const BusEvent &event) { handler(static_cast<const T &>(event)); });
+    }
+
+    // Every event on a channel
+    int subscribeChannel(QObject *context, BusChannel channel, const BusFilter &filter,
+                         std::function<void(const BusEvent &)> handler);
+
+    void unsubscribe(int subscriptionId);
+
+    BusStats stats() const;
+
+private slots:
+    void flush();
+
+private:
+    using EventPtr = std::shared_ptr<const BusEvent>;
+
+    struct Node {
+        const void *type = nullptr;
+        BusChannel channel = BusChannel::System;
+        EventPtr event;
+        QAtomicPointer<Node> next;
+    };
+
+    struct Subscription {
+        int id = 0;
+        const void *type = nullptr;     // nullptr = whole channel
+        BusFilter filter;
+        QPointer<QObject> context;
+        std::function<void(const BusEvent &)> handler;
+    };
+
+    template <typename T>
+    static const void *typeKey()
+    {
+        static const char key = 0;  // One address per event type
+        return &key;
+    }
+
+    void enqueue(const void *type, BusChannel channel, EventPtr event);
+    void push(Node *node);
+    Node *pop();
+    int addSubscription(QObject *context, const void *type, BusChannel channel, const BusFilter &filter,
+                        std::function<void(const BusEvent &)> handler);
+
+    // Queue: producers swap m_head, the flush walks from m_tail
+    Node m_stub;
+    QAtomicPointer<Node> m_head;
+    Node *m_tail;
+    QAtomicInt m_flushScheduled;
+
+    mutable QMutex m_subscriptionMutex;
+    QHash<const void *, QVector<Subscription>> m_byType;
+    QHash<int, QVector<Subscription>> m_byChannel;
+    int m_nextSubscriptionId;
+
+    QAtomicInteger<quint64> m_published;
+    quint64 m_delivered;
+    quint64 m_flushes;
+    quint64 m_crossThreadBatches;
 
-signals:
-    void eventReceived(const QString &channel, const QString &event, const QJsonObject &data);
+    static EventBus *m_instance;
 };
 
-#endif // EVENTBUS_H
\ No newline at end of file
+#endif // EVENTBUS_H
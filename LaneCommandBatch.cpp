@@ -0,0 +1,136 @@
+﻿// LaneCommandBatch.cpp
+#include "LaneCommandBatch.h"
+#include <QTimer>
+#include <QDebug>
+
+LaneCommandBatch::LaneCommandBatch(int batchId, const QVector<int> &laneIds, const QString &command,
+                                   const QJsonObject &data, const QString &ackType,
+                                   const LaneBatchOptions &options, Sender sender, QObject *parent)
+    : QObject(parent)
+    , m_id(batchId)
+    , m_command(command)
+    , m_data(data)
+    , m_ackType(ackType)
+    , m_options(options)
+    , m_sender(std::move(sender))
+    , m_total(0)
+{
+    // Lanes echo batch_id in their ack when they support it
+    m_data["batch_id"] = batchId;
+    m_result.command = command;
+
+    for (int laneId : laneIds) {
+        if (!m_queued.contains(laneId)) {
+            m_queued.enqueue(laneId);
+        }
+    }
+    m_total = m_queued.size();
+}
+
+LaneCommandBatch::~LaneCommandBatch()
+{
+    // Destroyed early (server stopped): whatever is still pending has failed
+    if (!m_promise.isFinished()) {
+        for (int laneId : m_queued) {
+            m_result.failed.append(laneId);
+        }
+        for (auto it = m_inFlight.constBegin(); it != m_inFlight.constEnd(); ++it) {
+            m_result.failed.append(it.key());
+        }
+        m_result.elapsedMs = m_timer.isValid() ? m_timer.elapsed() : 0;
+        m_promise.reportResult(m_result);
+        m_promise.reportFinished();
+    }
+}
+
+void LaneCommandBatch::start()
+{
+    m_timer.start();
+    m_promise.reportStarted();
+    m_promise.setProgressRange(0, m_total);
+    m_promise.setProgressValue(0);
+
+    if (m_total == 0) {
+        m_promise.reportResult(m_result);
+        m_promise.reportFinished();
+        emit finished(m_id);
+        return;
+    }
+
+    sendNext();
+}
+
+void LaneCommandBatch::sendNext()
+{
+    while (!m_queued.isEmpty() && (m_options.maxParallel <= 0 || m_inFlight.size() < m_options.maxParallel)) {
+        send(m_queued.dequeue());
+    }
+}
+
+void LaneCommandBatch::send(int laneId)
+{
+    const int attempt = m_inFlight.value(laneId, 0) + 1;
+    m_inFlight[laneId] = attempt;
+    m_result.attempts[laneId] = attempt;
+
+    if (!m_sender(laneId, m_command, m_data)) {
+        qWarning() << "Batch" << m_id << m_command << "could not reach lane" << laneId << "attempt" << attempt;
+    }
+
+    QTimer::singleShot(m_options.ackTimeoutMs, this, [this, laneId, attempt]() {
+        onDeadline(laneId, attempt);
+    });
+}
+
+void LaneCommandBatch::onDeadline(int laneId, int attempt)
+{
+    // A later attempt has its own deadline, and an acked lane is gone from the map
+    if (m_inFlight.value(laneId) != attempt) {
+        return;
+    }
+
+    if (attempt <= m_options.maxRetries) {
+        qDebug() << "Lane" << laneId << "did not ack" << m_command << "- retrying";
+        send(laneId);
+    } else {
+        qWarning() << "Lane" << laneId << "did not ack" << m_command << "after" << attempt << "attempts";
+        finishLane(laneId, false);
+    }
+}
+
+bool LaneCommandBatch::acknowledge(int laneId)
+{
+    if (!m_inFlight.contains(laneId)) {
+        return false;
+    }
+
+    finishLane(laneId, true);
+    return true;
+}
+
+void LaneCommandBatch::finishLane(int laneId, bool acknowledged)
+{
+    m_inFlight.remove(laneId);
+    if (acknowledged) {
+        m_result.acknowledged.append(laneId);
+    } else {
+        m_result.failed.append(laneId);
+    }
+
+    const int done = m_result.acknowledged.size() + m_result.failed.size();
+    m_promise.setProgressValue(done);
+    emit laneFinished(m_id, laneId, acknowledged);
+
+    if (done == m_total) {
+        m_result.elapsedMs = m_timer.elapsed();
+        m_promise.reportResult(m_result);
+        m_promise.reportFinished();
+
+        qDebug() << "Batch" << m_id << m_command << "finished:" << m_result.acknowledged.size() << "acked,"
+                 << m_result.failed.size() << "failed," << m_result.elapsedMs << "ms";
+        emit finished(m_id);
+        return;
+    }
+
+    sendNext();
+}
@@ -0,0 +1,83 @@
+﻿// LaneCommandBatch.h
+#ifndef LANECOMMANDBATCH_H
+#define LANECOMMANDBATCH_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QHash>
+#include <QQueue>
+#include <QJsonObject>
+#include <QElapsedTimer>
+#include <QFuture>
+#include <QFutureInterface>
+#include <functional>
+
+struct LaneBatchOptions {
+    int maxParallel = 8;        // Lanes waiting on an ack at once; 0 sends to every lane up front
+    int ackTimeoutMs = 3000;    // Deadline for each attempt
+    int maxRetries = 2;         // Resends after the first attempt times out
+};
+
+struct LaneBatchResult {
+    QString command;
+    QVector<int> acknowledged;
+    QVector<int> failed;        // No ack after the last retry
+    QMap<int, int> attempts;    // laneId -> sends
+    qint64 elapsedMs = 0;
+
+    bool allAcknowledged() const { return failed.isEmpty(); }
+};
+
+// Sends one command to a set of lanes and tracks the acks. At most
+// maxParallel lanes are outstanding at a time; each send gets its own
+// deadline and is repeated up to maxRetries times before the lane is marked
+// failed. The future reports progress as lanes finish and holds the result
+// once every lane has acked or failed.
+class LaneCommandBatch : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Returns false when the lane is not connected; that attempt still waits out its deadline
+    using Sender = std::function<bool(int laneId, const QString &command, const QJsonObject &data)>;
+
+    LaneCommandBatch(int batchId, const QVector<int> &laneIds, const QString &command, const QJsonObject &data,
+                     const QString &ackType, const LaneBatchOptions &options, Sender sender,
+                     QObject *parent = nullptr);
+    ~LaneCommandBatch();
+
+    int id() const { return m_id; }
+    QString ackType() const { return m_ackType; }
+    QFuture<LaneBatchResult> future() { return m_promise.future(); }
+
+    void start();
+    bool acknowledge(int laneId);   // True if the lane was waiting on this batch
+
+signals:
+    void laneFinished(int batchId, int laneId, bool acknowledged);
+    void finished(int batchId);
+
+private:
+    void sendNext();
+    void send(int laneId);
+    void onDeadline(int laneId, int attempt);
+    void finishLane(int laneId, bool acknowledged);
+
+    int m_id;
+    QString m_command;
+    QJsonObject m_data;
+    QString m_ackType;
+    LaneBatchOptions m_options;
+    Sender m_sender;
+
+    QQueue<int> m_queued;
+    QHash<int, int> m_inFlight;     // laneId -> attempt number
+    int m_total;
+    LaneBatchResult m_result;
+    QElapsedTimer m_timer;
+    QFutureInterface<LaneBatchResult> m_promise;
+};
+
+#endif // LANECOMMANDBATCH_H
@@ -0,0 +1,181 @@
+﻿// LaneFinder.cpp
+#include "LaneFinder.h"
+#include <QSet>
+#include <algorithm>
+
+namespace {
+
+const int MAX_SEARCH_DAYS = 366;
+const int SPREAD_PENALTY = 30;  // Score per lane of gap inside a block
+
+struct FreeGap {
+    qint64 start;
+    qint64 end;
+};
+
+// Free time on one lane inside [windowStart, windowEnd)
+QVector<FreeGap> freeGaps(const CalendarIndex &index, int laneId, qint64 windowStart, qint64 windowEnd)
+{
+    QVector<FreeGap> gaps;
+    qint64 cursor = windowStart;
+
+    // Bookings come back ordered by start time
+    for (const CalendarBooking &booking : index.bookings(laneId, windowStart, windowEnd)) {
+        if (booking.start > cursor) {
+            gaps.append({cursor, booking.start});
+        }
+        cursor = qMax(cursor, booking.end);
+    }
+    if (cursor < windowEnd) {
+        gaps.append({cursor, windowEnd});
+    }
+    return gaps;
+}
+
+qint64 dayMinutes(const QDate &date, const QTime &time, const QTime &dayStart)
+{
+    qint64 minutes = CalendarIndex::toMinutes(date, time);
+    if (time < dayStart) {
+        minutes += 24 * 60; // Past midnight belongs to the previous business day
+    }
+    return minutes;
+}
+
+bool overlapsChosen(const QVector<LaneBlock> &chosen, const LaneBlock &block)
+{
+    for (const LaneBlock &other : chosen) {
+        if (other.laneIds == block.laneIds && other.start < block.end && block.start < other.end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace
+
+int LaneFinder::lanesNeeded(const LaneSearchRequest &request)
+{
+    int perLane = qMax(1, request.bowlersPerLane);
+    return qMax(1, (request.partySize + perLane - 1) / perLane);
+}
+
+QVector<LaneBlock> LaneFinder::search(const CalendarIndex &index, const LaneSearchRequest &request)
+{
+    QVector<LaneBlock> results;
+
+    const int needed = lanesNeeded(request);
+    const int step = qMax(5, request.stepMinutes);
+    if (needed > request.laneIds.size() || request.durationMinutes <= 0
+        || !request.fromDate.isValid() || request.toDate < request.fromDate) {
+        return results;
+    }
+
+    QVector<int> lanes = request.laneIds;
+    std::sort(lanes.begin(), lanes.end());
+
+    const QTime windowStart = request.windowStart.isValid() ? request.windowStart : QTime(0, 0);
+    const QTime windowEnd = request.windowEnd.isValid() ? request.windowEnd : windowStart;
+    const QTime preferred = request.preferredStart.isValid() ? request.preferredStart : windowStart;
+
+    QDate lastDate = qMin(request.toDate, request.fromDate.addDays(MAX_SEARCH_DAYS - 1));
+
+    for (QDate date = request.fromDate; date <= lastDate; date = date.addDays(1)) {
+        CalendarBooking window = CalendarIndex::makeBooking(0, 0, date, windowStart, windowEnd);
+        if (!window.isValid()) {
+            window.end = window.start + 24 * 60; // No window end: the whole day from windowStart
+        }
+        qint64 latestStart = window.end - request.durationMinutes;
+        if (latestStart < window.start) {
+            continue;
+        }
+        qint64 preferredMinutes = dayMinutes(date, preferred, windowStart);
+
+        // Free gaps per lane, computed once per day
+        QVector<QVector<FreeGap>> gaps(lanes.size());
+        QSet<qint64> candidateSet;
+        for (qint64 t = window.start; t <= latestStart; t += step) {
+            candidateSet.insert(t);
+        }
+        for (int i = 0; i < lanes.size(); ++i) {
+            gaps[i] = freeGaps(index, lanes[i], window.start, window.end);
+            for (const FreeGap &gap : gaps[i]) {
+                if (gap.start <= latestStart) {
+                    candidateSet.insert(gap.start); // Right after a booking ends
+                }
+            }
+        }
+
+        QVector<qint64> candidates = candidateSet.values().toVector();
+        std::sort(candidates.begin(), candidates.end());
+
+        QVector<LaneBlock> dayBlocks;
+        QVector<int> gapCursor(lanes.size(), 0);
+        QVector<int> freeLanes;
+        freeLanes.reserve(lanes.size());
+
+        for (qint64 start : candidates) {
+            const qint64 end = start + request.durationMinutes;
+
+            // Candidates rise, so a gap too short for this one is too short for the rest
+            freeLanes.clear();
+            for (int i = 0; i < lanes.size(); ++i) {
+                int &p = gapCursor[i];
+                while (p < gaps[i].size() && gaps[i][p].end < end) {
+                    ++p;
+                }
+                if (p < gaps[i].size() && gaps[i][p].start <= start) {
+                    freeLanes.append(lanes[i]);
+                }
+            }
+            if (freeLanes.size() < needed) {
+                continue;
+            }
+
+            // Tightest run of free lanes by lane number
+            int bestFirst = 0;
+            for (int i = 1; i + needed <= freeLanes.size(); ++i) {
+                if (freeLanes[i + needed - 1] - freeLanes[i]
+                    < freeLanes[bestFirst + needed - 1] - freeLanes[bestFirst]) {
+                    bestFirst = i;
+                }
+            }
+            int extraSpread = freeLanes[bestFirst + needed - 1] - freeLanes[bestFirst] - (needed - 1);
+            if (request.requireAdjacent && extraSpread > 0) {
+                continue;
+            }
+
+            LaneBlock block;
+            block.start = CalendarIndex::fromMinutes(start);
+            block.end = CalendarIndex::fromMinutes(end);
+            block.laneIds = freeLanes.mid(bestFirst, needed);
+            block.adjacent = (extraSpread == 0);
+            block.score = static_cast<int>(qAbs(start - preferredMinutes)) + extraSpread * SPREAD_PENALTY;
+            dayBlocks.append(block);
+        }
+
+        std::stable_sort(dayBlocks.begin(), dayBlocks.end(), [](const LaneBlock &a, const LaneBlock &b) {
+            return a.score < b.score;
+        });
+
+        // Keep a few distinct options per day rather than every 15 minute shift
+        QVector<LaneBlock> chosen;
+        for (const LaneBlock &block : dayBlocks) {
+            if (chosen.size() >= request.maxResultsPerDay) {
+                break;
+            }
+            if (!overlapsChosen(chosen, block)) {
+                chosen.append(block);
+            }
+        }
+        results += chosen;
+    }
+
+    std::stable_sort(results.begin(), results.end(), [](const LaneBlock &a, const LaneBlock &b) {
+        return a.score != b.score ? a.score < b.score : a.start < b.start;
+    });
+    if (request.maxResults > 0 && results.size() > request.maxResults) {
+        results.resize(request.maxResults);
+    }
+
+    return results;
+}
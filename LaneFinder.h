@@ -0,0 +1,45 @@
+﻿// LaneFinder.h
+#ifndef LANEFINDER_H
+#define LANEFINDER_H
+
+#include <QVector>
+#include <QDate>
+#include <QTime>
+#include <QDateTime>
+#include "CalendarIndex.h"
+
+struct LaneSearchRequest {
+    int partySize = 1;
+    int bowlersPerLane = 6;
+    int durationMinutes = 120;
+    QDate fromDate;
+    QDate toDate;
+    QTime windowStart;          // Earliest start each day
+    QTime windowEnd;            // Latest finish; at or before windowStart means after midnight
+    QTime preferredStart;       // Ranks results by closeness; defaults to windowStart
+    int stepMinutes = 15;       // Start time granularity
+    QVector<int> laneIds;       // Lanes to consider, in physical order
+    bool requireAdjacent = false;
+    int maxResults = 20;
+    int maxResultsPerDay = 3;
+};
+
+struct LaneBlock {
+    QDateTime start;
+    QDateTime end;
+    QVector<int> laneIds;
+    bool adjacent = false;
+    int score = 0;              // Lower is better
+};
+
+// Searches the calendar index for lane blocks that fit a group booking.
+// Each lane's free gaps inside the daily window are computed once, then every
+// candidate start is checked against those gaps, so no SQL runs per candidate.
+class LaneFinder
+{
+public:
+    static int lanesNeeded(const LaneSearchRequest &request);
+    static QVector<LaneBlock> search(const CalendarIndex &index, const LaneSearchRequest &request);
+};
+
+#endif // LANEFINDER_H
@@ -1,4 +1,7 @@
 ﻿#include "LaneServer.h"
+#include "StandingsPublisher.h"
+#include "ConsoleHub.h"
+#include "BusEvents.h"
 #include <QJsonDocument>
 #include <QJsonArray>
 #include <QHostAddress>
@@ -6,6 +9,7 @@
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTimer>
+#include <QElapsedTimer>
 
 LaneServer::LaneServer(QObject *parent)
     : QObject(parent)
@@ -24,8 +28,42 @@ LaneServer::LaneServer(QObject *parent)
             });
     connect(m_leagueManager, &LeagueManager::leagueCreated,
             this, &LaneServer::onLeagueCreated);
-    connect(m_leagueManager, &LeagueManager::eventCompleted,
-            this, &LaneServer::onLeagueEventCompleted);
+    
+    // Lane traffic goes out on the bus; the UI and league side subscribe there
+    connect(this, &LaneServer::laneStatusChanged, this, [](int laneId, LaneStatus status) {
+        LaneStatusEvent event;
+        event.laneId = laneId;
+        event.status = static_cast<int>(status);
+        EventBus::instance()->publish(event);
+    });
+    connect(this, &LaneServer::gameDataReceived, this, [](int laneId, const QJsonObject &gameData) {
+        GameDataEvent event;
+        event.laneId = laneId;
+        event.gameData = gameData;
+        EventBus::instance()->publish(event);
+    });
+    connect(this, &LaneServer::gameCompleted, this,
+            [](int laneId, const QString &gameType, const QJsonObject &data) {
+        GameCompletedEvent event;
+        event.laneId = laneId;
+        event.gameType = gameType;
+        event.data = data;
+        EventBus::instance()->publish(event);
+    });
+    
+    EventBus::instance()->subscribe<LeagueEventCompletedEvent>(this, BusFilter::any(),
+        [this](const LeagueEventCompletedEvent &event) {
+            onLeagueEventCompleted(event.eventId, event.leagueId);
+        });
+    
+    m_standingsPublisher = new StandingsPublisher(this, m_leagueManager, this);
+    StandingsPublisher *publisher = m_standingsPublisher;
+    EventBus::instance()->subscribe<StandingsChangedEvent>(publisher, BusFilter::any(),
+        [publisher](const StandingsChangedEvent &event) {
+            publisher->markChanged(event.leagueId);
+        });
+    
+    m_consoleHub = new ConsoleHub(this, this);
     
     qDebug() << "LaneServer initialized with LeagueManager support";
         
@@ -37,13 +75,25 @@ LaneServer::~LaneServer()
     stop();
 }
 
-void LaneServer::start(quint16 port)
+bool LaneServer::start(quint16 port)
 {
     if (m_server->listen(QHostAddress::Any, port)) {
         qDebug() << "Lane server started on port" << port;
-    } else {
-        qDebug() << "Failed to start server:" << m_server->errorString();
+        m_consoleHub->listen(port + 1);     // Consoles on the next port up
+        return true;
+    }
+    qDebug() << "Failed to start server:" << m_server->errorString();
+    return false;
+}
+
+quint16 LaneServer::startFirstFree(const QVector<quint16> &ports)
+{
+    for (quint16 port : ports) {
+        if (start(port)) {
+            return port;
+        }
     }
+    return 0;
 }
 
 void LaneServer::onNewConnection()
@@ -74,10 +124,16 @@ void LaneServer::onClientDisconnected()
     
     if (m_connections.contains(socket)) {
         LaneConnection connection = m_connections[socket];
-        if (connection.laneId > 0) {
-            updateLaneStatus(connection.laneId, LaneStatus::Idle);
+        
+        // A lane that already re-registered on a new socket stays as it is;
+        // otherwise its game and session are kept for the reconnect
+        if (connection.laneId > 0 && m_laneToSocket.value(connection.laneId) == socket) {
+            updateLaneStatus(connection.laneId, LaneStatus::Offline);
             m_laneToSocket.remove(connection.laneId);
-            qDebug() << "Lane" << connection.laneId << "disconnected";
+            m_standingsPublisher->unsubscribe(connection.laneId);
+            m_laneSessions[connection.laneId].disconnectedAt = QDateTime::currentDateTime();
+            qDebug() << "Lane" << connection.laneId << "disconnected at seq"
+                     << m_laneSessions[connection.laneId].lastSeq;
         }
         m_connections.remove(socket);
     }
@@ -91,6 +147,7 @@ void LaneServer::stop()
         m_server->close();
         qDebug() << "Server stopped";
     }
+    m_consoleHub->close();
     
     // Clean up all connections
     for (auto it = m_connections.begin(); it != m_connections.end(); ++it) {
@@ -141,7 +198,28 @@ void LaneServer::handleRegistration(QTcpSocket *socket, const QJsonObject &messa
         m_connections[socket].lastSeen = QDateTime::currentDateTime();
         m_connections[socket].status = LaneStatus::Active;
         
+        // A reconnect can beat the old socket's timeout; the new one wins
+        QTcpSocket *previous = m_laneToSocket.value(laneId);
         m_laneToSocket[laneId] = socket;
+        if (previous && previous != socket) {
+            previous->abort();
+        }
+        
+        // The lane reports the last sequence it sent. Up to MAX_REPLAY_GAP
+        // missing messages are replayed; past that, or with nothing to
+        // resume from, it sends one lane_snapshot of its game instead.
+        LaneSession &session = m_laneSessions[laneId];
+        const qint64 laneSeq = message["seq"].toVariant().toLongLong();
+        QString resync = "none";
+        if (laneSeq < session.lastSeq) {
+            session.lastSeq = 0;    // Lane restarted and numbers from scratch
+            resync = laneSeq > 0 ? "snapshot" : "none";
+        } else if (laneSeq - session.lastSeq > MAX_REPLAY_GAP
+                   || (session.lastSeq == 0 && laneSeq > 0)) {
+            resync = "snapshot";
+        } else if (laneSeq > session.lastSeq) {
+            resync = "replay";
+        }
         
         // Send registration response
         QJsonObject response;
@@ -149,10 +227,29 @@ void LaneServer::handleRegistration(QTcpSocket *socket, const QJsonObject &messa
         response["status"] = "success";
         response["lane_id"] = laneId;
         response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+        response["last_seq"] = session.lastSeq;
+        response["resync"] = resync;
+        
+        // The game the server holds, for a lane that missed its start
+        if (m_laneGameTypes.contains(laneId)) {
+            response["game_type"] = m_laneGameTypes.value(laneId);
+            response["game"] = m_laneGameData.value(laneId);
+        }
         
         QJsonDocument doc(response);
         socket->write(doc.toJson(QJsonDocument::Compact) + "\n");
         
+        if (session.disconnectedAt.isValid()) {
+            qDebug() << "Lane" << laneId << "back after" << session.disconnectedAt.msecsTo(QDateTime::currentDateTime())
+                     << "ms, server at seq" << session.lastSeq << "lane at" << laneSeq << "-" << resync;
+            session.disconnectedAt = QDateTime();
+        }
+        
+        // Standings follow a league game across the reconnect
+        if (m_laneGameTypes.value(laneId) == "league_game") {
+            m_standingsPublisher->subscribe(laneId, m_laneGameData.value(laneId)["league_id"].toInt());
+        }
+        
         updateLaneStatus(laneId, LaneStatus::Active);
         qDebug() << "Lane" << laneId << "registered successfully";
     }
@@ -167,6 +264,7 @@ void LaneServer::handleHeartbeat(QTcpSocket *socket, const QJsonObject &message)
         QJsonObject response;
         response["type"] = "heartbeat_response";
         response["status"] = "ok";
+        response["last_seq"] = m_laneSessions.value(m_connections[socket].laneId).lastSeq;
         response["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
         
         QJsonDocument doc(response);
@@ -218,28 +316,223 @@ void LaneServer::updateLaneStatus(int laneId, LaneStatus status)
     emit laneStatusChanged(laneId, status);
 }
 
-void LaneServer::sendToLane(int laneId, const QString &command, const QJsonObject &data)
+bool LaneServer::sendToLane(int laneId, const QString &command, const QJsonObject &data)
+{
+    if (!writeFrame(laneId, encodeFrame(command, data))) {
+        return false;
+    }
+    
+    qDebug() << "Sent" << command << "to lane" << laneId;
+    return true;
+}
+
+QByteArray LaneServer::encodeFrame(const QString &type, const QJsonObject &data)
+{
+    return encodeFrame(type, QJsonDocument(data).toJson(QJsonDocument::Compact));
+}
+
+QByteArray LaneServer::encodeFrame(const QString &type, const QByteArray &encodedData)
+{
+    // The envelope is tiny, so it is rebuilt with a fresh timestamp around an
+    // already encoded payload
+    QJsonObject envelope;
+    envelope["type"] = type;
+    envelope["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    QByteArray frame = QJsonDocument(envelope).toJson(QJsonDocument::Compact);
+    frame.insert(1, "\"data\":" + encodedData + ",");
+    return frame + "\n";
+}
+
+bool LaneServer::writeFrame(int laneId, const QByteArray &frame)
 {
     if (!m_laneToSocket.contains(laneId)) {
         qWarning() << "Lane" << laneId << "not connected";
-        return;
+        return false;
     }
     
     QTcpSocket *socket = m_laneToSocket[laneId];
     if (!socket || socket->state() != QTcpSocket::ConnectedState) {
         qWarning() << "Lane" << laneId << "socket not valid";
-        return;
+        return false;
     }
     
-    QJsonObject message;
-    message["type"] = command;
-    message["data"] = data;
-    message["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    // QByteArray is implicitly shared, so a broadcast hands every socket the same buffer
+    socket->write(frame);
+    return true;
+}
+
+void LaneServer::setLaneGame(int laneId, const QString &gameType, const QJsonObject &gameData)
+{
+    if (gameType.isEmpty()) {
+        m_laneGameTypes.remove(laneId);
+        m_laneGameData.remove(laneId);
+    } else {
+        m_laneGameTypes[laneId] = gameType;
+        m_laneGameData[laneId] = gameData;
+    }
     
-    QJsonDocument doc(message);
-    socket->write(doc.toJson(QJsonDocument::Compact) + "\n");
+    LaneGameEvent event;
+    event.laneId = laneId;
+    event.gameType = gameType;
+    event.gameData = gameData;
+    EventBus::instance()->publish(event);
+}
+
+QJsonArray LaneServer::laneGames() const
+{
+    QJsonArray lanes;
+    for (auto it = m_laneGameTypes.constBegin(); it != m_laneGameTypes.constEnd(); ++it) {
+        QJsonObject lane;
+        lane["lane_id"] = it.key();
+        lane["game_type"] = it.value();
+        lane["game"] = m_laneGameData.value(it.key());
+        lanes.append(lane);
+    }
+    return lanes;
+}
+
+bool LaneServer::isListening() const
+{
+    return m_server->isListening();
+}
+
+QVector<int> LaneServer::resolveLaneGroup(const LaneGroup &group) const
+{
+    QVector<int> lanes;
+    
+    switch (group.kind) {
+    case LaneGroup::AllLanes:
+        lanes = connectedLanes();
+        break;
+    case LaneGroup::League:
+        for (auto it = m_laneGameData.constBegin(); it != m_laneGameData.constEnd(); ++it) {
+            if (it.value()["league_id"].toInt() == group.leagueId && m_laneToSocket.contains(it.key())) {
+                lanes.append(it.key());
+            }
+        }
+        break;
+    case LaneGroup::Lanes:
+        for (int laneId : group.laneIds) {
+            if (m_laneToSocket.contains(laneId) && !lanes.contains(laneId)) {
+                lanes.append(laneId);
+            }
+        }
+        break;
+    }
     
-    qDebug() << "Sent" << command << "to lane" << laneId;
+    return lanes;
+}
+
+BroadcastStats LaneServer::broadcastToLanes(const LaneGroup &group, const QString &type, const QJsonObject &data)
+{
+    BroadcastStats stats;
+    const QVector<int> lanes = resolveLaneGroup(group);
+    if (lanes.isEmpty()) {
+        return stats;
+    }
+    
+    QElapsedTimer timer;
+    timer.start();
+    const QByteArray frame = encodeFrame(type, data);
+    stats.serializeNs = timer.nsecsElapsed();
+    stats.frameBytes = frame.size();
+    
+    timer.restart();
+    for (int laneId : lanes) {
+        if (writeFrame(laneId, frame)) {
+            stats.recipients++;
+        }
+    }
+    stats.writeNs = timer.nsecsElapsed();
+    
+    qDebug() << "Broadcast" << type << "to" << stats.recipients << "lanes," << stats.frameBytes << "bytes,"
+             << stats.nsPerRecipient() << "ns per lane";
+    return stats;
+}
+
+BroadcastStats LaneServer::announce(const LaneGroup &group, const QString &text)
+{
+    QJsonObject messageData;
+    messageData["text"] = text;
+    messageData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    return broadcastToLanes(group, "display_message", messageData);
+}
+
+QFuture<LaneBatchResult> LaneServer::sendBatchCommand(const QVector<int> &laneIds, const QString &command,
+                                                      const QJsonObject &data, const QString &ackType,
+                                                      const LaneBatchOptions &options)
+{
+    const int batchId = m_nextBatchId++;
+    
+    // Every lane and retry gets the same payload, so it is encoded on the first
+    // send only; each send still gets its own envelope and timestamp
+    LaneCommandBatch *batch = new LaneCommandBatch(batchId, laneIds, command, data, ackType, options,
+        [this, payload = QByteArray()](int laneId, const QString &laneCommand, const QJsonObject &laneData) mutable {
+            if (payload.isEmpty()) {
+                payload = QJsonDocument(laneData).toJson(QJsonDocument::Compact);
+            }
+            return writeFrame(laneId, encodeFrame(laneCommand, payload));
+        }, this);
+    
+    m_batches[batchId] = batch;
+    connect(batch, &LaneCommandBatch::laneFinished, this, &LaneServer::batchLaneFinished);
+    connect(batch, &LaneCommandBatch::finished, this, [this](int finishedId) {
+        if (LaneCommandBatch *done = m_batches.take(finishedId)) {
+            done->deleteLater();
+        }
+    });
+    
+    QFuture<LaneBatchResult> future = batch->future();
+    batch->start();
+    return future;
+}
+
+QFuture<LaneBatchResult> LaneServer::shutdownLanes(const QVector<int> &laneIds, const LaneBatchOptions &options)
+{
+    QJsonObject shutdownData;
+    shutdownData["reason"] = "operator_request";
+    shutdownData["return_to"] = "advertising";
+    shutdownData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    return sendBatchCommand(laneIds, "shutdown_lane", shutdownData, "shutdown_acknowledged", options);
+}
+
+QFuture<LaneBatchResult> LaneServer::holdLanes(const QVector<int> &laneIds, bool hold, const LaneBatchOptions &options)
+{
+    QJsonObject holdData;
+    holdData["hold"] = hold;
+    holdData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    return sendBatchCommand(laneIds, "hold_toggle", holdData, "hold_acknowledged", options);
+}
+
+QFuture<LaneBatchResult> LaneServer::broadcastMessage(const QVector<int> &laneIds, const QString &text,
+                                                      const LaneBatchOptions &options)
+{
+    QJsonObject messageData;
+    messageData["text"] = text;
+    messageData["timestamp"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    
+    return sendBatchCommand(laneIds, "display_message", messageData, "message_acknowledged", options);
+}
+
+void LaneServer::acknowledgeBatchCommand(int laneId, const QString &ackType, const QJsonObject &data)
+{
+    // An ack that echoes batch_id goes to that batch; otherwise to the oldest
+    // batch still waiting on this lane for this kind of ack
+    const int echoedId = data["batch_id"].toInt();
+    const QList<LaneCommandBatch*> batches = m_batches.values();
+    
+    for (LaneCommandBatch *batch : batches) {
+        if (batch->ackType() != ackType || (echoedId > 0 && batch->id() != echoedId)) {
+            continue;
+        }
+        if (batch->acknowledge(laneId)) {
+            return;
+        }
+    }
 }
 
 void LaneServer::handleTeamMove(int fromLane, int toLane, const QString &teamData)
@@ -298,16 +591,18 @@ void LaneServer::handleGameComplete(int laneId, const QJsonObject &data)
     QString gameType = m_laneGameTypes.value(laneId, "unknown");
     
     if (gameType == "league_game" && m_leagueManager) {
-        // Process league game completion
+        // Process league game completion; LeagueManager publishes StandingsChangedEvent
+        // once the game is recorded, and the standings publisher picks it up from the bus
         m_leagueManager->handleLeagueGameComplete(laneId, data);
     } else if (gameType == "quick_game") {
         // Process quick game completion
         handleQuickGameComplete(laneId, data);
     }
     
+    recordCompletedGame(laneId, gameType, data);
+    
     // Clean up game state
-    m_laneGameTypes.remove(laneId);
-    m_laneGameData.remove(laneId);
+    setLaneGame(laneId, QString(), QJsonObject());
     
     // Update lane status
     setLaneStatus(laneId, LaneStatus::Ready);
@@ -315,6 +610,36 @@ void LaneServer::handleGameComplete(int laneId, const QJsonObject &data)
     emit gameCompleted(laneId, gameType, data);
 }
 
+void LaneServer::recordCompletedGame(int laneId, const QString &gameType, const QJsonObject &data)
+{
+    // Persist one games row per bowler for the end of day report
+    const QJsonObject gameData = m_laneGameData.value(laneId);
+    QJsonArray bowlers = data.contains("bowlers") ? data["bowlers"].toArray() : gameData["bowlers"].toArray();
+    
+    QDateTime startedAt = QDateTime::fromString(gameData["started_at"].toString(), Qt::ISODate);
+    QDateTime completedAt = QDateTime::currentDateTime();
+    
+    QVector<GameRecord> games;
+    for (const QJsonValue &bowlerValue : bowlers) {
+        QJsonObject bowler = bowlerValue.toObject();
+        
+        GameRecord game;
+        game.laneId = laneId;
+        game.bowlerId = bowler.contains("bowler_id") ? bowler["bowler_id"].toInt() : bowler["id"].toInt();
+        game.bowlerName = bowler["name"].toString();
+        game.leagueId = gameData["league_id"].toInt();
+        game.gameType = gameType;
+        game.gameNumber = qMax(1, data["game_number"].toInt());
+        game.score = bowler["total_score"].toInt();
+        game.framesJson = QJsonDocument(bowler["frames"].toArray()).toJson(QJsonDocument::Compact);
+        game.startedAt = startedAt;
+        game.completedAt = completedAt;
+        games.append(game);
+    }
+    
+    DatabaseManager::instance()->recordGames(games);
+}
+
 void LaneServer::handleQuickGameComplete(int laneId, const QJsonObject &data)
 {
     qDebug() << "Quick game completed on lane" << laneId;
@@ -505,27 +830,63 @@ void LaneServer::sendMessageToLane(int laneId, const QJsonObject &message)
 void LaneServer::broadcastToManagementClients(const QJsonObject &message)
 {
     // Broadcast to all connected management/display clients
-    // Implementation depends on your architecture
     qDebug() << "Broadcasting to management clients:" << message["type"].toString();
+    m_consoleHub->notify(message);
+}
+
+bool LaneServer::acceptSequence(int laneId, const QString &type, const QJsonObject &message)
+{
+    // Registration and heartbeats report the lane's position, they are not numbered
+    if (!message.contains("seq") || type == "registration" || type == "heartbeat") {
+        return true;
+    }
+    
+    LaneSession &session = m_laneSessions[laneId];
+    const qint64 seq = message["seq"].toVariant().toLongLong();
+    
+    // Already applied before the connection dropped
+    if (seq <= session.lastSeq) {
+        session.duplicates++;
+        return false;
+    }
     
-    // This could send to a separate management client connection,
-    // or to a web interface, or update a display board, etc.
+    // A snapshot stands in for everything before it
+    if (seq > session.lastSeq + 1 && type != "lane_snapshot") {
+        session.gaps++;
+        qWarning() << "Lane" << laneId << "skipped from seq" << session.lastSeq << "to" << seq;
+    }
+    session.lastSeq = seq;
+    return true;
 }
 
-QTcpSocket* LaneServer::getSocketForLane(int laneId)
+void LaneServer::handleLaneSnapshot(int laneId, const QJsonObject &data)
 {
-    // Find the socket associated with the given lane ID
-    for (auto it = m_laneClients.begin(); it != m_laneClients.end(); ++it) {
-        if (it.value() == laneId) {
-            return it.key();
-        }
+    // The lane's whole game replaces whatever the server pieced together;
+    // its seq (checked in processMessage) is where the lane numbers on from
+    const QString gameType = data["game_type"].toString();
+    const QJsonObject game = data["game"].toObject();
+    
+    qDebug() << "Lane" << laneId << "resynced from snapshot at seq" << m_laneSessions.value(laneId).lastSeq;
+    
+    if (gameType.isEmpty()) {
+        setLaneGame(laneId, QString(), QJsonObject());
+        setLaneStatus(laneId, LaneStatus::Ready);
+        return;
     }
-    return nullptr;
+    
+    setLaneGame(laneId, gameType, game);
+    emit gameDataReceived(laneId, game);
+}
+
+QTcpSocket* LaneServer::getSocketForLane(int laneId)
+{
+    return m_laneToSocket.value(laneId, nullptr);
 }
 
 int LaneServer::getLaneIdFromSocket(QTcpSocket *socket)
 {
-    return m_laneClients.value(socket, 0);
+    // Set at registration; 0 until the lane has registered
+    return qMax(0, m_connections.value(socket).laneId);
 }
 
 void LaneServer::setLaneStatus(int laneId, LaneStatus status)
@@ -543,6 +904,14 @@ void LaneServer::processMessage(QTcpSocket *socket, const QJsonObject &message)
     
     qDebug() << "Processing message from lane" << laneId << "type:" << type;
     
+    if (laneId > 0 && !acceptSequence(laneId, type, message)) {
+        return;
+    }
+    
+    if (laneId > 0 && type.endsWith("_acknowledged")) {
+        acknowledgeBatchCommand(laneId, type, data);
+    }
+    
     if (type == "registration") {
         handleRegistration(socket, message);
     } else if (type == "heartbeat") {
@@ -571,6 +940,14 @@ void LaneServer::processMessage(QTcpSocket *socket, const QJsonObject &message)
         handleRevertAcknowledged(laneId, data);
     } else if (type == "shutdown_acknowledged") {
         handleShutdownAcknowledged(laneId, data);
+    } else if (type == "message_acknowledged") {
+        qDebug() << "Lane" << laneId << "displayed broadcast message";
+    } else if (type == "standings_subscribe") {
+        m_standingsPublisher->subscribe(laneId, data["league_id"].toInt());
+    } else if (type == "standings_unsubscribe") {
+        m_standingsPublisher->unsubscribe(laneId);
+    } else if (type == "lane_snapshot") {
+        handleLaneSnapshot(laneId, data);
     } else {
         qWarning() << "Unknown message type from lane" << laneId << ":" << type;
     }
@@ -585,7 +962,7 @@ void LaneServer::handleHoldAcknowledged(int laneId, const QJsonObject &data)
     if (m_laneGameData.contains(laneId)) {
         QJsonObject gameData = m_laneGameData[laneId];
         gameData["held"] = isHeld;
-        m_laneGameData[laneId] = gameData;
+        setLaneGame(laneId, m_laneGameTypes.value(laneId), gameData);
         
         // Emit updated game data
         emit gameDataReceived(laneId, gameData);
@@ -643,7 +1020,7 @@ void LaneServer::handleBallUpdateAcknowledged(int laneId, const QJsonObject &dat
         }
         
         gameData["bowlers"] = bowlers;
-        m_laneGameData[laneId] = gameData;
+        setLaneGame(laneId, m_laneGameTypes.value(laneId), gameData);
         
         // Emit updated game data
         emit gameDataReceived(laneId, gameData);
@@ -668,14 +1045,15 @@ void LaneServer::handleShutdownAcknowledged(int laneId, const QJsonObject &data)
     qDebug() << "Lane" << laneId << "acknowledged shutdown command";
     
     // Clear game state
-    m_laneGameTypes.remove(laneId);
-    m_laneGameData.remove(laneId);
+    setLaneGame(laneId, QString(), QJsonObject());
+    m_standingsPublisher->unsubscribe(laneId);
     
     // Set status back to ready/connected
     setLaneStatus(laneId, LaneStatus::Idle);
     
     // Notify that lane is now available
     emit laneStatusChanged(laneId, LaneStatus::Idle);
+    emit laneShutdown(laneId);
 }
 
 // Enhanced command handlers for new functionality
@@ -796,6 +1174,7 @@ void LaneServer::handleQuickGameMessage(int laneId, const QJsonObject &data)
     
     // Store game type and enhanced data
     m_laneGameTypes[laneId] = "quick_game";
+    m_standingsPublisher->unsubscribe(laneId);
     
     // Create enhanced game data with 5-pin bowling structure
     QJsonObject enhancedData = data;
@@ -804,6 +1183,7 @@ void LaneServer::handleQuickGameMessage(int laneId, const QJsonObject &data)
     enhancedData["current_bowler"] = 0;
     enhancedData["current_frame"] = 1;
     enhancedData["current_ball"] = 1;
+    enhancedData["started_at"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     
     // Initialize bowler frame data for 5-pin bowling
     QJsonArray bowlers = data["bowlers"].toArray();
@@ -839,7 +1219,7 @@ void LaneServer::handleQuickGameMessage(int laneId, const QJsonObject &data)
     }
     
     enhancedData["bowlers"] = enhancedBowlers;
-    m_laneGameData[laneId] = enhancedData;
+    setLaneGame(laneId, "quick_game", enhancedData);
     
     // Create response data
     QJsonObject response;
@@ -868,6 +1248,7 @@ void LaneServer::handleLeagueGameMessage(int laneId, const QJsonObject &data)
     enhancedData["held"] = false;
     enhancedData["completed"] = false;
     enhancedData["current_bowler"] = 0;
+    enhancedData["started_at"] = QDateTime::currentDateTime().toString(Qt::ISODate);
     
     // Initialize team/bowler data similar to quick game but with league specifics
     QJsonArray teams = data["teams"].toArray();
@@ -915,7 +1296,7 @@ void LaneServer::handleLeagueGameMessage(int laneId, const QJsonObject &data)
     enhancedData["bowlers"] = enhancedBowlers;
     enhancedData["team_name"] = teams.size() > 0 ? teams[0].toObject()["name"].toString() : "";
     
-    m_laneGameData[laneId] = enhancedData;
+    setLaneGame(laneId, "league_game", enhancedData);
     
     int leagueId = data["league_id"].toInt();
     int eventId = data["event_id"].toInt();
@@ -925,6 +1306,9 @@ void LaneServer::handleLeagueGameMessage(int laneId, const QJsonObject &data)
         m_leagueManager->handleLeagueGameStart(laneId, enhancedData);
     }
     
+    // Standings follow the lane until it starts something else or shuts down
+    m_standingsPublisher->subscribe(laneId, leagueId);
+    
     // Create response data with league-specific configuration
     QJsonObject response;
     response["type"] = "league_game_start";
@@ -3,12 +3,18 @@
 
 #include <QObject>
 #include <QJsonObject>
+#include <QJsonArray>
 #include <QTcpServer>
 #include <QTcpSocket>
 #include <QTimer>
 #include <QDateTime>
 #include <QMap>
+#include <QFuture>
 #include "LeagueManager.h"
+#include "LaneCommandBatch.h"
+
+class StandingsPublisher;
+class ConsoleHub;
 
 
 enum class LaneStatus {
@@ -31,6 +37,48 @@ struct LaneConnection {
     QJsonObject gameData;
 };
 
+// What the server has applied from a lane; outlives the lane's socket so a
+// reconnect can resume where it left off. Lanes number every message they
+// send ("seq", from 1, kept across reconnects) and keep unacknowledged ones
+// until heartbeat_response or registration_response reports last_seq.
+struct LaneSession {
+    qint64 lastSeq = 0;             // Highest sequence applied
+    QDateTime disconnectedAt;       // Null while connected
+    int duplicates = 0;             // Replayed messages already applied
+    int gaps = 0;                   // Sequences skipped without a replay
+};
+
+// Which lanes a broadcast goes to; resolved against the connected lanes at send time
+struct LaneGroup {
+    enum Kind {
+        AllLanes,
+        League,     // Lanes currently bowling a game for leagueId
+        Lanes       // Explicit list, e.g. a lane pair
+    };
+    
+    Kind kind = AllLanes;
+    int leagueId = 0;
+    QVector<int> laneIds;
+    
+    static LaneGroup all() { return LaneGroup(); }
+    static LaneGroup league(int leagueId) { LaneGroup g; g.kind = League; g.leagueId = leagueId; return g; }
+    static LaneGroup lanes(const QVector<int> &laneIds) { LaneGroup g; g.kind = Lanes; g.laneIds = laneIds; return g; }
+    static LaneGroup pair(int laneId)   // Odd lane and the even lane beside it
+    {
+        int odd = (laneId % 2 == 0) ? laneId - 1 : laneId;
+        return lanes({odd, odd + 1});
+    }
+};
+
+struct BroadcastStats {
+    int recipients = 0;
+    int frameBytes = 0;
+    qint64 serializeNs = 0;     // Paid once per broadcast
+    qint64 writeNs = 0;         // Summed over recipients
+    
+    qint64 nsPerRecipient() const { return recipients > 0 ? (serializeNs + writeNs) / recipients : 0; }
+};
+
 class LaneServer : public QObject
 {
     Q_OBJECT
@@ -38,11 +86,40 @@ class LaneServer : public QObject
 public:
     explicit LaneServer(QObject *parent = nullptr);
     ~LaneServer();
-    void start(quint16 port = 50005);
+    bool start(quint16 port = 50005);
+    // Lanes on the first port that binds, consoles one above; 0 if none did.
+    // A standby taking over tries the primary's lane port before its own.
+    quint16 startFirstFree(const QVector<quint16> &ports);
     void stop();
     void handleTeamMove(int fromLane, int toLane, const QString &teamData);
     void onLaneCommand(const QJsonObject &data);
     LeagueManager* getLeagueManager() const { return m_leagueManager; }
+    ConsoleHub* consoleHub() const { return m_consoleHub; }
+    bool isListening() const;
+    
+    // The game each lane is bowling, as a hot standby needs it to take over;
+    // an empty gameType clears the lane
+    void setLaneGame(int laneId, const QString &gameType, const QJsonObject &gameData);
+    QJsonArray laneGames() const;      // [{lane_id, game_type, game}]
+    QVector<int> connectedLanes() const { return m_laneToSocket.keys().toVector(); }
+
+    // Fans a command out to many lanes and resolves once each has acked or
+    // run out of retries; see LaneCommandBatch
+    QFuture<LaneBatchResult> sendBatchCommand(const QVector<int> &laneIds, const QString &command,
+                                              const QJsonObject &data, const QString &ackType,
+                                              const LaneBatchOptions &options = LaneBatchOptions());
+    QFuture<LaneBatchResult> shutdownLanes(const QVector<int> &laneIds,
+                                           const LaneBatchOptions &options = LaneBatchOptions());
+    QFuture<LaneBatchResult> holdLanes(const QVector<int> &laneIds, bool hold,
+                                       const LaneBatchOptions &options = LaneBatchOptions());
+    QFuture<LaneBatchResult> broadcastMessage(const QVector<int> &laneIds, const QString &text,
+                                              const LaneBatchOptions &options = LaneBatchOptions());
+    
+    // Fire-and-forget: the message is serialised once and the same bytes are
+    // written to every lane in the group
+    BroadcastStats broadcastToLanes(const LaneGroup &group, const QString &type, const QJsonObject &data);
+    BroadcastStats announce(const LaneGroup &group, const QString &text);
+    QVector<int> resolveLaneGroup(const LaneGroup &group) const;
 
 signals:
     void laneStatusChanged(int laneId, LaneStatus status);
@@ -55,6 +132,7 @@ signals:
     void frameCompleted(int laneId, const QJsonObject &data);
     void gameCompleted(int laneId, const QString &gameType, const QJsonObject &data);
     void displayModeChanged(int laneId, const QString &frameMode, const QString &totalDisplay);
+    void batchLaneFinished(int batchId, int laneId, bool acknowledged);
 
 private slots:
     void onNewConnection();
@@ -70,17 +148,25 @@ private:
     void handleHeartbeat(QTcpSocket *socket, const QJsonObject &message);
     void handleGameData(QTcpSocket *socket, const QJsonObject &message);
     void updateLaneStatus(int laneId, LaneStatus status);
-    void sendToLane(int laneId, const QString &command, const QJsonObject &data);
+    bool sendToLane(int laneId, const QString &command, const QJsonObject &data);
+    bool writeFrame(int laneId, const QByteArray &frame);
+    static QByteArray encodeFrame(const QString &type, const QJsonObject &data);
+    static QByteArray encodeFrame(const QString &type, const QByteArray &encodedData);
+    void acknowledgeBatchCommand(int laneId, const QString &ackType, const QJsonObject &data);
 
     QTcpServer *m_server;
     QTimer *m_connectionTimer;
     QMap<QTcpSocket*, LaneConnection> m_connections;
     QMap<int, QTcpSocket*> m_laneToSocket;
+    QMap<int, LaneCommandBatch*> m_batches;    // Outstanding batches by id, oldest first
+    int m_nextBatchId = 1;
     bool m_running;
     
     static const int HEARTBEAT_TIMEOUT = 30000; // 30 seconds
 
     LeagueManager *m_leagueManager;
+    StandingsPublisher *m_standingsPublisher;
+    ConsoleHub *m_consoleHub;
     
     // League-specific message handlers
     void handleLeagueGameMessage(int laneId, const QJsonObject &data);
@@ -92,6 +178,7 @@ private:
     QMap<int, QJsonObject> m_laneGameData; // laneId -> game configuration
 
     void handleGameComplete(int laneId, const QJsonObject &data);
+    void recordCompletedGame(int laneId, const QString &gameType, const QJsonObject &data);
     void handleQuickGameComplete(int laneId, const QJsonObject &data);
     void handleBallThrown(int laneId, const QJsonObject &data);
     void handleFrameComplete(int laneId, const QJsonObject &data);
@@ -113,9 +200,13 @@ private:
     void sendRevertCommand(int laneId);
     void sendShutdownCommand(int laneId);
     
-    // Add missing member variables:
-    QMap<QTcpSocket*, int> m_laneClients;
     QMap<int, LaneStatus> m_laneStatuses;
+    
+    // Reconnect resync
+    bool acceptSequence(int laneId, const QString &type, const QJsonObject &message);
+    void handleLaneSnapshot(int laneId, const QJsonObject &data);
+    QMap<int, LaneSession> m_laneSessions;
+    static const int MAX_REPLAY_GAP = 64;   // Beyond this a lane sends a snapshot instead
 
 };
 
@@ -0,0 +1,67 @@
+﻿// LeagueCalculator.cpp
+#include "LeagueCalculator.h"
+
+namespace {
+
+using namespace LeaguePolicy;
+
+template <typename AveragePolicy, typename HandicapPolicy>
+std::unique_ptr<LeagueCalculator> withAbsent(const LeagueConfig &config)
+{
+    switch (config.absentHandling.type) {
+    case LeagueConfig::AbsentHandling::FixedValue:
+        return std::make_unique<PolicyCalculator<AveragePolicy, HandicapPolicy, FixedAbsent>>(config);
+    case LeagueConfig::AbsentHandling::UseAverage:
+        return std::make_unique<PolicyCalculator<AveragePolicy, HandicapPolicy, AverageAbsent>>(config);
+    case LeagueConfig::AbsentHandling::PercentageOfAverage:
+        break;
+    }
+    return std::make_unique<PolicyCalculator<AveragePolicy, HandicapPolicy, PercentageAbsent>>(config);
+}
+
+template <typename AveragePolicy>
+std::unique_ptr<LeagueCalculator> withHandicap(const LeagueConfig &config)
+{
+    switch (config.hdcpCalc.type) {
+    case LeagueConfig::HandicapCalculation::StraightDifference:
+        return withAbsent<AveragePolicy, StraightHandicap>(config);
+    case LeagueConfig::HandicapCalculation::WithDeduction:
+        return withAbsent<AveragePolicy, DeductionHandicap>(config);
+    case LeagueConfig::HandicapCalculation::PercentageBased:
+        break;
+    }
+    return withAbsent<AveragePolicy, PercentageHandicap>(config);
+}
+
+} // namespace
+
+void RosterColumns::reserve(int count)
+{
+    bowlerIds.reserve(count);
+    games.reserve(count);
+    pins.reserve(count);
+    balls.reserve(count);
+    storedAverages.reserve(count);
+}
+
+void RosterColumns::append(int bowlerId, int gameCount, int pinCount, int ballCount, double storedAverage)
+{
+    bowlerIds.append(bowlerId);
+    games.append(gameCount);
+    pins.append(pinCount);
+    balls.append(ballCount);
+    storedAverages.append(storedAverage);
+}
+
+std::unique_ptr<LeagueCalculator> LeagueCalculator::create(const LeagueConfig &config)
+{
+    switch (config.avgCalc.type) {
+    case LeagueConfig::AverageCalculation::TotalPinsPerBall:
+        return withHandicap<PinsPerBallAverage>(config);
+    case LeagueConfig::AverageCalculation::PeriodicUpdate:
+        return withHandicap<PeriodicAverage>(config);
+    case LeagueConfig::AverageCalculation::TotalPinsPerGame:
+        break;
+    }
+    return withHandicap<PinsPerGameAverage>(config);
+}
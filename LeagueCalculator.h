@@ -0,0 +1,181 @@
+﻿// LeagueCalculator.h
+#ifndef LEAGUECALCULATOR_H
+#define LEAGUECALCULATOR_H
+
+#include <QVector>
+#include <QtMath>
+#include <memory>
+#include "LeagueManager.h"
+
+// One league's roster as columns, in the order loaded from bowler_season_data
+struct RosterColumns {
+    QVector<int> bowlerIds;
+    QVector<int> games;
+    QVector<int> pins;
+    QVector<int> balls;
+    QVector<double> storedAverages;     // Kept between PeriodicUpdate intervals
+
+    int size() const { return bowlerIds.size(); }
+    void reserve(int count);
+    void append(int bowlerId, int gameCount, int pinCount, int ballCount, double storedAverage);
+};
+
+struct RosterFigures {
+    QVector<double> averages;
+    QVector<double> handicaps;
+    QVector<int> absentScores;
+};
+
+// Average, handicap and absent rules as policies. Each computes one bowler
+// from plain numbers, so PolicyCalculator can inline them into a single loop.
+namespace LeaguePolicy {
+
+inline double round2(double value) { return qRound(value * 100.0) / 100.0; }
+
+struct PinsPerGameAverage {
+    static double compute(const LeagueConfig::AverageCalculation &, int games, int pins, int, double)
+    {
+        return games > 0 ? static_cast<double>(pins) / games : 0.0;
+    }
+};
+
+struct PinsPerBallAverage {
+    static double compute(const LeagueConfig::AverageCalculation &, int, int pins, int balls, double)
+    {
+        return balls > 0 ? static_cast<double>(pins) / balls : 0.0;
+    }
+};
+
+struct PeriodicAverage {
+    static double compute(const LeagueConfig::AverageCalculation &rule, int games, int pins, int, double stored)
+    {
+        // Only moves every updateInterval games
+        if (games % qMax(1, rule.updateInterval) != 0) {
+            return stored;
+        }
+        return games > 0 ? static_cast<double>(pins) / games : 0.0;
+    }
+};
+
+struct PercentageHandicap {
+    static double compute(const LeagueConfig::HandicapCalculation &rule, double average)
+    {
+        return (rule.highValue - average) * rule.percentage;
+    }
+};
+
+struct StraightHandicap {
+    static double compute(const LeagueConfig::HandicapCalculation &rule, double average)
+    {
+        return rule.highValue - average;
+    }
+};
+
+struct DeductionHandicap {
+    static double compute(const LeagueConfig::HandicapCalculation &rule, double average)
+    {
+        return rule.highValue - average - rule.deduction;
+    }
+};
+
+struct PercentageAbsent {
+    static int compute(const LeagueConfig::AbsentHandling &rule, double average)
+    {
+        return static_cast<int>(average * rule.percentage);
+    }
+};
+
+struct FixedAbsent {
+    static int compute(const LeagueConfig::AbsentHandling &rule, double)
+    {
+        return rule.fixedValue;
+    }
+};
+
+struct AverageAbsent {
+    static int compute(const LeagueConfig::AbsentHandling &, double average)
+    {
+        return static_cast<int>(average);
+    }
+};
+
+} // namespace LeaguePolicy
+
+// The rules of one league. create() picks the policy combination once from
+// the config; after that no call switches on the rule types.
+class LeagueCalculator
+{
+public:
+    virtual ~LeagueCalculator() = default;
+
+    virtual double average(int games, int pins, int balls, double storedAverage) const = 0;
+    virtual double handicap(int games, double average) const = 0;
+    virtual int absentScore(double average) const = 0;
+
+    // Whole roster in one pass over the columns
+    virtual RosterFigures evaluate(const RosterColumns &roster) const = 0;
+
+    static std::unique_ptr<LeagueCalculator> create(const LeagueConfig &config);
+};
+
+template <typename AveragePolicy, typename HandicapPolicy, typename AbsentPolicy>
+class PolicyCalculator final : public LeagueCalculator
+{
+public:
+    explicit PolicyCalculator(const LeagueConfig &config)
+        : m_avgCalc(config.avgCalc)
+        , m_hdcpCalc(config.hdcpCalc)
+        , m_absent(config.absentHandling)
+    {
+    }
+
+    double average(int games, int pins, int balls, double storedAverage) const override
+    {
+        if (games < m_avgCalc.delayGames) {
+            return 0.0; // Not enough games played yet
+        }
+        return LeaguePolicy::round2(AveragePolicy::compute(m_avgCalc, games, pins, balls, storedAverage));
+    }
+
+    double handicap(int games, double average) const override
+    {
+        if (games < m_hdcpCalc.delayGames || average <= 0.0) {
+            return 0.0;
+        }
+        return qMax(0.0, LeaguePolicy::round2(HandicapPolicy::compute(m_hdcpCalc, average))); // No negative handicaps
+    }
+
+    int absentScore(double average) const override
+    {
+        return qMax(0, AbsentPolicy::compute(m_absent, average));
+    }
+
+    RosterFigures evaluate(const RosterColumns &roster) const override
+    {
+        const int count = roster.size();
+        RosterFigures figures;
+        figures.averages.resize(count);
+        figures.handicaps.resize(count);
+        figures.absentScores.resize(count);
+
+        const int *games = roster.games.constData();
+        const int *pins = roster.pins.constData();
+        const int *balls = roster.balls.constData();
+        const double *stored = roster.storedAverages.constData();
+
+        for (int i = 0; i < count; ++i) {
+            const double avg = average(games[i], pins[i], balls[i], stored[i]);
+            figures.averages[i] = avg;
+            figures.handicaps[i] = handicap(games[i], avg);
+            figures.absentScores[i] = absentScore(avg);
+        }
+        return figures;
+    }
+
+private:
+    LeagueConfig::AverageCalculation m_avgCalc;
+    LeagueConfig::HandicapCalculation m_hdcpCalc;
+    LeagueConfig::AbsentHandling m_absent;
+};
+
+#endif // LEAGUECALCULATOR_H
@@ -0,0 +1,387 @@
+﻿// LeagueConfigLoader.cpp
+#include "LeagueConfigLoader.h"
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QStringList>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+
+// Registered for --audit-queries; %1 is the IN list of the leagues being loaded
+const QString CONFIG_SELECT = "SELECT league_id, name, start_date, end_date, number_of_weeks, lane_ids, status, "
+                              "config_json FROM league_configs";
+
+const QString ALL_CONFIGS_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadConfigs",
+    CONFIG_SELECT, "reads every league's settings");
+const QString ACTIVE_CONFIGS_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadActive",
+    CONFIG_SELECT + " WHERE COALESCE(status, '') NOT IN ('completed', 'cancelled')",
+    "one row per season, filtered on status at startup");
+const QString LEAGUE_CONFIG_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadLeague",
+    CONFIG_SELECT + " WHERE league_id = ?");
+const QString LEAGUE_TEAMS_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadInto",
+    "SELECT lt.league_id, lt.team_id, COALESCE(lt.name, t.name), lt.bowler_ids, lt.division_id, "
+    "lt.wins, lt.losses, lt.ties, lt.total_points, lt.team_average "
+    "FROM league_teams lt LEFT JOIN teams t ON t.id = lt.team_id "
+    "WHERE lt.league_id IN (%1) ORDER BY lt.league_id, lt.team_id");
+const QString LEAGUE_EVENTS_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadInto",
+    "SELECT event_id, league_id, week_number, scheduled_time, lane_ids, matchups_json, "
+    "event_completed FROM league_events WHERE league_id IN (%1) ORDER BY league_id, week_number");
+const QString SEASON_FIGURES_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadFigures",
+    "SELECT league_id, COUNT(*), SUM(total_pins), SUM(games_played) "
+    "FROM bowler_season_data GROUP BY league_id",
+    "totals for every league");
+const QString COMPLETED_WEEKS_SQL = QueryPlanAudit::statement("LeagueConfigLoader::loadFigures",
+    "SELECT league_id, COUNT(*) FROM league_events WHERE event_completed = 1 GROUP BY league_id",
+    "totals for every league");
+
+QVector<int> intArray(const QString &text)
+{
+    // JSON arrays, with comma separated lists accepted from older rows
+    QVector<int> values;
+    const QJsonDocument doc = QJsonDocument::fromJson(text.toUtf8());
+    if (doc.isArray()) {
+        for (const QJsonValue &value : doc.array()) {
+            values.append(value.toInt());
+        }
+        return values;
+    }
+    for (const QString &part : text.split(',', Qt::SkipEmptyParts)) {
+        bool ok = false;
+        const int value = part.trimmed().toInt(&ok);
+        if (ok) {
+            values.append(value);
+        }
+    }
+    return values;
+}
+
+QVector<int> intValues(const QJsonArray &array)
+{
+    QVector<int> values;
+    values.reserve(array.size());
+    for (const QJsonValue &value : array) {
+        values.append(value.toInt());
+    }
+    return values;
+}
+
+QString idList(const QList<int> &ids)
+{
+    QStringList parts;
+    for (int id : ids) {
+        parts << QString::number(id);
+    }
+    return parts.join(',');
+}
+
+LeagueConfig readConfig(const QSqlQuery &query)
+{
+    LeagueConfig config;
+    config.leagueId = query.value(0).toInt();
+    config.name = query.value(1).toString();
+    config.startDate = QDate::fromString(query.value(2).toString(), "yyyy-MM-dd");
+    config.endDate = QDate::fromString(query.value(3).toString(), "yyyy-MM-dd");
+    config.numberOfWeeks = query.value(4).toInt();
+    config.laneIds = intArray(query.value(5).toString());
+    config.status = query.value(6).toString();
+    LeagueConfigLoader::applyConfigJson(config, QJsonDocument::fromJson(query.value(7).toString().toUtf8()).object());
+    return config;
+}
+
+} // namespace
+
+QJsonObject LeagueConfigLoader::configToJson(const LeagueConfig &config)
+{
+    QJsonObject configJson;
+    configJson["avg_calc_type"] = static_cast<int>(config.avgCalc.type);
+    configJson["avg_calc_interval"] = config.avgCalc.updateInterval;
+    configJson["avg_delay_games"] = config.avgCalc.delayGames;
+
+    configJson["hdcp_calc_type"] = static_cast<int>(config.hdcpCalc.type);
+    configJson["hdcp_high_value"] = config.hdcpCalc.highValue;
+    configJson["hdcp_percentage"] = config.hdcpCalc.percentage;
+    configJson["hdcp_deduction"] = config.hdcpCalc.deduction;
+    configJson["hdcp_delay_games"] = config.hdcpCalc.delayGames;
+
+    configJson["absent_type"] = static_cast<int>(config.absentHandling.type);
+    configJson["absent_percentage"] = config.absentHandling.percentage;
+    configJson["absent_fixed_value"] = config.absentHandling.fixedValue;
+
+    configJson["prebowl_enabled"] = config.preBowlRules.enabled;
+    configJson["prebowl_carry_over"] = config.preBowlRules.carryToNextSeason;
+    configJson["prebowl_random_use"] = config.preBowlRules.randomUseWhenAbsent;
+    configJson["prebowl_use_by"] = static_cast<int>(config.preBowlRules.useBy);
+    configJson["prebowl_max_uses"] = config.preBowlRules.maxUsesPerGame;
+
+    configJson["divisions_count"] = config.divisions.count;
+    configJson["divisions_reorder"] = config.divisions.reorderMidSeason;
+    configJson["divisions_order_by"] = static_cast<int>(config.divisions.orderBy);
+
+    configJson["playoffs_type"] = static_cast<int>(config.playoffs.type);
+    configJson["playoffs_division_only"] = config.playoffs.divisionOnly;
+
+    configJson["points_type"] = static_cast<int>(config.pointSystem.type);
+    configJson["points_win"] = config.pointSystem.winPoints;
+    configJson["points_loss"] = config.pointSystem.lossPoints;
+    configJson["points_tie"] = config.pointSystem.tiePoints;
+    configJson["points_heads_up"] = config.pointSystem.includeHeadsUp;
+    configJson["points_heads_up_hdcp"] = config.pointSystem.headsUpWithHandicap;
+    configJson["points_stacked_ties"] = config.pointSystem.stackedTiePoints;
+
+    QJsonArray positionRoundsArray;
+    for (int week : config.positionRoundWeeks) {
+        positionRoundsArray.append(week);
+    }
+    configJson["position_round_weeks"] = positionRoundsArray;
+
+    QJsonArray blackoutArray;
+    for (const BlackoutPeriod &period : config.blackouts) {
+        if (period.from == period.to) {
+            blackoutArray.append(period.from.toString("yyyy-MM-dd"));
+        } else {
+            QJsonObject range;
+            range["from"] = period.from.toString("yyyy-MM-dd");
+            range["to"] = period.to.toString("yyyy-MM-dd");
+            blackoutArray.append(range);
+        }
+    }
+    configJson["blackout_dates"] = blackoutArray;
+
+    return configJson;
+}
+
+void LeagueConfigLoader::applyConfigJson(LeagueConfig &config, const QJsonObject &json)
+{
+    // Keys missing from older rows keep the LeagueConfig defaults
+    auto readInt = [&json](const char *key, int fallback) { return json.value(key).toInt(fallback); };
+    auto readDouble = [&json](const char *key, double fallback) { return json.value(key).toDouble(fallback); };
+    auto readBool = [&json](const char *key, bool fallback) { return json.value(key).toBool(fallback); };
+
+    config.avgCalc.type = static_cast<LeagueConfig::AverageCalculation::Type>(
+        readInt("avg_calc_type", config.avgCalc.type));
+    config.avgCalc.updateInterval = readInt("avg_calc_interval", config.avgCalc.updateInterval);
+    config.avgCalc.delayGames = readInt("avg_delay_games", config.avgCalc.delayGames);
+
+    config.hdcpCalc.type = static_cast<LeagueConfig::HandicapCalculation::Type>(
+        readInt("hdcp_calc_type", config.hdcpCalc.type));
+    config.hdcpCalc.highValue = readInt("hdcp_high_value", config.hdcpCalc.highValue);
+    config.hdcpCalc.percentage = readDouble("hdcp_percentage", config.hdcpCalc.percentage);
+    config.hdcpCalc.deduction = readInt("hdcp_deduction", config.hdcpCalc.deduction);
+    config.hdcpCalc.delayGames = readInt("hdcp_delay_games", config.hdcpCalc.delayGames);
+
+    config.absentHandling.type = static_cast<LeagueConfig::AbsentHandling::Type>(
+        readInt("absent_type", config.absentHandling.type));
+    config.absentHandling.percentage = readDouble("absent_percentage", config.absentHandling.percentage);
+    config.absentHandling.fixedValue = readInt("absent_fixed_value", config.absentHandling.fixedValue);
+
+    config.preBowlRules.enabled = readBool("prebowl_enabled", config.preBowlRules.enabled);
+    config.preBowlRules.carryToNextSeason = readBool("prebowl_carry_over", config.preBowlRules.carryToNextSeason);
+    config.preBowlRules.randomUseWhenAbsent = readBool("prebowl_random_use", config.preBowlRules.randomUseWhenAbsent);
+    config.preBowlRules.useBy = static_cast<LeagueConfig::PreBowlRules::UseBy>(
+        readInt("prebowl_use_by", config.preBowlRules.useBy));
+    config.preBowlRules.maxUsesPerGame = readInt("prebowl_max_uses", config.preBowlRules.maxUsesPerGame);
+
+    config.divisions.count = readInt("divisions_count", config.divisions.count);
+    config.divisions.reorderMidSeason = readBool("divisions_reorder", config.divisions.reorderMidSeason);
+    config.divisions.orderBy = static_cast<LeagueConfig::Divisions::OrderBy>(
+        readInt("divisions_order_by", config.divisions.orderBy));
+
+    config.playoffs.type = static_cast<LeagueConfig::Playoffs::Type>(readInt("playoffs_type", config.playoffs.type));
+    config.playoffs.divisionOnly = readBool("playoffs_division_only", config.playoffs.divisionOnly);
+
+    config.pointSystem.type = static_cast<LeagueConfig::PointSystem::Type>(
+        readInt("points_type", config.pointSystem.type));
+    config.pointSystem.winPoints = readInt("points_win", config.pointSystem.winPoints);
+    config.pointSystem.lossPoints = readInt("points_loss", config.pointSystem.lossPoints);
+    config.pointSystem.tiePoints = readInt("points_tie", config.pointSystem.tiePoints);
+    config.pointSystem.includeHeadsUp = readBool("points_heads_up", config.pointSystem.includeHeadsUp);
+    config.pointSystem.headsUpWithHandicap = readBool("points_heads_up_hdcp", config.pointSystem.headsUpWithHandicap);
+    config.pointSystem.stackedTiePoints = readBool("points_stacked_ties", config.pointSystem.stackedTiePoints);
+
+    config.positionRoundWeeks.clear();
+    for (const QJsonValue &week : json["position_round_weeks"].toArray()) {
+        config.positionRoundWeeks.append(week.toInt());
+    }
+
+    // Single nights are stored as a date, ranges as {from, to}
+    config.blackouts.clear();
+    for (const QJsonValue &value : json["blackout_dates"].toArray()) {
+        BlackoutPeriod period;
+        if (value.isObject()) {
+            period.from = QDate::fromString(value["from"].toString(), "yyyy-MM-dd");
+            period.to = QDate::fromString(value["to"].toString(), "yyyy-MM-dd");
+        } else {
+            period.from = QDate::fromString(value.toString(), "yyyy-MM-dd");
+            period.to = period.from;
+        }
+        if (period.from.isValid() && period.to >= period.from) {
+            config.blackouts.append(period);
+        }
+    }
+}
+
+QMap<int, LeagueConfig> LeagueConfigLoader::loadConfigs(const QSqlDatabase &database)
+{
+    QMap<int, LeagueConfig> configs;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    if (!query.exec(ALL_CONFIGS_SQL)) {
+        qWarning() << "Failed to load league configs:" << query.lastError().text();
+        return configs;
+    }
+
+    while (query.next()) {
+        const LeagueConfig config = readConfig(query);
+        configs.insert(config.leagueId, config);
+    }
+    return configs;
+}
+
+QMap<int, LeagueFigures> LeagueConfigLoader::loadFigures(const QSqlDatabase &database)
+{
+    QMap<int, LeagueFigures> figures;
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    // Bowlers with season rows, and the league average over every game they bowled
+    if (!query.exec(SEASON_FIGURES_SQL)) {
+        qWarning() << "Failed to load league figures:" << query.lastError().text();
+        return figures;
+    }
+    while (query.next()) {
+        LeagueFigures &league = figures[query.value(0).toInt()];
+        const int games = query.value(3).toInt();
+        league.activeBowlers = query.value(1).toInt();
+        league.averageScore = games > 0 ? query.value(2).toDouble() / games : 0.0;
+    }
+
+    if (!query.exec(COMPLETED_WEEKS_SQL)) {
+        qWarning() << "Failed to load completed weeks:" << query.lastError().text();
+        return figures;
+    }
+    while (query.next()) {
+        figures[query.value(0).toInt()].completedWeeks = query.value(1).toInt();
+    }
+    return figures;
+}
+
+bool LeagueConfigLoader::loadInto(const QSqlDatabase &database, const QString &configSql, const QVariant &value,
+                                  LeagueSnapshot *into)
+{
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    query.prepare(configSql);
+    if (value.isValid()) {
+        query.addBindValue(value);
+    }
+    if (!query.exec()) {
+        qWarning() << "Failed to load league configs:" << query.lastError().text();
+        return false;
+    }
+
+    QList<int> leagueIds;
+    while (query.next()) {
+        const LeagueConfig config = readConfig(query);
+        into->configs.insert(config.leagueId, config);
+        leagueIds.append(config.leagueId);
+    }
+
+    if (leagueIds.isEmpty()) {
+        return true;
+    }
+    const QString inLeagues = idList(leagueIds);
+
+    // Teams, with the name from teams when the junction row has none
+    if (!query.exec(LEAGUE_TEAMS_SQL.arg(inLeagues))) {
+        qWarning() << "Failed to load league teams:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        LeagueTeamData team;
+        team.leagueId = query.value(0).toInt();
+        team.teamId = query.value(1).toInt();
+        team.name = query.value(2).toString();
+        team.bowlerIds = intArray(query.value(3).toString());
+        team.divisionId = query.value(4).toInt();
+        team.wins = query.value(5).toInt();
+        team.losses = query.value(6).toInt();
+        team.ties = query.value(7).toInt();
+        team.totalPoints = query.value(8).toInt();
+        team.teamAverage = query.value(9).toDouble();
+        into->teams[team.leagueId].append(team);
+    }
+
+    if (!query.exec(LEAGUE_EVENTS_SQL.arg(inLeagues))) {
+        qWarning() << "Failed to load league events:" << query.lastError().text();
+        return false;
+    }
+    while (query.next()) {
+        LeagueEvent event;
+        event.eventId = query.value(0).toInt();
+        event.leagueId = query.value(1).toInt();
+        event.weekNumber = query.value(2).toInt();
+        event.scheduledTime = QDateTime::fromString(query.value(3).toString(), Qt::ISODate);
+        event.laneIds = intArray(query.value(4).toString());
+        event.eventCompleted = query.value(6).toBool();
+
+        const QJsonArray matchups = QJsonDocument::fromJson(query.value(5).toString().toUtf8())
+                                        .object()["matchups"].toArray();
+        for (const QJsonValue &value : matchups) {
+            const QJsonObject matchupObj = value.toObject();
+            LeagueEvent::Matchup matchup;
+            matchup.team1Id = matchupObj["team1_id"].toInt();
+            matchup.team2Id = matchupObj["team2_id"].toInt();
+            matchup.laneId = matchupObj["lane_id"].toInt();
+            matchup.completed = matchupObj["completed"].toBool();
+            matchup.team1Score = matchupObj["team1_score"].toInt();
+            matchup.team2Score = matchupObj["team2_score"].toInt();
+            matchup.team1Points = matchupObj["team1_points"].toInt();
+            matchup.team2Points = matchupObj["team2_points"].toInt();
+            for (const QJsonValue &gameId : matchupObj["game_ids"].toArray()) {
+                matchup.gameIds.append(gameId.toInt());
+            }
+            matchup.team1Games = intValues(matchupObj["team1_games"].toArray());
+            matchup.team2Games = intValues(matchupObj["team2_games"].toArray());
+            matchup.team1Handicaps = intValues(matchupObj["team1_handicaps"].toArray());
+            matchup.team2Handicaps = intValues(matchupObj["team2_handicaps"].toArray());
+            event.matchups.append(matchup);
+        }
+        into->events[event.leagueId].append(event);
+    }
+
+    return true;
+}
+
+LeagueSnapshot LeagueConfigLoader::loadActive(const QString &databasePath, const QString &connectionName)
+{
+    LeagueSnapshot snapshot;
+    QElapsedTimer timer;
+    timer.start();
+
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(databasePath);
+        database.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+
+        if (!database.open()) {
+            qWarning() << "League warm start could not open the database:" << database.lastError().text();
+        } else {
+            loadInto(database, ACTIVE_CONFIGS_SQL, QVariant(), &snapshot);
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+
+    snapshot.elapsedMs = timer.elapsed();
+    return snapshot;
+}
+
+bool LeagueConfigLoader::loadLeague(const QSqlDatabase &database, int leagueId, LeagueSnapshot *into)
+{
+    return loadInto(database, LEAGUE_CONFIG_SQL, leagueId, into) && into->configs.contains(leagueId);
+}
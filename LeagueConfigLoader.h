@@ -0,0 +1,50 @@
+﻿// LeagueConfigLoader.h
+#ifndef LEAGUECONFIGLOADER_H
+#define LEAGUECONFIGLOADER_H
+
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <QJsonObject>
+#include <QSqlDatabase>
+#include <QVariant>
+#include "LeagueManager.h"
+
+// The in-memory league model LeagueManager works from
+struct LeagueSnapshot {
+    QMap<int, LeagueConfig> configs;
+    QMap<int, QVector<LeagueEvent>> events;
+    QMap<int, QVector<LeagueTeamData>> teams;
+    qint64 elapsedMs = 0;
+};
+
+// Season figures the league list shows next to the config
+struct LeagueFigures {
+    int activeBowlers = 0;
+    double averageScore = 0.0;
+    int completedWeeks = 0;
+};
+
+// Reads league_configs, league_teams and league_events back into LeagueConfig,
+// LeagueTeamData and LeagueEvent. loadActive() is meant for a worker thread at
+// startup and opens its own connection; seasons that are completed or
+// cancelled are left out and loaded on first use with loadLeague().
+class LeagueConfigLoader
+{
+public:
+    static LeagueSnapshot loadActive(const QString &databasePath, const QString &connectionName);
+    static bool loadLeague(const QSqlDatabase &database, int leagueId, LeagueSnapshot *into);
+    static QMap<int, LeagueConfig> loadConfigs(const QSqlDatabase &database);
+    static QMap<int, LeagueFigures> loadFigures(const QSqlDatabase &database);
+
+    // config_json as written by LeagueManager::createLeague
+    static QJsonObject configToJson(const LeagueConfig &config);
+    static void applyConfigJson(LeagueConfig &config, const QJsonObject &json);
+
+private:
+    // configSql selects the league_configs rows; teams and events follow for those leagues
+    static bool loadInto(const QSqlDatabase &database, const QString &configSql, const QVariant &value,
+                         LeagueSnapshot *into);
+};
+
+#endif // LEAGUECONFIGLOADER_H
@@ -1,5 +1,6 @@
 ﻿#include "LeagueManagementDialog.h"
 #include "MainWindow.h"
+#include "LeagueConfigLoader.h"
 #include <QDateTime>
 
 LeagueManagementDialog::LeagueManagementDialog(MainWindow *mainWindow, QWidget *parent)
@@ -1420,12 +1421,43 @@ void LeagueManagementDialog::loadLeaguesFromDatabase()
     
     m_enhancedLeagues.clear();
     
+    // Stored configs, one read for every league; matched by id, then by name
+    const QMap<int, LeagueConfig> storedConfigs = LeagueConfigLoader::loadConfigs(QSqlDatabase::database());
+    const QMap<int, LeagueFigures> figures = LeagueConfigLoader::loadFigures(QSqlDatabase::database());
+    QMap<QString, int> configIdsByName;
+    for (auto it = storedConfigs.constBegin(); it != storedConfigs.constEnd(); ++it) {
+        configIdsByName.insert(it.value().name, it.key());
+    }
+    
     // Convert LeagueData to EnhancedLeagueInfo
     for (const LeagueData& dbLeague : dbLeagues) {
         EnhancedLeagueInfo league;
         league.basicInfo = dbLeague;
         
-        // Set defaults for enhanced fields (would load from extended config table in real implementation)
+        int configId = storedConfigs.contains(dbLeague.id) ? dbLeague.id : configIdsByName.value(dbLeague.name, -1);
+        if (configId >= 0 && storedConfigs.contains(configId)) {
+            const LeagueConfig &config = storedConfigs[configId];
+            league.startDate = config.startDate.toString("yyyy-MM-dd");
+            league.endDate = config.endDate.toString("yyyy-MM-dd");
+            league.numberOfWeeks = config.numberOfWeeks;
+            league.status = config.status.isEmpty() ? QString("Scheduled")
+                                                    : config.status.left(1).toUpper() + config.status.mid(1);
+            league.createdAt = dbLeague.createdAt;
+            league.totalTeams = dbLeague.teamCount;
+            const LeagueFigures leagueFigures = figures.value(configId);
+            league.activeBowlers = leagueFigures.activeBowlers;
+            league.averageScore = leagueFigures.averageScore;
+            league.completedWeeks = leagueFigures.completedWeeks;
+            
+            league.advancedConfig = config;
+            league.advancedConfig.leagueId = dbLeague.id;
+            league.advancedConfig.name = dbLeague.name;
+            
+            m_enhancedLeagues.append(league);
+            continue;
+        }
+        
+        // No stored config yet: defaults for enhanced fields
         league.startDate = "2024-09-01";
         league.endDate = "2024-12-15";
         league.numberOfWeeks = 16;
@@ -1,11 +1,86 @@
 ﻿#include "LeagueManager.h"
 #include "LaneServer.h"
+#include "LeagueScheduler.h"
+#include "ScheduleOptimizer.h"
+#include "LeagueCalculator.h"
+#include "LeagueSimulator.h"
+#include "LeagueConfigLoader.h"
+#include "PointsEngine.h"
+#include "BusEvents.h"
+#include "QueryPlanAudit.h"
 #include <QDebug>
 #include <QSqlQuery>
 #include <QSqlError>
 #include <QJsonDocument>
 #include <QtMath>
 #include <QRandomGenerator>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+namespace {
+
+MatchupScores toMatchupScores(const LeagueEvent::Matchup &matchup, int games)
+{
+    MatchupScores scores;
+    scores.resize(qMax(matchup.team1Handicaps.size(), matchup.team2Handicaps.size()), games);
+    scores.team1Id = matchup.team1Id;
+    scores.team2Id = matchup.team2Id;
+    
+    std::copy_n(matchup.team1Games.constBegin(), qMin(matchup.team1Games.size(), scores.team1Scratch.size()),
+                scores.team1Scratch.begin());
+    std::copy_n(matchup.team2Games.constBegin(), qMin(matchup.team2Games.size(), scores.team2Scratch.size()),
+                scores.team2Scratch.begin());
+    std::copy_n(matchup.team1Handicaps.constBegin(), matchup.team1Handicaps.size(), scores.team1Handicaps.begin());
+    std::copy_n(matchup.team2Handicaps.constBegin(), matchup.team2Handicaps.size(), scores.team2Handicaps.begin());
+    return scores;
+}
+
+// Every fixed statement, registered for --audit-queries
+const QString CREATE_LEAGUE_SQL = QueryPlanAudit::statement("LeagueManager::createLeague",
+    "INSERT INTO league_configs (name, start_date, end_date, number_of_weeks, "
+    "lane_ids, status, config_json) VALUES (?, ?, ?, ?, ?, ?, ?)");
+const QString CLEAR_SCHEDULE_SQL = QueryPlanAudit::statement("LeagueManager::generateLeagueSchedule",
+    "DELETE FROM league_events WHERE league_id = ?");
+const QString ROSTER_FIGURES_SQL = QueryPlanAudit::statement("LeagueManager::refreshRosterFigures",
+    "SELECT bowler_id, games_played, total_pins, balls_thrown, current_average, current_handicap "
+    "FROM bowler_season_data WHERE league_id = ?");
+const QString UPDATE_ROSTER_FIGURES_SQL = QueryPlanAudit::statement("LeagueManager::refreshRosterFigures",
+    "UPDATE bowler_season_data SET current_average = ?, current_handicap = ?, last_updated = ? "
+    "WHERE bowler_id = ? AND league_id = ?");
+const QString UNUSED_PREBOWLS_SQL = QueryPlanAudit::statement("LeagueManager::resolveAbsentees",
+    "SELECT prebowl_id, bowler_id, game_data, date(created_at) FROM prebowl_games "
+    "WHERE bowler_id IN (%1) AND league_id = ? AND times_used < MIN(max_uses, ?) "
+    "ORDER BY bowler_id, prebowl_id");
+const QString ADD_PREBOWL_SQL = QueryPlanAudit::statement("LeagueManager::recordPreBowlGame",
+    "INSERT INTO prebowl_games (bowler_id, league_id, game_data, max_uses) VALUES (?, ?, ?, ?)");
+const QString MARK_PREBOWL_USED_SQL = QueryPlanAudit::statement("LeagueManager::usePreBowlGame",
+    "UPDATE prebowl_games SET times_used = times_used + 1 WHERE prebowl_id = ?");
+const QString AVAILABLE_PREBOWLS_SQL = QueryPlanAudit::statement("LeagueManager::getAvailablePreBowls",
+    "SELECT prebowl_id FROM prebowl_games WHERE bowler_id = ? AND league_id = ? AND times_used < max_uses");
+const QString PREBOWL_GAME_SQL = QueryPlanAudit::statement("LeagueManager::usePreBowlGame",
+    "SELECT game_data FROM prebowl_games WHERE prebowl_id = ?");
+const QString UPDATE_TEAM_STANDING_SQL = QueryPlanAudit::statement("LeagueManager::calculateEventPoints",
+    "UPDATE league_teams SET total_points = total_points + ?, wins = wins + ?, "
+    "losses = losses + ?, ties = ties + ? WHERE league_id = ? AND team_id = ?");
+const QString UPDATE_EVENT_SQL = QueryPlanAudit::statement("LeagueManager::saveLeagueEvent",
+    "UPDATE league_events SET matchups_json = ?, event_completed = ? WHERE event_id = ?");
+const QString INSERT_EVENT_SQL = QueryPlanAudit::statement("LeagueManager::saveLeagueEvent",
+    "INSERT INTO league_events (league_id, week_number, scheduled_time, "
+    "lane_ids, matchups_json, event_completed) VALUES (?, ?, ?, ?, ?, ?)");
+const QString BOWLER_SEASON_SQL = QueryPlanAudit::statement("LeagueManager::loadBowlerSeasonData",
+    "SELECT * FROM bowler_season_data WHERE bowler_id = ? AND league_id = ?");
+const QString LEAGUE_SEASON_SQL = QueryPlanAudit::statement("LeagueManager::loadLeagueSeasonData",
+    "SELECT * FROM bowler_season_data WHERE league_id = ?");
+const QString SAVE_BOWLER_SEASON_SQL = QueryPlanAudit::statement("LeagueManager::saveBowlerSeasonData",
+    "INSERT OR REPLACE INTO bowler_season_data "
+    "(bowler_id, league_id, team_id, current_average, current_handicap, "
+    "games_played, total_pins, balls_thrown, strikes, spares, high_game, "
+    "high_series, prebowl_games, last_updated) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+
+} // namespace
 
 LeagueManager::LeagueManager(LaneServer *laneServer, QObject *parent)
     : QObject(parent)
@@ -14,6 +89,7 @@ LeagueManager::LeagueManager(LaneServer *laneServer, QObject *parent)
     , m_updateTimer(new QTimer(this))
 {
     initializeDatabase();
+    startWarmStart();
     
     // Setup periodic updates (every 5 minutes)
     m_updateTimer->setInterval(300000);
@@ -26,87 +102,111 @@ LeagueManager::LeagueManager(LaneServer *laneServer, QObject *parent)
 LeagueManager::~LeagueManager()
 {
     m_updateTimer->stop();
+    
+    if (m_warmStartThread) {
+        m_warmStartThread->wait();
+        delete m_warmStartThread;
+    }
 }
 
 void LeagueManager::initializeDatabase()
 {
-    // Create league management tables
-    QSqlQuery query;
+    // League tables are created by DatabaseManager's versioned schema migrations
+    if (!m_dbManager->migrateSchema()) {
+        qWarning() << "Database initialization error: league tables are not up to date";
+    }
+}
+
+void LeagueManager::startWarmStart()
+{
+    // Configs, teams and schedules of the running seasons are read on a worker
+    // thread with its own connection, so the GUI keeps painting while they load
+    const QString databasePath = QSqlDatabase::database().databaseName();
+    std::shared_ptr<LeagueSnapshot> snapshot = std::make_shared<LeagueSnapshot>();
+    m_warmStartSnapshot = snapshot;
+    
+    m_warmStartThread = QThread::create([databasePath, snapshot]() {
+        *snapshot = LeagueConfigLoader::loadActive(databasePath, "league_warm_start");
+    });
+    connect(m_warmStartThread, &QThread::finished, this, &LeagueManager::applyWarmStart);
+    m_warmStartThread->start();
+}
+
+void LeagueManager::applyWarmStart()
+{
+    if (!m_warmStartThread) {
+        return; // Already applied by ensureWarmStarted()
+    }
+    
+    m_warmStartThread->wait();
+    m_warmStartThread->deleteLater();
+    m_warmStartThread = nullptr;
+    
+    mergeSnapshot(*m_warmStartSnapshot);
+    const int leagueCount = m_warmStartSnapshot->configs.size();
+    const qint64 elapsedMs = m_warmStartSnapshot->elapsedMs;
+    m_warmStartSnapshot.reset();
+    m_warmStarted = true;
+    m_missingLeagues.clear();
+    
+    qDebug() << "Warm start loaded" << leagueCount << "active leagues in" << elapsedMs << "ms";
+    emit leaguesLoaded(leagueCount, elapsedMs);
+}
+
+void LeagueManager::ensureWarmStarted()
+{
+    // A league message that beats the worker waits for it rather than
+    // finding an empty model
+    if (m_warmStartThread) {
+        applyWarmStart();
+    }
+}
+
+bool LeagueManager::ensureLeagueLoaded(int leagueId)
+{
+    ensureWarmStarted();
     
-    // League configurations table
-    query.exec("CREATE TABLE IF NOT EXISTS league_configs ("
-              "league_id INTEGER PRIMARY KEY, "
-              "name TEXT NOT NULL, "
-              "start_date TEXT, "
-              "end_date TEXT, "
-              "number_of_weeks INTEGER, "
-              "lane_ids TEXT, "
-              "status TEXT DEFAULT 'scheduled', "
-              "config_json TEXT, "
-              "created_at DATETIME DEFAULT CURRENT_TIMESTAMP"
-              ")");
-    
-    // League teams table
-    query.exec("CREATE TABLE IF NOT EXISTS league_teams ("
-              "team_id INTEGER PRIMARY KEY, "
-              "league_id INTEGER, "
-              "name TEXT NOT NULL, "
-              "bowler_ids TEXT, "
-              "division_id INTEGER DEFAULT 0, "
-              "wins INTEGER DEFAULT 0, "
-              "losses INTEGER DEFAULT 0, "
-              "ties INTEGER DEFAULT 0, "
-              "total_points INTEGER DEFAULT 0, "
-              "team_average REAL DEFAULT 0.0, "
-              "FOREIGN KEY(league_id) REFERENCES league_configs(league_id)"
-              ")");
-    
-    // Bowler season data table
-    query.exec("CREATE TABLE IF NOT EXISTS bowler_season_data ("
-              "bowler_id INTEGER, "
-              "league_id INTEGER, "
-              "team_id INTEGER, "
-              "current_average REAL DEFAULT 0.0, "
-              "current_handicap REAL DEFAULT 0.0, "
-              "games_played INTEGER DEFAULT 0, "
-              "total_pins INTEGER DEFAULT 0, "
-              "balls_thrown INTEGER DEFAULT 0, "
-              "strikes INTEGER DEFAULT 0, "
-              "spares INTEGER DEFAULT 0, "
-              "high_game INTEGER DEFAULT 0, "
-              "high_series INTEGER DEFAULT 0, "
-              "prebowl_games TEXT, "
-              "last_updated DATETIME DEFAULT CURRENT_TIMESTAMP, "
-              "PRIMARY KEY(bowler_id, league_id)"
-              ")");
-    
-    // League events table
-    query.exec("CREATE TABLE IF NOT EXISTS league_events ("
-              "event_id INTEGER PRIMARY KEY, "
-              "league_id INTEGER, "
-              "week_number INTEGER, "
-              "scheduled_time DATETIME, "
-              "lane_ids TEXT, "
-              "matchups_json TEXT, "
-              "event_completed BOOLEAN DEFAULT 0, "
-              "FOREIGN KEY(league_id) REFERENCES league_configs(league_id)"
-              ")");
-    
-    // Pre-bowl games table
-    query.exec("CREATE TABLE IF NOT EXISTS prebowl_games ("
-              "prebowl_id INTEGER PRIMARY KEY, "
-              "bowler_id INTEGER, "
-              "league_id INTEGER, "
-              "game_data TEXT, "
-              "times_used INTEGER DEFAULT 0, "
-              "max_uses INTEGER DEFAULT 1, "
-              "created_at DATETIME DEFAULT CURRENT_TIMESTAMP, "
-              "FOREIGN KEY(bowler_id) REFERENCES bowlers(id), "
-              "FOREIGN KEY(league_id) REFERENCES league_configs(league_id)"
-              ")");
-    
-    if (query.lastError().isValid()) {
-        qWarning() << "Database initialization error:" << query.lastError().text();
+    if (m_leagueConfigs.contains(leagueId)) {
+        return true;
+    }
+    // A league another connection creates shows up once the retry is due
+    auto missing = m_missingLeagues.constFind(leagueId);
+    if (missing != m_missingLeagues.constEnd()
+        && missing.value().secsTo(QDateTime::currentDateTime()) < MISSING_LEAGUE_RETRY_SECS) {
+        return false;
+    }
+    
+    // Completed and cancelled seasons are left out of the warm start
+    LeagueSnapshot snapshot;
+    if (!LeagueConfigLoader::loadLeague(QSqlDatabase::database(), leagueId, &snapshot)) {
+        qWarning() << "League not found:" << leagueId;
+        m_missingLeagues.insert(leagueId, QDateTime::currentDateTime());
+        return false;
+    }
+    
+    m_missingLeagues.remove(leagueId);
+    mergeSnapshot(snapshot);
+    return true;
+}
+
+void LeagueManager::mergeSnapshot(const LeagueSnapshot &snapshot)
+{
+    // Anything this session already created or changed is newer than the snapshot
+    for (auto it = snapshot.configs.constBegin(); it != snapshot.configs.constEnd(); ++it) {
+        if (!m_leagueConfigs.contains(it.key())) {
+            m_leagueConfigs.insert(it.key(), it.value());
+            m_calculators.remove(it.key());
+        }
+    }
+    for (auto it = snapshot.teams.constBegin(); it != snapshot.teams.constEnd(); ++it) {
+        if (!m_leagueTeams.contains(it.key())) {
+            m_leagueTeams.insert(it.key(), it.value());
+        }
+    }
+    for (auto it = snapshot.events.constBegin(); it != snapshot.events.constEnd(); ++it) {
+        if (!m_leagueEvents.contains(it.key())) {
+            m_leagueEvents.insert(it.key(), it.value());
+        }
     }
 }
 
@@ -118,8 +218,7 @@ int LeagueManager::createLeague(const LeagueConfig &config)
     }
     
     QSqlQuery query;
-    query.prepare("INSERT INTO league_configs (name, start_date, end_date, number_of_weeks, "
-                 "lane_ids, status, config_json) VALUES (?, ?, ?, ?, ?, ?, ?)");
+    query.prepare(CREATE_LEAGUE_SQL);
     
     // Convert lane IDs to JSON string
     QJsonArray laneArray;
@@ -128,41 +227,7 @@ int LeagueManager::createLeague(const LeagueConfig &config)
     }
     
     // Convert config to JSON
-    QJsonObject configJson;
-    configJson["avg_calc_type"] = static_cast<int>(config.avgCalc.type);
-    configJson["avg_calc_interval"] = config.avgCalc.updateInterval;
-    configJson["avg_delay_games"] = config.avgCalc.delayGames;
-    
-    configJson["hdcp_calc_type"] = static_cast<int>(config.hdcpCalc.type);
-    configJson["hdcp_high_value"] = config.hdcpCalc.highValue;
-    configJson["hdcp_percentage"] = config.hdcpCalc.percentage;
-    configJson["hdcp_deduction"] = config.hdcpCalc.deduction;
-    configJson["hdcp_delay_games"] = config.hdcpCalc.delayGames;
-    
-    configJson["absent_type"] = static_cast<int>(config.absentHandling.type);
-    configJson["absent_percentage"] = config.absentHandling.percentage;
-    configJson["absent_fixed_value"] = config.absentHandling.fixedValue;
-    
-    configJson["prebowl_enabled"] = config.preBowlRules.enabled;
-    configJson["prebowl_carry_over"] = config.preBowlRules.carryToNextSeason;
-    configJson["prebowl_random_use"] = config.preBowlRules.randomUseWhenAbsent;
-    configJson["prebowl_use_by"] = static_cast<int>(config.preBowlRules.useBy);
-    configJson["prebowl_max_uses"] = config.preBowlRules.maxUsesPerGame;
-    
-    configJson["divisions_count"] = config.divisions.count;
-    configJson["divisions_reorder"] = config.divisions.reorderMidSeason;
-    configJson["divisions_order_by"] = static_cast<int>(config.divisions.orderBy);
-    
-    configJson["playoffs_type"] = static_cast<int>(config.playoffs.type);
-    configJson["playoffs_division_only"] = config.playoffs.divisionOnly;
-    
-    configJson["points_type"] = static_cast<int>(config.pointSystem.type);
-    configJson["points_win"] = config.pointSystem.winPoints;
-    configJson["points_loss"] = config.pointSystem.lossPoints;
-    configJson["points_tie"] = config.pointSystem.tiePoints;
-    configJson["points_heads_up"] = config.pointSystem.includeHeadsUp;
-    configJson["points_heads_up_hdcp"] = config.pointSystem.headsUpWithHandicap;
-    configJson["points_stacked_ties"] = config.pointSystem.stackedTiePoints;
+    const QJsonObject configJson = LeagueConfigLoader::configToJson(config);
     
     query.addBindValue(config.name);
     query.addBindValue(config.startDate.toString("yyyy-MM-dd"));
@@ -183,6 +248,8 @@ int LeagueManager::createLeague(const LeagueConfig &config)
     LeagueConfig newConfig = config;
     newConfig.leagueId = leagueId;
     m_leagueConfigs[leagueId] = newConfig;
+    m_calculators.remove(leagueId);
+    m_missingLeagues.remove(leagueId);
     
     emit leagueCreated(leagueId, config.name);
     
@@ -192,58 +259,122 @@ int LeagueManager::createLeague(const LeagueConfig &config)
 
 bool LeagueManager::generateLeagueSchedule(int leagueId)
 {
-    if (!m_leagueConfigs.contains(leagueId)) {
+    if (!ensureLeagueLoaded(leagueId)) {
         qWarning() << "League not found:" << leagueId;
         return false;
     }
     
     const LeagueConfig &config = m_leagueConfigs[leagueId];
-    QVector<TeamData> teams = getLeagueTeams(leagueId);
+    QVector<LeagueTeamData> teams = getLeagueTeams(leagueId);
     
     if (teams.size() < 2) {
         qWarning() << "Not enough teams to generate schedule for league" << leagueId;
         return false;
     }
     
-    // Generate round-robin schedule
-    QVector<QPair<int, int>> matchupPairs = generateRoundRobinPairs(
-        QVector<int>(teams.begin(), teams.end(), [](const TeamData &t) { return t.teamId; }));
+    QVector<int> teamIds;
+    teamIds.reserve(teams.size());
+    for (const LeagueTeamData &team : teams) {
+        teamIds.append(team.teamId);
+    }
+    
+    QSet<int> positionRoundWeeks;
+    for (int week : config.positionRoundWeeks) {
+        positionRoundWeeks.insert(week);
+    }
+    
+    // Circle-method round robin: every team bowls once per week, byes for odd counts
+    QVector<ScheduledWeek> weeks = LeagueScheduler::buildSeason(teamIds, config.numberOfWeeks,
+                                                               config.laneIds.size(), positionRoundWeeks);
+    if (weeks.isEmpty()) {
+        qWarning() << "Could not build schedule for league" << leagueId
+                   << "(" << teamIds.size() << "teams," << config.laneIds.size() << "lanes)";
+        return false;
+    }
+    
+    QStringList problems = LeagueScheduler::validateSeason(weeks, teamIds, config.laneIds.size());
+    if (!problems.isEmpty()) {
+        qWarning() << "Generated schedule for league" << leagueId << "failed validation:" << problems;
+        return false;
+    }
     
-    // Calculate games needed for complete round-robin
-    int gamesPerWeek = config.laneIds.size();
-    int totalMatchups = matchupPairs.size();
-    int weeksNeeded = qCeil(static_cast<double>(totalMatchups) / gamesPerWeek);
+    // A new schedule replaces the old one, which is only safe before any of it is bowled
+    for (const LeagueEvent &existing : m_leagueEvents.value(leagueId)) {
+        bool started = existing.eventCompleted;
+        for (const LeagueEvent::Matchup &matchup : existing.matchups) {
+            started = started || matchup.completed;
+        }
+        if (started) {
+            qWarning() << "League" << leagueId << "has bowled week" << existing.weekNumber
+                       << "- not regenerating its schedule";
+            return false;
+        }
+    }
+    
+    auto blackedOut = [&config](const QDate &date) {
+        for (const BlackoutPeriod &period : config.blackouts) {
+            if (period.contains(date)) {
+                return true;
+            }
+        }
+        return false;
+    };
     
     // Generate events for each week
     QVector<LeagueEvent> events;
-    int currentMatchupIndex = 0;
+    events.reserve(weeks.size());
+    QDate eventDate = config.startDate;
     
-    for (int week = 1; week <= config.numberOfWeeks && week <= weeksNeeded; ++week) {
+    for (const ScheduledWeek &week : weeks) {
         LeagueEvent event;
+        event.eventId = 0;
         event.leagueId = leagueId;
-        event.weekNumber = week;
-        event.scheduledTime = QDateTime(config.startDate.addDays((week - 1) * 7), QTime(19, 0));
+        event.weekNumber = week.weekNumber;
+        // Blackouts push the rest of the season back a week at a time
+        while (blackedOut(eventDate)) {
+            eventDate = eventDate.addDays(7);
+        }
+        event.scheduledTime = QDateTime(eventDate, QTime(19, 0));
+        eventDate = eventDate.addDays(7);
         event.laneIds = config.laneIds;
         
-        // Assign matchups to lanes for this week
-        for (int lane = 0; lane < config.laneIds.size() && currentMatchupIndex < totalMatchups; ++lane) {
-            if (currentMatchupIndex < matchupPairs.size()) {
-                LeagueEvent::Matchup matchup;
-                matchup.team1Id = matchupPairs[currentMatchupIndex].first;
-                matchup.team2Id = matchupPairs[currentMatchupIndex].second;
-                matchup.laneId = config.laneIds[lane];
-                
-                event.matchups.append(matchup);
-                currentMatchupIndex++;
-            }
+        for (const ScheduledMatchup &scheduled : week.matchups) {
+            LeagueEvent::Matchup matchup;
+            matchup.team1Id = scheduled.team1Id;
+            matchup.team2Id = scheduled.team2Id;
+            matchup.laneId = config.laneIds[scheduled.slot];
+            
+            event.matchups.append(matchup);
         }
         
         events.append(event);
     }
     
-    // Save events to database
-    for (const LeagueEvent &event : events) {
-        saveLeagueEvent(event);
+    // Save events to database, in place of any earlier schedule
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
+    
+    QSqlQuery clear;
+    clear.prepare(CLEAR_SCHEDULE_SQL);
+    clear.addBindValue(leagueId);
+    if (!clear.exec()) {
+        qWarning() << "Failed to clear old schedule for league" << leagueId << ":" << clear.lastError().text();
+        database.rollback();
+        return false;
+    }
+    
+    for (LeagueEvent &event : events) {
+        event.eventId = saveLeagueEvent(event);
+        if (event.eventId < 0) {
+            database.rollback();
+            return false;
+        }
+    }
+    
+    if (!database.commit()) {
+        qWarning() << "Failed to commit schedule for league" << leagueId << ":" << database.lastError().text();
+        database.rollback();
+        return false;
     }
     
     m_leagueEvents[leagueId] = events;
@@ -252,25 +383,216 @@ bool LeagueManager::generateLeagueSchedule(int leagueId)
     return true;
 }
 
+bool LeagueManager::optimizeLeagueSchedule(int leagueId, int timeBudgetMs)
+{
+    if (!ensureLeagueLoaded(leagueId) || !m_leagueEvents.contains(leagueId)) {
+        qWarning() << "No schedule to optimise for league" << leagueId;
+        return false;
+    }
+    
+    const LeagueConfig &config = m_leagueConfigs[leagueId];
+    QVector<LeagueEvent> &events = m_leagueEvents[leagueId];
+    
+    QVector<int> teamIds;
+    for (const LeagueTeamData &team : getLeagueTeams(leagueId)) {
+        teamIds.append(team.teamId);
+    }
+    
+    QHash<int, int> laneSlot;
+    for (int slot = 0; slot < config.laneIds.size(); ++slot) {
+        laneSlot[config.laneIds[slot]] = slot;
+    }
+    
+    ScheduleOptimizerOptions options;
+    options.timeBudgetMs = timeBudgetMs;
+    
+    QVector<ScheduledWeek> weeks;
+    weeks.reserve(events.size());
+    
+    for (const LeagueEvent &event : events) {
+        ScheduledWeek week;
+        week.weekNumber = event.weekNumber;
+        
+        // Weeks already under way are frozen: they still count towards lane usage
+        bool started = event.eventCompleted;
+        for (const LeagueEvent::Matchup &matchup : event.matchups) {
+            started = started || matchup.completed;
+        }
+        week.positionRound = started || config.positionRoundWeeks.contains(event.weekNumber);
+        
+        for (const LeagueEvent::Matchup &matchup : event.matchups) {
+            ScheduledMatchup scheduled;
+            scheduled.team1Id = matchup.team1Id;
+            scheduled.team2Id = matchup.team2Id;
+            scheduled.slot = laneSlot.value(matchup.laneId, -1);
+            week.matchups.append(scheduled);
+        }
+        
+        // Lanes booked by anything other than this league that night
+        QDate date = event.scheduledTime.date();
+        QTime startTime = event.scheduledTime.time();
+        QTime endTime = startTime.addSecs(LEAGUE_NIGHT_MINUTES * 60);
+        for (int slot = 0; slot < config.laneIds.size(); ++slot) {
+            const QVector<CalendarEventData> conflicts =
+                m_dbManager->getConflictingEvents(date, startTime, endTime, config.laneIds[slot]);
+            for (const CalendarEventData &conflict : conflicts) {
+                if (conflict.leagueId != leagueId) {
+                    options.blockedSlots[event.weekNumber].insert(slot);
+                    break;
+                }
+            }
+        }
+        
+        weeks.append(week);
+    }
+    
+    ScheduleOptimizerResult result = ScheduleOptimizer::optimize(weeks, teamIds, config.laneIds.size(), options);
+    
+    for (int i = 0; i < events.size(); ++i) {
+        if (weeks[i].positionRound) continue;
+        
+        LeagueEvent &event = events[i];
+        event.matchups.clear();
+        for (const ScheduledMatchup &scheduled : result.weeks[i].matchups) {
+            LeagueEvent::Matchup matchup;
+            matchup.team1Id = scheduled.team1Id;
+            matchup.team2Id = scheduled.team2Id;
+            matchup.laneId = (scheduled.slot >= 0) ? config.laneIds[scheduled.slot] : 0;
+            event.matchups.append(matchup);
+        }
+        saveLeagueEvent(event);
+    }
+    
+    if (result.blockedMatchups > 0) {
+        qWarning() << "League" << leagueId << "schedule still has" << result.blockedMatchups
+                   << "matchups on booked lanes";
+    }
+    
+    qDebug() << "Optimised schedule for league" << leagueId << "- repeats:" << result.backToBackRepeats
+             << "blocked:" << result.blockedMatchups << "iterations:" << result.iterations;
+    return result.blockedMatchups == 0;
+}
+
 QVector<QPair<int, int>> LeagueManager::generateRoundRobinPairs(const QVector<int> &teamIds) const
 {
     QVector<QPair<int, int>> pairs;
-    int teamCount = teamIds.size();
     
-    // Standard round-robin algorithm
-    for (int i = 0; i < teamCount; ++i) {
-        for (int j = i + 1; j < teamCount; ++j) {
-            pairs.append(QPair<int, int>(teamIds[i], teamIds[j]));
+    // Circle-method rounds flattened in play order, byes dropped
+    const QVector<QVector<QPair<int, int>>> rounds = LeagueScheduler::circleRounds(teamIds);
+    for (const QVector<QPair<int, int>> &round : rounds) {
+        for (const QPair<int, int> &pair : round) {
+            if (pair.first != LeagueScheduler::BYE_TEAM && pair.second != LeagueScheduler::BYE_TEAM) {
+                pairs.append(pair);
+            }
         }
     }
     
     return pairs;
 }
 
+void LeagueManager::assignLanesToMatchups(int leagueId, LeagueEvent &event) const
+{
+    const LeagueConfig config = m_leagueConfigs.value(leagueId);
+    const int laneSlots = config.laneIds.size();
+    if (laneSlots == 0) {
+        return;
+    }
+    
+    QHash<int, int> teamIndex;
+    QHash<int, int> laneSlot;
+    for (int slot = 0; slot < laneSlots; ++slot) {
+        laneSlot[config.laneIds[slot]] = slot;
+    }
+    
+    auto indexOf = [&teamIndex](int teamId) {
+        auto it = teamIndex.find(teamId);
+        if (it == teamIndex.end()) {
+            it = teamIndex.insert(teamId, teamIndex.size());
+        }
+        return it.value();
+    };
+    
+    QVector<QPair<int, int>> pairs;
+    for (const LeagueEvent::Matchup &matchup : event.matchups) {
+        indexOf(matchup.team1Id);
+        indexOf(matchup.team2Id);
+        pairs.append(QPair<int, int>(matchup.team1Id, matchup.team2Id));
+    }
+    
+    // Count how often each team has already bowled on each lane this season
+    QVector<int> laneUsage(teamIndex.size() * laneSlots, 0);
+    for (const LeagueEvent &other : m_leagueEvents.value(leagueId)) {
+        if (other.weekNumber == event.weekNumber) continue;
+        for (const LeagueEvent::Matchup &matchup : other.matchups) {
+            int slot = laneSlot.value(matchup.laneId, -1);
+            if (slot < 0) continue;
+            if (teamIndex.contains(matchup.team1Id)) laneUsage[teamIndex[matchup.team1Id] * laneSlots + slot]++;
+            if (teamIndex.contains(matchup.team2Id)) laneUsage[teamIndex[matchup.team2Id] * laneSlots + slot]++;
+        }
+    }
+    
+    QVector<int> slots = LeagueScheduler::assignSlots(pairs, laneSlots, teamIndex, laneUsage, event.weekNumber);
+    for (int i = 0; i < event.matchups.size(); ++i) {
+        event.matchups[i].laneId = (slots[i] >= 0) ? config.laneIds[slots[i]] : 0;
+    }
+}
+
+bool LeagueManager::fillPositionRound(int leagueId, int weekNumber)
+{
+    if (!m_leagueEvents.contains(leagueId)) {
+        qWarning() << "No events found for league" << leagueId;
+        return false;
+    }
+    
+    QVector<LeagueEvent> &events = m_leagueEvents[leagueId];
+    LeagueEvent *positionEvent = nullptr;
+    for (LeagueEvent &event : events) {
+        if (event.weekNumber == weekNumber) {
+            positionEvent = &event;
+            break;
+        }
+    }
+    
+    if (!positionEvent) {
+        qWarning() << "Week" << weekNumber << "not scheduled for league" << leagueId;
+        return false;
+    }
+    
+    // Rank teams by points, then pair 1v2, 3v4, ...
+    QVector<LeagueTeamData> teams = getLeagueTeams(leagueId);
+    std::stable_sort(teams.begin(), teams.end(),
+                     [](const LeagueTeamData &a, const LeagueTeamData &b) {
+                         return a.totalPoints > b.totalPoints;
+                     });
+    
+    QVector<int> rankedTeamIds;
+    for (const LeagueTeamData &team : teams) {
+        rankedTeamIds.append(team.teamId);
+    }
+    
+    positionEvent->matchups.clear();
+    for (const QPair<int, int> &pair : LeagueScheduler::positionRoundPairs(rankedTeamIds)) {
+        if (pair.second == LeagueScheduler::BYE_TEAM) continue;
+        
+        LeagueEvent::Matchup matchup;
+        matchup.team1Id = pair.first;
+        matchup.team2Id = pair.second;
+        positionEvent->matchups.append(matchup);
+    }
+    
+    assignLanesToMatchups(leagueId, *positionEvent);
+    saveLeagueEvent(*positionEvent);
+    
+    qDebug() << "Filled position round week" << weekNumber << "for league" << leagueId;
+    return true;
+}
+
 void LeagueManager::processLeagueGame(int leagueId, int eventId, int laneId, const QJsonObject &gameData)
 {
     qDebug() << "Processing league game for league" << leagueId << "event" << eventId << "lane" << laneId;
     
+    ensureLeagueLoaded(leagueId);
+    
     // Find the corresponding event and matchup
     if (!m_leagueEvents.contains(leagueId)) {
         qWarning() << "No events found for league" << leagueId;
@@ -312,12 +634,13 @@ void LeagueManager::processLeagueGame(int leagueId, int eventId, int laneId, con
     }
     
     // Update matchup results
+    const bool matchupComplete = recordMatchupGames(leagueId, *currentMatchup, gameData);
     currentMatchup->team1Score = gameData["team1_total"].toInt();
     currentMatchup->team2Score = gameData["team2_total"].toInt();
-    currentMatchup->completed = true;
+    currentMatchup->completed = currentMatchup->completed || matchupComplete;
     
     // Calculate points based on league point system
-    calculateHeadsUpPoints(*currentMatchup, currentMatchup->team1Points, currentMatchup->team2Points);
+    calculateHeadsUpPoints(leagueId, *currentMatchup, currentMatchup->team1Points, currentMatchup->team2Points);
     
     // Check if event is complete
     bool eventComplete = true;
@@ -328,10 +651,20 @@ void LeagueManager::processLeagueGame(int leagueId, int eventId, int laneId, con
         }
     }
     
-    if (eventComplete) {
+    // Standings are added to, so the night is scored once; a game re-sent
+    // after that only updates the stored matrix
+    if (eventComplete && !currentEvent->eventCompleted) {
         currentEvent->eventCompleted = true;
         calculateEventPoints(eventId);
+        // Every league, so rule changes saved for another league since its
+        // last night are applied too; rows that did not move are not written
+        refreshAllRosterFigures();
         emit eventCompleted(eventId, leagueId);
+
+        LeagueEventCompletedEvent completed;
+        completed.leagueId = leagueId;
+        completed.eventId = eventId;
+        EventBus::instance()->publish(completed);
     }
     
     // Update team and league standings
@@ -378,142 +711,505 @@ void LeagueManager::processBowlerGame(int bowlerId, int leagueId, const QJsonObj
     emit bowlerStatisticsUpdated(bowlerId, leagueId);
 }
 
+const LeagueCalculator &LeagueManager::calculatorFor(int leagueId) const
+{
+    // The rule types are resolved once per league, not on every call
+    std::shared_ptr<LeagueCalculator> &calculator = m_calculators[leagueId];
+    if (!calculator) {
+        calculator = LeagueCalculator::create(m_leagueConfigs.value(leagueId));
+    }
+    return *calculator;
+}
+
 double LeagueManager::calculateBowlerAverage(int bowlerId, int leagueId) const
 {
-    const LeagueConfig &config = m_leagueConfigs[leagueId];
     BowlerSeasonData bowlerData = loadBowlerSeasonData(bowlerId, leagueId);
     
-    if (bowlerData.gamesPlayed < config.avgCalc.delayGames) {
-        return 0.0; // Not enough games played yet
+    return calculatorFor(leagueId).average(bowlerData.gamesPlayed, bowlerData.totalPins,
+                                           bowlerData.ballsThrown, bowlerData.currentAverage);
+}
+
+double LeagueManager::calculateBowlerHandicap(int bowlerId, int leagueId) const
+{
+    const LeagueCalculator &calculator = calculatorFor(leagueId);
+    BowlerSeasonData bowlerData = loadBowlerSeasonData(bowlerId, leagueId);
+    
+    double average = calculator.average(bowlerData.gamesPlayed, bowlerData.totalPins,
+                                        bowlerData.ballsThrown, bowlerData.currentAverage);
+    return calculator.handicap(bowlerData.gamesPlayed, average);
+}
+
+int LeagueManager::calculateAbsentScore(int bowlerId, int leagueId) const
+{
+    return calculatorFor(leagueId).absentScore(calculateBowlerAverage(bowlerId, leagueId));
+}
+
+bool LeagueManager::refreshRosterFigures(int leagueId)
+{
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare(ROSTER_FIGURES_SQL);
+    query.addBindValue(leagueId);
+    
+    if (!query.exec()) {
+        qWarning() << "Failed to load roster for league" << leagueId << ":" << query.lastError().text();
+        return false;
+    }
+    
+    RosterColumns roster;
+    QVector<double> storedHandicaps;
+    while (query.next()) {
+        roster.append(query.value(0).toInt(), query.value(1).toInt(), query.value(2).toInt(),
+                      query.value(3).toInt(), query.value(4).toDouble());
+        storedHandicaps.append(query.value(5).toDouble());
     }
     
-    double average = 0.0;
+    const RosterFigures figures = calculatorFor(leagueId).evaluate(roster);
+    
+    // Only rows whose figures moved are written back
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
     
-    switch (config.avgCalc.type) {
-    case LeagueConfig::AverageCalculation::TotalPinsPerGame:
-        if (bowlerData.gamesPlayed > 0) {
-            average = static_cast<double>(bowlerData.totalPins) / bowlerData.gamesPlayed;
+    QSqlQuery update;
+    update.prepare(UPDATE_ROSTER_FIGURES_SQL);
+    const QString now = QDateTime::currentDateTime().toString(Qt::ISODate);
+    int changed = 0;
+    
+    for (int i = 0; i < roster.size(); ++i) {
+        if (qFuzzyCompare(1.0 + figures.averages[i], 1.0 + roster.storedAverages[i]) &&
+            qFuzzyCompare(1.0 + figures.handicaps[i], 1.0 + storedHandicaps[i])) {
+            continue;
         }
-        break;
         
-    case LeagueConfig::AverageCalculation::TotalPinsPerBall:
-        if (bowlerData.ballsThrown > 0) {
-            average = static_cast<double>(bowlerData.totalPins) / bowlerData.ballsThrown;
-        }
-        break;
+        update.addBindValue(figures.averages[i]);
+        update.addBindValue(figures.handicaps[i]);
+        update.addBindValue(now);
+        update.addBindValue(roster.bowlerIds[i]);
+        update.addBindValue(leagueId);
         
-    case LeagueConfig::AverageCalculation::PeriodicUpdate:
-        // Update only every N games
-        if (bowlerData.gamesPlayed % config.avgCalc.updateInterval == 0) {
-            if (bowlerData.gamesPlayed > 0) {
-                average = static_cast<double>(bowlerData.totalPins) / bowlerData.gamesPlayed;
-            }
-        } else {
-            // Return current stored average
-            average = bowlerData.currentAverage;
+        if (!update.exec()) {
+            qWarning() << "Failed to store roster figures:" << update.lastError().text();
+            database.rollback();
+            return false;
         }
-        break;
+        changed++;
+    }
+    
+    if (!database.commit()) {
+        qWarning() << "Failed to commit roster figures:" << database.lastError().text();
+        database.rollback();
+        return false;
     }
     
-    return qRound(average * 100.0) / 100.0; // Round to 2 decimal places
+    qDebug() << "Roster figures for league" << leagueId << ":" << roster.size() << "bowlers," << changed << "updated";
+    return true;
 }
 
-double LeagueManager::calculateBowlerHandicap(int bowlerId, int leagueId) const
+void LeagueManager::refreshAllRosterFigures()
 {
-    const LeagueConfig &config = m_leagueConfigs[leagueId];
-    BowlerSeasonData bowlerData = loadBowlerSeasonData(bowlerId, leagueId);
-    
-    if (bowlerData.gamesPlayed < config.hdcpCalc.delayGames) {
-        return 0.0; // Not enough games for handicap calculation
+    for (int leagueId : m_leagueConfigs.keys()) {
+        refreshRosterFigures(leagueId);
     }
+}
+
+WhatIfReport LeagueManager::simulateRuleChanges(int leagueId, const QVector<WhatIfVariant> &variants) const
+{
+    SeasonReplayData season = SeasonReplayData::load(QSqlDatabase::database(), leagueId);
     
-    double average = calculateBowlerAverage(bowlerId, leagueId);
-    if (average <= 0.0) {
-        return 0.0;
+    // What-if runs are mostly on archived seasons, which may not be loaded
+    LeagueConfig baseline = m_leagueConfigs.value(leagueId);
+    if (!m_leagueConfigs.contains(leagueId)) {
+        LeagueSnapshot snapshot;
+        if (LeagueConfigLoader::loadLeague(QSqlDatabase::database(), leagueId, &snapshot)) {
+            baseline = snapshot.configs.value(leagueId);
+        }
     }
+    return LeagueSimulator::run(season, baseline, variants);
+}
+
+void LeagueManager::handleAbsentBowler(int bowlerId, int leagueId, int eventId)
+{
+    Q_UNUSED(eventId)
+    ensureLeagueLoaded(leagueId);
     
-    double handicap = 0.0;
+    // Same rules as a league night, for a single bowler
+    QMap<int, BowlerSeasonData> seasonData;
+    seasonData.insert(bowlerId, loadBowlerSeasonData(bowlerId, leagueId));
     
-    switch (config.hdcpCalc.type) {
-    case LeagueConfig::HandicapCalculation::PercentageBased:
-        handicap = (config.hdcpCalc.highValue - average) * config.hdcpCalc.percentage;
-        break;
-        
-    case LeagueConfig::HandicapCalculation::StraightDifference:
-        handicap = config.hdcpCalc.highValue - average;
-        break;
-        
-    case LeagueConfig::HandicapCalculation::WithDeduction:
-        handicap = config.hdcpCalc.highValue - average - config.hdcpCalc.deduction;
-        break;
+    QMap<int, AbsentResolution> resolved;
+    if (!resolveAbsentees(leagueId, {bowlerId}, seasonData, &resolved, 1)) {
+        return;
     }
     
-    return qMax(0.0, qRound(handicap * 100.0) / 100.0); // No negative handicaps
+    updateBowlerStatistics(bowlerId, leagueId);
+    emit bowlerStatisticsUpdated(bowlerId, leagueId);
+    
+    const AbsentResolution &resolution = resolved[bowlerId];
+    qDebug() << "Absent bowler" << bowlerId << "scores" << resolution.scores << "pre-bowls" << resolution.preBowlIds;
 }
 
-int LeagueManager::calculateAbsentScore(int bowlerId, int leagueId) const
+bool LeagueManager::resolveAbsentees(int leagueId, const QVector<int> &absentBowlerIds,
+                                     QMap<int, BowlerSeasonData> &seasonData, QMap<int, AbsentResolution> *resolved,
+                                     int gamesEach)
 {
+    if (absentBowlerIds.isEmpty()) {
+        return true;
+    }
+    
     const LeagueConfig &config = m_leagueConfigs[leagueId];
-    double bowlerAverage = calculateBowlerAverage(bowlerId, leagueId);
+    const LeagueCalculator &calculator = calculatorFor(leagueId);
+    const QSet<int> absent(absentBowlerIds.constBegin(), absentBowlerIds.constEnd());
+    
+    // Every absentee's unused pre-bowls in one query, in the order they were bowled
+    struct PreBowl {
+        int id;
+        QDate bowled;
+        QJsonObject game;
+    };
+    QMap<int, QVector<PreBowl>> preBowls;
+    
+    if (config.preBowlRules.enabled && config.preBowlRules.randomUseWhenAbsent) {
+        QSqlQuery query;
+        query.setForwardOnly(true);
+        QStringList placeholders;
+        for (int i = 0; i < absent.size(); ++i) {
+            placeholders.append("?");
+        }
+        query.prepare(UNUSED_PREBOWLS_SQL.arg(placeholders.join(", ")));
+        for (int bowlerId : absent) {
+            query.addBindValue(bowlerId);
+        }
+        query.addBindValue(leagueId);
+        query.addBindValue(config.preBowlRules.maxUsesPerGame);
+        
+        if (!query.exec()) {
+            qWarning() << "Failed to load pre-bowl games for league" << leagueId << ":" << query.lastError().text();
+            return false;
+        }
+        while (query.next()) {
+            PreBowl preBowl;
+            preBowl.id = query.value(0).toInt();
+            preBowl.bowled = QDate::fromString(query.value(3).toString(), Qt::ISODate);
+            preBowl.game = QJsonDocument::fromJson(query.value(2).toString().toUtf8()).object();
+            preBowls[query.value(1).toInt()].append(preBowl);
+        }
+    }
     
-    int absentScore = 0;
+    QVector<int> usedPreBowls;
     
-    switch (config.absentHandling.type) {
-    case LeagueConfig::AbsentHandling::PercentageOfAverage:
-        absentScore = static_cast<int>(bowlerAverage * config.absentHandling.percentage);
-        break;
+    for (int bowlerId : absent) {
+        if (!seasonData.contains(bowlerId)) {
+            seasonData.insert(bowlerId, loadBowlerSeasonData(bowlerId, leagueId));
+        }
+        BowlerSeasonData &data = seasonData[bowlerId];
+        const QVector<PreBowl> available = preBowls.value(bowlerId);
+        QVector<PreBowl> chosen;
+        
+        if (gamesEach == GAMES_PER_SERIES
+            && config.preBowlRules.useBy == LeagueConfig::PreBowlRules::ByThreeGameSet) {
+            // Whole sets only, one per night. A set is GAMES_PER_SERIES pre-bowls
+            // bowled the same day, taken in the order they were bowled.
+            QVector<int> setStarts;
+            for (int day = 0; day < available.size();) {
+                int end = day;
+                while (end < available.size() && available[end].bowled == available[day].bowled) {
+                    ++end;
+                }
+                for (int start = day; start + GAMES_PER_SERIES <= end; start += GAMES_PER_SERIES) {
+                    setStarts.append(start);
+                }
+                day = end;
+            }
+            if (!setStarts.isEmpty()) {
+                const int first = setStarts[QRandomGenerator::global()->bounded(setStarts.size())];
+                chosen = available.mid(first, GAMES_PER_SERIES);
+            }
+        } else {
+            // One pre-bowl per game, never the same one twice in a night
+            chosen = available;
+            std::shuffle(chosen.begin(), chosen.end(), *QRandomGenerator::global());
+            chosen.resize(qMin(chosen.size(), gamesEach));
+        }
         
-    case LeagueConfig::AbsentHandling::FixedValue:
-        absentScore = config.absentHandling.fixedValue;
-        break;
+        // Games without a pre-bowl get the absent score from the entering average
+        const double average = calculator.average(data.gamesPlayed, data.totalPins,
+                                                  data.ballsThrown, data.currentAverage);
+        const int absentScore = calculator.absentScore(average);
         
-    case LeagueConfig::AbsentHandling::UseAverage:
-        absentScore = static_cast<int>(bowlerAverage);
-        break;
+        AbsentResolution &resolution = (*resolved)[bowlerId];
+        int series = 0;
+        for (int game = 0; game < gamesEach; ++game) {
+            int score = absentScore;
+            if (game < chosen.size()) {
+                const QJsonObject &preBowl = chosen[game].game;
+                score = preBowl["total_score"].toInt();
+                data.strikes += preBowl["strikes"].toInt(0);
+                data.spares += preBowl["spares"].toInt(0);
+                resolution.preBowlIds.append(chosen[game].id);
+                usedPreBowls.append(chosen[game].id);
+            }
+            
+            resolution.scores.append(score);
+            data.gamesPlayed++;
+            data.totalPins += score;
+            data.highGame = qMax(data.highGame, score);
+            series += score;
+        }
+        if (gamesEach == GAMES_PER_SERIES) {
+            data.highSeries = qMax(data.highSeries, series);
+        }
+        data.lastUpdated = QDateTime::currentDateTime();
+    }
+    
+    // Pre-bowl usage and season rows together, or not at all
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
+    
+    QSqlQuery markUsed;
+    markUsed.prepare(MARK_PREBOWL_USED_SQL);
+    for (int preBowlId : usedPreBowls) {
+        markUsed.addBindValue(preBowlId);
+        if (!markUsed.exec()) {
+            qWarning() << "Failed to mark pre-bowl game used:" << markUsed.lastError().text();
+            database.rollback();
+            return false;
+        }
+    }
+    
+    for (int bowlerId : absent) {
+        if (!saveBowlerSeasonData(seasonData[bowlerId])) {
+            database.rollback();
+            return false;
+        }
+    }
+    
+    if (!database.commit()) {
+        qWarning() << "Failed to commit absent bowlers:" << database.lastError().text();
+        database.rollback();
+        return false;
     }
     
-    return qMax(0, absentScore);
+    qDebug() << "Resolved" << absent.size() << "absent bowlers for league" << leagueId << "using"
+             << usedPreBowls.size() << "pre-bowl games";
+    return true;
 }
 
-void LeagueManager::handleAbsentBowler(int bowlerId, int leagueId, int eventId)
+bool LeagueManager::openLeagueEvent(int eventId, const QVector<int> &absentBowlerIds)
 {
-    const LeagueConfig &config = m_leagueConfigs[leagueId];
+    ensureWarmStarted();
     
-    // Check if we should use a pre-bowl game instead
-    if (config.preBowlRules.enabled && config.preBowlRules.randomUseWhenAbsent) {
-        QVector<int> availablePreBowls = getAvailablePreBowls(bowlerId, leagueId);
-        
-        if (!availablePreBowls.isEmpty()) {
-            // Randomly select a pre-bowl game
-            int randomIndex = QRandomGenerator::global()->bounded(availablePreBowls.size());
-            int preBowlGameId = availablePreBowls[randomIndex];
+    LeagueEvent *event = nullptr;
+    for (auto it = m_leagueEvents.begin(); it != m_leagueEvents.end() && !event; ++it) {
+        for (LeagueEvent &evt : it.value()) {
+            if (evt.eventId == eventId) {
+                event = &evt;
+                break;
+            }
+        }
+    }
+    
+    if (!event) {
+        qWarning() << "Event not found:" << eventId;
+        return false;
+    }
+    
+    const int leagueId = event->leagueId;
+    ensureLeagueLoaded(leagueId);
+    const LeagueCalculator &calculator = calculatorFor(leagueId);
+    
+    QMap<int, const LeagueTeamData *> teams;
+    for (const LeagueTeamData &team : m_leagueTeams[leagueId]) {
+        teams.insert(team.teamId, &team);
+    }
+    
+    // The whole league's season rows in one read; entering figures are taken
+    // before the night's absent games are added
+    QMap<int, BowlerSeasonData> seasonData = loadLeagueSeasonData(leagueId);
+    QMap<int, QPair<double, double>> entering; // bowlerId -> (average, handicap)
+    QSet<int> rosterBowlers;
+    
+    for (const LeagueEvent::Matchup &matchup : event->matchups) {
+        for (int teamId : {matchup.team1Id, matchup.team2Id}) {
+            const LeagueTeamData *team = teams.value(teamId);
+            if (!team) {
+                continue;
+            }
+            for (int bowlerId : team->bowlerIds) {
+                if (!seasonData.contains(bowlerId)) {
+                    BowlerSeasonData firstNight; // No games in this league yet
+                    firstNight.bowlerId = bowlerId;
+                    firstNight.leagueId = leagueId;
+                    firstNight.teamId = teamId;
+                    seasonData.insert(bowlerId, firstNight);
+                }
+                const BowlerSeasonData &data = seasonData[bowlerId];
+                const double average = calculator.average(data.gamesPlayed, data.totalPins,
+                                                          data.ballsThrown, data.currentAverage);
+                entering.insert(bowlerId, qMakePair(average, calculator.handicap(data.gamesPlayed, average)));
+                rosterBowlers.insert(bowlerId);
+            }
+        }
+    }
+    
+    QVector<int> absentees;
+    for (int bowlerId : absentBowlerIds) {
+        if (rosterBowlers.contains(bowlerId)) {
+            absentees.append(bowlerId);
+        } else {
+            qWarning() << "Absent bowler" << bowlerId << "is not on a team bowling event" << eventId;
+        }
+    }
+    
+    QMap<int, AbsentResolution> resolved;
+    if (!resolveAbsentees(leagueId, absentees, seasonData, &resolved)) {
+        return false;
+    }
+    
+    // One roster per lane, with absent and pre-bowl games already filled in
+    QMap<int, QJsonObject> &rosters = m_eventRosters[eventId];
+    rosters.clear();
+    
+    for (const LeagueEvent::Matchup &matchup : event->matchups) {
+        QJsonArray teamsArray;
+        for (int teamId : {matchup.team1Id, matchup.team2Id}) {
+            const LeagueTeamData *team = teams.value(teamId);
+            if (!team) {
+                continue;
+            }
             
-            usePreBowlGame(bowlerId, leagueId, preBowlGameId);
+            QJsonArray bowlersArray;
+            for (int bowlerId : team->bowlerIds) {
+                QJsonObject bowler;
+                bowler["bowler_id"] = bowlerId;
+                bowler["average"] = entering[bowlerId].first;
+                bowler["handicap"] = entering[bowlerId].second;
+                
+                if (resolved.contains(bowlerId)) {
+                    writeAbsentResolution(bowler, resolved[bowlerId]);
+                } else {
+                    bowler["status"] = "present";
+                }
+                bowlersArray.append(bowler);
+            }
             
-            qDebug() << "Used pre-bowl game" << preBowlGameId << "for absent bowler" << bowlerId;
-            return;
+            QJsonObject teamObj;
+            teamObj["team_id"] = teamId;
+            teamObj["name"] = team->name;
+            teamObj["bowlers"] = bowlersArray;
+            teamsArray.append(teamObj);
+        }
+        
+        QJsonObject roster;
+        roster["league_id"] = leagueId;
+        roster["event_id"] = eventId;
+        roster["week_number"] = event->weekNumber;
+        roster["lane_id"] = matchup.laneId;
+        roster["teams"] = teamsArray;
+        rosters.insert(matchup.laneId, roster);
+        
+        emit sendToLane(matchup.laneId, "league_roster", roster);
+    }
+    
+    if (!resolved.isEmpty()) {
+        refreshRosterFigures(leagueId);
+        for (auto it = resolved.constBegin(); it != resolved.constEnd(); ++it) {
+            emit bowlerStatisticsUpdated(it.key(), leagueId);
+        }
+    }
+    
+    qDebug() << "Opened event" << eventId << "for league" << leagueId << ":" << rosters.size() << "lanes,"
+             << resolved.size() << "absent";
+    return true;
+}
+
+bool LeagueManager::addLaneAbsentees(int eventId, int laneId, const QVector<int> &absentBowlerIds)
+{
+    QJsonObject roster = m_eventRosters.value(eventId).value(laneId);
+    if (roster.isEmpty() || absentBowlerIds.isEmpty()) {
+        return true;
+    }
+    const int leagueId = roster["league_id"].toInt();
+    
+    // Only bowlers on this lane still marked present; the rest were resolved already
+    QMap<int, int> presentTeams; // bowlerId -> teamId
+    for (const QJsonValue &team : roster["teams"].toArray()) {
+        for (const QJsonValue &value : team.toObject()["bowlers"].toArray()) {
+            const QJsonObject bowler = value.toObject();
+            if (bowler["status"].toString() == "present") {
+                presentTeams.insert(bowler["bowler_id"].toInt(), team.toObject()["team_id"].toInt());
+            }
         }
     }
     
-    // Use absent score calculation
-    int absentScore = calculateAbsentScore(bowlerId, leagueId);
+    QVector<int> absentees;
+    QMap<int, BowlerSeasonData> seasonData;
+    for (int bowlerId : absentBowlerIds) {
+        if (!presentTeams.contains(bowlerId)) {
+            continue;
+        }
+        BowlerSeasonData data = loadBowlerSeasonData(bowlerId, leagueId);
+        if (data.teamId == 0) {
+            data.teamId = presentTeams.value(bowlerId); // No games in this league yet
+        }
+        seasonData.insert(bowlerId, data);
+        absentees.append(bowlerId);
+    }
     
-    // Create absent game data
-    QJsonObject absentGameData;
-    absentGameData["bowler_id"] = bowlerId;
-    absentGameData["total_score"] = absentScore;
-    absentGameData["absent"] = true;
-    absentGameData["strikes"] = 0;
-    absentGameData["spares"] = 0;
+    if (absentees.isEmpty()) {
+        return true;
+    }
     
-    // Process as regular game
-    processBowlerGame(bowlerId, leagueId, absentGameData);
+    QMap<int, AbsentResolution> resolved;
+    if (!resolveAbsentees(leagueId, absentees, seasonData, &resolved)) {
+        return false;
+    }
     
-    qDebug() << "Processed absent score" << absentScore << "for bowler" << bowlerId;
+    QJsonArray teams = roster["teams"].toArray();
+    for (int t = 0; t < teams.size(); ++t) {
+        QJsonObject team = teams[t].toObject();
+        QJsonArray bowlers = team["bowlers"].toArray();
+        for (int b = 0; b < bowlers.size(); ++b) {
+            QJsonObject bowler = bowlers[b].toObject();
+            if (resolved.contains(bowler["bowler_id"].toInt())) {
+                writeAbsentResolution(bowler, resolved[bowler["bowler_id"].toInt()]);
+                bowlers[b] = bowler;
+            }
+        }
+        team["bowlers"] = bowlers;
+        teams[t] = team;
+    }
+    roster["teams"] = teams;
+    m_eventRosters[eventId].insert(laneId, roster);
+    
+    refreshRosterFigures(leagueId);
+    for (auto it = resolved.constBegin(); it != resolved.constEnd(); ++it) {
+        emit bowlerStatisticsUpdated(it.key(), leagueId);
+    }
+    
+    qDebug() << "Lane" << laneId << "added" << resolved.size() << "absent bowlers to event" << eventId;
+    return true;
+}
+
+void LeagueManager::writeAbsentResolution(QJsonObject &bowler, const AbsentResolution &resolution)
+{
+    bowler["status"] = resolution.preBowlIds.isEmpty() ? "absent" : "prebowl";
+    
+    QJsonArray scores;
+    for (int score : resolution.scores) {
+        scores.append(score);
+    }
+    bowler["scores"] = scores;
+    
+    QJsonArray preBowlIds;
+    for (int preBowlId : resolution.preBowlIds) {
+        preBowlIds.append(preBowlId);
+    }
+    bowler["prebowl_ids"] = preBowlIds;
 }
 
 int LeagueManager::recordPreBowlGame(int bowlerId, int leagueId, const QJsonObject &gameData)
 {
+    ensureLeagueLoaded(leagueId);
     const LeagueConfig &config = m_leagueConfigs[leagueId];
     
     if (!config.preBowlRules.enabled) {
@@ -522,8 +1218,7 @@ int LeagueManager::recordPreBowlGame(int bowlerId, int leagueId, const QJsonObje
     }
     
     QSqlQuery query;
-    query.prepare("INSERT INTO prebowl_games (bowler_id, league_id, game_data, max_uses) "
-                 "VALUES (?, ?, ?, ?)");
+    query.prepare(ADD_PREBOWL_SQL);
     
     query.addBindValue(bowlerId);
     query.addBindValue(leagueId);
@@ -546,8 +1241,7 @@ QVector<int> LeagueManager::getAvailablePreBowls(int bowlerId, int leagueId) con
     QVector<int> availablePreBowls;
     
     QSqlQuery query;
-    query.prepare("SELECT prebowl_id FROM prebowl_games "
-                 "WHERE bowler_id = ? AND league_id = ? AND times_used < max_uses");
+    query.prepare(AVAILABLE_PREBOWLS_SQL);
     query.addBindValue(bowlerId);
     query.addBindValue(leagueId);
     
@@ -564,7 +1258,7 @@ void LeagueManager::usePreBowlGame(int bowlerId, int leagueId, int preBowlGameId
 {
     // Get pre-bowl game data
     QSqlQuery query;
-    query.prepare("SELECT game_data FROM prebowl_games WHERE prebowl_id = ?");
+    query.prepare(PREBOWL_GAME_SQL);
     query.addBindValue(preBowlGameId);
     
     if (!query.exec() || !query.next()) {
@@ -580,30 +1274,85 @@ void LeagueManager::usePreBowlGame(int bowlerId, int leagueId, int preBowlGameId
     processBowlerGame(bowlerId, leagueId, gameData);
     
     // Update usage count
-    query.prepare("UPDATE prebowl_games SET times_used = times_used + 1 "
-                 "WHERE prebowl_id = ?");
+    query.prepare(MARK_PREBOWL_USED_SQL);
     query.addBindValue(preBowlGameId);
     query.exec();
     
     qDebug() << "Used pre-bowl game" << preBowlGameId << "for bowler" << bowlerId;
 }
 
-void LeagueManager::calculateHeadsUpPoints(const LeagueEvent::Matchup &matchup, 
-                                          int &team1Points, int &team2Points)
+bool LeagueManager::recordMatchupGames(int leagueId, LeagueEvent::Matchup &matchup, const QJsonObject &gameData)
 {
-    team1Points = 0;
-    team2Points = 0;
+    // Place each bowler's game in the matrix by roster position
+    QVector<int> team1Roster;
+    QVector<int> team2Roster;
+    for (const LeagueTeamData &team : m_leagueTeams.value(leagueId)) {
+        if (team.teamId == matchup.team1Id) {
+            team1Roster = team.bowlerIds;
+        } else if (team.teamId == matchup.team2Id) {
+            team2Roster = team.bowlerIds;
+        }
+    }
     
-    if (matchup.team1Score > matchup.team2Score) {
-        team1Points = 2; // Win
-        team2Points = 0; // Loss
-    } else if (matchup.team2Score > matchup.team1Score) {
-        team1Points = 0; // Loss
-        team2Points = 2; // Win
-    } else {
-        team1Points = 1; // Tie
-        team2Points = 1; // Tie
+    const int positions = qMax(team1Roster.size(), team2Roster.size());
+    for (QVector<int> *games : {&matchup.team1Games, &matchup.team2Games}) {
+        const int bowled = games->size();
+        if (bowled < positions * GAMES_PER_SERIES) {
+            games->resize(positions * GAMES_PER_SERIES);
+            std::fill(games->begin() + bowled, games->end(), -1);
+        }
+    }
+    for (QVector<int> *handicaps : {&matchup.team1Handicaps, &matchup.team2Handicaps}) {
+        if (handicaps->size() < positions) {
+            handicaps->resize(positions);
+        }
+    }
+    
+    const int defaultGame = gameData["game_number"].toInt(0);
+    for (const QJsonValue &bowlerValue : gameData["bowlers"].toArray()) {
+        const QJsonObject bowlerGame = bowlerValue.toObject();
+        const int bowlerId = bowlerGame["bowler_id"].toInt();
+        
+        int position = team1Roster.indexOf(bowlerId);
+        QVector<int> *games = &matchup.team1Games;
+        QVector<int> *handicaps = &matchup.team1Handicaps;
+        if (position < 0) {
+            position = team2Roster.indexOf(bowlerId);
+            games = &matchup.team2Games;
+            handicaps = &matchup.team2Handicaps;
+        }
+        if (bowlerId <= 0 || position < 0) {
+            continue;
+        }
+        
+        // Game number from the lane, else the position's next open game
+        int game = bowlerGame["game_number"].toInt(defaultGame) - 1;
+        if (game < 0 || game >= GAMES_PER_SERIES) {
+            game = 0;
+            while (game < GAMES_PER_SERIES - 1 && (*games)[position * GAMES_PER_SERIES + game] >= 0) {
+                game++;
+            }
+        }
+        
+        (*games)[position * GAMES_PER_SERIES + game] = bowlerGame["total_score"].toInt();
+        (*handicaps)[position] = static_cast<int>(bowlerGame["handicap"].toDouble());
+    }
+    
+    // Without rosters there is no matrix to fill; the lane's last game closes it
+    if (positions == 0) {
+        return defaultGame >= GAMES_PER_SERIES;
     }
+    return toMatchupScores(matchup, GAMES_PER_SERIES).isComplete(team1Roster.size(), team2Roster.size());
+}
+
+void LeagueManager::calculateHeadsUpPoints(int leagueId, const LeagueEvent::Matchup &matchup,
+                                          int &team1Points, int &team2Points)
+{
+    const PointsEngine engine(m_leagueConfigs.value(leagueId).pointSystem);
+    const MatchupPoints points = engine.scoreMatchup(toMatchupScores(matchup, GAMES_PER_SERIES));
+    
+    team1Points = points.team1Points;
+    team2Points = points.team2Points;
 }
 
 void LeagueManager::calculateEventPoints(int eventId)
@@ -628,96 +1377,73 @@ void LeagueManager::calculateEventPoints(int eventId)
         return;
     }
     
-    const LeagueConfig &config = m_leagueConfigs[leagueId];
-    
-    // Calculate points based on point system
-    switch (config.pointSystem.type) {
-    case LeagueConfig::PointSystem::WinLossTie:
-        // Already calculated in calculateHeadsUpPoints
-        break;
-        
-    case LeagueConfig::PointSystem::TeamVsTeam:
-        {
-            QMap<int, int> teamPoints;
-            calculateTeamVsPoints(eventId, teamPoints);
-            
-            // Update matchup points
-            for (LeagueEvent::Matchup &matchup : event->matchups) {
-                matchup.team1Points = teamPoints.value(matchup.team1Id, 0);
-                matchup.team2Points = teamPoints.value(matchup.team2Id, 0);
-            }
-        }
-        break;
-        
-    case LeagueConfig::PointSystem::Custom:
-        // Implement custom point calculation logic
-        break;
-    }
-    
-    // Update team statistics with points
+    // Every matchup of the night scored together, so rankings see all teams
+    QVector<MatchupScores> matchups;
+    matchups.reserve(event->matchups.size());
     for (const LeagueEvent::Matchup &matchup : event->matchups) {
-        updateTeamPoints(matchup.team1Id, matchup.team1Points);
-        updateTeamPoints(matchup.team2Id, matchup.team2Points);
+        matchups.append(toMatchupScores(matchup, GAMES_PER_SERIES));
     }
-}
-
-void LeagueManager::calculateTeamVsPoints(int eventId, QMap<int, int> &teamPoints)
-{
-    // Get all teams and their scores for this event
-    QMap<int, int> teamScores;
     
-    // Find the event and collect team scores
-    for (const auto &events : m_leagueEvents) {
-        for (const LeagueEvent &event : events) {
-            if (event.eventId == eventId) {
-                for (const LeagueEvent::Matchup &matchup : event.matchups) {
-                    teamScores[matchup.team1Id] = matchup.team1Score;
-                    teamScores[matchup.team2Id] = matchup.team2Score;
-                }
-                break;
-            }
-        }
+    QMap<int, int> divisionOf;
+    for (const LeagueTeamData &team : m_leagueTeams.value(leagueId)) {
+        divisionOf.insert(team.teamId, team.divisionId);
     }
     
-    // Sort teams by score (highest first)
-    QVector<QPair<int, int>> sortedTeams; // (teamId, score)
-    for (auto it = teamScores.begin(); it != teamScores.end(); ++it) {
-        sortedTeams.append(QPair<int, int>(it.key(), it.value()));
-    }
+    const PointsEngine engine(m_leagueConfigs.value(leagueId).pointSystem);
+    const EventPoints points = engine.scoreEvent(matchups, divisionOf);
     
-    std::sort(sortedTeams.begin(), sortedTeams.end(), 
-              [](const QPair<int, int> &a, const QPair<int, int> &b) {
-                  return a.second > b.second; // Sort by score descending
-              });
+    // Points and W/L/T for the whole night in one transaction
+    QSqlDatabase database = QSqlDatabase::database();
+    database.transaction();
     
-    // Assign points based on ranking
-    int totalTeams = sortedTeams.size();
-    for (int i = 0; i < sortedTeams.size(); ++i) {
-        int teamId = sortedTeams[i].first;
-        int points = totalTeams - i; // Highest score gets most points
-        teamPoints[teamId] = points;
-    }
-}
-
-void LeagueManager::updateTeamPoints(int teamId, int points)
-{
     QSqlQuery query;
-    query.prepare("UPDATE league_teams SET total_points = total_points + ? WHERE team_id = ?");
-    query.addBindValue(points);
-    query.addBindValue(teamId);
+    query.prepare(UPDATE_TEAM_STANDING_SQL);
     
-    if (!query.exec()) {
-        qWarning() << "Failed to update team points:" << query.lastError().text();
+    for (int i = 0; i < event->matchups.size(); ++i) {
+        LeagueEvent::Matchup &matchup = event->matchups[i];
+        const MatchupPoints &result = points.matchups[i];
+        matchup.team1Points = result.team1Points;
+        matchup.team2Points = result.team2Points;
+        
+        const int teamIds[] = {matchup.team1Id, matchup.team2Id};
+        const int teamPoints[] = {result.team1Points, result.team2Points};
+        // Standings count the match itself, not the comparisons points came from
+        const int won[] = {result.matchResult > 0, result.matchResult < 0};
+        for (int side = 0; side < 2; ++side) {
+            query.addBindValue(teamPoints[side]);
+            query.addBindValue(won[side]);
+            query.addBindValue(won[1 - side]);
+            query.addBindValue(result.matchResult == 0 ? 1 : 0);
+            query.addBindValue(leagueId);
+            query.addBindValue(teamIds[side]);
+            
+            if (!query.exec()) {
+                qWarning() << "Failed to update team points:" << query.lastError().text();
+                database.rollback();
+                return;
+            }
+        }
+    }
+    
+    if (!database.commit()) {
+        qWarning() << "Failed to commit event points:" << database.lastError().text();
+        database.rollback();
+        return;
     }
+    
+    qDebug() << "Scored event" << eventId << ":" << event->matchups.size() << "matchups," << points.rankPoints.size()
+             << "teams ranked";
 }
 
 void LeagueManager::updateBowlerStatistics(int bowlerId, int leagueId)
 {
     BowlerSeasonData bowlerData = loadBowlerSeasonData(bowlerId, leagueId);
     
-    // Recalculate average and handicap
-    bowlerData.currentAverage = calculateBowlerAverage(bowlerId, leagueId);
-    bowlerData.currentHandicap = calculateBowlerHandicap(bowlerId, leagueId);
+    // Recalculate average and handicap from the row already loaded
+    const LeagueCalculator &calculator = calculatorFor(leagueId);
+    bowlerData.currentAverage = calculator.average(bowlerData.gamesPlayed, bowlerData.totalPins,
+                                                   bowlerData.ballsThrown, bowlerData.currentAverage);
+    bowlerData.currentHandicap = calculator.handicap(bowlerData.gamesPlayed, bowlerData.currentAverage);
     bowlerData.lastUpdated = QDateTime::currentDateTime();
     
     // Save updated statistics
@@ -754,6 +1480,10 @@ void LeagueManager::updateLeagueStandings(int leagueId)
 {
     // This triggers a recalculation of all standings
     emit standingsUpdated(leagueId);
+
+    StandingsChangedEvent changed;
+    changed.leagueId = leagueId;
+    EventBus::instance()->publish(changed);
 }
 
 // Message handling from lanes
@@ -771,7 +1501,7 @@ void LeagueManager::handleLeagueGameStart(int laneId, const QJsonObject &gameDat
     
     // Send league configuration to lane
     QJsonObject configData;
-    if (m_leagueConfigs.contains(leagueId)) {
+    if (ensureLeagueLoaded(leagueId)) {
         const LeagueConfig &config = m_leagueConfigs[leagueId];
         
         configData["league_name"] = config.name;
@@ -782,6 +1512,24 @@ void LeagueManager::handleLeagueGameStart(int laneId, const QJsonObject &gameDat
     }
     
     emit sendToLane(laneId, "league_config", configData);
+    
+    QVector<int> absentBowlerIds;
+    for (const QJsonValue &value : gameData["absent_bowler_ids"].toArray()) {
+        absentBowlerIds.append(value.toInt());
+    }
+    
+    // The first lane to start opens the event for every matchup; lanes that
+    // start later add their own absentees to the roster resolved then
+    if (!m_eventRosters.contains(eventId)) {
+        openLeagueEvent(eventId, absentBowlerIds);
+        return;
+    }
+    addLaneAbsentees(eventId, laneId, absentBowlerIds);
+    
+    const QJsonObject roster = m_eventRosters.value(eventId).value(laneId);
+    if (!roster.isEmpty()) {
+        emit sendToLane(laneId, "league_roster", roster);
+    }
 }
 
 void LeagueManager::handleLeagueGameComplete(int laneId, const QJsonObject &gameData)
@@ -805,7 +1553,7 @@ void LeagueManager::handleDisplayModeChange(int laneId, const QJsonObject &displ
 }
 
 // Database operations
-void LeagueManager::saveLeagueEvent(const LeagueEvent &event)
+int LeagueManager::saveLeagueEvent(const LeagueEvent &event)
 {
     QJsonObject matchupsJson;
     QJsonArray matchupsArray;
@@ -827,6 +1575,18 @@ void LeagueManager::saveLeagueEvent(const LeagueEvent &event)
         }
         matchupObj["game_ids"] = gameIdsArray;
         
+        auto toArray = [](const QVector<int> &values) {
+            QJsonArray array;
+            for (int value : values) {
+                array.append(value);
+            }
+            return array;
+        };
+        matchupObj["team1_games"] = toArray(matchup.team1Games);
+        matchupObj["team2_games"] = toArray(matchup.team2Games);
+        matchupObj["team1_handicaps"] = toArray(matchup.team1Handicaps);
+        matchupObj["team2_handicaps"] = toArray(matchup.team2Handicaps);
+        
         matchupsArray.append(matchupObj);
     }
     matchupsJson["matchups"] = matchupsArray;
@@ -839,15 +1599,13 @@ void LeagueManager::saveLeagueEvent(const LeagueEvent &event)
     QSqlQuery query;
     if (event.eventId > 0) {
         // Update existing event
-        query.prepare("UPDATE league_events SET matchups_json = ?, event_completed = ? "
-                     "WHERE event_id = ?");
+        query.prepare(UPDATE_EVENT_SQL);
         query.addBindValue(QJsonDocument(matchupsJson).toJson(QJsonDocument::Compact));
         query.addBindValue(event.eventCompleted);
         query.addBindValue(event.eventId);
     } else {
         // Insert new event
-        query.prepare("INSERT INTO league_events (league_id, week_number, scheduled_time, "
-                     "lane_ids, matchups_json, event_completed) VALUES (?, ?, ?, ?, ?, ?)");
+        query.prepare(INSERT_EVENT_SQL);
         query.addBindValue(event.leagueId);
         query.addBindValue(event.weekNumber);
         query.addBindValue(event.scheduledTime.toString(Qt::ISODate));
@@ -858,9 +1616,41 @@ void LeagueManager::saveLeagueEvent(const LeagueEvent &event)
     
     if (!query.exec()) {
         qWarning() << "Failed to save league event:" << query.lastError().text();
+        return -1;
+    }
+    
+    return (event.eventId > 0) ? event.eventId : query.lastInsertId().toInt();
+}
+
+namespace {
+
+void readBowlerSeasonRow(const QSqlQuery &query, BowlerSeasonData &data)
+{
+    data.teamId = query.value("team_id").toInt();
+    data.currentAverage = query.value("current_average").toDouble();
+    data.currentHandicap = query.value("current_handicap").toDouble();
+    data.gamesPlayed = query.value("games_played").toInt();
+    data.totalPins = query.value("total_pins").toInt();
+    data.ballsThrown = query.value("balls_thrown").toInt();
+    data.strikes = query.value("strikes").toInt();
+    data.spares = query.value("spares").toInt();
+    data.highGame = query.value("high_game").toInt();
+    data.highSeries = query.value("high_series").toInt();
+    data.lastUpdated = QDateTime::fromString(query.value("last_updated").toString(), Qt::ISODate);
+    
+    // Parse pre-bowl games
+    QString preBowlStr = query.value("prebowl_games").toString();
+    if (!preBowlStr.isEmpty()) {
+        QJsonDocument preBowlDoc = QJsonDocument::fromJson(preBowlStr.toUtf8());
+        QJsonArray preBowlArray = preBowlDoc.array();
+        for (const QJsonValue &value : preBowlArray) {
+            data.preBowlGameIds.append(value.toInt());
+        }
     }
 }
 
+} // namespace
+
 BowlerSeasonData LeagueManager::loadBowlerSeasonData(int bowlerId, int leagueId) const
 {
     BowlerSeasonData data;
@@ -868,38 +1658,43 @@ BowlerSeasonData LeagueManager::loadBowlerSeasonData(int bowlerId, int leagueId)
     data.leagueId = leagueId;
     
     QSqlQuery query;
-    query.prepare("SELECT * FROM bowler_season_data WHERE bowler_id = ? AND league_id = ?");
+    query.prepare(BOWLER_SEASON_SQL);
     query.addBindValue(bowlerId);
     query.addBindValue(leagueId);
     
     if (query.exec() && query.next()) {
-        data.teamId = query.value("team_id").toInt();
-        data.currentAverage = query.value("current_average").toDouble();
-        data.currentHandicap = query.value("current_handicap").toDouble();
-        data.gamesPlayed = query.value("games_played").toInt();
-        data.totalPins = query.value("total_pins").toInt();
-        data.ballsThrown = query.value("balls_thrown").toInt();
-        data.strikes = query.value("strikes").toInt();
-        data.spares = query.value("spares").toInt();
-        data.highGame = query.value("high_game").toInt();
-        data.highSeries = query.value("high_series").toInt();
-        data.lastUpdated = QDateTime::fromString(query.value("last_updated").toString(), Qt::ISODate);
-        
-        // Parse pre-bowl games
-        QString preBowlStr = query.value("prebowl_games").toString();
-        if (!preBowlStr.isEmpty()) {
-            QJsonDocument preBowlDoc = QJsonDocument::fromJson(preBowlStr.toUtf8());
-            QJsonArray preBowlArray = preBowlDoc.array();
-            for (const QJsonValue &value : preBowlArray) {
-                data.preBowlGameIds.append(value.toInt());
-            }
-        }
+        readBowlerSeasonRow(query, data);
     }
     
     return data;
 }
 
-void LeagueManager::saveBowlerSeasonData(const BowlerSeasonData &data)
+QMap<int, BowlerSeasonData> LeagueManager::loadLeagueSeasonData(int leagueId) const
+{
+    QMap<int, BowlerSeasonData> seasonData;
+    
+    QSqlQuery query;
+    query.setForwardOnly(true);
+    query.prepare(LEAGUE_SEASON_SQL);
+    query.addBindValue(leagueId);
+    
+    if (!query.exec()) {
+        qWarning() << "Failed to load season data for league" << leagueId << ":" << query.lastError().text();
+        return seasonData;
+    }
+    
+    while (query.next()) {
+        BowlerSeasonData data;
+        data.bowlerId = query.value("bowler_id").toInt();
+        data.leagueId = leagueId;
+        readBowlerSeasonRow(query, data);
+        seasonData.insert(data.bowlerId, data);
+    }
+    
+    return seasonData;
+}
+
+bool LeagueManager::saveBowlerSeasonData(const BowlerSeasonData &data)
 {
     // Convert pre-bowl games to JSON
     QJsonArray preBowlArray;
@@ -908,11 +1703,7 @@ void LeagueManager::saveBowlerSeasonData(const BowlerSeasonData &data)
     }
     
     QSqlQuery query;
-    query.prepare("INSERT OR REPLACE INTO bowler_season_data "
-                 "(bowler_id, league_id, team_id, current_average, current_handicap, "
-                 "games_played, total_pins, balls_thrown, strikes, spares, high_game, "
-                 "high_series, prebowl_games, last_updated) "
-                 "VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+    query.prepare(SAVE_BOWLER_SEASON_SQL);
     
     query.addBindValue(data.bowlerId);
     query.addBindValue(data.leagueId);
@@ -931,7 +1722,9 @@ void LeagueManager::saveBowlerSeasonData(const BowlerSeasonData &data)
     
     if (!query.exec()) {
         qWarning() << "Failed to save bowler season data:" << query.lastError().text();
+        return false;
     }
+    return true;
 }
 
 bool LeagueManager::validateLeagueConfig(const LeagueConfig &config) const
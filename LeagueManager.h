@@ -8,10 +8,24 @@
 #include <QVector>
 #include <QMap>
 #include <QTimer>
+#include <memory>
 #include "DatabaseManager.h"
 
 // Forward declarations
 class LaneServer;
+class LeagueCalculator;
+class QThread;
+struct LeagueSnapshot;
+struct WhatIfVariant;
+struct WhatIfReport;
+
+// League nights skipped, from and to inclusive; one night has from == to
+struct BlackoutPeriod {
+    QDate from;
+    QDate to;
+    
+    bool contains(const QDate &date) const { return date >= from && date <= to; }
+};
 
 // League configuration structures
 struct LeagueConfig {
@@ -22,6 +36,8 @@ struct LeagueConfig {
     int numberOfWeeks;
     QVector<int> laneIds;
     QString status; // "scheduled", "active", "completed", "cancelled"
+    QVector<int> positionRoundWeeks; // Weeks paired from standings (1v2, 3v4, ...)
+    QVector<BlackoutPeriod> blackouts; // Holidays, tournaments, summer breaks
     
     // League rules
     struct AverageCalculation {
@@ -190,6 +206,13 @@ struct LeagueEvent {
         int team1Points = 0;
         int team2Points = 0;
         
+        // Game matrix as lanes report it: [position * games + game], -1 until
+        // bowled. Positions follow each team's roster order.
+        QVector<int> team1Games;
+        QVector<int> team2Games;
+        QVector<int> team1Handicaps;   // Per position
+        QVector<int> team2Handicaps;
+        
         QVector<int> gameIds; // Individual game results
     };
     
@@ -223,13 +246,21 @@ public:
     bool generateRoundRobinSchedule(int leagueId);
     bool generateCustomSchedule(int leagueId, const QJsonObject &scheduleRules);
     QVector<LeagueEvent> getLeagueSchedule(int leagueId) const;
+    bool fillPositionRound(int leagueId, int weekNumber);
+    bool optimizeLeagueSchedule(int leagueId, int timeBudgetMs = 2000);
     
     // Game processing
     void processLeagueGame(int leagueId, int eventId, int laneId, const QJsonObject &gameData);
     void processBowlerGame(int bowlerId, int leagueId, const QJsonObject &gameData);
+    // One absent game per call, as before league nights were opened as a whole:
+    // a pre-bowl when the league allows it, otherwise the absent score
     void handleAbsentBowler(int bowlerId, int leagueId, int eventId);
     void usePreBowlGame(int bowlerId, int leagueId, int preBowlGameId);
     
+    // League night start: absent scores and pre-bowl games for every matchup of
+    // the event in one pass and one transaction, then each lane gets its roster
+    bool openLeagueEvent(int eventId, const QVector<int> &absentBowlerIds);
+    
     // Statistics and calculations
     void updateBowlerStatistics(int bowlerId, int leagueId);
     void updateTeamStatistics(int teamId);
@@ -239,10 +270,21 @@ public:
     double calculateBowlerHandicap(int bowlerId, int leagueId) const;
     int calculateAbsentScore(int bowlerId, int leagueId) const;
     
+    // Recomputes and stores averages and handicaps for a whole roster in one
+    // pass; see LeagueCalculator. Every league's roster is refreshed when a
+    // league event completes.
+    bool refreshRosterFigures(int leagueId);
+    void refreshAllRosterFigures();
+    
+    // Season replayed under alternate rules, standings diffed against the current ones
+    WhatIfReport simulateRuleChanges(int leagueId, const QVector<WhatIfVariant> &variants) const;
+    
     // Point system management
     void calculateEventPoints(int eventId);
-    void calculateHeadsUpPoints(const LeagueEvent::Matchup &matchup, int &team1Points, int &team2Points);
-    void calculateTeamVsPoints(int eventId, QMap<int, int> &teamPoints);
+    void calculateHeadsUpPoints(int leagueId, const LeagueEvent::Matchup &matchup, int &team1Points, int &team2Points);
+    // Lanes report one game at a time; true once both teams have every game
+    // of the series in for each roster position
+    bool recordMatchupGames(int leagueId, LeagueEvent::Matchup &matchup, const QJsonObject &gameData);
     
     // Pre-bowl management
     int recordPreBowlGame(int bowlerId, int leagueId, const QJsonObject &gameData);
@@ -266,6 +308,12 @@ public:
     QJsonObject getTeamStatistics(int teamId) const;
     QJsonObject getLeagueSummary(int leagueId) const;
     
+    // Active leagues are read on a worker thread at startup; archived seasons
+    // are read the first time something asks for them
+    bool isWarmStarted() const { return m_warmStarted; }
+    void ensureWarmStarted();
+    bool ensureLeagueLoaded(int leagueId);
+    
     // Event handling from client
     void handleLeagueGameStart(int laneId, const QJsonObject &gameData);
     void handleLeagueGameComplete(int laneId, const QJsonObject &gameData);
@@ -279,6 +327,7 @@ signals:
     void standingsUpdated(int leagueId);
     void bowlerStatisticsUpdated(int bowlerId, int leagueId);
     void teamStatisticsUpdated(int teamId);
+    void leaguesLoaded(int leagueCount, qint64 elapsedMs);
     
     // Send updates to lanes
     void sendToLane(int laneId, const QString &messageType, const QJsonObject &data);
@@ -286,23 +335,40 @@ signals:
 private slots:
     void onPeriodicUpdate();
     void onEventScheduled();
+    void applyWarmStart();
 
 private:
+    // How an absent bowler's games for the night were filled
+    struct AbsentResolution {
+        QVector<int> scores;        // One per game filled
+        QVector<int> preBowlIds;    // Pre-bowls used, in game order
+    };
+    
     // Helper methods
     void initializeDatabase();
+    void startWarmStart();
+    void mergeSnapshot(const LeagueSnapshot &snapshot);
     bool validateLeagueConfig(const LeagueConfig &config) const;
     bool validateTeamAssignment(int leagueId, const QVector<int> &bowlerIds) const;
     
+    const LeagueCalculator &calculatorFor(int leagueId) const;
+    bool resolveAbsentees(int leagueId, const QVector<int> &absentBowlerIds,
+                          QMap<int, BowlerSeasonData> &seasonData, QMap<int, AbsentResolution> *resolved,
+                          int gamesEach = GAMES_PER_SERIES);
+    bool addLaneAbsentees(int eventId, int laneId, const QVector<int> &absentBowlerIds);
+    static void writeAbsentResolution(QJsonObject &bowler, const AbsentResolution &resolution);
+    
     QVector<QPair<int, int>> generateRoundRobinPairs(const QVector<int> &teamIds) const;
     void assignLanesToMatchups(int leagueId, LeagueEvent &event) const;
     
     void saveLeagueConfig(const LeagueConfig &config);
-    void saveBowlerSeasonData(const BowlerSeasonData &data);
+    bool saveBowlerSeasonData(const BowlerSeasonData &data);
     void saveLeagueTeamData(const LeagueTeamData &data);
-    void saveLeagueEvent(const LeagueEvent &event);
+    int saveLeagueEvent(const LeagueEvent &event);
     
     LeagueConfig loadLeagueConfig(int leagueId) const;
     BowlerSeasonData loadBowlerSeasonData(int bowlerId, int leagueId) const;
+    QMap<int, BowlerSeasonData> loadLeagueSeasonData(int leagueId) const;
     LeagueTeamData loadLeagueTeamData(int teamId) const;
     LeagueEvent loadLeagueEvent(int eventId) const;
     
@@ -314,6 +380,13 @@ private:
     QMap<int, QVector<LeagueTeamData>> m_leagueTeams;
     QMap<QPair<int, int>, BowlerSeasonData> m_bowlerSeasonData; // (bowlerId, leagueId) -> data
     QMap<int, QVector<LeagueEvent>> m_leagueEvents;
+    mutable QMap<int, std::shared_ptr<LeagueCalculator>> m_calculators; // Built from m_leagueConfigs on first use
+    
+    QThread *m_warmStartThread = nullptr;
+    std::shared_ptr<LeagueSnapshot> m_warmStartSnapshot; // Written by the worker, read after it finishes
+    bool m_warmStarted = false;
+    QMap<int, QDateTime> m_missingLeagues; // Not in league_configs when last looked up
+    QMap<int, QMap<int, QJsonObject>> m_eventRosters; // eventId -> laneId -> roster sent at open
     
     QTimer *m_updateTimer;
     
@@ -322,6 +395,9 @@ private:
     static constexpr double DEFAULT_HANDICAP_PERCENTAGE = 0.8;
     static const int MAX_TEAMS_PER_DIVISION = 12;
     static const int MIN_TEAMS_FOR_PLAYOFFS = 4;
+    static const int LEAGUE_NIGHT_MINUTES = 180;
+    static constexpr int GAMES_PER_SERIES = 3;
+    static const int MISSING_LEAGUE_RETRY_SECS = 60;
 };
 
 #endif // LEAGUEMANAGER_H
\ No newline at end of file
@@ -344,6 +344,7 @@ void LeagueScheduleDialog::createSchedule()
     }
     
     // Create league schedule using DatabaseManager
+    QVector<ScheduleConflict> conflicts;
     QVector<int> createdEvents = m_dbManager->addLeagueSchedule(
         0, // league ID - would come from league management system
         m_leagueNameEdit->text().trimmed(),
@@ -356,20 +357,37 @@ void LeagueScheduleDialog::createSchedule()
         m_contactNameEdit->text().trimmed(),
         m_contactPhoneEdit->text().trimmed(),
         m_contactEmailEdit->text().trimmed(),
-        QString("League schedule for %1").arg(m_leagueNameEdit->text().trimmed())
+        QString("League schedule for %1").arg(m_leagueNameEdit->text().trimmed()),
+        &conflicts
     );
     
     if (!createdEvents.isEmpty()) {
+        QString conflictText;
+        if (!conflicts.isEmpty()) {
+            conflictText = QString("\n\nSkipped %1 lane bookings that conflict with existing events:")
+                          .arg(conflicts.size());
+            for (int i = 0; i < conflicts.size() && i < 10; ++i) {
+                conflictText += QString("\n• Week %1 (%2) - Lane %3")
+                               .arg(conflicts[i].weekNumber)
+                               .arg(conflicts[i].date.toString("MMM d"))
+                               .arg(conflicts[i].laneId);
+            }
+            if (conflicts.size() > 10) {
+                conflictText += QString("\n• ... and %1 more").arg(conflicts.size() - 10);
+            }
+        }
+        
         QMessageBox::information(this, "League Schedule Created", 
                                QString("Successfully created %1 league events for '%2'\n\n"
                                       "Events created: %3\n"
                                       "Lanes used: %4\n"
-                                      "Duration: %5 weeks")
+                                      "Duration: %5 weeks%6")
                                .arg(createdEvents.size())
                                .arg(m_leagueNameEdit->text())
                                .arg(createdEvents.size())
                                .arg(selectedLanes.size())
-                               .arg(m_weeksSpinner->value()));
+                               .arg(m_weeksSpinner->value())
+                               .arg(conflictText));
         
         accept(); // Close dialog
     } else {
@@ -0,0 +1,266 @@
+﻿// LeagueScheduler.cpp
+#include "LeagueScheduler.h"
+#include <QDebug>
+#include <climits>
+#include <utility>
+
+QVector<QVector<QPair<int, int>>> LeagueScheduler::circleRounds(const QVector<int> &teamIds)
+{
+    QVector<QVector<QPair<int, int>>> rounds;
+    if (teamIds.size() < 2) {
+        return rounds;
+    }
+
+    QVector<int> ring = teamIds;
+    if (ring.size() % 2 != 0) {
+        ring.append(BYE_TEAM);
+    }
+
+    const int n = ring.size();
+    rounds.reserve(n - 1);
+
+    for (int round = 0; round < n - 1; ++round) {
+        QVector<QPair<int, int>> pairs;
+        pairs.reserve(n / 2);
+
+        for (int i = 0; i < n / 2; ++i) {
+            int first = ring[i];
+            int second = ring[n - 1 - i];
+
+            // Alternate sides so the fixed team isn't always team 1
+            bool swapSides = (i == 0) ? (round % 2 == 1) : (i % 2 == 1);
+            if (swapSides) {
+                std::swap(first, second);
+            }
+            pairs.append(QPair<int, int>(first, second));
+        }
+        rounds.append(pairs);
+
+        // Rotate everyone except the first team one position clockwise
+        ring.insert(1, ring.takeLast());
+    }
+
+    return rounds;
+}
+
+QVector<int> LeagueScheduler::assignSlots(const QVector<QPair<int, int>> &pairs, int laneSlots,
+                                          const QHash<int, int> &teamIndex, QVector<int> &laneUsage,
+                                          int rotation)
+{
+    const int pairCount = pairs.size();
+    QVector<int> slots(pairCount, -1);
+    if (pairCount == 0 || laneSlots <= 0) {
+        return slots;
+    }
+
+    QVector<bool> slotTaken(laneSlots, false);
+
+    for (int k = 0; k < pairCount; ++k) {
+        // Rotate the order pairs pick in so no position always chooses first
+        int p = (k + rotation) % pairCount;
+        int a = teamIndex.value(pairs[p].first, -1);
+        int b = teamIndex.value(pairs[p].second, -1);
+
+        int bestSlot = -1;
+        int bestCost = 0;
+        for (int offset = 0; offset < laneSlots; ++offset) {
+            int s = (offset + rotation + k) % laneSlots;
+            if (slotTaken[s]) continue;
+
+            int cost = 0;
+            if (a >= 0) cost += laneUsage[a * laneSlots + s];
+            if (b >= 0) cost += laneUsage[b * laneSlots + s];
+
+            if (bestSlot < 0 || cost < bestCost) {
+                bestSlot = s;
+                bestCost = cost;
+            }
+        }
+
+        if (bestSlot < 0) {
+            break; // More pairs than slots
+        }
+
+        slotTaken[bestSlot] = true;
+        slots[p] = bestSlot;
+        if (a >= 0) laneUsage[a * laneSlots + bestSlot]++;
+        if (b >= 0) laneUsage[b * laneSlots + bestSlot]++;
+    }
+
+    return slots;
+}
+
+QVector<ScheduledWeek> LeagueScheduler::buildSeason(const QVector<int> &teamIds, int numberOfWeeks,
+                                                    int laneSlots, const QSet<int> &positionRoundWeeks)
+{
+    QVector<ScheduledWeek> weeks;
+
+    QVector<QVector<QPair<int, int>>> rounds = circleRounds(teamIds);
+    if (rounds.isEmpty() || numberOfWeeks <= 0) {
+        return weeks;
+    }
+
+    int matchesPerRound = teamIds.size() / 2;
+    if (laneSlots < matchesPerRound) {
+        qWarning() << "Cannot schedule" << teamIds.size() << "teams on" << laneSlots
+                   << "lane slots - need at least" << matchesPerRound;
+        return weeks;
+    }
+
+    QHash<int, int> teamIndex;
+    for (int i = 0; i < teamIds.size(); ++i) {
+        teamIndex[teamIds[i]] = i;
+    }
+    QVector<int> laneUsage(teamIds.size() * laneSlots, 0);
+
+    weeks.reserve(numberOfWeeks);
+    int roundCursor = 0;
+
+    for (int week = 1; week <= numberOfWeeks; ++week) {
+        ScheduledWeek scheduledWeek;
+        scheduledWeek.weekNumber = week;
+
+        if (positionRoundWeeks.contains(week)) {
+            // Matchups are filled from standings when the week is bowled
+            scheduledWeek.positionRound = true;
+            weeks.append(scheduledWeek);
+            continue;
+        }
+
+        const int cycle = roundCursor / rounds.size();
+        const QVector<QPair<int, int>> &round = rounds[roundCursor % rounds.size()];
+        ++roundCursor;
+
+        QVector<QPair<int, int>> games;
+        games.reserve(round.size());
+        for (const QPair<int, int> &pair : round) {
+            if (pair.first == BYE_TEAM) {
+                scheduledWeek.byeTeamIds.append(pair.second);
+            } else if (pair.second == BYE_TEAM) {
+                scheduledWeek.byeTeamIds.append(pair.first);
+            } else if (cycle % 2 == 1) {
+                games.append(QPair<int, int>(pair.second, pair.first));
+            } else {
+                games.append(pair);
+            }
+        }
+
+        QVector<int> slots = assignSlots(games, laneSlots, teamIndex, laneUsage, week);
+
+        scheduledWeek.matchups.reserve(games.size());
+        for (int i = 0; i < games.size(); ++i) {
+            ScheduledMatchup matchup;
+            matchup.team1Id = games[i].first;
+            matchup.team2Id = games[i].second;
+            matchup.slot = slots[i];
+            scheduledWeek.matchups.append(matchup);
+        }
+
+        weeks.append(scheduledWeek);
+    }
+
+    return weeks;
+}
+
+QVector<QPair<int, int>> LeagueScheduler::positionRoundPairs(const QVector<int> &rankedTeamIds)
+{
+    QVector<QPair<int, int>> pairs;
+    pairs.reserve((rankedTeamIds.size() + 1) / 2);
+
+    for (int i = 0; i < rankedTeamIds.size(); i += 2) {
+        int second = (i + 1 < rankedTeamIds.size()) ? rankedTeamIds[i + 1] : BYE_TEAM;
+        pairs.append(QPair<int, int>(rankedTeamIds[i], second));
+    }
+
+    return pairs;
+}
+
+QStringList LeagueScheduler::validateSeason(const QVector<ScheduledWeek> &weeks,
+                                            const QVector<int> &teamIds, int laneSlots)
+{
+    QStringList problems;
+
+    QSet<int> knownTeams;
+    for (int teamId : teamIds) {
+        knownTeams.insert(teamId);
+    }
+
+    QHash<QPair<int, int>, int> pairCounts;
+    int regularWeeks = 0;
+
+    for (const ScheduledWeek &week : weeks) {
+        if (week.positionRound) {
+            continue;
+        }
+        ++regularWeeks;
+
+        QSet<int> seenTeams;
+        QSet<int> usedSlots;
+
+        auto markTeam = [&](int teamId) {
+            if (!knownTeams.contains(teamId)) {
+                problems.append(QString("Week %1: unknown team %2").arg(week.weekNumber).arg(teamId));
+            } else if (seenTeams.contains(teamId)) {
+                problems.append(QString("Week %1: team %2 scheduled more than once")
+                                .arg(week.weekNumber).arg(teamId));
+            }
+            seenTeams.insert(teamId);
+        };
+
+        for (const ScheduledMatchup &matchup : week.matchups) {
+            if (matchup.team1Id == matchup.team2Id) {
+                problems.append(QString("Week %1: team %2 plays itself")
+                                .arg(week.weekNumber).arg(matchup.team1Id));
+            }
+            markTeam(matchup.team1Id);
+            markTeam(matchup.team2Id);
+
+            if (matchup.slot < 0 || matchup.slot >= laneSlots) {
+                problems.append(QString("Week %1: matchup %2 vs %3 has no lane")
+                                .arg(week.weekNumber).arg(matchup.team1Id).arg(matchup.team2Id));
+            } else if (usedSlots.contains(matchup.slot)) {
+                problems.append(QString("Week %1: lane slot %2 used twice")
+                                .arg(week.weekNumber).arg(matchup.slot));
+            }
+            usedSlots.insert(matchup.slot);
+
+            QPair<int, int> key(qMin(matchup.team1Id, matchup.team2Id),
+                                qMax(matchup.team1Id, matchup.team2Id));
+            pairCounts[key]++;
+        }
+
+        for (int teamId : week.byeTeamIds) {
+            markTeam(teamId);
+        }
+
+        if (week.byeTeamIds.size() > 1) {
+            problems.append(QString("Week %1: %2 teams on a bye")
+                            .arg(week.weekNumber).arg(week.byeTeamIds.size()));
+        }
+
+        if (seenTeams.size() != knownTeams.size()) {
+            problems.append(QString("Week %1: only %2 of %3 teams scheduled")
+                            .arg(week.weekNumber).arg(seenTeams.size()).arg(knownTeams.size()));
+        }
+    }
+
+    // Every pairing should be played the same number of times, give or take one
+    const int teamCount = teamIds.size();
+    const int totalPairs = teamCount * (teamCount - 1) / 2;
+    if (regularWeeks > 0 && totalPairs > 0) {
+        int minCount = (pairCounts.size() < totalPairs) ? 0 : INT_MAX;
+        int maxCount = 0;
+        for (auto it = pairCounts.constBegin(); it != pairCounts.constEnd(); ++it) {
+            minCount = qMin(minCount, it.value());
+            maxCount = qMax(maxCount, it.value());
+        }
+
+        int roundsPerCycle = (teamCount % 2 == 0) ? teamCount - 1 : teamCount;
+        if (regularWeeks >= roundsPerCycle && maxCount - minCount > 1) {
+            problems.append(QString("Unbalanced pairings: some teams meet %1 times, others %2")
+                            .arg(maxCount).arg(minCount));
+        }
+    }
+
+    return problems;
+}
@@ -0,0 +1,59 @@
+﻿// LeagueScheduler.h
+#ifndef LEAGUESCHEDULER_H
+#define LEAGUESCHEDULER_H
+
+#include <QVector>
+#include <QPair>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+
+// One matchup in a generated week. slot is an index into the league's lane list.
+struct ScheduledMatchup {
+    int team1Id = 0;
+    int team2Id = 0;
+    int slot = -1;
+};
+
+struct ScheduledWeek {
+    int weekNumber = 0;
+    bool positionRound = false;     // Paired from standings when the week is bowled
+    QVector<ScheduledMatchup> matchups;
+    QVector<int> byeTeamIds;        // Teams sitting out (odd team counts)
+};
+
+// Round-robin season generator based on the circle method.
+// Every team bowls exactly once per week (or has a bye), every pairing is
+// played once per cycle, and lane slots are rotated so each team sees each
+// lane as evenly as the week count allows.
+class LeagueScheduler
+{
+public:
+    static const int BYE_TEAM = 0;
+
+    // One round per entry, each round a list of (team1, team2) pairs.
+    // Odd team counts are padded with BYE_TEAM.
+    static QVector<QVector<QPair<int, int>>> circleRounds(const QVector<int> &teamIds);
+
+    // Builds numberOfWeeks weeks by cycling the circle rounds (swapping
+    // team1/team2 on alternate cycles) and assigning lane slots.
+    // Returns an empty schedule if laneSlots cannot hold one round.
+    static QVector<ScheduledWeek> buildSeason(const QVector<int> &teamIds, int numberOfWeeks,
+                                              int laneSlots,
+                                              const QSet<int> &positionRoundWeeks = QSet<int>());
+
+    // Pairs ranked teams 1v2, 3v4, ... ; an odd last team gets BYE_TEAM.
+    static QVector<QPair<int, int>> positionRoundPairs(const QVector<int> &rankedTeamIds);
+
+    // Assigns slots to pairs, preferring the slot each pair has used least.
+    // laneUsage is indexed [teamIndex * laneSlots + slot] and is updated.
+    static QVector<int> assignSlots(const QVector<QPair<int, int>> &pairs, int laneSlots,
+                                    const QHash<int, int> &teamIndex, QVector<int> &laneUsage,
+                                    int rotation = 0);
+
+    // Checks the schedule invariants; returns a list of problems (empty if valid).
+    static QStringList validateSeason(const QVector<ScheduledWeek> &weeks,
+                                      const QVector<int> &teamIds, int laneSlots);
+};
+
+#endif // LEAGUESCHEDULER_H
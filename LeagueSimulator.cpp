@@ -0,0 +1,392 @@
+﻿// LeagueSimulator.cpp
+#include "LeagueSimulator.h"
+#include "LeagueCalculator.h"
+#include "PointsEngine.h"
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QHash>
+#include <QDateTime>
+#include <QThread>
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+struct GameRow {
+    int bowler;
+    int gameNumber;
+    int score;
+    int balls;
+    QDateTime time;
+};
+
+// A league night claims the games recorded from a little before its start
+// until well after midnight, so late finishes stay in their own week
+const qint64 NIGHT_LEAD_SECS = 6 * 3600;
+const qint64 NIGHT_LENGTH_SECS = 18 * 3600;
+
+int countBalls(const QString &framesJson)
+{
+    int balls = 0;
+    const QJsonArray frames = QJsonDocument::fromJson(framesJson.toUtf8()).array();
+    for (const QJsonValue &frame : frames) {
+        for (const QJsonValue &ball : frame.toArray()) {
+            if (ball.toInt(-1) >= 0) {
+                balls++;
+            }
+        }
+    }
+    return balls;
+}
+
+struct TeamTotals {
+    int points = 0;
+    int wins = 0;
+    int losses = 0;
+    int ties = 0;
+    int scratchPins = 0;
+    int handicapPins = 0;
+};
+
+// Replay inputs, registered for --audit-queries
+const QString ROSTER_SQL = QueryPlanAudit::statement("SeasonReplayData::load",
+    "SELECT bowler_id, team_id FROM bowler_season_data WHERE league_id = ? AND team_id > 0");
+const QString SCHEDULE_SQL = QueryPlanAudit::statement("SeasonReplayData::load",
+    "SELECT week_number, scheduled_time, matchups_json FROM league_events WHERE league_id = ? ORDER BY week_number");
+const QString GAMES_SQL = QueryPlanAudit::statement("SeasonReplayData::load",
+    "SELECT bowler_id, game_number, score, frames_json, created_at FROM games WHERE league_id = ?");
+const QString TEAM_NAMES_SQL = QueryPlanAudit::statement("SeasonReplayData::load",
+    "SELECT id, name FROM teams", "reads every team name once per load");
+
+} // namespace
+
+SeasonReplayData SeasonReplayData::load(const QSqlDatabase &database, int leagueId)
+{
+    SeasonReplayData season;
+    season.leagueId = leagueId;
+
+    QHash<int, int> teamIndex;
+    QHash<int, int> bowlerIndex;
+    auto teamFor = [&season, &teamIndex](int teamId) {
+        auto it = teamIndex.find(teamId);
+        if (it != teamIndex.end()) {
+            return it.value();
+        }
+        const int index = season.teamIds.size();
+        teamIndex.insert(teamId, index);
+        season.teamIds.append(teamId);
+        season.teamBowlers.append(QVector<int>());
+        return index;
+    };
+
+    QSqlQuery query(database);
+    query.setForwardOnly(true);
+
+    // Rosters
+    query.prepare(ROSTER_SQL);
+    query.addBindValue(leagueId);
+    if (!query.exec()) {
+        qWarning() << "Failed to load league roster:" << query.lastError().text();
+        return season;
+    }
+    while (query.next()) {
+        const int team = teamFor(query.value(1).toInt());
+        const int bowler = season.bowlerIds.size();
+        bowlerIndex.insert(query.value(0).toInt(), bowler);
+        season.bowlerIds.append(query.value(0).toInt());
+        season.bowlerTeam.append(team);
+        season.teamBowlers[team].append(bowler);
+    }
+
+    // Schedule; league night start times tie games to weeks
+    QVector<QPair<QDateTime, int>> nights;
+    query.prepare(SCHEDULE_SQL);
+    query.addBindValue(leagueId);
+    if (!query.exec()) {
+        qWarning() << "Failed to load league schedule:" << query.lastError().text();
+        return season;
+    }
+    while (query.next()) {
+        Week week;
+        week.weekNumber = query.value(0).toInt();
+        const QJsonArray matchups = QJsonDocument::fromJson(query.value(2).toString().toUtf8())
+                                        .object()["matchups"].toArray();
+        for (const QJsonValue &value : matchups) {
+            const QJsonObject matchup = value.toObject();
+            week.matchups.append(qMakePair(teamFor(matchup["team1_id"].toInt()), teamFor(matchup["team2_id"].toInt())));
+        }
+        nights.append(qMakePair(QDateTime::fromString(query.value(1).toString(), Qt::ISODate), season.weeks.size()));
+        season.weeks.append(week);
+    }
+    std::sort(nights.begin(), nights.end());
+
+    // Games bowled
+    QVector<GameRow> games;
+    query.prepare(GAMES_SQL);
+    query.addBindValue(leagueId);
+    if (!query.exec()) {
+        qWarning() << "Failed to load league games:" << query.lastError().text();
+        return season;
+    }
+    while (query.next()) {
+        auto bowler = bowlerIndex.constFind(query.value(0).toInt());
+        if (bowler == bowlerIndex.constEnd()) {
+            continue; // Subs and walk-ins do not count towards a team here
+        }
+        GameRow row;
+        row.bowler = bowler.value();
+        row.gameNumber = qMax(1, query.value(1).toInt());
+        row.score = query.value(2).toInt();
+        row.balls = countBalls(query.value(3).toString());
+        // Recorded as "yyyy-MM-dd hh:mm:ss" local time
+        row.time = QDateTime::fromString(query.value(4).toString().left(19), "yyyy-MM-dd hh:mm:ss");
+        season.gamesPerWeek = qMax(season.gamesPerWeek, row.gameNumber);
+        games.append(row);
+    }
+
+    const int gridSize = season.bowlerIds.size() * season.gamesPerWeek;
+    QVector<bool> played(season.weeks.size(), false);
+    for (Week &week : season.weeks) {
+        week.scores.fill(-1, gridSize);
+        week.balls.fill(0, gridSize);
+    }
+    for (const GameRow &row : games) {
+        if (!row.time.isValid()) {
+            continue;
+        }
+        // The last night to start before the game, if the game falls within it
+        auto night = std::upper_bound(nights.constBegin(), nights.constEnd(), row.time.addSecs(NIGHT_LEAD_SECS),
+                                      [](const QDateTime &time, const QPair<QDateTime, int> &entry) {
+                                          return time < entry.first;
+                                      });
+        if (night == nights.constBegin()) {
+            continue;
+        }
+        --night;
+        if (night->first.secsTo(row.time) >= NIGHT_LENGTH_SECS) {
+            continue; // Pre-bowls and games on other days
+        }
+        const int week = night->second;
+        const int cell = row.bowler * season.gamesPerWeek + row.gameNumber - 1;
+        season.weeks[week].scores[cell] = row.score;
+        season.weeks[week].balls[cell] = row.balls;
+        played[week] = true;
+    }
+
+    // Weeks not bowled yet are left out of the replay
+    QVector<Week> bowled;
+    for (int w = 0; w < season.weeks.size(); ++w) {
+        if (played[w]) {
+            bowled.append(season.weeks[w]);
+        }
+    }
+    season.weeks = bowled;
+
+    // Team names
+    query.prepare(TEAM_NAMES_SQL);
+    season.teamNames.reserve(season.teamIds.size());
+    for (int i = 0; i < season.teamIds.size(); ++i) {
+        season.teamNames.append(QString("Team %1").arg(season.teamIds[i]));
+    }
+    if (query.exec()) {
+        while (query.next()) {
+            auto team = teamIndex.constFind(query.value(0).toInt());
+            if (team != teamIndex.constEnd()) {
+                season.teamNames[team.value()] = query.value(1).toString();
+            }
+        }
+    }
+
+    return season;
+}
+
+WhatIfResult LeagueSimulator::replay(const SeasonReplayData &season, const WhatIfVariant &variant)
+{
+    const LeagueConfig &config = variant.config;
+    const std::unique_ptr<LeagueCalculator> calculator = LeagueCalculator::create(config);
+
+    const int bowlerCount = season.bowlerIds.size();
+    const int teamCount = season.teamIds.size();
+    const int gamesPerWeek = season.gamesPerWeek;
+
+    const PointsEngine engine(config.pointSystem);
+    const bool handicapped = engine.usesHandicap();
+
+    // Running bowler figures as columns, rebuilt as the season is replayed
+    RosterColumns roster;
+    roster.reserve(bowlerCount);
+    for (int b = 0; b < bowlerCount; ++b) {
+        roster.append(season.bowlerIds[b], 0, 0, 0, 0.0);
+    }
+
+    QVector<TeamTotals> totals(teamCount);
+    QVector<MatchupScores> matchups;
+
+    for (const SeasonReplayData::Week &week : season.weeks) {
+        // Figures going into the night are what the bowlers carry all night
+        const RosterFigures figures = calculator->evaluate(roster);
+
+        for (int team = 0; team < teamCount; ++team) {
+            for (int bowler : season.teamBowlers[team]) {
+                const int handicap = handicapped ? static_cast<int>(figures.handicaps[bowler]) : 0;
+                for (int g = 0; g < gamesPerWeek; ++g) {
+                    int score = week.scores[bowler * gamesPerWeek + g];
+                    if (score < 0) {
+                        score = figures.absentScores[bowler];
+                    } else {
+                        totals[team].scratchPins += score;
+                    }
+                    totals[team].handicapPins += score + handicap;
+                }
+            }
+        }
+
+        // The night's matchups as game matrices, absentees at their absent score
+        matchups.resize(week.matchups.size());
+        for (int m = 0; m < week.matchups.size(); ++m) {
+            const QVector<int> &bowlers1 = season.teamBowlers[week.matchups[m].first];
+            const QVector<int> &bowlers2 = season.teamBowlers[week.matchups[m].second];
+            MatchupScores &scores = matchups[m];
+            scores.resize(qMax(bowlers1.size(), bowlers2.size()), gamesPerWeek);
+            scores.team1Id = season.teamIds[week.matchups[m].first];
+            scores.team2Id = season.teamIds[week.matchups[m].second];
+
+            auto fill = [&](const QVector<int> &bowlers, QVector<int> &scratch, QVector<int> &handicaps) {
+                for (int p = 0; p < bowlers.size(); ++p) {
+                    const int bowler = bowlers[p];
+                    handicaps[p] = static_cast<int>(figures.handicaps[bowler]);
+                    for (int g = 0; g < gamesPerWeek; ++g) {
+                        const int score = week.scores[bowler * gamesPerWeek + g];
+                        scratch[p * gamesPerWeek + g] = score < 0 ? figures.absentScores[bowler] : score;
+                    }
+                }
+            };
+            fill(bowlers1, scores.team1Scratch, scores.team1Handicaps);
+            fill(bowlers2, scores.team2Scratch, scores.team2Handicaps);
+        }
+
+        const EventPoints points = engine.scoreEvent(matchups);
+        for (int m = 0; m < week.matchups.size(); ++m) {
+            const MatchupPoints &result = points.matchups[m];
+            TeamTotals &team1 = totals[week.matchups[m].first];
+            TeamTotals &team2 = totals[week.matchups[m].second];
+            team1.points += result.team1Points;
+            team2.points += result.team2Points;
+            // W/L/T count matches, not the comparisons the points came from
+            team1.wins += result.matchResult > 0;
+            team1.losses += result.matchResult < 0;
+            team2.wins += result.matchResult < 0;
+            team2.losses += result.matchResult > 0;
+            team1.ties += result.matchResult == 0;
+            team2.ties += result.matchResult == 0;
+        }
+
+        // Only games actually bowled feed the averages
+        for (int b = 0; b < bowlerCount; ++b) {
+            for (int g = 0; g < gamesPerWeek; ++g) {
+                const int cell = b * gamesPerWeek + g;
+                if (week.scores[cell] >= 0) {
+                    roster.games[b]++;
+                    roster.pins[b] += week.scores[cell];
+                    roster.balls[b] += week.balls[cell];
+                }
+            }
+            roster.storedAverages[b] = figures.averages[b];
+        }
+    }
+
+    WhatIfResult result;
+    result.name = variant.name;
+    result.standings.reserve(teamCount);
+    for (int team = 0; team < teamCount; ++team) {
+        WhatIfStanding standing;
+        standing.teamId = season.teamIds[team];
+        standing.teamName = season.teamNames.value(team);
+        standing.points = totals[team].points;
+        standing.wins = totals[team].wins;
+        standing.losses = totals[team].losses;
+        standing.ties = totals[team].ties;
+        standing.scratchPins = totals[team].scratchPins;
+        standing.handicapPins = totals[team].handicapPins;
+        result.standings.append(standing);
+    }
+
+    std::sort(result.standings.begin(), result.standings.end(), [](const WhatIfStanding &a, const WhatIfStanding &b) {
+        if (a.points != b.points) {
+            return a.points > b.points;
+        }
+        if (a.handicapPins != b.handicapPins) {
+            return a.handicapPins > b.handicapPins;
+        }
+        return a.teamId < b.teamId;
+    });
+    for (int i = 0; i < result.standings.size(); ++i) {
+        result.standings[i].rank = i + 1;
+    }
+
+    return result;
+}
+
+WhatIfReport LeagueSimulator::run(const SeasonReplayData &season, const LeagueConfig &baseline,
+                                  const QVector<WhatIfVariant> &variants, int threadCount)
+{
+    WhatIfReport report;
+    report.weeksReplayed = season.weeks.size();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QVector<WhatIfVariant> jobs;
+    jobs.reserve(variants.size() + 1);
+    jobs.append({QStringLiteral("Current rules"), baseline});
+    jobs += variants;
+
+    report.results.resize(jobs.size());
+
+    threadCount = threadCount > 0 ? threadCount : QThread::idealThreadCount();
+    threadCount = qBound(1, threadCount, jobs.size());
+    report.threadCount = threadCount;
+
+    // Threads take the next variant until none are left
+    QAtomicInt next(0);
+    QList<QThread*> threads;
+    for (int i = 0; i < threadCount; ++i) {
+        threads.append(QThread::create([&season, &jobs, &report, &next]() {
+            for (int job = next.fetchAndAddRelaxed(1); job < jobs.size(); job = next.fetchAndAddRelaxed(1)) {
+                report.results[job] = replay(season, jobs[job]);
+            }
+        }));
+    }
+
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+    for (QThread *thread : threads) {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    // Diff every variant against the baseline
+    QHash<int, WhatIfStanding> base;
+    for (const WhatIfStanding &standing : report.results[0].standings) {
+        base.insert(standing.teamId, standing);
+    }
+    for (int r = 1; r < report.results.size(); ++r) {
+        for (WhatIfStanding &standing : report.results[r].standings) {
+            const WhatIfStanding before = base.value(standing.teamId);
+            standing.rankChange = before.rank - standing.rank;
+            standing.pointsChange = standing.points - before.points;
+        }
+    }
+
+    report.elapsedMs = timer.elapsed();
+    qDebug() << "What-if replay:" << jobs.size() << "rule sets over" << report.weeksReplayed << "weeks on"
+             << threadCount << "threads in" << report.elapsedMs << "ms";
+    return report;
+}
@@ -0,0 +1,82 @@
+﻿// LeagueSimulator.h
+#ifndef LEAGUESIMULATOR_H
+#define LEAGUESIMULATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QPair>
+#include <QSqlDatabase>
+#include "LeagueManager.h"
+
+// A league season in memory, in the shape the replay walks: bowlers and teams
+// are indices, and each week holds its matchups and a flat score grid.
+struct SeasonReplayData {
+    int leagueId = 0;
+    QVector<int> teamIds;
+    QStringList teamNames;
+    QVector<int> bowlerIds;
+    QVector<int> bowlerTeam;                // Team index per bowler
+    QVector<QVector<int>> teamBowlers;      // Bowler indices per team
+    int gamesPerWeek = 3;
+
+    struct Week {
+        int weekNumber = 0;
+        QVector<QPair<int, int>> matchups;  // Team indices
+        QVector<int> scores;                // [bowler * gamesPerWeek + game]; -1 = absent
+        QVector<int> balls;                 // Same layout; 0 when frames were not recorded
+    };
+    QVector<Week> weeks;                    // Only weeks with games bowled
+
+    static SeasonReplayData load(const QSqlDatabase &database, int leagueId);
+};
+
+struct WhatIfVariant {
+    QString name;
+    LeagueConfig config;
+};
+
+struct WhatIfStanding {
+    int teamId = 0;
+    QString teamName;
+    int rank = 0;
+    int points = 0;
+    int wins = 0;
+    int losses = 0;
+    int ties = 0;
+    int scratchPins = 0;
+    int handicapPins = 0;                   // Same as scratch plus absent scores in scratch leagues
+
+    // Against the first result (the league's current rules)
+    int rankChange = 0;                     // Positive = moved up
+    int pointsChange = 0;
+};
+
+struct WhatIfResult {
+    QString name;
+    QVector<WhatIfStanding> standings;      // By rank
+};
+
+struct WhatIfReport {
+    QVector<WhatIfResult> results;          // results[0] is the baseline
+    int weeksReplayed = 0;
+    int threadCount = 0;
+    qint64 elapsedMs = 0;
+};
+
+// Replays a season under alternate rules ("90% of 230 instead of 80% of
+// 225") and diffs the final standings against the current rules. Averages
+// and handicaps are rebuilt week by week with LeagueCalculator, absentees
+// get the variant's absent score, and points follow the variant's point
+// system. The season is loaded once and shared read-only; each variant is
+// replayed on its own thread.
+class LeagueSimulator
+{
+public:
+    static WhatIfReport run(const SeasonReplayData &season, const LeagueConfig &baseline,
+                            const QVector<WhatIfVariant> &variants, int threadCount = 0);
+
+    static WhatIfResult replay(const SeasonReplayData &season, const WhatIfVariant &variant);
+};
+
+#endif // LEAGUESIMULATOR_H
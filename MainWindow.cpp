@@ -1,5 +1,6 @@
 ﻿#include "MainWindow.h"
 #include "QuickGameDialog.h"
+#include "BusEvents.h"
 #include <QApplication>
 #include <QMenuBar>
 #include <QStatusBar>
@@ -7,33 +8,60 @@
 #include <QGroupBox>
 #include <QMessageBox>
 #include <QJsonDocument>
+#include <QSysInfo>
 
-MainWindow::MainWindow(QWidget *parent)
+MainWindow::MainWindow(QWidget *parent, const QString &attachAddress)
     : QMainWindow(parent)
     , m_centralWidget(nullptr)
     , m_timeUpdateTimer(new QTimer(this))
     , m_laneServer(nullptr)
+    , m_consoleClient(nullptr)
     , m_actions(nullptr)
     , m_totalLanes(8) // Default 8 lanes, should be configurable
 {
     setupUI();
     
     // Initialize core components
-    m_laneServer = new LaneServer(this);
+    if (attachAddress.isEmpty()) {
+        m_laneServer = new LaneServer(this);
+    } else {
+        m_consoleClient = new ConsoleClient(QSysInfo::machineHostName(), this);
+    }
     m_actions = new Actions(this, this);
     
     // Connect signals
     connect(m_timeUpdateTimer, &QTimer::timeout, this, &MainWindow::updateTime);
-    connect(m_laneServer, &LaneServer::laneStatusChanged, 
-            this, &MainWindow::onLaneStatusChanged);
-    connect(m_laneServer, &LaneServer::gameDataReceived,
-            this, &MainWindow::onGameDataReceived);
+    EventBus::instance()->subscribe<LaneStatusEvent>(this, BusFilter::any(),
+        [this](const LaneStatusEvent &event) {
+            onLaneStatusChanged(event.laneId, static_cast<LaneStatus>(event.status));
+        });
+    EventBus::instance()->subscribe<GameDataEvent>(this, BusFilter::any(),
+        [this](const GameDataEvent &event) {
+            onGameDataReceived(event.laneId, event.gameData);
+        });
     
     // Start timer
     m_timeUpdateTimer->start(1000); // Update every second
     
-    // Start lane server
-    m_laneServer->start();
+    // Start lane server, or attach to one; either way lane traffic arrives on the bus
+    if (m_laneServer) {
+        m_laneServer->start();
+    } else {
+        const int colon = attachAddress.lastIndexOf(':');
+        const QString host = colon > 0 ? attachAddress.left(colon) : attachAddress;
+        const quint16 port = colon > 0 ? static_cast<quint16>(attachAddress.mid(colon + 1).toUInt()) : 50006;
+        connect(m_consoleClient, &ConsoleClient::attached, this, [this, host](int laneCount) {
+            statusBar()->showMessage(QString("Attached to %1 (%2 lanes)").arg(host).arg(laneCount));
+        });
+        connect(m_consoleClient, &ConsoleClient::detached, this, [this, host]() {
+            statusBar()->showMessage(QString("Reconnecting to %1...").arg(host));
+        });
+        connect(m_consoleClient, &ConsoleClient::rejected, this, [this, host](const QString &reason) {
+            statusBar()->showMessage(QString("%1 refused this console (%2); check BOWLING_CONSOLE_KEY")
+                                     .arg(host, reason));
+        });
+        m_consoleClient->connectToServer(host, port);
+    }
     
     setWindowTitle("Centre Bowling Management System");
     resize(1200, 800);
@@ -86,8 +114,22 @@ void MainWindow::setupTopBar()
     m_dateTimeLabel = new QLabel(getCurrentTime());
     m_dateTimeLabel->setStyleSheet("QLabel { color: #4A90E2; font-size: 14px; }");
     
+    // Quick search across bowlers, teams and bookings
+    m_searchEdit = new QLineEdit;
+    m_searchEdit->setPlaceholderText("Search bowlers, teams, bookings...");
+    m_searchEdit->setFixedWidth(280);
+    m_searchEdit->setStyleSheet("QLineEdit { background-color: #2a2a2a; color: white; border: 1px solid #555; padding: 4px; }");
+    connect(m_searchEdit, &QLineEdit::returnPressed, this, [this]() {
+        if (!m_searchEdit->text().trimmed().isEmpty()) {
+            m_actions->quickSearch(m_searchEdit->text(),
+                                   m_searchEdit->mapToGlobal(QPoint(0, m_searchEdit->height())));
+        }
+    });
+    
     topLayout->addWidget(m_logoLabel);
     topLayout->addStretch();
+    topLayout->addWidget(m_searchEdit);
+    topLayout->addSpacing(20);
     topLayout->addWidget(m_dateTimeLabel);
     
     m_mainLayout->addWidget(m_topBar);
@@ -117,7 +159,7 @@ void MainWindow::setupMainContent()
     quickLayout->setContentsMargins(10, 10, 10, 10);
     
     QStringList quickButtons = {"Quick Start", "View Bowler", "Bowler Management", "Calendar", "Teams", 
-                               "Leagues", "Party", "Status", "Settings", "Test Lane", "QG Diagnostic", "DB Browser"};
+                               "Leagues", "Party", "Announce", "Status", "Settings", "Test Lane", "QG Diagnostic", "DB Browser"};
     
     for (const QString &buttonText : quickButtons) {
         QPushButton *button = new QPushButton(buttonText);
@@ -282,6 +324,8 @@ void MainWindow::onQuickAccessButtonClicked(const QString &buttonText)
         m_actions->leagues();
     } else if (buttonText == "Party") {
         m_actions->party();
+    } else if (buttonText == "Announce") {
+        m_actions->announce();
     } else if (buttonText == "Status") {
         m_actions->showStatus();
     } else if (buttonText == "Settings") {
@@ -502,7 +546,7 @@ void MainWindow::showQuickGameDialog(int laneNumber)
         commandData["type"] = "quick_game";
         commandData["data"] = gameData;
         
-        m_laneServer->onLaneCommand(commandData);
+        dispatchLaneCommand(commandData);
     }
 }
 
@@ -512,7 +556,16 @@ void MainWindow::sendLaneCommand(int laneNumber, const QString &command, const Q
     commandData["lane_id"] = laneNumber;
     commandData["command"] = command;
     
-    m_laneServer->onLaneCommand(commandData);
+    dispatchLaneCommand(commandData);
+}
+
+bool MainWindow::dispatchLaneCommand(const QJsonObject &commandData)
+{
+    if (m_laneServer) {
+        m_laneServer->onLaneCommand(commandData);
+        return true;
+    }
+    return m_consoleClient->sendCommand(commandData);
 }
 
 void MainWindow::onBallValueChanged(int laneNumber, const QString &bowlerName, int frame, int ball, int newValue)
@@ -3,6 +3,7 @@
 
 #include <QMainWindow>
 #include <QLabel>
+#include <QLineEdit>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
@@ -15,6 +16,7 @@
 #include <QDialog>
 #include <QMap>
 #include "LaneServer.h"
+#include "ConsoleClient.h"
 #include "Actions.h"
 #include "EnhancedLaneWidget.h"
 #include "GameDisplayDialog.h"
@@ -25,8 +27,16 @@ class MainWindow : public QMainWindow
     Q_OBJECT
 
 public:
-    MainWindow(QWidget *parent = nullptr);
+    // attachAddress "host[:port]" runs as a console of a remote bowlingd
+    // instead of hosting the lane server in-process
+    MainWindow(QWidget *parent = nullptr, const QString &attachAddress = QString());
     ~MainWindow();
+    
+    // Lane commands go to the in-process LaneServer, or through the console
+    // connection when attached; false if the command could not be sent
+    bool dispatchLaneCommand(const QJsonObject &commandData);
+    LaneServer *laneServer() const { return m_laneServer; }
+    ConsoleClient *consoleClient() const { return m_consoleClient; }
 
 protected:
     void keyPressEvent(QKeyEvent *event) override;
@@ -68,6 +78,7 @@ private:
     QFrame *m_topBar;
     QLabel *m_logoLabel;
     QLabel *m_dateTimeLabel;
+    QLineEdit *m_searchEdit;
     QLabel *m_statusBar;
     QFrame *m_quickAccessFrame;
     QScrollArea *m_laneScrollArea;
@@ -80,7 +91,8 @@ private:
     QTimer *m_timeUpdateTimer;
     
     // Core components
-    LaneServer *m_laneServer;
+    LaneServer *m_laneServer;           // Null when attached to a remote server
+    ConsoleClient *m_consoleClient;
     Actions *m_actions;
     
     // Enhanced lane widgets
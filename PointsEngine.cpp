@@ -0,0 +1,254 @@
+﻿// PointsEngine.cpp
+#include "PointsEngine.h"
+#include <algorithm>
+
+namespace {
+
+int teamSeries(const QVector<int> &scratch, const QVector<int> &handicaps, int positions, int games, bool withHandicap)
+{
+    int series = 0;
+    for (int p = 0; p < positions; ++p) {
+        const int handicap = withHandicap ? handicaps[p] : 0;
+        for (int g = 0; g < games; ++g) {
+            const int score = scratch[p * games + g];
+            series += score >= 0 ? score + handicap : 0;
+        }
+    }
+    return series;
+}
+
+} // namespace
+
+void MatchupScores::resize(int positionCount, int gameCount)
+{
+    positions = positionCount;
+    games = gameCount;
+    team1Scratch.fill(-1, positions * games);
+    team2Scratch.fill(-1, positions * games);
+    team1Handicaps.fill(0, positions);
+    team2Handicaps.fill(0, positions);
+}
+
+bool MatchupScores::isComplete(int team1Positions, int team2Positions) const
+{
+    if (team1Positions <= 0 || team2Positions <= 0
+        || team1Positions > positions || team2Positions > positions) {
+        return false;
+    }
+    const auto allBowled = [this](const QVector<int> &scratch, int rosterSize) {
+        return std::all_of(scratch.constBegin(), scratch.constBegin() + rosterSize * games,
+                           [](int score) { return score >= 0; });
+    };
+    return allBowled(team1Scratch, team1Positions) && allBowled(team2Scratch, team2Positions);
+}
+
+PointsEngine::PointsEngine(const LeagueConfig::PointSystem &rules)
+    : m_rules(rules)
+{
+    switch (rules.type) {
+    case LeagueConfig::PointSystem::WinLossTie:
+        m_headsUp = rules.includeHeadsUp;
+        m_teamTotals = true;
+        m_modes.append(rules.headsUpWithHandicap);
+        break;
+    case LeagueConfig::PointSystem::TeamVsTeam:
+        m_leagueRanking = true;
+        m_modes.append(rules.trackHandicap);
+        break;
+    case LeagueConfig::PointSystem::Custom:
+        m_headsUp = rules.trackHeadsUp;
+        m_teamTotals = rules.trackTeamVs;
+        m_leagueRanking = rules.trackLeagueVs;
+        m_divisionRanking = rules.trackDivisionVs;
+        if (rules.trackScratch) {
+            m_modes.append(false);
+        }
+        if (rules.trackHandicap || m_modes.isEmpty()) {
+            m_modes.append(true);
+        }
+        break;
+    }
+}
+
+void PointsEngine::scoreMatrix(const MatchupScores &scores, bool withHandicap, MatchupPoints &points) const
+{
+    const int positions = scores.positions;
+    const int games = scores.games;
+    const int win = m_rules.winPoints;
+    const int loss = m_rules.lossPoints;
+    const int tie = m_rules.tiePoints;
+
+    const int *scratch1 = scores.team1Scratch.constData();
+    const int *scratch2 = scores.team2Scratch.constData();
+    int *positionPoints1 = points.team1PositionPoints.data();
+    int *positionPoints2 = points.team2PositionPoints.data();
+
+    QVector<int> teamGames1(games, 0);
+    QVector<int> teamGames2(games, 0);
+    int wins = 0;
+    int losses = 0;
+    int ties = 0;
+
+    for (int p = 0; p < positions; ++p) {
+        const int handicap1 = withHandicap ? scores.team1Handicaps[p] : 0;
+        const int handicap2 = withHandicap ? scores.team2Handicaps[p] : 0;
+        int series1 = 0;
+        int series2 = 0;
+        int complete = 1;
+
+        // Comparisons as 0/1 products so the inner loop has no branches
+        for (int g = 0; g < games; ++g) {
+            const int raw1 = scratch1[p * games + g];
+            const int raw2 = scratch2[p * games + g];
+            const int bowled = (raw1 >= 0) & (raw2 >= 0);
+            const int score1 = (raw1 + handicap1) * (raw1 >= 0); // Unbowled counts as 0
+            const int score2 = (raw2 + handicap2) * (raw2 >= 0);
+            const int w = bowled & (score1 > score2);
+            const int l = bowled & (score1 < score2);
+            const int t = bowled & (score1 == score2);
+
+            positionPoints1[p] += m_headsUp * (w * win + l * loss + t * tie);
+            positionPoints2[p] += m_headsUp * (l * win + w * loss + t * tie);
+            wins += m_headsUp * w;
+            losses += m_headsUp * l;
+            ties += m_headsUp * t;
+
+            complete &= bowled;
+            series1 += score1;
+            series2 += score2;
+            teamGames1[g] += score1;
+            teamGames2[g] += score2;
+        }
+
+        // Position series only once every game on both sides is in
+        if (m_headsUp && complete && games > 0) {
+            const int w = series1 > series2;
+            const int l = series1 < series2;
+            const int t = series1 == series2;
+            positionPoints1[p] += w * win + l * loss + t * tie;
+            positionPoints2[p] += l * win + w * loss + t * tie;
+            wins += w;
+            losses += l;
+            ties += t;
+        }
+    }
+
+    for (int p = 0; p < positions; ++p) {
+        points.team1Points += positionPoints1[p];
+        points.team2Points += positionPoints2[p];
+    }
+
+    if (m_teamTotals) {
+        int series1 = 0;
+        int series2 = 0;
+        for (int g = 0; g < games; ++g) {
+            series1 += teamGames1[g];
+            series2 += teamGames2[g];
+        }
+
+        // Each game, then the series; a game neither team has bowled yet is skipped
+        teamGames1.append(series1);
+        teamGames2.append(series2);
+        for (int g = 0; g < teamGames1.size(); ++g) {
+            if (teamGames1[g] == 0 && teamGames2[g] == 0) {
+                continue;
+            }
+            const int w = teamGames1[g] > teamGames2[g];
+            const int l = teamGames1[g] < teamGames2[g];
+            const int t = teamGames1[g] == teamGames2[g];
+            points.team1Points += w * win + l * loss + t * tie;
+            points.team2Points += l * win + w * loss + t * tie;
+            wins += w;
+            losses += l;
+            ties += t;
+        }
+    }
+
+    points.team1Wins += wins;
+    points.team1Losses += losses;
+    points.ties += ties;
+}
+
+MatchupPoints PointsEngine::scoreMatchup(const MatchupScores &scores) const
+{
+    MatchupPoints points;
+    points.team1PositionPoints.fill(0, scores.positions);
+    points.team2PositionPoints.fill(0, scores.positions);
+
+    for (bool withHandicap : m_modes) {
+        scoreMatrix(scores, withHandicap, points);
+    }
+
+    // Reported series follow the first mode, handicap unless scratch is also tracked
+    points.team1Series = teamSeries(scores.team1Scratch, scores.team1Handicaps, scores.positions, scores.games,
+                                    m_modes.first());
+    points.team2Series = teamSeries(scores.team2Scratch, scores.team2Handicaps, scores.positions, scores.games,
+                                    m_modes.first());
+    points.matchResult = (points.team1Series > points.team2Series) - (points.team1Series < points.team2Series);
+    return points;
+}
+
+void PointsEngine::rank(const QVector<QPair<int, int>> &series, QMap<int, int> &rankPoints) const
+{
+    QVector<QPair<int, int>> sorted = series; // (teamId, series)
+    std::sort(sorted.begin(), sorted.end(), [](const QPair<int, int> &a, const QPair<int, int> &b) {
+        return a.second != b.second ? a.second > b.second : a.first < b.first;
+    });
+
+    // Stacked: 8,7,6,6,5,... Linear: 8,7,6,6,4,...
+    const int count = sorted.size();
+    int place = 0;
+    for (int i = 0; i < count; ++i) {
+        if (i > 0 && sorted[i].second != sorted[i - 1].second) {
+            place = m_rules.stackedTiePoints ? place + 1 : i;
+        }
+        rankPoints[sorted[i].first] += count - place;
+    }
+}
+
+EventPoints PointsEngine::scoreEvent(const QVector<MatchupScores> &matchups, const QMap<int, int> &divisionOf) const
+{
+    EventPoints event;
+    event.matchups.reserve(matchups.size());
+    for (const MatchupScores &scores : matchups) {
+        event.matchups.append(scoreMatchup(scores));
+    }
+
+    if (m_leagueRanking || m_divisionRanking) {
+        for (bool withHandicap : m_modes) {
+            QVector<QPair<int, int>> league;
+            QMap<int, QVector<QPair<int, int>>> divisions;
+
+            for (const MatchupScores &scores : matchups) {
+                const QPair<int, int> team1(scores.team1Id, teamSeries(scores.team1Scratch, scores.team1Handicaps,
+                                                                       scores.positions, scores.games, withHandicap));
+                const QPair<int, int> team2(scores.team2Id, teamSeries(scores.team2Scratch, scores.team2Handicaps,
+                                                                       scores.positions, scores.games, withHandicap));
+                league << team1 << team2;
+                divisions[divisionOf.value(scores.team1Id)].append(team1);
+                divisions[divisionOf.value(scores.team2Id)].append(team2);
+            }
+
+            if (m_leagueRanking) {
+                rank(league, event.rankPoints);
+            }
+            if (m_divisionRanking) {
+                for (const QVector<QPair<int, int>> &division : divisions) {
+                    rank(division, event.rankPoints);
+                }
+            }
+        }
+
+        for (int i = 0; i < matchups.size(); ++i) {
+            event.matchups[i].team1Points += event.rankPoints.value(matchups[i].team1Id);
+            event.matchups[i].team2Points += event.rankPoints.value(matchups[i].team2Id);
+        }
+    }
+
+    for (int i = 0; i < matchups.size(); ++i) {
+        event.totals[matchups[i].team1Id] += event.matchups[i].team1Points;
+        event.totals[matchups[i].team2Id] += event.matchups[i].team2Points;
+    }
+
+    return event;
+}
@@ -0,0 +1,83 @@
+﻿// PointsEngine.h
+#ifndef POINTSENGINE_H
+#define POINTSENGINE_H
+
+#include <QVector>
+#include <QMap>
+#include "LeagueManager.h"
+
+// One matchup as a game matrix. Positions follow each team's roster order;
+// cells are [position * games + game] and -1 marks a game not bowled.
+struct MatchupScores {
+    int team1Id = 0;
+    int team2Id = 0;
+    int positions = 0;
+    int games = 3;
+    QVector<int> team1Scratch;
+    QVector<int> team2Scratch;
+    QVector<int> team1Handicaps;        // Per position, added to every game
+    QVector<int> team2Handicaps;
+
+    // Sizes the matrix, with every cell unbowled and no handicap
+    void resize(int positionCount, int gameCount);
+
+    // Every game in for the first team1Positions / team2Positions positions,
+    // which is each team's roster size; false while either roster is empty
+    bool isComplete(int team1Positions, int team2Positions) const;
+};
+
+struct MatchupPoints {
+    int team1Points = 0;
+    int team2Points = 0;
+    int team1Wins = 0;                  // Comparisons won; team 2's are the mirror image
+    int team1Losses = 0;
+    int ties = 0;
+    int team1Series = 0;                // Pins the team comparisons were made on
+    int team2Series = 0;
+    int matchResult = 0;                // The match on series: 1 team 1 won, -1 team 2 won, 0 tied
+    QVector<int> team1PositionPoints;   // Heads-up points per position
+    QVector<int> team2PositionPoints;
+};
+
+struct EventPoints {
+    QVector<MatchupPoints> matchups;    // Same order as the input, ranking points included
+    QMap<int, int> rankPoints;          // teamId -> team vs team / division / league ranking points
+    QMap<int, int> totals;              // teamId -> everything earned on the night
+};
+
+// Scores league nights by the league's PointSystem:
+//  - heads-up: each position against the opposing position, game by game and
+//    series (WinLossTie with includeHeadsUp, Custom with trackHeadsUp)
+//  - team totals against the opponent, game by game and series (WinLossTie,
+//    Custom with trackTeamVs)
+//  - every team bowling ranked on series, highest gets the most points
+//    (TeamVsTeam, Custom with trackLeagueVs), or within each division (Custom
+//    with trackDivisionVs); stackedTiePoints picks 8,7,6,6,5 over 8,7,6,6,4
+// Custom leagues can score scratch and handicap side by side.
+class PointsEngine
+{
+public:
+    explicit PointsEngine(const LeagueConfig::PointSystem &rules);
+
+    // False for scratch leagues, where no comparison adds handicap
+    bool usesHandicap() const { return m_modes.contains(true); }
+
+    MatchupPoints scoreMatchup(const MatchupScores &scores) const;
+
+    // All matchups of a night together; teams missing from divisionOf rank in division 0
+    EventPoints scoreEvent(const QVector<MatchupScores> &matchups,
+                           const QMap<int, int> &divisionOf = QMap<int, int>()) const;
+
+private:
+    void scoreMatrix(const MatchupScores &scores, bool withHandicap, MatchupPoints &points) const;
+    void rank(const QVector<QPair<int, int>> &series, QMap<int, int> &rankPoints) const;
+
+    LeagueConfig::PointSystem m_rules;
+    QVector<bool> m_modes;              // true = handicap, false = scratch
+    bool m_headsUp = false;
+    bool m_teamTotals = false;
+    bool m_leagueRanking = false;
+    bool m_divisionRanking = false;
+};
+
+#endif // POINTSENGINE_H
@@ -0,0 +1,324 @@
+﻿// QueryPlanAudit.cpp
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QSqlRecord>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QDate>
+#include <QTime>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const QString AUDIT_CONNECTION = "query_plan_audit";
+
+// "SCAN bowlers" / "SCAN TABLE bowlers" with no index to narrow it
+QString scannedTable(const QString &detail)
+{
+    static const QRegularExpression scan("^SCAN (?:TABLE )?(\\w+)");
+    QRegularExpressionMatch match = scan.match(detail);
+    if (!match.hasMatch() || detail.contains("USING") || detail.contains("VIRTUAL TABLE")) {
+        return QString();
+    }
+    return match.captured(1);
+}
+
+// Errors and scans nobody has accounted for
+bool isFlagged(const QueryPlanFinding &finding)
+{
+    return !finding.error.isEmpty() || (!finding.scannedTables.isEmpty() && finding.scanReason.isEmpty());
+}
+
+QVector<QueryPlanAudit::Statement> &registry()
+{
+    // Filled during static initialisation, before main() reads it
+    static QVector<QueryPlanAudit::Statement> statements;
+    return statements;
+}
+
+} // namespace
+
+QString QueryPlanAudit::statement(const char *source, const QString &sql, const char *scanReason)
+{
+    registry().append({QString::fromLatin1(source), sql, QString::fromLatin1(scanReason)});
+    return sql;
+}
+
+QVector<QueryPlanAudit::Statement> QueryPlanAudit::statements()
+{
+    QVector<Statement> sorted = registry();
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Statement &a, const Statement &b) {
+        return a.source < b.source;
+    });
+    return sorted;
+}
+
+bool QueryPlanAudit::cloneSchema(const QSqlDatabase &source, QSqlDatabase &target)
+{
+    QSqlQuery read(source);
+    if (!read.exec("SELECT type, name, sql FROM sqlite_master WHERE sql IS NOT NULL AND name NOT LIKE 'sqlite_%' "
+                   "ORDER BY CASE type WHEN 'table' THEN 0 WHEN 'index' THEN 1 ELSE 2 END")) {
+        qCritical() << "Failed to read schema:" << read.lastError().text();
+        return false;
+    }
+
+    struct SchemaObject {
+        QString name;
+        QString sql;
+    };
+    QVector<SchemaObject> objects;
+    QStringList virtualTables;
+
+    while (read.next()) {
+        SchemaObject object{read.value(1).toString(), read.value(2).toString()};
+        if (object.sql.startsWith("CREATE VIRTUAL TABLE", Qt::CaseInsensitive)) {
+            virtualTables.append(object.name);
+        }
+        objects.append(object);
+    }
+
+    QSqlQuery write(target);
+    for (const SchemaObject &object : objects) {
+        // Shadow tables are recreated by their virtual table
+        bool shadow = false;
+        for (const QString &virtualTable : virtualTables) {
+            if (object.name.startsWith(virtualTable + "_")) {
+                shadow = true;
+                break;
+            }
+        }
+        if (shadow) {
+            continue;
+        }
+
+        if (!write.exec(object.sql)) {
+            qWarning() << "Could not clone" << object.name << ":" << write.lastError().text();
+        }
+    }
+
+    return true;
+}
+
+bool QueryPlanAudit::seed(QSqlDatabase &database, int rowsPerTable)
+{
+    QSqlQuery query(database);
+
+    QStringList tables;
+    if (!query.exec("SELECT name, sql FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%'")) {
+        return false;
+    }
+    QStringList virtualTables;
+    while (query.next()) {
+        if (query.value(1).toString().startsWith("CREATE VIRTUAL TABLE", Qt::CaseInsensitive)) {
+            virtualTables.append(query.value(0).toString());
+        } else {
+            tables.append(query.value(0).toString());
+        }
+    }
+
+    database.transaction();
+
+    for (const QString &table : tables) {
+        bool shadow = false;
+        for (const QString &virtualTable : virtualTables) {
+            shadow = shadow || table.startsWith(virtualTable + "_");
+        }
+        if (shadow) {
+            continue;
+        }
+
+        // Column names and types drive the synthetic values
+        QStringList columns;
+        QStringList types;
+        query.exec(QString("PRAGMA table_info(%1)").arg(table));
+        int primaryKeys = 0;
+        QString rowIdColumn;
+        while (query.next()) {
+            QString type = query.value(2).toString().toUpper();
+            if (query.value(5).toInt() > 0) {
+                ++primaryKeys;
+                if (type == "INTEGER") {
+                    rowIdColumn = query.value(1).toString();
+                }
+            }
+            columns.append(query.value(1).toString());
+            types.append(type);
+        }
+        if (primaryKeys != 1) {
+            rowIdColumn.clear(); // Composite keys are filled like any other column
+        }
+
+        QStringList insertColumns;
+        QStringList placeholders;
+        for (const QString &column : columns) {
+            if (column != rowIdColumn) {
+                insertColumns.append(column);
+                placeholders.append("?");
+            }
+        }
+
+        QSqlQuery insert(database);
+        insert.prepare(QString("INSERT OR IGNORE INTO %1 (%2) VALUES (%3)")
+                       .arg(table, insertColumns.join(", "), placeholders.join(", ")));
+
+        for (int row = 0; row < rowsPerTable; ++row) {
+            bool firstKey = true;
+            for (int c = 0; c < columns.size(); ++c) {
+                const QString &column = columns[c];
+                if (column == rowIdColumn) {
+                    continue;
+                }
+
+                QVariant value;
+                if (column.endsWith("_id")) {
+                    // The first key column is unique, the rest repeat like real foreign keys
+                    value = firstKey ? row + 1 : (row % 97) + 1;
+                    firstKey = false;
+                } else if (column == "date" || column.endsWith("_date")) {
+                    value = QDate(2024, 1, 1).addDays(row % 730).toString(Qt::ISODate);
+                } else if (column.endsWith("_time")) {
+                    value = QTime(8, 0).addSecs((row % 64) * 900).toString("hh:mm:ss");
+                } else if (types[c].contains("INT") || types[c] == "BOOLEAN") {
+                    value = row % 300;
+                } else if (types[c] == "REAL") {
+                    value = row * 0.5;
+                } else {
+                    value = QString("%1 %2").arg(column).arg(row);
+                }
+                insert.addBindValue(value);
+            }
+
+            if (!insert.exec()) {
+                qWarning() << "Seeding" << table << "failed:" << insert.lastError().text();
+                break;
+            }
+        }
+    }
+
+    if (!database.commit()) {
+        database.rollback();
+        return false;
+    }
+
+    // Give the planner real statistics, as a long-running install would have
+    query.exec("ANALYZE");
+    return true;
+}
+
+QVector<QueryPlanFinding> QueryPlanAudit::run(QSqlDatabase &database)
+{
+    QVector<QueryPlanFinding> findings;
+
+    for (const Statement &statement : statements()) {
+        QueryPlanFinding finding;
+        finding.source = statement.source;
+        finding.sql = QString(statement.sql).replace("%1", "?");
+        finding.scanReason = statement.scanReason;
+
+        QSqlQuery query(database);
+        if (!query.prepare("EXPLAIN QUERY PLAN " + finding.sql)) {
+            finding.error = query.lastError().text();
+            findings.append(finding);
+            continue;
+        }
+
+        for (int i = 0; i < finding.sql.count('?'); ++i) {
+            query.addBindValue(1);
+        }
+
+        if (!query.exec()) {
+            finding.error = query.lastError().text();
+            findings.append(finding);
+            continue;
+        }
+
+        const int detailColumn = query.record().count() - 1;
+        while (query.next()) {
+            QString detail = query.value(detailColumn).toString();
+            finding.plan.append(detail);
+
+            QString table = scannedTable(detail);
+            if (!table.isEmpty()) {
+                finding.scannedTables.append(table);
+            }
+        }
+
+        findings.append(finding);
+    }
+
+    return findings;
+}
+
+QString QueryPlanAudit::report(const QVector<QueryPlanFinding> &findings)
+{
+    QString text;
+    QTextStream out(&text);
+
+    int flagged = 0;
+    for (const QueryPlanFinding &finding : findings) {
+        const bool scanned = !finding.scannedTables.isEmpty();
+        const bool problem = isFlagged(finding);
+        if (problem) {
+            ++flagged;
+        }
+
+        out << (problem ? "[SCAN] " : scanned ? "[scan] " : "[ OK ] ") << finding.source << "\n";
+        out << "       " << finding.sql.simplified() << "\n";
+        if (scanned && !problem) {
+            out << "       expected: " << finding.scanReason << "\n";
+        }
+        if (!finding.error.isEmpty()) {
+            out << "       error: " << finding.error << "\n";
+        }
+        for (const QString &line : finding.plan) {
+            out << "       > " << line << "\n";
+        }
+    }
+
+    out << "\n" << findings.size() << " statements audited, " << flagged << " flagged\n";
+    return text;
+}
+
+int QueryPlanAudit::runFromCommandLine(int rowsPerTable)
+{
+    QTextStream out(stdout);
+
+    QTemporaryDir workDir;
+    if (!workDir.isValid()) {
+        out << "Could not create a temporary directory for the audit database\n";
+        return 1;
+    }
+
+    int flagged = 0;
+    {
+        QSqlDatabase target = QSqlDatabase::addDatabase("QSQLITE", AUDIT_CONNECTION);
+        target.setDatabaseName(workDir.filePath("audit.db"));
+        if (!target.open()) {
+            out << "Could not open audit database: " << target.lastError().text() << "\n";
+            return 1;
+        }
+
+        out << "Seeding " << rowsPerTable << " rows per table...\n";
+        out.flush();
+        if (!cloneSchema(QSqlDatabase::database(), target) || !seed(target, rowsPerTable)) {
+            out << "Could not prepare the audit database\n";
+            return 1;
+        }
+
+        QVector<QueryPlanFinding> findings = run(target);
+        out << report(findings);
+
+        for (const QueryPlanFinding &finding : findings) {
+            if (isFlagged(finding)) {
+                ++flagged;
+            }
+        }
+        target.close();
+    }
+    QSqlDatabase::removeDatabase(AUDIT_CONNECTION);
+
+    return flagged > 0 ? 1 : 0;
+}
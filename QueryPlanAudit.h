@@ -0,0 +1,57 @@
+﻿// QueryPlanAudit.h
+#ifndef QUERYPLANAUDIT_H
+#define QUERYPLANAUDIT_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSqlDatabase>
+
+struct QueryPlanFinding {
+    QString source;             // Function that prepares the statement
+    QString sql;
+    QString scanReason;         // Expected scan, reported but not flagged
+    QStringList plan;           // EXPLAIN QUERY PLAN detail lines
+    QStringList scannedTables;  // Tables read without an index
+    QString error;
+};
+
+// Runs EXPLAIN QUERY PLAN over the statements the app prepares, against a
+// copy of the live schema seeded with a large synthetic data set, and flags
+// every full table scan not marked as expected. Used by the --audit-queries
+// command line mode.
+//
+// Every statement with fixed SQL is a file-scope constant registered through
+// statement(), so the audit list is the code's own list:
+//
+//     const QString LEAGUE_SEASON_SQL = QueryPlanAudit::statement("LeagueManager::loadLeagueSeasonData",
+//         "SELECT * FROM bowler_season_data WHERE league_id = ?");
+//
+// A %1 in the SQL stands for an IN (...) list filled in at the call site and
+// is audited as a single placeholder. Not covered: schema changes in
+// SchemaMigrator, sqlite_master lookups, and SQL assembled from table and
+// column names at run time (replication dumps, the database browser).
+class QueryPlanAudit
+{
+public:
+    struct Statement {
+        QString source;
+        QString sql;
+        QString scanReason;     // Set when a full scan is expected and accepted
+    };
+
+    // Registers sql under source and returns it unchanged
+    static QString statement(const char *source, const QString &sql, const char *scanReason = nullptr);
+    static QVector<Statement> statements();
+
+    static bool cloneSchema(const QSqlDatabase &source, QSqlDatabase &target);
+    static bool seed(QSqlDatabase &database, int rowsPerTable);
+    static QVector<QueryPlanFinding> run(QSqlDatabase &database);
+    static QString report(const QVector<QueryPlanFinding> &findings);
+
+    // Clones the default connection's schema into a temporary database, seeds
+    // it, audits it and prints the report. Returns 1 if any scan was flagged.
+    static int runFromCommandLine(int rowsPerTable);
+};
+
+#endif // QUERYPLANAUDIT_H
@@ -0,0 +1,433 @@
+﻿// QueryResultModel.cpp
+#include "QueryResultModel.h"
+#include <QSqlDatabase>
+#include <QSqlDriver>
+#include <QSqlRecord>
+#include <QSqlError>
+#include <QRegularExpression>
+#include <QColor>
+#include <QDebug>
+#include <sqlite3.h>
+
+// QueryWorker
+
+QueryWorker::QueryWorker(const QString &databasePath, const QString &connectionName)
+    : m_databasePath(databasePath)
+    , m_connectionName(connectionName)
+{
+}
+
+void QueryWorker::open()
+{
+    // The connection belongs to the worker thread, so it is created here
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", m_connectionName);
+    database.setDatabaseName(m_databasePath);
+    database.setConnectOptions("QSQLITE_BUSY_TIMEOUT=2000");
+
+    if (!database.open()) {
+        emit failed(m_latestRequest.loadAcquire(), database.lastError().text());
+        return;
+    }
+
+    // Needs the QSQLITE plugin built against the same libsqlite3 we link
+    const QVariant handle = database.driver()->handle();
+    if (handle.isValid() && qstrcmp(handle.typeName(), "sqlite3*") == 0) {
+        QMutexLocker locker(&m_handleMutex);
+        m_handle = *static_cast<sqlite3 *const *>(handle.constData());
+    }
+}
+
+void QueryWorker::close()
+{
+    {
+        QMutexLocker locker(&m_handleMutex);
+        m_handle = nullptr;
+    }
+    m_cursor = QSqlQuery();
+    {
+        QSqlDatabase database = QSqlDatabase::database(m_connectionName, false);
+        database.close();
+    }
+    QSqlDatabase::removeDatabase(m_connectionName);
+}
+
+void QueryWorker::interrupt()
+{
+    // A no-op when nothing is running; an idle open cursor keeps it pending
+    // until the cursor is dropped, which release() and start() do first
+    QMutexLocker locker(&m_handleMutex);
+    if (m_handle) {
+        sqlite3_interrupt(m_handle);
+    }
+}
+
+void QueryWorker::release()
+{
+    m_cursor = QSqlQuery();
+}
+
+void QueryWorker::start(int requestId, const QString &sql, const QString &table, int pageSize)
+{
+    if (!isCurrent(requestId)) {
+        return;
+    }
+
+    m_cursor = QSqlQuery();
+    m_pageSize = qMax(1, pageSize);
+    m_lastRowId = 0;
+    m_columnsSent = false;
+
+    m_sql = sql.trimmed();
+    while (m_sql.endsWith(';')) {
+        m_sql.chop(1);
+        m_sql = m_sql.trimmed();
+    }
+
+    if (!table.isEmpty()) {
+        // Views and WITHOUT ROWID tables have no rowid to key pages on
+        m_mode = KeysetMode;
+        m_source = QString("\"%1\"").arg(table);
+        QSqlQuery probe(QSqlDatabase::database(m_connectionName, false));
+        if (!probe.prepare(QString("SELECT rowid, * FROM %1 LIMIT 1").arg(m_source))) {
+            m_mode = CursorMode;
+            m_sql = QString("SELECT * FROM %1").arg(m_source);
+        }
+    } else {
+        const QString keyword = m_sql.section(QRegularExpression("\\s+"), 0, 0).toUpper();
+        const bool query = keyword == "SELECT" || keyword == "WITH" || keyword == "VALUES";
+        m_mode = query ? CursorMode : SingleMode;
+    }
+
+    runPage(requestId);
+}
+
+bool QueryWorker::openCursor(const QString &select)
+{
+    m_cursor = QSqlQuery(QSqlDatabase::database(m_connectionName, false));
+    m_cursor.setForwardOnly(true);
+    return m_cursor.prepare(select) && m_cursor.exec();
+}
+
+void QueryWorker::fetchPage(int requestId)
+{
+    if (isCurrent(requestId) && m_mode != SingleMode) {
+        runPage(requestId);
+    }
+}
+
+void QueryWorker::runPage(int requestId)
+{
+    if (m_mode == CursorMode) {
+        // Opened with the first page; later pages carry on from the same
+        // statement, so rows are never produced twice
+        if (!m_columnsSent && !openCursor(m_sql)) {
+            if (isCurrent(requestId)) {
+                emit failed(requestId, m_cursor.lastError().text());
+            }
+            m_cursor = QSqlQuery();
+            return;
+        }
+        if (!m_cursor.isSelect()) {
+            // WITH ... UPDATE and the like
+            emit statementFinished(requestId, m_cursor.numRowsAffected());
+            m_cursor = QSqlQuery();
+            return;
+        }
+        sendRows(requestId, m_cursor, 0);
+        return;
+    }
+
+    QSqlQuery query(QSqlDatabase::database(m_connectionName, false));
+    query.setForwardOnly(true);
+
+    bool prepared = false;
+    switch (m_mode) {
+    case KeysetMode:
+        prepared = query.prepare(QString("SELECT rowid, * FROM %1 WHERE rowid > ? ORDER BY rowid LIMIT ?")
+                                 .arg(m_source));
+        query.addBindValue(m_lastRowId);
+        query.addBindValue(m_pageSize);
+        break;
+    case SingleMode:
+    case CursorMode:
+        prepared = query.prepare(m_sql);
+        break;
+    }
+
+    if (!prepared || !query.exec()) {
+        emit failed(requestId, query.lastError().text());
+        return;
+    }
+
+    if (!query.isSelect()) {
+        emit statementFinished(requestId, query.numRowsAffected());
+        return;
+    }
+
+    // The rowid used for keyset paging is not shown
+    sendRows(requestId, query, m_mode == KeysetMode ? 1 : 0);
+}
+
+void QueryWorker::sendRows(int requestId, QSqlQuery &query, int firstColumn)
+{
+    const QSqlRecord record = query.record();
+    const int columnCount = record.count();
+
+    if (!m_columnsSent) {
+        QStringList columns;
+        for (int c = firstColumn; c < columnCount; ++c) {
+            columns << record.fieldName(c);
+        }
+        emit columnsReady(requestId, columns);
+        m_columnsSent = true;
+    }
+
+    QueryRows rows;
+    rows.reserve(m_mode == SingleMode ? 64 : m_pageSize);
+
+    // A cursor stops at a page, so the row after it stays unread until asked for
+    while ((m_mode == SingleMode || rows.size() < m_pageSize) && query.next()) {
+        if (!isCurrent(requestId)) {
+            break;
+        }
+
+        QVariantList row;
+        row.reserve(columnCount - firstColumn);
+        for (int c = firstColumn; c < columnCount; ++c) {
+            row.append(query.value(c));
+        }
+        if (m_mode == KeysetMode) {
+            m_lastRowId = query.value(0).toLongLong();
+        }
+        rows.append(row);
+    }
+
+    // Cancelled mid-page; an interrupted step also ends up here
+    if (!isCurrent(requestId)) {
+        m_cursor = QSqlQuery();
+        return;
+    }
+    if (query.lastError().isValid()) {
+        const QString error = query.lastError().text();
+        m_cursor = QSqlQuery();     // query may be the cursor itself
+        emit failed(requestId, error);
+        return;
+    }
+
+    bool atEnd = (m_mode == SingleMode) || rows.size() < m_pageSize;
+    if (atEnd) {
+        m_cursor = QSqlQuery(); // Releases the read lock
+    }
+    emit pageReady(requestId, rows, atEnd);
+}
+
+// QueryResultModel
+
+QueryResultModel::QueryResultModel(const QString &databasePath, QObject *parent)
+    : QAbstractTableModel(parent)
+    , m_thread(new QThread)
+    , m_worker(new QueryWorker(databasePath,
+                               QString("query_browser_%1").arg(reinterpret_cast<quintptr>(this), 0, 16)))
+{
+    qRegisterMetaType<QueryRows>("QueryRows");
+
+    m_worker->moveToThread(m_thread);
+    connect(m_worker, &QueryWorker::columnsReady, this, &QueryResultModel::onColumnsReady);
+    connect(m_worker, &QueryWorker::pageReady, this, &QueryResultModel::onPageReady);
+    connect(m_worker, &QueryWorker::statementFinished, this, &QueryResultModel::onStatementFinished);
+    connect(m_worker, &QueryWorker::failed, this, &QueryResultModel::onFailed);
+
+    m_thread->start();
+    QMetaObject::invokeMethod(m_worker, "open", Qt::QueuedConnection);
+}
+
+QueryResultModel::~QueryResultModel()
+{
+    // Abort whatever statement is running so the wait is short, then close the
+    // connection on the worker's thread and stop it. The thread must be done
+    // before it is deleted, or the app exits with "QThread destroyed while running".
+    m_worker->setLatestRequest(-1);
+    m_worker->interrupt();
+    QueryWorker *worker = m_worker;
+    QThread *thread = m_thread;
+    QMetaObject::invokeMethod(m_worker, [worker, thread]() {
+        worker->close();
+        thread->quit();
+    }, Qt::QueuedConnection);
+    m_thread->wait();
+    delete m_worker;
+    delete m_thread;
+}
+
+void QueryResultModel::setQuery(const QString &sql)
+{
+    startRequest(sql, QString());
+}
+
+void QueryResultModel::browseTable(const QString &table)
+{
+    startRequest(QString(), table);
+}
+
+void QueryResultModel::cancel()
+{
+    if (!m_fetching && m_atEnd) {
+        return;
+    }
+
+    // The worker drops anything that is not the latest request; a statement
+    // still running is interrupted, and a part-read cursor let go
+    m_worker->setLatestRequest(++m_requestId);
+    m_worker->interrupt();
+    QueryWorker *worker = m_worker;
+    QMetaObject::invokeMethod(m_worker, [worker]() {
+        worker->release();
+    }, Qt::QueuedConnection);
+    m_atEnd = true;
+    setFetching(false);
+}
+
+void QueryResultModel::startRequest(const QString &sql, const QString &table)
+{
+    const int requestId = ++m_requestId;
+    m_worker->setLatestRequest(requestId);
+    if (m_fetching) {
+        m_worker->interrupt();
+    }
+
+    beginResetModel();
+    m_columns.clear();
+    m_rows.clear();
+    m_atEnd = false;
+    endResetModel();
+
+    m_timer.start();
+    setFetching(true);
+
+    QueryWorker *worker = m_worker;
+    QMetaObject::invokeMethod(m_worker, [worker, requestId, sql, table]() {
+        worker->start(requestId, sql, table, PAGE_SIZE);
+    }, Qt::QueuedConnection);
+}
+
+void QueryResultModel::setFetching(bool fetching)
+{
+    if (m_fetching != fetching) {
+        m_fetching = fetching;
+        emit runningChanged(fetching);
+    }
+}
+
+int QueryResultModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_rows.size();
+}
+
+int QueryResultModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_columns.size();
+}
+
+QVariant QueryResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+
+    const QVariantList &row = m_rows[index.row()];
+    if (index.column() >= row.size()) {
+        return QVariant();
+    }
+    const QVariant &value = row[index.column()];
+
+    if (role == Qt::DisplayRole) {
+        return value.isNull() ? QString("[NULL]") : value.toString();
+    }
+    if (role == Qt::ForegroundRole && value.isNull()) {
+        return QColor("#999");
+    }
+    return QVariant();
+}
+
+QVariant QueryResultModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    return section < m_columns.size() ? m_columns[section] : QVariant();
+}
+
+bool QueryResultModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && !m_atEnd && !m_fetching;
+}
+
+void QueryResultModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    m_timer.start();
+    setFetching(true);
+
+    QueryWorker *worker = m_worker;
+    const int requestId = m_requestId;
+    QMetaObject::invokeMethod(m_worker, [worker, requestId]() {
+        worker->fetchPage(requestId);
+    }, Qt::QueuedConnection);
+}
+
+void QueryResultModel::onColumnsReady(int requestId, const QStringList &columns)
+{
+    if (requestId != m_requestId) {
+        return;
+    }
+
+    beginResetModel();
+    m_columns = columns;
+    endResetModel();
+    emit columnsLoaded();
+}
+
+void QueryResultModel::onPageReady(int requestId, const QueryRows &rows, bool atEnd)
+{
+    if (requestId != m_requestId) {
+        return;
+    }
+
+    if (!rows.isEmpty()) {
+        beginInsertRows(QModelIndex(), m_rows.size(), m_rows.size() + rows.size() - 1);
+        m_rows += rows;
+        endInsertRows();
+    }
+
+    m_atEnd = atEnd;
+    setFetching(false);
+    emit pageLoaded(m_rows.size(), atEnd, m_timer.elapsed());
+}
+
+void QueryResultModel::onStatementFinished(int requestId, int rowsAffected)
+{
+    if (requestId != m_requestId) {
+        return;
+    }
+
+    m_atEnd = true;
+    setFetching(false);
+    emit statementFinished(rowsAffected, m_timer.elapsed());
+}
+
+void QueryResultModel::onFailed(int requestId, const QString &error)
+{
+    if (requestId != m_requestId) {
+        return;
+    }
+
+    m_atEnd = true;
+    setFetching(false);
+    emit queryFailed(error);
+}
@@ -0,0 +1,136 @@
+﻿// QueryResultModel.h
+#ifndef QUERYRESULTMODEL_H
+#define QUERYRESULTMODEL_H
+
+#include <QAbstractTableModel>
+#include <QObject>
+#include <QThread>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSqlQuery>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVariantList>
+#include <QVector>
+
+typedef QVector<QVariantList> QueryRows;
+struct sqlite3;
+
+// Runs browser queries on its own SQLite connection in a worker thread.
+// Tables with a rowid are paged with a separate short statement per page
+// keyed on rowid, so nothing stays open between pages. Free-form SELECTs,
+// views and WITHOUT ROWID tables stream from one forward-only cursor, so the
+// first page shows as soon as SQLite has produced it; the cursor holds a read
+// lock until it is read to the end, cancelled or replaced. Work for anything
+// but the latest request is dropped, and interrupt() stops a statement that
+// is still running.
+class QueryWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    QueryWorker(const QString &databasePath, const QString &connectionName);
+
+    // Thread-safe; anything older than requestId stops at the next row
+    void setLatestRequest(int requestId) { m_latestRequest.storeRelease(requestId); }
+
+    // Thread-safe; aborts the statement the worker is stepping, if any, with
+    // sqlite3_interrupt on the worker's own connection
+    void interrupt();
+
+public slots:
+    void open();
+    void close();
+    void start(int requestId, const QString &sql, const QString &table, int pageSize);
+    void fetchPage(int requestId);
+    void release();             // Drops the cursor of a part-read result
+
+signals:
+    void columnsReady(int requestId, const QStringList &columns);
+    void pageReady(int requestId, const QueryRows &rows, bool atEnd);
+    void statementFinished(int requestId, int rowsAffected);
+    void failed(int requestId, const QString &error);
+
+private:
+    enum Mode {
+        KeysetMode,     // WHERE rowid > last ORDER BY rowid
+        CursorMode,     // One forward-only statement, pageSize rows at a time
+        SingleMode      // Statements other than queries; one page
+    };
+
+    bool isCurrent(int requestId) const { return m_latestRequest.loadAcquire() == requestId; }
+    bool openCursor(const QString &select);
+    void runPage(int requestId);
+    void sendRows(int requestId, QSqlQuery &query, int firstColumn);
+
+    QString m_databasePath;
+    QString m_connectionName;
+    QAtomicInt m_latestRequest;
+
+    QMutex m_handleMutex;       // Guards m_handle against close() during interrupt()
+    sqlite3 *m_handle = nullptr;
+
+    Mode m_mode = SingleMode;
+    QString m_sql;
+    QString m_source;           // Quoted table paged in KeysetMode
+    QSqlQuery m_cursor;         // Open in CursorMode until the last row
+    int m_pageSize = 500;
+    qint64 m_lastRowId = 0;
+    bool m_columnsSent = false;
+};
+
+// Lazily filled table model over QueryWorker results. Views pull further
+// pages through canFetchMore()/fetchMore() as the user scrolls.
+class QueryResultModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit QueryResultModel(const QString &databasePath, QObject *parent = nullptr);
+    ~QueryResultModel();
+
+    void setQuery(const QString &sql);
+    void browseTable(const QString &table);
+    void cancel();
+
+    bool isRunning() const { return m_fetching; }
+    bool isComplete() const { return m_atEnd; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+
+signals:
+    void columnsLoaded();
+    void pageLoaded(int totalRows, bool complete, qint64 elapsedMs);
+    void statementFinished(int rowsAffected, qint64 elapsedMs);
+    void queryFailed(const QString &error);
+    void runningChanged(bool running);
+
+private slots:
+    void onColumnsReady(int requestId, const QStringList &columns);
+    void onPageReady(int requestId, const QueryRows &rows, bool atEnd);
+    void onStatementFinished(int requestId, int rowsAffected);
+    void onFailed(int requestId, const QString &error);
+
+private:
+    void startRequest(const QString &sql, const QString &table);
+    void setFetching(bool fetching);
+
+    static const int PAGE_SIZE = 500;
+
+    QThread *m_thread;          // Stopped and deleted with the model
+    QueryWorker *m_worker;
+
+    int m_requestId = 0;
+    QStringList m_columns;
+    QueryRows m_rows;
+    bool m_fetching = false;
+    bool m_atEnd = true;
+    QElapsedTimer m_timer;
+};
+
+#endif // QUERYRESULTMODEL_H
@@ -0,0 +1,348 @@
+﻿// ReplicationLog.cpp
+#include "ReplicationLog.h"
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QJsonArray>
+#include <QUuid>
+#include <QDebug>
+
+namespace {
+
+const QString LOG_PREFIX = "replication_";
+
+// Fixed statements, registered for --audit-queries; the per-table ones are
+// built from the schema at run time and are not
+const QString INSTANCE_ID_SQL = QueryPlanAudit::statement("ReplicationLog::install",
+    "SELECT value FROM replication_meta WHERE key = 'instance_id'");
+const QString STORE_INSTANCE_ID_SQL = QueryPlanAudit::statement("ReplicationLog::install",
+    "INSERT OR REPLACE INTO replication_meta (key, value) VALUES ('instance_id', ?)");
+const QString LAST_ID_SQL = QueryPlanAudit::statement("ReplicationLog::lastId",
+    "SELECT COALESCE(MAX(id), 0) FROM replication_log");
+const QString FIRST_ID_SQL = QueryPlanAudit::statement("ReplicationLog::firstId",
+    "SELECT COALESCE(MIN(id), 0) FROM replication_log");
+const QString CHANGES_SQL = QueryPlanAudit::statement("ReplicationLog::changesSince",
+    "SELECT id, table_name, row_id, op FROM replication_log WHERE id > ? ORDER BY id LIMIT ?");
+const QString PRUNE_SQL = QueryPlanAudit::statement("ReplicationLog::prune",
+    "DELETE FROM replication_log WHERE id <= ?");
+
+QString insertStatement(const QString &table, const QStringList &columns)
+{
+    QStringList placeholders;
+    for (int i = 0; i <= columns.size(); ++i) {
+        placeholders.append("?");
+    }
+    return QString("INSERT OR REPLACE INTO %1 (rowid, %2) VALUES (%3)")
+            .arg(table, columns.join(", "), placeholders.join(", "));
+}
+
+} // namespace
+
+ReplicationLog::ReplicationLog(const QSqlDatabase &database)
+    : m_database(database)
+{
+}
+
+bool ReplicationLog::install()
+{
+    QSqlQuery query(m_database);
+
+    if (query.exec(INSTANCE_ID_SQL) && query.next()) {
+        m_instanceId = query.value(0).toString();
+    }
+    if (m_instanceId.isEmpty()) {
+        m_instanceId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+        query.prepare(STORE_INSTANCE_ID_SQL);
+        query.addBindValue(m_instanceId);
+        if (!query.exec()) {
+            qCritical() << "Failed to store replication instance id:" << query.lastError().text();
+            return false;
+        }
+    }
+
+    const QStringList ops = {"insert", "update", "delete"};
+    for (const QString &table : tables()) {
+        for (const QString &op : ops) {
+            const QString row = op == "delete" ? "old" : "new";
+            const QString statement = QString(
+                "CREATE TRIGGER IF NOT EXISTS replication_%1_%2 AFTER %3 ON %1 BEGIN "
+                "INSERT INTO replication_log (table_name, row_id, op) VALUES ('%1', %4.rowid, '%5'); END")
+                    .arg(table, op, op.toUpper(), row, op.left(1).toUpper());
+            if (!query.exec(statement)) {
+                qCritical() << "Failed to add replication trigger on" << table << ":" << query.lastError().text();
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+qint64 ReplicationLog::lastId() const
+{
+    QSqlQuery query(m_database);
+    if (query.exec(LAST_ID_SQL) && query.next()) {
+        return query.value(0).toLongLong();
+    }
+    return 0;
+}
+
+qint64 ReplicationLog::firstId() const
+{
+    QSqlQuery query(m_database);
+    if (query.exec(FIRST_ID_SQL) && query.next()) {
+        return query.value(0).toLongLong();
+    }
+    return 0;
+}
+
+QStringList ReplicationLog::tables() const
+{
+    QStringList tables;
+    QStringList rollups;
+    QStringList shadowPrefixes;
+    const auto isShadow = [&shadowPrefixes](const QString &name) {
+        for (const QString &prefix : shadowPrefixes) {
+            if (name.startsWith(prefix)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    QSqlQuery query(m_database);
+
+    // Virtual tables (search_index) can carry neither triggers nor rowid
+    // writes, and their shadow tables belong to the module; each side keeps
+    // its own, built from the replicated source tables
+    query.exec("SELECT name FROM sqlite_master WHERE type = 'table' AND sql LIKE 'CREATE VIRTUAL TABLE%'");
+    while (query.next()) {
+        shadowPrefixes.append(query.value(0).toString() + "_");
+    }
+
+    query.exec("SELECT name FROM sqlite_master WHERE type = 'table' AND name NOT LIKE 'sqlite_%' "
+               "AND sql NOT LIKE 'CREATE VIRTUAL TABLE%' ORDER BY name");
+    while (query.next()) {
+        const QString name = query.value(0).toString();
+        if (name.startsWith(LOG_PREFIX) || isShadow(name)) {
+            continue;
+        }
+        (name.startsWith("rollup_") ? rollups : tables).append(name);
+    }
+    return tables + rollups;
+}
+
+QStringList ReplicationLog::columns(const QString &table) const
+{
+    auto cached = m_columns.constFind(table);
+    if (cached != m_columns.constEnd()) {
+        return cached.value();
+    }
+
+    QStringList names;
+    QSqlQuery query(m_database);
+    query.exec(QString("PRAGMA table_info(%1)").arg(table));
+    while (query.next()) {
+        names.append(query.value(1).toString());
+    }
+    m_columns.insert(table, names);
+    return names;
+}
+
+QJsonObject ReplicationLog::changesSince(qint64 afterId, int limit) const
+{
+    QJsonObject batch;
+    QJsonObject columnsByTable;
+    QJsonArray changes;
+    qint64 to = afterId;
+
+    QSqlQuery log(m_database);
+    log.prepare(CHANGES_SQL);
+    log.addBindValue(afterId);
+    log.addBindValue(limit);
+    if (!log.exec()) {
+        qWarning() << "Failed to read replication log:" << log.lastError().text();
+        return batch;
+    }
+
+    QHash<QString, QSqlQuery> rowQueries;
+    while (log.next()) {
+        to = log.value(0).toLongLong();
+        const QString table = log.value(1).toString();
+        const qint64 rowId = log.value(2).toLongLong();
+        const QString op = log.value(3).toString();
+
+        const QStringList names = columns(table);
+        if (!columnsByTable.contains(table)) {
+            columnsByTable[table] = QJsonArray::fromStringList(names);
+        }
+
+        // The row as it is now; gone means a later delete in the log covers it
+        QJsonValue values = QJsonValue::Null;
+        if (op != "D") {
+            auto rowQuery = rowQueries.find(table);
+            if (rowQuery == rowQueries.end()) {
+                rowQuery = rowQueries.insert(table, QSqlQuery(m_database));
+                rowQuery->prepare(QString("SELECT %1 FROM %2 WHERE rowid = ?").arg(names.join(", "), table));
+            }
+            rowQuery->addBindValue(rowId);
+            if (rowQuery->exec() && rowQuery->next()) {
+                QJsonArray row;
+                for (int i = 0; i < names.size(); ++i) {
+                    row.append(QJsonValue::fromVariant(rowQuery->value(i)));
+                }
+                values = row;
+            }
+        }
+
+        changes.append(QJsonArray{to, table, op, rowId, values});
+    }
+
+    batch["from"] = afterId;
+    batch["to"] = to;
+    batch["columns"] = columnsByTable;
+    batch["changes"] = changes;
+    return batch;
+}
+
+QJsonObject ReplicationLog::dumpTable(const QString &table, qint64 afterRowId, int limit) const
+{
+    const QStringList names = columns(table);
+    QJsonArray rows;
+    qint64 lastRowId = afterRowId;
+
+    QSqlQuery query(m_database);
+    query.prepare(QString("SELECT rowid, %1 FROM %2 WHERE rowid > ? ORDER BY rowid LIMIT ?")
+                  .arg(names.join(", "), table));
+    query.addBindValue(afterRowId);
+    query.addBindValue(limit);
+    if (query.exec()) {
+        while (query.next()) {
+            lastRowId = query.value(0).toLongLong();
+            QJsonArray row;
+            for (int i = 0; i <= names.size(); ++i) {
+                row.append(QJsonValue::fromVariant(query.value(i)));
+            }
+            rows.append(row);
+        }
+    } else {
+        qWarning() << "Failed to dump" << table << ":" << query.lastError().text();
+    }
+
+    QJsonObject dump;
+    dump["table"] = table;
+    dump["columns"] = QJsonArray::fromStringList(names);
+    dump["rows"] = rows;
+    dump["last_rowid"] = lastRowId;
+    return dump;
+}
+
+bool ReplicationLog::applyChanges(const QJsonObject &batch)
+{
+    const QStringList known = tables();
+    const QJsonObject columnsByTable = batch["columns"].toObject();
+
+    if (!m_database.transaction()) {
+        qWarning() << "Failed to start replication batch:" << m_database.lastError().text();
+        return false;
+    }
+
+    QHash<QString, QSqlQuery> inserts;
+    QSqlQuery query(m_database);
+    for (const QJsonValue &value : batch["changes"].toArray()) {
+        const QJsonArray change = value.toArray();
+        const QString table = change[1].toString();
+        const QString op = change[2].toString();
+        const qint64 rowId = static_cast<qint64>(change[3].toDouble());
+
+        if (!known.contains(table)) {
+            qWarning() << "Replicated change for unknown table" << table;
+            continue;
+        }
+
+        if (op == "D") {
+            query.prepare(QString("DELETE FROM %1 WHERE rowid = ?").arg(table));
+            query.addBindValue(rowId);
+        } else {
+            if (change[4].isNull()) {
+                continue;
+            }
+            auto insert = inserts.find(table);
+            if (insert == inserts.end()) {
+                QStringList names;
+                for (const QJsonValue &name : columnsByTable[table].toArray()) {
+                    names.append(name.toString());
+                }
+                insert = inserts.insert(table, QSqlQuery(m_database));
+                insert->prepare(insertStatement(table, names));
+            }
+            insert->addBindValue(rowId);
+            for (const QJsonValue &column : change[4].toArray()) {
+                insert->addBindValue(column.toVariant());
+            }
+            if (!insert->exec()) {
+                qWarning() << "Failed to apply replicated row in" << table << ":" << insert->lastError().text();
+                m_database.rollback();
+                return false;
+            }
+            continue;
+        }
+
+        if (!query.exec()) {
+            qWarning() << "Failed to apply replicated delete in" << table << ":" << query.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+    }
+
+    return m_database.commit();
+}
+
+bool ReplicationLog::loadTable(const QJsonObject &dump, bool reset)
+{
+    const QString table = dump["table"].toString();
+    if (!tables().contains(table)) {
+        qWarning() << "Replicated dump for unknown table" << table;
+        return false;
+    }
+
+    QStringList names;
+    for (const QJsonValue &name : dump["columns"].toArray()) {
+        names.append(name.toString());
+    }
+
+    if (!m_database.transaction()) {
+        return false;
+    }
+
+    QSqlQuery query(m_database);
+    if (reset && !query.exec(QString("DELETE FROM %1").arg(table))) {
+        qWarning() << "Failed to clear" << table << ":" << query.lastError().text();
+        m_database.rollback();
+        return false;
+    }
+
+    query.prepare(insertStatement(table, names));
+    for (const QJsonValue &value : dump["rows"].toArray()) {
+        for (const QJsonValue &column : value.toArray()) {
+            query.addBindValue(column.toVariant());
+        }
+        if (!query.exec()) {
+            qWarning() << "Failed to load replicated row in" << table << ":" << query.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+    }
+
+    return m_database.commit();
+}
+
+int ReplicationLog::prune(qint64 throughId)
+{
+    QSqlQuery query(m_database);
+    query.prepare(PRUNE_SQL);
+    query.addBindValue(throughId);
+    if (!query.exec()) {
+        qWarning() << "Failed to prune replication log:" << query.lastError().text();
+        return 0;
+    }
+    return query.numRowsAffected();
+}
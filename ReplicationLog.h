@@ -0,0 +1,55 @@
+﻿// ReplicationLog.h
+#ifndef REPLICATIONLOG_H
+#define REPLICATIONLOG_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QJsonObject>
+#include <QSqlDatabase>
+
+// Row-level change capture for the hot standby. Triggers on every table
+// append (table, rowid, op) to replication_log; a batch of changes ships each
+// touched row as it is now, so a row changed many times between polls goes
+// once. The standby applies I/U as INSERT OR REPLACE keyed on rowid and D as
+// DELETE, which makes replaying a change it already has harmless.
+//
+// Batches and table dumps are JSON:
+//   changes {from, to, columns: {table: [names]}, changes: [[id, table, op, rowid, [values] | null]]}
+//   dump    {table, columns, rows: [[rowid, values...]], last_rowid}
+class ReplicationLog
+{
+public:
+    explicit ReplicationLog(const QSqlDatabase &database);
+
+    // Instance id and triggers; tables added by later migrations are picked up on the next start
+    bool install();
+
+    QSqlDatabase database() const { return m_database; }
+    QString instanceId() const { return m_instanceId; }
+    qint64 lastId() const;
+    qint64 firstId() const;             // Oldest change still held, 0 when empty
+
+    // Replicated tables; rollup_ tables last, so after a full copy their
+    // shipped rows overwrite what the games trigger added while games loaded.
+    // Virtual tables and their shadow tables are left out.
+    QStringList tables() const;
+
+    QJsonObject changesSince(qint64 afterId, int limit) const;
+    QJsonObject dumpTable(const QString &table, qint64 afterRowId, int limit) const;
+
+    bool applyChanges(const QJsonObject &batch);
+    bool loadTable(const QJsonObject &dump, bool reset);
+
+    // Drops changes up to and including throughId; returns how many went
+    int prune(qint64 throughId);
+
+private:
+    QStringList columns(const QString &table) const;
+
+    QSqlDatabase m_database;
+    QString m_instanceId;
+    mutable QHash<QString, QStringList> m_columns;
+};
+
+#endif // REPLICATIONLOG_H
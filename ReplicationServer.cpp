@@ -0,0 +1,224 @@
+﻿// ReplicationServer.cpp
+#include "ReplicationServer.h"
+#include "LaneServer.h"
+#include "SchemaMigrator.h"
+#include "BusEvents.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QHostAddress>
+#include <QDebug>
+
+namespace {
+
+QByteArray encodeFrame(const QString &type, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    return QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n";
+}
+
+} // namespace
+
+ReplicationServer::ReplicationServer(LaneServer *laneServer, ReplicationLog *log, QObject *parent)
+    : QObject(parent)
+    , m_laneServer(laneServer)
+    , m_log(log)
+    , m_server(new QTcpServer(this))
+    , m_pollTimer(new QTimer(this))
+    , m_heartbeatTimer(new QTimer(this))
+    , m_pollsSincePrune(0)
+{
+    connect(m_server, &QTcpServer::newConnection, this, &ReplicationServer::onNewConnection);
+    connect(m_pollTimer, &QTimer::timeout, this, &ReplicationServer::poll);
+    connect(m_heartbeatTimer, &QTimer::timeout, this, &ReplicationServer::sendHeartbeats);
+
+    EventBus::instance()->subscribe<LaneGameEvent>(this, BusFilter::any(), [this](const LaneGameEvent &event) {
+        QJsonObject lane;
+        lane["lane_id"] = event.laneId;
+        lane["game_type"] = event.gameType;
+        lane["game"] = event.gameData;
+        broadcast(encodeFrame("replica_lane", lane));
+    });
+}
+
+ReplicationServer::~ReplicationServer()
+{
+    close();
+}
+
+bool ReplicationServer::listen(quint16 port)
+{
+    if (!m_server->listen(QHostAddress::Any, port)) {
+        qWarning() << "Replication server failed to listen on port" << port << ":" << m_server->errorString();
+        return false;
+    }
+    m_pollTimer->start(POLL_INTERVAL);
+    m_heartbeatTimer->start(HEARTBEAT_INTERVAL);
+    qDebug() << "Replication server listening on port" << port << "as" << m_log->instanceId();
+    return true;
+}
+
+void ReplicationServer::close()
+{
+    m_pollTimer->stop();
+    m_heartbeatTimer->stop();
+    if (m_server->isListening()) {
+        m_server->close();
+    }
+    for (auto it = m_standbys.begin(); it != m_standbys.end(); ++it) {
+        it.key()->disconnect(this);
+        it.key()->disconnectFromHost();
+        it.key()->deleteLater();
+    }
+    m_standbys.clear();
+}
+
+void ReplicationServer::onNewConnection()
+{
+    while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+        connect(socket, &QTcpSocket::disconnected, this, &ReplicationServer::onStandbyDisconnected);
+        connect(socket, &QTcpSocket::readyRead, this, &ReplicationServer::onStandbyDataReady);
+        m_standbys.insert(socket, Standby());
+        qDebug() << "Standby connected from" << socket->peerAddress().toString();
+    }
+}
+
+void ReplicationServer::onStandbyDisconnected()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    qWarning() << "Standby" << socket->peerAddress().toString() << "disconnected at change"
+               << m_standbys.value(socket).ackedId;
+    m_standbys.remove(socket);
+    socket->deleteLater();
+}
+
+void ReplicationServer::onStandbyDataReady()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket*>(sender());
+    if (!socket) return;
+
+    while (socket->canReadLine()) {
+        const QJsonObject message = QJsonDocument::fromJson(socket->readLine()).object();
+        const QString type = message["type"].toString();
+        const QJsonObject data = message["data"].toObject();
+
+        if (type == "replica_hello") {
+            handleHello(socket, data);
+        } else if (type == "replica_ack") {
+            m_standbys[socket].ackedId = static_cast<qint64>(data["last_id"].toDouble());
+        }
+    }
+}
+
+void ReplicationServer::handleHello(QTcpSocket *socket, const QJsonObject &data)
+{
+    const int schema = data["schema"].toInt();
+    if (schema != SchemaMigrator::latestVersion()) {
+        QJsonObject error;
+        error["message"] = QString("Schema %1 does not match primary schema %2")
+                           .arg(schema).arg(SchemaMigrator::latestVersion());
+        socket->write(encodeFrame("replica_error", error));
+        socket->disconnectFromHost();
+        return;
+    }
+
+    // Catching up from the log is only possible if it still holds the next change
+    const qint64 lastApplied = static_cast<qint64>(data["last_id"].toDouble());
+    const qint64 firstHeld = m_log->firstId();
+    const bool catchUp = data["instance"].toString() == m_log->instanceId()
+                         && lastApplied > 0 && (firstHeld == 0 || firstHeld <= lastApplied + 1);
+
+    // A full copy reflects every change up to the log position read here
+    Standby &standby = m_standbys[socket];
+    standby.sentId = catchUp ? lastApplied : m_log->lastId();
+    standby.ackedId = lastApplied;
+
+    QJsonObject welcome;
+    welcome["instance"] = m_log->instanceId();
+    welcome["full_sync"] = !catchUp;
+    welcome["last_id"] = standby.sentId;
+    socket->write(encodeFrame("replica_welcome", welcome));
+    if (!catchUp) {
+        sendFullCopy(socket);
+    }
+    standby.ready = true;
+
+    QJsonObject lanes;
+    lanes["lanes"] = m_laneServer->laneGames();
+    socket->write(encodeFrame("replica_lanes", lanes));
+
+    qDebug() << "Standby" << socket->peerAddress().toString()
+             << (catchUp ? "catching up from change" : "copied at change") << standby.sentId;
+}
+
+void ReplicationServer::sendFullCopy(QTcpSocket *socket)
+{
+    // Runs in one go on this thread, so nothing is written to the tables
+    // between reading the log position and the last row dumped
+    for (const QString &table : m_log->tables()) {
+        qint64 afterRowId = 0;
+        bool reset = true;
+        while (true) {
+            QJsonObject dump = m_log->dumpTable(table, afterRowId, DUMP_CHUNK);
+            const int rows = dump["rows"].toArray().size();
+            if (rows == 0 && !reset) {
+                break;
+            }
+            dump["reset"] = reset;
+            socket->write(encodeFrame("replica_table", dump));
+            reset = false;
+            afterRowId = static_cast<qint64>(dump["last_rowid"].toDouble());
+            if (rows < DUMP_CHUNK) {
+                break;
+            }
+        }
+    }
+}
+
+void ReplicationServer::poll()
+{
+    // About once a minute keep the newest changes, and anything a standby has yet to be sent
+    if (++m_pollsSincePrune >= 600) {
+        m_pollsSincePrune = 0;
+        qint64 through = m_log->lastId() - RETAIN_CHANGES;
+        for (const Standby &standby : qAsConst(m_standbys)) {
+            through = qMin(through, standby.sentId);
+        }
+        if (through > 0) {
+            m_log->prune(through);
+        }
+    }
+
+    for (auto it = m_standbys.begin(); it != m_standbys.end(); ++it) {
+        Standby &standby = it.value();
+        if (!standby.ready) {
+            continue;
+        }
+
+        const QJsonObject batch = m_log->changesSince(standby.sentId, BATCH_LIMIT);
+        if (batch["changes"].toArray().isEmpty()) {
+            continue;
+        }
+        it.key()->write(encodeFrame("replica_changes", batch));
+        standby.sentId = static_cast<qint64>(batch["to"].toDouble());
+    }
+}
+
+void ReplicationServer::sendHeartbeats()
+{
+    QJsonObject heartbeat;
+    heartbeat["last_id"] = m_log->lastId();
+    broadcast(encodeFrame("replica_heartbeat", heartbeat));
+}
+
+void ReplicationServer::broadcast(const QByteArray &frame)
+{
+    for (auto it = m_standbys.constBegin(); it != m_standbys.constEnd(); ++it) {
+        if (it.value().ready) {
+            it.key()->write(frame);
+        }
+    }
+}
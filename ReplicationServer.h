@@ -0,0 +1,71 @@
+﻿// ReplicationServer.h
+#ifndef REPLICATIONSERVER_H
+#define REPLICATIONSERVER_H
+
+#include <QObject>
+#include <QHash>
+#include <QJsonObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include "ReplicationLog.h"
+
+class LaneServer;
+
+// Primary side of the hot standby. A standby says hello with the instance id
+// and log position it last applied; if this log still covers that position
+// it gets only what it missed, otherwise a full copy of every table first.
+// After that it is sent new changes every poll, each lane's game as it
+// changes, and a heartbeat it uses to decide when to take over.
+//
+//   standby -> primary  replica_hello {instance, last_id, schema}, replica_ack {last_id}
+//   primary -> standby  replica_welcome {instance, full_sync, last_id}, replica_table {dump, reset},
+//                       replica_changes {batch}, replica_lanes {lanes}, replica_lane {lane_id, game_type, game},
+//                       replica_heartbeat {last_id}, replica_error {message}
+class ReplicationServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    ReplicationServer(LaneServer *laneServer, ReplicationLog *log, QObject *parent = nullptr);
+    ~ReplicationServer();
+
+    bool listen(quint16 port);
+    void close();
+    bool isListening() const { return m_server->isListening(); }
+    int standbyCount() const { return m_standbys.size(); }
+
+private slots:
+    void onNewConnection();
+    void onStandbyDisconnected();
+    void onStandbyDataReady();
+    void poll();
+    void sendHeartbeats();
+
+private:
+    struct Standby {
+        bool ready = false;             // Hello handled, streaming
+        qint64 sentId = 0;
+        qint64 ackedId = 0;
+    };
+
+    void handleHello(QTcpSocket *socket, const QJsonObject &data);
+    void sendFullCopy(QTcpSocket *socket);
+    void broadcast(const QByteArray &frame);
+
+    static constexpr int POLL_INTERVAL = 100;
+    static constexpr int HEARTBEAT_INTERVAL = 1000;
+    static constexpr int BATCH_LIMIT = 500;
+    static constexpr int DUMP_CHUNK = 1000;
+    static constexpr qint64 RETAIN_CHANGES = 20000;
+
+    LaneServer *m_laneServer;
+    ReplicationLog *m_log;
+    QTcpServer *m_server;
+    QTimer *m_pollTimer;
+    QTimer *m_heartbeatTimer;
+    QHash<QTcpSocket *, Standby> m_standbys;
+    int m_pollsSincePrune;
+};
+
+#endif // REPLICATIONSERVER_H
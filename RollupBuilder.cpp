@@ -0,0 +1,326 @@
+﻿// RollupBuilder.cpp
+#include "RollupBuilder.h"
+#include "QueryPlanAudit.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QThread>
+#include <QHash>
+#include <QPair>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QDebug>
+
+namespace {
+
+// Registered for --audit-queries
+const QString GAMES_IN_RANGE_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "SELECT lane_id, bowler_id, bowler_name, league_id, score, created_at "
+    "FROM games WHERE created_at >= ? AND created_at < ?");
+const QString LANE_TOTALS_SQL = QueryPlanAudit::statement("RollupBuilder::laneTotals",
+    "SELECT lane_id, SUM(games), SUM(pins), MAX(high_game) FROM rollup_lane_day "
+    "WHERE day >= ? AND day <= ? GROUP BY lane_id");
+const QString BOWLER_TOTALS_SQL = QueryPlanAudit::statement("RollupBuilder::bowlerTotals",
+    "SELECT SUM(games), SUM(pins), MAX(high_game) FROM rollup_bowler_day "
+    "WHERE bowler_id = ? AND day >= ? AND day <= ?");
+const QString LEAGUE_WEEKS_SQL = QueryPlanAudit::statement("RollupBuilder::leagueWeeks",
+    "SELECT week_start, games, pins, high_game FROM rollup_league_week "
+    "WHERE league_id = ? AND week_start >= ? AND week_start <= ?");
+const QString CLEAR_LANE_DAYS_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "DELETE FROM rollup_lane_day WHERE day >= ? AND day <= ?");
+const QString CLEAR_BOWLER_DAYS_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "DELETE FROM rollup_bowler_day WHERE day >= ? AND day <= ?");
+const QString CLEAR_LEAGUE_WEEKS_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "DELETE FROM rollup_league_week WHERE week_start >= ? AND week_start <= ?",
+    "one row per league and week, cleared only by a rebuild");
+const QString INSERT_LANE_DAY_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "INSERT INTO rollup_lane_day (day, lane_id, games, pins, high_game) VALUES (?, ?, ?, ?, ?)");
+const QString INSERT_BOWLER_DAY_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "INSERT INTO rollup_bowler_day (day, bowler_key, bowler_id, bowler_name, games, pins, high_game) "
+    "VALUES (?, ?, ?, ?, ?, ?, ?)");
+const QString INSERT_LEAGUE_WEEK_SQL = QueryPlanAudit::statement("RollupBuilder::rebuild",
+    "INSERT INTO rollup_league_week (league_id, week_start, games, pins, high_game) VALUES (?, ?, ?, ?, ?)");
+
+struct BowlerDay {
+    RollupTotals totals;
+    int bowlerId = 0;
+    QString bowlerName;
+};
+
+// What one thread aggregates from its slice of days
+struct PartialRollup {
+    QHash<QPair<QString, int>, RollupTotals> laneDays;        // (day, lane)
+    QHash<QPair<QString, QString>, BowlerDay> bowlerDays;     // (day, bowler key)
+    QHash<QPair<int, QString>, RollupTotals> leagueWeeks;     // (league, week start)
+    int gamesRead = 0;
+    QString error;
+};
+
+void addGame(RollupTotals &totals, int score)
+{
+    totals.games++;
+    totals.pins += score;
+    totals.highGame = qMax(totals.highGame, score);
+}
+
+void mergeTotals(RollupTotals &into, const RollupTotals &from)
+{
+    into.games += from.games;
+    into.pins += from.pins;
+    into.highGame = qMax(into.highGame, from.highGame);
+}
+
+// Runs on a worker thread; the connection is created, used and removed there
+void aggregateRange(const QString &databasePath, const QString &connectionName,
+                    const QDate &from, const QDate &to, PartialRollup *out)
+{
+    {
+        QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", connectionName);
+        database.setDatabaseName(databasePath);
+        database.setConnectOptions("QSQLITE_OPEN_READONLY;QSQLITE_BUSY_TIMEOUT=5000");
+
+        if (!database.open()) {
+            out->error = database.lastError().text();
+        } else {
+            QSqlQuery query(database);
+            query.setForwardOnly(true);
+            query.prepare(GAMES_IN_RANGE_SQL);
+            query.addBindValue(from.toString(Qt::ISODate));
+            query.addBindValue(to.addDays(1).toString(Qt::ISODate));
+
+            if (!query.exec()) {
+                out->error = query.lastError().text();
+            }
+
+            while (query.next()) {
+                const int laneId = query.value(0).toInt();
+                const int bowlerId = query.value(1).toInt();
+                const QString bowlerName = query.value(2).toString();
+                const int leagueId = query.value(3).toInt();
+                const int score = query.value(4).toInt();
+                const QString day = query.value(5).toString().left(10);
+
+                addGame(out->laneDays[qMakePair(day, laneId)], score);
+
+                BowlerDay &bowler = out->bowlerDays[qMakePair(day, RollupBuilder::bowlerKey(bowlerId, bowlerName))];
+                addGame(bowler.totals, score);
+                bowler.bowlerId = qMax(bowler.bowlerId, bowlerId);
+                bowler.bowlerName = qMax(bowler.bowlerName, bowlerName);
+
+                if (leagueId > 0) {
+                    QString week = RollupBuilder::weekStart(QDate::fromString(day, Qt::ISODate)).toString(Qt::ISODate);
+                    addGame(out->leagueWeeks[qMakePair(leagueId, week)], score);
+                }
+                out->gamesRead++;
+            }
+        }
+    }
+    QSqlDatabase::removeDatabase(connectionName);
+}
+
+} // namespace
+
+QString RollupBuilder::bowlerKey(int bowlerId, const QString &bowlerName)
+{
+    if (bowlerId > 0) {
+        return QString("id:%1").arg(bowlerId);
+    }
+
+    // The rollup triggers key names with SQLite's lower(), which folds A-Z
+    // only; QString::toLower() would also fold "É" and split a walk-in's day
+    QString name = bowlerName;
+    for (QChar &c : name) {
+        if (c >= QLatin1Char('A') && c <= QLatin1Char('Z')) {
+            c = QChar(c.unicode() + ('a' - 'A'));
+        }
+    }
+    return "name:" + name;
+}
+
+RollupRebuildResult RollupBuilder::rebuild(const QSqlDatabase &database, const QDate &from, const QDate &to,
+                                           int threadCount)
+{
+    RollupRebuildResult result;
+    if (!from.isValid() || !to.isValid() || to < from) {
+        return result;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Whole weeks, so every league week in range is rebuilt from all its games
+    result.from = weekStart(from);
+    result.to = weekStart(to).addDays(6);
+    const int days = static_cast<int>(result.from.daysTo(result.to)) + 1;
+
+    threadCount = threadCount > 0 ? threadCount : QThread::idealThreadCount();
+    threadCount = qBound(1, threadCount, days);
+    result.threadCount = threadCount;
+
+    QVector<PartialRollup> partials(threadCount);
+    QList<QThread*> threads;
+    const QString databasePath = database.databaseName();
+
+    for (int i = 0; i < threadCount; ++i) {
+        QDate chunkStart = result.from.addDays(static_cast<qint64>(days) * i / threadCount);
+        QDate chunkEnd = result.from.addDays(static_cast<qint64>(days) * (i + 1) / threadCount - 1);
+        QString connectionName = QString("rollup_backfill_%1").arg(i);
+        PartialRollup *partial = &partials[i];
+
+        threads.append(QThread::create([databasePath, connectionName, chunkStart, chunkEnd, partial]() {
+            aggregateRange(databasePath, connectionName, chunkStart, chunkEnd, partial);
+        }));
+    }
+
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+    for (QThread *thread : threads) {
+        thread->wait();
+    }
+    qDeleteAll(threads);
+
+    // Days never span chunks, but a league week can
+    QHash<QPair<int, QString>, RollupTotals> leagueWeeks;
+    for (const PartialRollup &partial : partials) {
+        if (!partial.error.isEmpty()) {
+            qCritical() << "Rollup backfill failed:" << partial.error;
+            return result;
+        }
+        result.gamesRead += partial.gamesRead;
+        for (auto it = partial.leagueWeeks.constBegin(); it != partial.leagueWeeks.constEnd(); ++it) {
+            mergeTotals(leagueWeeks[it.key()], it.value());
+        }
+    }
+
+    QSqlDatabase writer = database;
+    QSqlQuery query(writer);
+    const QString first = result.from.toString(Qt::ISODate);
+    const QString last = result.to.toString(Qt::ISODate);
+
+    writer.transaction();
+    bool ok = true;
+
+    for (const QString &clear : {CLEAR_LANE_DAYS_SQL, CLEAR_BOWLER_DAYS_SQL, CLEAR_LEAGUE_WEEKS_SQL}) {
+        query.prepare(clear);
+        query.addBindValue(first);
+        query.addBindValue(last);
+        ok = ok && query.exec();
+    }
+
+    query.prepare(INSERT_LANE_DAY_SQL);
+    for (const PartialRollup &partial : partials) {
+        for (auto it = partial.laneDays.constBegin(); ok && it != partial.laneDays.constEnd(); ++it) {
+            query.addBindValue(it.key().first);
+            query.addBindValue(it.key().second);
+            query.addBindValue(it.value().games);
+            query.addBindValue(it.value().pins);
+            query.addBindValue(it.value().highGame);
+            ok = query.exec();
+        }
+    }
+
+    query.prepare(INSERT_BOWLER_DAY_SQL);
+    for (const PartialRollup &partial : partials) {
+        for (auto it = partial.bowlerDays.constBegin(); ok && it != partial.bowlerDays.constEnd(); ++it) {
+            query.addBindValue(it.key().first);
+            query.addBindValue(it.key().second);
+            query.addBindValue(it.value().bowlerId > 0 ? QVariant(it.value().bowlerId) : QVariant());
+            query.addBindValue(it.value().bowlerName);
+            query.addBindValue(it.value().totals.games);
+            query.addBindValue(it.value().totals.pins);
+            query.addBindValue(it.value().totals.highGame);
+            ok = query.exec();
+        }
+    }
+
+    query.prepare(INSERT_LEAGUE_WEEK_SQL);
+    for (auto it = leagueWeeks.constBegin(); ok && it != leagueWeeks.constEnd(); ++it) {
+        query.addBindValue(it.key().first);
+        query.addBindValue(it.key().second);
+        query.addBindValue(it.value().games);
+        query.addBindValue(it.value().pins);
+        query.addBindValue(it.value().highGame);
+        ok = query.exec();
+    }
+
+    if (!ok || !writer.commit()) {
+        qCritical() << "Failed to write rollups:" << query.lastError().text();
+        writer.rollback();
+        return result;
+    }
+
+    result.success = true;
+    result.elapsedMs = timer.elapsed();
+
+    qDebug() << "Rollups rebuilt from" << first << "to" << last << ":" << result.gamesRead << "games,"
+             << threadCount << "threads," << result.elapsedMs << "ms";
+    return result;
+}
+
+QMap<int, RollupTotals> RollupBuilder::laneTotals(const QSqlDatabase &database, const QDate &from, const QDate &to)
+{
+    QMap<int, RollupTotals> totals;
+
+    QSqlQuery query(database);
+    query.prepare(LANE_TOTALS_SQL);
+    query.addBindValue(from.toString(Qt::ISODate));
+    query.addBindValue(to.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qWarning() << "Failed to read lane rollups:" << query.lastError().text();
+        return totals;
+    }
+
+    while (query.next()) {
+        RollupTotals &lane = totals[query.value(0).toInt()];
+        lane.games = query.value(1).toInt();
+        lane.pins = query.value(2).toLongLong();
+        lane.highGame = query.value(3).toInt();
+    }
+    return totals;
+}
+
+RollupTotals RollupBuilder::bowlerTotals(const QSqlDatabase &database, int bowlerId, const QDate &from, const QDate &to)
+{
+    RollupTotals totals;
+
+    QSqlQuery query(database);
+    query.prepare(BOWLER_TOTALS_SQL);
+    query.addBindValue(bowlerId);
+    query.addBindValue(from.toString(Qt::ISODate));
+    query.addBindValue(to.toString(Qt::ISODate));
+
+    if (query.exec() && query.next()) {
+        totals.games = query.value(0).toInt();
+        totals.pins = query.value(1).toLongLong();
+        totals.highGame = query.value(2).toInt();
+    } else if (query.lastError().isValid()) {
+        qWarning() << "Failed to read bowler rollups:" << query.lastError().text();
+    }
+    return totals;
+}
+
+QMap<QDate, RollupTotals> RollupBuilder::leagueWeeks(const QSqlDatabase &database, int leagueId,
+                                                     const QDate &from, const QDate &to)
+{
+    QMap<QDate, RollupTotals> weeks;
+
+    QSqlQuery query(database);
+    query.prepare(LEAGUE_WEEKS_SQL);
+    query.addBindValue(leagueId);
+    query.addBindValue(weekStart(from).toString(Qt::ISODate));
+    query.addBindValue(to.toString(Qt::ISODate));
+
+    if (!query.exec()) {
+        qWarning() << "Failed to read league rollups:" << query.lastError().text();
+        return weeks;
+    }
+
+    while (query.next()) {
+        RollupTotals &week = weeks[QDate::fromString(query.value(0).toString(), Qt::ISODate)];
+        week.games = query.value(1).toInt();
+        week.pins = query.value(2).toLongLong();
+        week.highGame = query.value(3).toInt();
+    }
+    return weeks;
+}
@@ -0,0 +1,49 @@
+﻿// RollupBuilder.h
+#ifndef ROLLUPBUILDER_H
+#define ROLLUPBUILDER_H
+
+#include <QString>
+#include <QDate>
+#include <QMap>
+#include <QSqlDatabase>
+
+struct RollupTotals {
+    int games = 0;
+    qint64 pins = 0;
+    int highGame = 0;
+
+    double average() const { return games > 0 ? static_cast<double>(pins) / games : 0.0; }
+};
+
+struct RollupRebuildResult {
+    bool success = false;
+    QDate from;             // Widened to whole weeks
+    QDate to;
+    int gamesRead = 0;
+    int threadCount = 0;
+    qint64 elapsedMs = 0;
+};
+
+// The rollup_* tables are kept current by the games_rollup_* triggers.
+// RollupBuilder recomputes them from the games table when they drift (a
+// database restored from a backup, or rows written with triggers off): the
+// date range is split across threads that each aggregate on their own
+// read-only connection, and the merged rows are written back in one
+// transaction.
+class RollupBuilder
+{
+public:
+    static RollupRebuildResult rebuild(const QSqlDatabase &database, const QDate &from, const QDate &to,
+                                       int threadCount = 0);
+
+    // Sums over the rollups, touching one row per day rather than every game
+    static QMap<int, RollupTotals> laneTotals(const QSqlDatabase &database, const QDate &from, const QDate &to);
+    static RollupTotals bowlerTotals(const QSqlDatabase &database, int bowlerId, const QDate &from, const QDate &to);
+    static QMap<QDate, RollupTotals> leagueWeeks(const QSqlDatabase &database, int leagueId,
+                                                 const QDate &from, const QDate &to);
+
+    static QDate weekStart(const QDate &date) { return date.addDays(1 - date.dayOfWeek()); }
+    static QString bowlerKey(int bowlerId, const QString &bowlerName);
+};
+
+#endif // ROLLUPBUILDER_H
@@ -0,0 +1,370 @@
+﻿// ScheduleOptimizer.cpp
+#include "ScheduleOptimizer.h"
+#include <QDebug>
+#include <QThread>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QtMath>
+#include <utility>
+
+namespace {
+
+qint64 pairKey(int team1Id, int team2Id)
+{
+    return (static_cast<qint64>(qMin(team1Id, team2Id)) << 32) | static_cast<quint32>(qMax(team1Id, team2Id));
+}
+
+// One annealing run over its own copy of the season
+class AnnealingChain
+{
+public:
+    AnnealingChain(const QVector<ScheduledWeek> &weeks, const QVector<int> &teamIds, int laneSlots,
+                   const ScheduleOptimizerOptions &options, quint32 seed)
+        : m_weeks(weeks)
+        , m_slots(laneSlots)
+        , m_options(options)
+        , m_rng(seed)
+    {
+        for (int i = 0; i < teamIds.size(); ++i) {
+            m_teamIndex[teamIds[i]] = i;
+        }
+        m_usage.fill(0, teamIds.size() * m_slots);
+
+        m_blocked.resize(m_weeks.size());
+        for (int w = 0; w < m_weeks.size(); ++w) {
+            m_blocked[w].fill(false, m_slots);
+            const QSet<int> blocked = m_options.blockedSlots.value(m_weeks[w].weekNumber);
+            for (int slot : blocked) {
+                if (slot >= 0 && slot < m_slots) {
+                    m_blocked[w][slot] = true;
+                }
+            }
+
+            if (!m_weeks[w].positionRound && !m_weeks[w].matchups.isEmpty()) {
+                m_regular.append(w);
+            }
+
+            for (const ScheduledMatchup &matchup : m_weeks[w].matchups) {
+                if (matchup.slot < 0 || matchup.slot >= m_slots) continue;
+                addUsage(matchup.team1Id, matchup.slot, 1);
+                addUsage(matchup.team2Id, matchup.slot, 1);
+            }
+        }
+
+        m_cost = totalCost();
+        m_bestCost = m_cost;
+        m_best = m_weeks;
+    }
+
+    void run(qint64 budgetMs)
+    {
+        if (m_regular.isEmpty() || m_slots < 2) {
+            return;
+        }
+
+        const double startTemp = 10.0 * m_options.laneBalanceWeight + m_options.repeatWeight;
+        const double endTemp = 0.05;
+        double temperature = startTemp;
+
+        QElapsedTimer timer;
+        timer.start();
+
+        forever {
+            if (m_regular.size() > 1 && m_rng.bounded(5) == 0) {
+                tryWeekSwap(temperature);
+            } else {
+                trySlotMove(temperature);
+            }
+            ++m_iterations;
+
+            if ((m_iterations & 1023) == 0) {
+                if (m_cost < m_bestCost) {
+                    m_bestCost = m_cost;
+                    m_best = m_weeks;
+                }
+
+                qint64 elapsed = timer.elapsed();
+                if (elapsed >= budgetMs) {
+                    break;
+                }
+                double fraction = static_cast<double>(elapsed) / budgetMs;
+                temperature = startTemp * qPow(endTemp / startTemp, fraction);
+            }
+        }
+
+        if (m_cost < m_bestCost) {
+            m_bestCost = m_cost;
+            m_best = m_weeks;
+        }
+    }
+
+    qint64 bestCost() const { return m_bestCost; }
+    qint64 iterations() const { return m_iterations; }
+
+    ScheduleOptimizerResult result() const
+    {
+        // Re-score the best schedule from scratch so the breakdown is exact
+        AnnealingChain scorer(m_best, teamIdsByIndex(), m_slots, m_options, 0);
+
+        ScheduleOptimizerResult result;
+        result.weeks = m_best;
+        result.cost = scorer.m_cost;
+        result.laneImbalance = scorer.laneCost();
+        result.iterations = m_iterations;
+        for (int w = 0; w < scorer.m_weeks.size(); ++w) {
+            result.blockedMatchups += scorer.blockedCount(w);
+            if (w + 1 < scorer.m_weeks.size()) {
+                result.backToBackRepeats += scorer.repeatsBetween(w, w + 1);
+            }
+        }
+        return result;
+    }
+
+private:
+    QVector<int> teamIdsByIndex() const
+    {
+        QVector<int> teamIds(m_teamIndex.size());
+        for (auto it = m_teamIndex.constBegin(); it != m_teamIndex.constEnd(); ++it) {
+            teamIds[it.value()] = it.key();
+        }
+        return teamIds;
+    }
+
+    int usageAt(int teamId, int slot) const
+    {
+        int team = m_teamIndex.value(teamId, -1);
+        return team < 0 ? 0 : m_usage[team * m_slots + slot];
+    }
+
+    void addUsage(int teamId, int slot, int change)
+    {
+        int team = m_teamIndex.value(teamId, -1);
+        if (team >= 0) {
+            m_usage[team * m_slots + slot] += change;
+        }
+    }
+
+    // Change in sum of squared lane usage when a team moves one game between slots
+    qint64 moveDelta(int teamId, int fromSlot, int toSlot) const
+    {
+        if (!m_teamIndex.contains(teamId)) return 0;
+        return 2 * (usageAt(teamId, toSlot) - usageAt(teamId, fromSlot)) + 2;
+    }
+
+    qint64 laneCost() const
+    {
+        qint64 cost = 0;
+        for (int value : m_usage) {
+            cost += static_cast<qint64>(value) * value;
+        }
+        return cost;
+    }
+
+    int blockedCount(int w) const
+    {
+        int count = 0;
+        for (const ScheduledMatchup &matchup : m_weeks[w].matchups) {
+            if (matchup.slot >= 0 && matchup.slot < m_slots && m_blocked[w][matchup.slot]) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    int repeatsBetween(int a, int b) const
+    {
+        if (a < 0 || b >= m_weeks.size() || m_weeks[b].weekNumber - m_weeks[a].weekNumber != 1) {
+            return 0;
+        }
+
+        int repeats = 0;
+        for (const ScheduledMatchup &first : m_weeks[a].matchups) {
+            qint64 key = pairKey(first.team1Id, first.team2Id);
+            for (const ScheduledMatchup &second : m_weeks[b].matchups) {
+                if (pairKey(second.team1Id, second.team2Id) == key) {
+                    ++repeats;
+                    break;
+                }
+            }
+        }
+        return repeats;
+    }
+
+    qint64 totalCost() const
+    {
+        qint64 blocked = 0;
+        qint64 repeats = 0;
+        for (int w = 0; w < m_weeks.size(); ++w) {
+            blocked += blockedCount(w);
+            if (w + 1 < m_weeks.size()) {
+                repeats += repeatsBetween(w, w + 1);
+            }
+        }
+        return laneCost() * m_options.laneBalanceWeight
+               + blocked * m_options.blockedWeight
+               + repeats * m_options.repeatWeight;
+    }
+
+    bool accept(qint64 delta, double temperature)
+    {
+        if (delta <= 0) return true;
+        return m_rng.generateDouble() < qExp(-static_cast<double>(delta) / temperature);
+    }
+
+    void trySlotMove(double temperature)
+    {
+        int w = m_regular[m_rng.bounded(m_regular.size())];
+        QVector<ScheduledMatchup> &matchups = m_weeks[w].matchups;
+
+        int mi = m_rng.bounded(matchups.size());
+        int fromSlot = matchups[mi].slot;
+        int toSlot = m_rng.bounded(m_slots);
+        if (fromSlot < 0 || toSlot == fromSlot) return;
+
+        int other = -1;
+        for (int j = 0; j < matchups.size(); ++j) {
+            if (matchups[j].slot == toSlot) {
+                other = j;
+                break;
+            }
+        }
+
+        qint64 laneDelta = moveDelta(matchups[mi].team1Id, fromSlot, toSlot)
+                         + moveDelta(matchups[mi].team2Id, fromSlot, toSlot);
+        int blockedDelta = 0;
+        if (other >= 0) {
+            // A swap keeps both slots occupied, so only lane balance changes
+            laneDelta += moveDelta(matchups[other].team1Id, toSlot, fromSlot)
+                       + moveDelta(matchups[other].team2Id, toSlot, fromSlot);
+        } else {
+            blockedDelta = int(m_blocked[w][toSlot]) - int(m_blocked[w][fromSlot]);
+        }
+
+        qint64 delta = laneDelta * m_options.laneBalanceWeight + blockedDelta * m_options.blockedWeight;
+        if (!accept(delta, temperature)) return;
+
+        addUsage(matchups[mi].team1Id, fromSlot, -1);
+        addUsage(matchups[mi].team2Id, fromSlot, -1);
+        addUsage(matchups[mi].team1Id, toSlot, 1);
+        addUsage(matchups[mi].team2Id, toSlot, 1);
+        matchups[mi].slot = toSlot;
+
+        if (other >= 0) {
+            addUsage(matchups[other].team1Id, toSlot, -1);
+            addUsage(matchups[other].team2Id, toSlot, -1);
+            addUsage(matchups[other].team1Id, fromSlot, 1);
+            addUsage(matchups[other].team2Id, fromSlot, 1);
+            matchups[other].slot = fromSlot;
+        }
+
+        m_cost += delta;
+    }
+
+    qint64 localWeekCost(int i, int j) const
+    {
+        QSet<int> edges = { i - 1, i, j - 1, j };
+        qint64 repeats = 0;
+        for (int a : edges) {
+            if (a >= 0 && a + 1 < m_weeks.size()) {
+                repeats += repeatsBetween(a, a + 1);
+            }
+        }
+        return repeats * m_options.repeatWeight
+               + (blockedCount(i) + blockedCount(j)) * static_cast<qint64>(m_options.blockedWeight);
+    }
+
+    void swapWeeks(int i, int j)
+    {
+        std::swap(m_weeks[i].matchups, m_weeks[j].matchups);
+        std::swap(m_weeks[i].byeTeamIds, m_weeks[j].byeTeamIds);
+    }
+
+    void tryWeekSwap(double temperature)
+    {
+        int i = m_regular[m_rng.bounded(m_regular.size())];
+        int j = m_regular[m_rng.bounded(m_regular.size())];
+        if (i == j) return;
+
+        qint64 before = localWeekCost(i, j);
+        swapWeeks(i, j);
+        qint64 delta = localWeekCost(i, j) - before;
+
+        if (accept(delta, temperature)) {
+            m_cost += delta;
+        } else {
+            swapWeeks(i, j);
+        }
+    }
+
+    QVector<ScheduledWeek> m_weeks;
+    QVector<ScheduledWeek> m_best;
+    QVector<int> m_regular;             // Week indices with matchups that may move
+    QVector<QVector<bool>> m_blocked;   // [week index][slot]
+    QHash<int, int> m_teamIndex;
+    QVector<int> m_usage;               // [team index * slots + slot]
+    int m_slots;
+    ScheduleOptimizerOptions m_options;
+    QRandomGenerator m_rng;
+
+    qint64 m_cost = 0;
+    qint64 m_bestCost = 0;
+    qint64 m_iterations = 0;
+};
+
+} // namespace
+
+ScheduleOptimizerResult ScheduleOptimizer::optimize(const QVector<ScheduledWeek> &weeks,
+                                                    const QVector<int> &teamIds, int laneSlots,
+                                                    const ScheduleOptimizerOptions &options)
+{
+    int threadCount = options.threadCount > 0 ? options.threadCount : QThread::idealThreadCount();
+    threadCount = qMax(1, threadCount);
+
+    QList<AnnealingChain*> chains;
+    QList<QThread*> threads;
+
+    for (int i = 0; i < threadCount; ++i) {
+        AnnealingChain *chain = new AnnealingChain(weeks, teamIds, laneSlots, options,
+                                                   QRandomGenerator::global()->generate());
+        chains.append(chain);
+        threads.append(QThread::create([chain, &options]() {
+            chain->run(options.timeBudgetMs);
+        }));
+    }
+
+    for (QThread *thread : threads) {
+        thread->start();
+    }
+    for (QThread *thread : threads) {
+        thread->wait();
+    }
+
+    AnnealingChain *best = chains.first();
+    qint64 totalIterations = 0;
+    for (AnnealingChain *chain : chains) {
+        totalIterations += chain->iterations();
+        if (chain->bestCost() < best->bestCost()) {
+            best = chain;
+        }
+    }
+
+    ScheduleOptimizerResult result = best->result();
+    result.iterations = totalIterations;
+
+    qDeleteAll(threads);
+    qDeleteAll(chains);
+
+    qDebug() << "Schedule optimiser:" << threadCount << "chains," << result.iterations << "iterations,"
+             << "cost" << result.cost << "blocked" << result.blockedMatchups
+             << "repeats" << result.backToBackRepeats;
+
+    return result;
+}
+
+ScheduleOptimizerResult ScheduleOptimizer::evaluate(const QVector<ScheduledWeek> &weeks,
+                                                    const QVector<int> &teamIds, int laneSlots,
+                                                    const ScheduleOptimizerOptions &options)
+{
+    AnnealingChain chain(weeks, teamIds, laneSlots, options, 0);
+    return chain.result();
+}
@@ -0,0 +1,46 @@
+﻿// ScheduleOptimizer.h
+#ifndef SCHEDULEOPTIMIZER_H
+#define SCHEDULEOPTIMIZER_H
+
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include "LeagueScheduler.h"
+
+struct ScheduleOptimizerOptions {
+    int timeBudgetMs = 2000;            // Wall-clock budget for the whole search
+    int threadCount = 0;                // 0 = QThread::idealThreadCount()
+    QHash<int, QSet<int>> blockedSlots; // Week number -> lane slots booked by other events
+
+    // Cost weights
+    int blockedWeight = 1000;           // Matchup placed on a booked lane
+    int repeatWeight = 50;              // Same opponents in consecutive weeks
+    int laneBalanceWeight = 1;          // Uneven lane usage per team
+};
+
+struct ScheduleOptimizerResult {
+    QVector<ScheduledWeek> weeks;
+    qint64 cost = 0;
+    int blockedMatchups = 0;
+    int backToBackRepeats = 0;
+    qint64 laneImbalance = 0;           // Sum over teams of squared lane usage
+    qint64 iterations = 0;
+};
+
+// Simulated annealing over a generated season. Moves are lane swaps within a
+// week and whole-week swaps; the pairings themselves are never changed, so the
+// round-robin guarantees from LeagueScheduler still hold. Independent chains
+// run on separate threads and the best result wins.
+class ScheduleOptimizer
+{
+public:
+    static ScheduleOptimizerResult optimize(const QVector<ScheduledWeek> &weeks,
+                                            const QVector<int> &teamIds, int laneSlots,
+                                            const ScheduleOptimizerOptions &options = ScheduleOptimizerOptions());
+
+    static ScheduleOptimizerResult evaluate(const QVector<ScheduledWeek> &weeks,
+                                            const QVector<int> &teamIds, int laneSlots,
+                                            const ScheduleOptimizerOptions &options = ScheduleOptimizerOptions());
+};
+
+#endif // SCHEDULEOPTIMIZER_H
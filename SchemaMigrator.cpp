@@ -0,0 +1,573 @@
+﻿// SchemaMigrator.cpp
+#include "SchemaMigrator.h"
+#include "DatabaseManager.h"
+#include <QSqlQuery>
+#include <QSqlError>
+#include <QPair>
+#include <QDebug>
+
+namespace {
+
+// ALTER TABLE has no IF NOT EXISTS for columns, so skip the ones already there
+bool addMissingColumns(QSqlDatabase &database, const QString &table,
+                       const QVector<QPair<QString, QString>> &columns)
+{
+    QSqlQuery query(database);
+    if (!query.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        return false;
+    }
+
+    QStringList existing;
+    while (query.next()) {
+        existing.append(query.value(1).toString());
+    }
+
+    for (const auto &column : columns) {
+        if (existing.contains(column.first)) {
+            continue;
+        }
+        if (!query.exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column.first, column.second))) {
+            qCritical() << "Failed to add" << table << "column" << column.first << ":" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+struct SearchSource {
+    QString table;
+    int kind;
+    QString row;                    // search_index values for the row "new"
+};
+
+QVector<SearchSource> searchSources()
+{
+    // COALESCE throughout: one NULL column would otherwise blank the whole entry
+    const QString bowlerRow = QString("new.id * 4 + %1, COALESCE(new.first_name, '') || ' ' || COALESCE(new.last_name, ''), "
+                                      "COALESCE(new.phone, '') || ' ' || COALESCE(new.address, '')")
+                              .arg(SearchHit::Bowler);
+    const QString teamRow = QString("new.id * 4 + %1, COALESCE(new.name, ''), ''").arg(SearchHit::Team);
+    const QString eventRow = QString("new.id * 4 + %1, COALESCE(new.title, ''), "
+                                     "COALESCE(new.contact_name, '') || ' ' || COALESCE(new.contact_phone, '') || ' ' || "
+                                     "COALESCE(new.contact_email, '') || ' ' || COALESCE(new.event_type, '')")
+                             .arg(SearchHit::CalendarEvent);
+
+    return {
+        {"bowlers", SearchHit::Bowler, bowlerRow},
+        {"teams", SearchHit::Team, teamRow},
+        {"calendar_events", SearchHit::CalendarEvent, eventRow}
+    };
+}
+
+// The source's entries as a SELECT of rowid, title and detail
+QString sourceRows(const SearchSource &source)
+{
+    return QString("SELECT %1 FROM %2").arg(QString(source.row).replace("new.", ""), source.table);
+}
+
+bool fillSearchIndex(QSqlQuery &query)
+{
+    if (!query.exec("DELETE FROM search_index")) {
+        qCritical() << "Failed to clear search index:" << query.lastError().text();
+        return false;
+    }
+    for (const SearchSource &source : searchSources()) {
+        if (!query.exec("INSERT INTO search_index(rowid, title, detail) " + sourceRows(source))) {
+            qCritical() << "Failed to index" << source.table << "for search:" << query.lastError().text();
+            return false;
+        }
+    }
+    return true;
+}
+
+// One FTS5 table for every searchable row. The rowid is id * 4 + SearchHit::Kind,
+// so triggers can replace a single entry without scanning the index. FTS5 is
+// optional: without it the migration still lands and search() falls back to LIKE.
+bool createSearchIndex(QSqlDatabase &database)
+{
+    QSqlQuery query(database);
+
+    QString createSearchTable = R"(
+        CREATE VIRTUAL TABLE IF NOT EXISTS search_index USING fts5(
+            title, detail,
+            tokenize = 'unicode61 remove_diacritics 2',
+            prefix = '2 3'
+        )
+    )";
+
+    if (!query.exec(createSearchTable)) {
+        qWarning() << "Full-text search unavailable:" << query.lastError().text();
+        return true;
+    }
+
+    // Databases that built the index on start may carry older trigger bodies
+    // and rows, so both are replaced
+    for (const SearchSource &source : searchSources()) {
+        QString insert = QString("INSERT INTO search_index(rowid, title, detail) VALUES (%1);").arg(source.row);
+        QString remove = QString("DELETE FROM search_index WHERE rowid = old.id * 4 + %1;").arg(source.kind);
+
+        QStringList statements;
+        for (const char *suffix : {"insert", "update", "delete"}) {
+            statements << QString("DROP TRIGGER IF EXISTS %1_search_%2").arg(source.table, suffix);
+        }
+        statements << QString("CREATE TRIGGER %1_search_insert AFTER INSERT ON %1 BEGIN %2 END")
+                      .arg(source.table, insert);
+        statements << QString("CREATE TRIGGER %1_search_update AFTER UPDATE ON %1 BEGIN %2 %3 END")
+                      .arg(source.table, remove, insert);
+        statements << QString("CREATE TRIGGER %1_search_delete AFTER DELETE ON %1 BEGIN %2 END")
+                      .arg(source.table, remove);
+
+        for (const QString &statement : statements) {
+            if (!query.exec(statement)) {
+                qCritical() << "Failed to index" << source.table << "for search:" << query.lastError().text();
+                return false;
+            }
+        }
+    }
+    return fillSearchIndex(query);
+}
+
+// rollup_bowler_day's key for a games row. lower() folds A-Z only, and
+// RollupBuilder::bowlerKey() folds names the same way.
+QString rollupBowlerKey(const QString &row)
+{
+    return QString("CASE WHEN %1bowler_id > 0 THEN 'id:' || %1bowler_id "
+                   "ELSE 'name:' || lower(COALESCE(%1bowler_name, '')) END").arg(row);
+}
+
+// Recounts the three rollup rows a games row falls in from the games table
+// itself, since a high game cannot be taken back by subtraction. row is
+// "old" or "new"; the day's games are found through idx_games_created.
+QString refreshRollupsFor(const QString &row)
+{
+    const QString day = QString("date(%1.created_at)").arg(row);
+    const QString nextDay = QString("date(%1.created_at, '+1 day')").arg(row);
+    const QString week = QString("date(%1.created_at, '-6 days', 'weekday 1')").arg(row);
+    const QString key = rollupBowlerKey(row + ".");
+
+    return QString(R"(
+        DELETE FROM rollup_lane_day WHERE day = %1 AND lane_id = %5.lane_id;
+        INSERT INTO rollup_lane_day (day, lane_id, games, pins, high_game)
+        SELECT %1, %5.lane_id, COUNT(*), SUM(score), MAX(score) FROM games
+        WHERE created_at >= %1 AND created_at < %2 AND lane_id = %5.lane_id
+        HAVING COUNT(*) > 0;
+        DELETE FROM rollup_bowler_day WHERE day = %1 AND bowler_key = %4;
+        INSERT INTO rollup_bowler_day (day, bowler_key, bowler_id, bowler_name, games, pins, high_game)
+        SELECT %1, %4, MAX(bowler_id), MAX(bowler_name), COUNT(*), SUM(score), MAX(score) FROM games
+        WHERE created_at >= %1 AND created_at < %2 AND %6 = %4
+        HAVING COUNT(*) > 0;
+        DELETE FROM rollup_league_week WHERE league_id = %5.league_id AND week_start = %3;
+        INSERT INTO rollup_league_week (league_id, week_start, games, pins, high_game)
+        SELECT %5.league_id, %3, COUNT(*), SUM(score), MAX(score) FROM games
+        WHERE %5.league_id > 0 AND created_at >= %3 AND created_at < date(%3, '+7 days')
+          AND league_id = %5.league_id
+        HAVING COUNT(*) > 0;
+    )").arg(day, nextDay, week, key, row, rollupBowlerKey(QString()));
+}
+
+} // namespace
+
+SchemaMigrator::SchemaMigrator(const QSqlDatabase &database)
+    : m_database(database)
+{
+}
+
+bool SchemaMigrator::rebuildSearchIndex()
+{
+    if (!m_database.tables().contains("search_index")) {
+        return true; // Built without FTS5; search() uses LIKE
+    }
+    QSqlQuery query(m_database);
+    return fillSearchIndex(query);
+}
+
+QString SchemaMigrator::searchRows()
+{
+    QStringList selects;
+    for (const SearchSource &source : searchSources()) {
+        selects.append(sourceRows(source));
+    }
+    return selects.join(" UNION ALL ");
+}
+
+const QStringList &SchemaMigrator::baseline()
+{
+    static const QStringList statements = {
+        R"(
+            CREATE TABLE IF NOT EXISTS bowlers (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                first_name TEXT NOT NULL,
+                last_name TEXT NOT NULL,
+                sex TEXT DEFAULT 'Male',
+                avg INTEGER DEFAULT 0,
+                address TEXT,
+                phone TEXT,
+                birthday TEXT,
+                over_18 INTEGER DEFAULT 1,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS teams (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT UNIQUE NOT NULL,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS team_bowlers (
+                team_id INTEGER,
+                bowler_id INTEGER,
+                PRIMARY KEY (team_id, bowler_id),
+                FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE CASCADE,
+                FOREIGN KEY (bowler_id) REFERENCES bowlers(id) ON DELETE CASCADE
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS leagues (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                name TEXT UNIQUE NOT NULL,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS league_teams (
+                league_id INTEGER,
+                team_id INTEGER,
+                PRIMARY KEY (league_id, team_id),
+                FOREIGN KEY (league_id) REFERENCES leagues(id) ON DELETE CASCADE,
+                FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE CASCADE
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS calendar_events (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                date TEXT NOT NULL,
+                start_time TEXT NOT NULL,
+                end_time TEXT NOT NULL,
+                lane_id INTEGER NOT NULL,
+                event_type TEXT NOT NULL DEFAULT 'Open Bowling',
+                title TEXT NOT NULL,
+                description TEXT,
+                contact_name TEXT NOT NULL,
+                contact_phone TEXT NOT NULL,
+                contact_email TEXT,
+                bowler_count INTEGER DEFAULT 1,
+                additional_details TEXT,
+                league_id INTEGER DEFAULT 0,
+                team_id INTEGER DEFAULT 0,
+                created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+                updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP,
+                FOREIGN KEY (league_id) REFERENCES leagues(id) ON DELETE SET NULL,
+                FOREIGN KEY (team_id) REFERENCES teams(id) ON DELETE SET NULL
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS league_configs (
+                league_id INTEGER PRIMARY KEY,
+                name TEXT NOT NULL,
+                start_date TEXT,
+                end_date TEXT,
+                number_of_weeks INTEGER,
+                lane_ids TEXT,
+                status TEXT DEFAULT 'scheduled',
+                config_json TEXT,
+                created_at DATETIME DEFAULT CURRENT_TIMESTAMP
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS bowler_season_data (
+                bowler_id INTEGER,
+                league_id INTEGER,
+                team_id INTEGER,
+                current_average REAL DEFAULT 0.0,
+                current_handicap REAL DEFAULT 0.0,
+                games_played INTEGER DEFAULT 0,
+                total_pins INTEGER DEFAULT 0,
+                balls_thrown INTEGER DEFAULT 0,
+                strikes INTEGER DEFAULT 0,
+                spares INTEGER DEFAULT 0,
+                high_game INTEGER DEFAULT 0,
+                high_series INTEGER DEFAULT 0,
+                prebowl_games TEXT,
+                last_updated DATETIME DEFAULT CURRENT_TIMESTAMP,
+                PRIMARY KEY(bowler_id, league_id)
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS league_events (
+                event_id INTEGER PRIMARY KEY,
+                league_id INTEGER,
+                week_number INTEGER,
+                scheduled_time DATETIME,
+                lane_ids TEXT,
+                matchups_json TEXT,
+                event_completed BOOLEAN DEFAULT 0,
+                FOREIGN KEY(league_id) REFERENCES league_configs(league_id)
+            )
+        )",
+        R"(
+            CREATE TABLE IF NOT EXISTS prebowl_games (
+                prebowl_id INTEGER PRIMARY KEY,
+                bowler_id INTEGER,
+                league_id INTEGER,
+                game_data TEXT,
+                times_used INTEGER DEFAULT 0,
+                max_uses INTEGER DEFAULT 1,
+                created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+                FOREIGN KEY(bowler_id) REFERENCES bowlers(id),
+                FOREIGN KEY(league_id) REFERENCES league_configs(league_id)
+            )
+        )",
+        "CREATE INDEX IF NOT EXISTS idx_calendar_events_date ON calendar_events(date)",
+        "CREATE INDEX IF NOT EXISTS idx_calendar_events_lane_date ON calendar_events(lane_id, date)",
+        "CREATE INDEX IF NOT EXISTS idx_calendar_events_date_time ON calendar_events(date, start_time, end_time)"
+    };
+    return statements;
+}
+
+const QVector<SchemaMigration> &SchemaMigrator::migrations()
+{
+    static const QVector<SchemaMigration> migrations = {
+        // Lookup indexes found by --audit-queries
+        {1, "Add lookup indexes flagged by the query plan audit",
+         {"CREATE INDEX IF NOT EXISTS idx_team_bowlers_bowler ON team_bowlers(bowler_id)",
+          "CREATE INDEX IF NOT EXISTS idx_league_teams_league ON league_teams(league_id)",
+          "CREATE INDEX IF NOT EXISTS idx_league_teams_team ON league_teams(team_id)",
+          "CREATE INDEX IF NOT EXISTS idx_bowler_season_data_league ON bowler_season_data(league_id)",
+          "CREATE INDEX IF NOT EXISTS idx_prebowl_games_bowler_league ON prebowl_games(bowler_id, league_id)",
+          "CREATE INDEX IF NOT EXISTS idx_league_events_league_week ON league_events(league_id, week_number)",
+          "CREATE INDEX IF NOT EXISTS idx_calendar_events_league ON calendar_events(league_id)"},
+         nullptr},
+
+        // LeagueManager's league_teams definition never took effect because the
+        // junction table is created first; give the junction its standings columns
+        {2, "League standings columns on league_teams",
+         {},
+         [](QSqlDatabase &database) {
+             return addMissingColumns(database, "league_teams", {
+                 {"name", "TEXT"},
+                 {"bowler_ids", "TEXT"},
+                 {"division_id", "INTEGER DEFAULT 0"},
+                 {"wins", "INTEGER DEFAULT 0"},
+                 {"losses", "INTEGER DEFAULT 0"},
+                 {"ties", "INTEGER DEFAULT 0"},
+                 {"total_points", "INTEGER DEFAULT 0"},
+                 {"team_average", "REAL DEFAULT 0.0"}
+             });
+         }},
+
+        // Completed games, read by the end of day report
+        {3, "Games table",
+         {R"(
+            CREATE TABLE IF NOT EXISTS games (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                lane_id INTEGER NOT NULL,
+                bowler_id INTEGER,
+                bowler_name TEXT,
+                league_id INTEGER,
+                game_type TEXT NOT NULL DEFAULT 'quick_game',
+                game_number INTEGER DEFAULT 1,
+                score INTEGER DEFAULT 0,
+                frames_json TEXT,
+                started_at DATETIME,
+                created_at DATETIME DEFAULT CURRENT_TIMESTAMP,
+                FOREIGN KEY(bowler_id) REFERENCES bowlers(id)
+            )
+          )",
+          "CREATE INDEX IF NOT EXISTS idx_games_created ON games(created_at)",
+          "CREATE INDEX IF NOT EXISTS idx_games_bowler ON games(bowler_id)"},
+         nullptr},
+
+        // Reporting rollups kept current by a trigger on games; RollupBuilder
+        // rebuilds them. Keys and week starts must match RollupBuilder's.
+        {4, "Daily and weekly rollup tables",
+         {R"(
+            CREATE TABLE IF NOT EXISTS rollup_lane_day (
+                day TEXT NOT NULL,
+                lane_id INTEGER NOT NULL,
+                games INTEGER DEFAULT 0,
+                pins INTEGER DEFAULT 0,
+                high_game INTEGER DEFAULT 0,
+                PRIMARY KEY (day, lane_id)
+            )
+          )",
+          R"(
+            CREATE TABLE IF NOT EXISTS rollup_bowler_day (
+                day TEXT NOT NULL,
+                bowler_key TEXT NOT NULL,
+                bowler_id INTEGER,
+                bowler_name TEXT,
+                games INTEGER DEFAULT 0,
+                pins INTEGER DEFAULT 0,
+                high_game INTEGER DEFAULT 0,
+                PRIMARY KEY (day, bowler_key)
+            )
+          )",
+          R"(
+            CREATE TABLE IF NOT EXISTS rollup_league_week (
+                league_id INTEGER NOT NULL,
+                week_start TEXT NOT NULL,
+                games INTEGER DEFAULT 0,
+                pins INTEGER DEFAULT 0,
+                high_game INTEGER DEFAULT 0,
+                PRIMARY KEY (league_id, week_start)
+            )
+          )",
+          "CREATE INDEX IF NOT EXISTS idx_rollup_bowler_day_bowler ON rollup_bowler_day(bowler_id, day)",
+          R"(
+            CREATE TRIGGER IF NOT EXISTS games_rollup_insert AFTER INSERT ON games BEGIN
+                INSERT INTO rollup_lane_day (day, lane_id, games, pins, high_game)
+                VALUES (date(new.created_at), new.lane_id, 1, new.score, new.score)
+                ON CONFLICT(day, lane_id) DO UPDATE SET
+                    games = games + 1, pins = pins + excluded.pins, high_game = max(high_game, excluded.high_game);
+                INSERT INTO rollup_bowler_day (day, bowler_key, bowler_id, bowler_name, games, pins, high_game)
+                VALUES (date(new.created_at),
+                        CASE WHEN new.bowler_id > 0 THEN 'id:' || new.bowler_id
+                             ELSE 'name:' || lower(COALESCE(new.bowler_name, '')) END,
+                        new.bowler_id, new.bowler_name, 1, new.score, new.score)
+                ON CONFLICT(day, bowler_key) DO UPDATE SET
+                    games = games + 1, pins = pins + excluded.pins, high_game = max(high_game, excluded.high_game);
+                INSERT INTO rollup_league_week (league_id, week_start, games, pins, high_game)
+                SELECT new.league_id, date(new.created_at, '-6 days', 'weekday 1'), 1, new.score, new.score
+                WHERE new.league_id > 0
+                ON CONFLICT(league_id, week_start) DO UPDATE SET
+                    games = games + 1, pins = pins + excluded.pins, high_game = max(high_game, excluded.high_game);
+            END
+          )",
+          R"(
+            INSERT OR REPLACE INTO rollup_lane_day (day, lane_id, games, pins, high_game)
+            SELECT date(created_at), lane_id, COUNT(*), SUM(score), MAX(score) FROM games GROUP BY 1, 2
+          )",
+          R"(
+            INSERT OR REPLACE INTO rollup_bowler_day (day, bowler_key, bowler_id, bowler_name, games, pins, high_game)
+            SELECT date(created_at),
+                   CASE WHEN bowler_id > 0 THEN 'id:' || bowler_id ELSE 'name:' || lower(COALESCE(bowler_name, '')) END,
+                   MAX(bowler_id), MAX(bowler_name), COUNT(*), SUM(score), MAX(score)
+            FROM games GROUP BY 1, 2
+          )",
+          R"(
+            INSERT OR REPLACE INTO rollup_league_week (league_id, week_start, games, pins, high_game)
+            SELECT league_id, date(created_at, '-6 days', 'weekday 1'), COUNT(*), SUM(score), MAX(score)
+            FROM games WHERE league_id > 0 GROUP BY 1, 2
+          )"},
+         nullptr},
+
+        // Change log shipped to a hot standby; ReplicationLog adds the
+        // per-table triggers that fill it
+        {5, "Replication log",
+         {R"(
+            CREATE TABLE IF NOT EXISTS replication_log (
+                id INTEGER PRIMARY KEY AUTOINCREMENT,
+                table_name TEXT NOT NULL,
+                row_id INTEGER NOT NULL,
+                op TEXT NOT NULL
+            )
+          )",
+          R"(
+            CREATE TABLE IF NOT EXISTS replication_meta (
+                key TEXT PRIMARY KEY,
+                value TEXT
+            )
+          )"},
+         nullptr},
+
+        // Full-text search, which DatabaseManager used to set up on every start
+        {6, "Full-text search index", {}, createSearchIndex},
+
+        // Games edited or deleted at the desk no longer leave the rollups stale
+        {7, "Rollup update and delete triggers",
+         {QString("CREATE TRIGGER IF NOT EXISTS games_rollup_update AFTER UPDATE ON games BEGIN %1 %2 END")
+              .arg(refreshRollupsFor("old"), refreshRollupsFor("new")),
+          QString("CREATE TRIGGER IF NOT EXISTS games_rollup_delete AFTER DELETE ON games BEGIN %1 END")
+              .arg(refreshRollupsFor("old"))},
+         nullptr},
+
+        // What-if replays load a league's games in one pass
+        {8, "League games index",
+         {"CREATE INDEX IF NOT EXISTS idx_games_league ON games(league_id, created_at)"},
+         nullptr}
+    };
+    return migrations;
+}
+
+int SchemaMigrator::latestVersion()
+{
+    return migrations().isEmpty() ? 0 : migrations().last().version;
+}
+
+int SchemaMigrator::currentVersion() const
+{
+    QSqlQuery query(m_database);
+    if (!query.exec("PRAGMA user_version") || !query.next()) {
+        qCritical() << "Failed to read schema version:" << query.lastError().text();
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+bool SchemaMigrator::migrate()
+{
+    int version = currentVersion();
+    if (version < 0) {
+        return false;
+    }
+
+    const int latest = latestVersion();
+    if (version == latest) {
+        return true;
+    }
+    if (version > latest) {
+        qWarning() << "Database schema version" << version << "is newer than this build supports (" << latest << ")";
+        return true;
+    }
+
+    QSqlQuery query(m_database);
+
+    // Version 1 indexes tables that predate the migrator
+    if (version == 0) {
+        for (const QString &statement : baseline()) {
+            if (!query.exec(statement)) {
+                qCritical() << "Failed to create the baseline schema:" << query.lastError().text();
+                return false;
+            }
+        }
+    }
+
+    for (const SchemaMigration &migration : migrations()) {
+        if (migration.version <= version) {
+            continue;
+        }
+
+        if (!m_database.transaction()) {
+            qCritical() << "Failed to start schema migration" << migration.version << ":"
+                        << m_database.lastError().text();
+            return false;
+        }
+
+        bool ok = true;
+        for (const QString &statement : migration.statements) {
+            if (!query.exec(statement)) {
+                qCritical() << "Schema migration" << migration.version << "failed:" << query.lastError().text();
+                ok = false;
+                break;
+            }
+        }
+        if (ok && migration.apply) {
+            ok = migration.apply(m_database);
+        }
+
+        // user_version is transactional, so it only moves if the whole migration lands
+        if (!ok || !query.exec(QString("PRAGMA user_version = %1").arg(migration.version))
+            || !m_database.commit()) {
+            qCritical() << "Rolling back schema migration" << migration.version;
+            m_database.rollback();
+            return false;
+        }
+
+        version = migration.version;
+        qDebug() << "Applied schema migration" << version << "-" << migration.description;
+    }
+
+    return true;
+}
@@ -0,0 +1,50 @@
+﻿// SchemaMigrator.h
+#ifndef SCHEMAMIGRATOR_H
+#define SCHEMAMIGRATOR_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSqlDatabase>
+#include <functional>
+
+struct SchemaMigration {
+    int version;
+    QString description;
+    QStringList statements;
+    std::function<bool(QSqlDatabase &)> apply;     // Optional step run after the statements
+};
+
+// Brings bowling.db up to the latest schema. PRAGMA user_version records the
+// last migration applied and each pending migration runs in its own
+// transaction, so an interrupted upgrade resumes from the last good version.
+// An up-to-date database costs a single PRAGMA read at startup.
+class SchemaMigrator
+{
+public:
+    explicit SchemaMigrator(const QSqlDatabase &database);
+
+    // Tables and indexes created on every start before versioning. Run for a
+    // database still at user_version 0, ahead of version 1.
+    static const QStringList &baseline();
+
+    // Ordered by version; append new migrations, never edit shipped ones
+    static const QVector<SchemaMigration> &migrations();
+    static int latestVersion();
+
+    int currentVersion() const;     // -1 if it cannot be read
+    bool migrate();
+
+    // Refills search_index from bowlers, teams and calendar_events, e.g. after
+    // a standby has copied those tables in pages
+    bool rebuildSearchIndex();
+
+    // Every entry search_index holds, as one SELECT of rowid, title and detail;
+    // what search() filters with LIKE when SQLite has no FTS5
+    static QString searchRows();
+
+private:
+    QSqlDatabase m_database;
+};
+
+#endif // SCHEMAMIGRATOR_H
@@ -0,0 +1,148 @@
+﻿// StandbyClient.cpp
+#include "StandbyClient.h"
+#include "SchemaMigrator.h"
+#include <QJsonDocument>
+#include <QDebug>
+
+StandbyClient::StandbyClient(ReplicationLog *log, QObject *parent)
+    : QObject(parent)
+    , m_log(log)
+    , m_socket(new QTcpSocket(this))
+    , m_checkTimer(new QTimer(this))
+    , m_port(0)
+    , m_appliedId(0)
+    , m_welcomeId(0)
+    , m_synced(false)
+    , m_fullCopy(false)
+    , m_tookOver(false)
+{
+    connect(m_socket, &QTcpSocket::connected, this, &StandbyClient::onConnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &StandbyClient::onReadyRead);
+    connect(m_checkTimer, &QTimer::timeout, this, &StandbyClient::checkPrimary);
+}
+
+void StandbyClient::follow(const QString &host, quint16 port)
+{
+    m_host = host;
+    m_port = port;
+    m_lastHeard.start();
+    m_checkTimer->start(CHECK_INTERVAL);
+    m_socket->connectToHost(m_host, m_port);
+}
+
+QJsonArray StandbyClient::laneGames() const
+{
+    QJsonArray lanes;
+    for (const QJsonObject &lane : m_laneGames) {
+        lanes.append(lane);
+    }
+    return lanes;
+}
+
+void StandbyClient::send(const QString &type, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    m_socket->write(QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n");
+}
+
+void StandbyClient::onConnected()
+{
+    qDebug() << "Following primary" << m_host << m_port << "from change" << m_appliedId;
+    m_lastHeard.restart();
+
+    QJsonObject hello;
+    hello["instance"] = m_primaryInstance;
+    hello["last_id"] = m_appliedId;
+    hello["schema"] = SchemaMigrator::latestVersion();
+    send("replica_hello", hello);
+}
+
+void StandbyClient::checkPrimary()
+{
+    if (m_tookOver) {
+        return;
+    }
+
+    if (m_synced && m_lastHeard.elapsed() > FAILOVER_TIMEOUT) {
+        qWarning() << "Primary silent for" << m_lastHeard.elapsed() << "ms, taking over at change" << m_appliedId;
+        m_tookOver = true;
+        m_checkTimer->stop();
+        m_socket->abort();
+        emit takeoverRequired();
+        return;
+    }
+
+    // Keep knocking; a primary that comes straight back is followed again
+    if (m_socket->state() == QAbstractSocket::UnconnectedState) {
+        m_socket->connectToHost(m_host, m_port);
+    }
+}
+
+void StandbyClient::onReadyRead()
+{
+    while (m_socket->canReadLine()) {
+        const QJsonObject message = QJsonDocument::fromJson(m_socket->readLine()).object();
+        m_lastHeard.restart();
+        processMessage(message["type"].toString(), message["data"].toObject());
+    }
+}
+
+void StandbyClient::processMessage(const QString &type, const QJsonObject &data)
+{
+    if (type == "replica_welcome") {
+        m_primaryInstance = data["instance"].toString();
+        m_welcomeId = static_cast<qint64>(data["last_id"].toDouble());
+        if (data["full_sync"].toBool()) {
+            // Nothing to catch up from until the copy has fully landed
+            m_synced = false;
+            m_fullCopy = true;
+            m_appliedId = 0;
+            qDebug() << "Copying primary database at change" << m_welcomeId;
+        }
+    } else if (type == "replica_table") {
+        if (!m_log->loadTable(data, data["reset"].toBool())) {
+            qCritical() << "Failed to load" << data["table"].toString() << "from primary";
+            m_socket->abort();
+        }
+    } else if (type == "replica_lanes") {
+        // Last message of the hello exchange, so the copy is complete
+        m_laneGames.clear();
+        for (const QJsonValue &lane : data["lanes"].toArray()) {
+            m_laneGames.insert(lane.toObject()["lane_id"].toInt(), lane.toObject());
+        }
+        m_appliedId = m_welcomeId;
+        if (m_fullCopy) {
+            // search_index is not replicated; refill it from the copied rows
+            SchemaMigrator migrator(m_log->database());
+            if (!migrator.rebuildSearchIndex()) {
+                qWarning() << "Failed to rebuild search index after copy";
+            }
+            m_fullCopy = false;
+        }
+        if (!m_synced) {
+            m_synced = true;
+            emit synced(m_appliedId);
+        }
+    } else if (type == "replica_lane") {
+        if (data["game_type"].toString().isEmpty()) {
+            m_laneGames.remove(data["lane_id"].toInt());
+        } else {
+            m_laneGames.insert(data["lane_id"].toInt(), data);
+        }
+    } else if (type == "replica_changes") {
+        if (!m_log->applyChanges(data)) {
+            qCritical() << "Failed to apply changes" << data["from"].toDouble() << "to" << data["to"].toDouble();
+            m_socket->abort();     // Reconnects and catches up from the last good change
+            return;
+        }
+        m_appliedId = static_cast<qint64>(data["to"].toDouble());
+
+        QJsonObject ack;
+        ack["last_id"] = m_appliedId;
+        send("replica_ack", ack);
+    } else if (type == "replica_error") {
+        qCritical() << "Primary refused standby:" << data["message"].toString();
+    }
+}
@@ -0,0 +1,65 @@
+﻿// StandbyClient.h
+#ifndef STANDBYCLIENT_H
+#define STANDBYCLIENT_H
+
+#include <QObject>
+#include <QString>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QElapsedTimer>
+#include "ReplicationLog.h"
+
+// Standby side of ReplicationServer. Applies the primary's table copy and
+// change stream to the local database and keeps the game each lane is
+// bowling. Once it has a complete copy, FAILOVER_TIMEOUT without hearing
+// from the primary - a dead process, host or link - makes it emit
+// takeoverRequired exactly once; the caller then starts the lane server.
+// The log position is only kept in memory, so a restarted standby copies
+// everything again.
+class StandbyClient : public QObject
+{
+    Q_OBJECT
+
+public:
+    StandbyClient(ReplicationLog *log, QObject *parent = nullptr);
+
+    void follow(const QString &host, quint16 port);
+    bool isSynced() const { return m_synced; }
+    qint64 appliedId() const { return m_appliedId; }
+    QJsonArray laneGames() const;       // As LaneServer::laneGames
+
+signals:
+    void synced(qint64 lastId);
+    void takeoverRequired();
+
+private slots:
+    void onConnected();
+    void onReadyRead();
+    void checkPrimary();
+
+private:
+    void processMessage(const QString &type, const QJsonObject &data);
+    void send(const QString &type, const QJsonObject &data);
+
+    static constexpr int FAILOVER_TIMEOUT = 3000;
+    static constexpr int CHECK_INTERVAL = 500;
+
+    ReplicationLog *m_log;
+    QTcpSocket *m_socket;
+    QTimer *m_checkTimer;
+    QElapsedTimer m_lastHeard;
+    QString m_host;
+    quint16 m_port;
+    QString m_primaryInstance;
+    qint64 m_appliedId;
+    qint64 m_welcomeId;                 // Position the current hello exchange brings us to
+    bool m_synced;
+    bool m_fullCopy;                    // Tables were copied; search index needs a rebuild
+    bool m_tookOver;
+    QMap<int, QJsonObject> m_laneGames; // laneId -> {lane_id, game_type, game}
+};
+
+#endif // STANDBYCLIENT_H
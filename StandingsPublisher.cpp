@@ -0,0 +1,197 @@
+﻿// StandingsPublisher.cpp
+#include "StandingsPublisher.h"
+#include "LaneServer.h"
+#include "LeagueManager.h"
+#include <QJsonObject>
+#include <QTimer>
+#include <QDebug>
+
+StandingsPublisher::StandingsPublisher(LaneServer *laneServer, LeagueManager *leagueManager, QObject *parent)
+    : QObject(parent)
+    , m_laneServer(laneServer)
+    , m_leagueManager(leagueManager)
+    , m_minIntervalMs(2000)
+{
+}
+
+void StandingsPublisher::subscribe(int laneId, int leagueId)
+{
+    if (leagueId <= 0) {
+        return;
+    }
+    if (m_laneLeague.value(laneId) == leagueId) {
+        return;
+    }
+
+    unsubscribe(laneId);
+    m_laneLeague[laneId] = leagueId;
+
+    LeagueFeed &feed = m_feeds[leagueId];
+    feed.laneVersions[laneId] = -1;
+
+    // A current snapshot can go out straight away; otherwise the next flush covers this lane
+    if (!feed.dirty && feed.version > 0) {
+        sendFull(leagueId, feed, {laneId});
+    } else {
+        markChanged(leagueId);
+    }
+}
+
+void StandingsPublisher::unsubscribe(int laneId)
+{
+    auto lane = m_laneLeague.find(laneId);
+    if (lane == m_laneLeague.end()) {
+        return;
+    }
+
+    const int leagueId = lane.value();
+    m_laneLeague.erase(lane);
+
+    auto feed = m_feeds.find(leagueId);
+    if (feed != m_feeds.end()) {
+        feed->laneVersions.remove(laneId);
+        if (feed->laneVersions.isEmpty()) {
+            m_feeds.erase(feed);
+        }
+    }
+}
+
+void StandingsPublisher::markChanged(int leagueId)
+{
+    auto it = m_feeds.find(leagueId);
+    if (it == m_feeds.end()) {
+        return; // Nobody is watching this league
+    }
+
+    LeagueFeed &feed = it.value();
+    feed.dirty = true;
+    if (feed.flushScheduled) {
+        return;
+    }
+
+    // Games finishing together within the interval share one push
+    int delay = 0;
+    if (feed.lastPush.isValid()) {
+        delay = qMax(0, m_minIntervalMs - static_cast<int>(feed.lastPush.elapsed()));
+    }
+
+    feed.flushScheduled = true;
+    QTimer::singleShot(delay, this, [this, leagueId]() {
+        flush(leagueId);
+    });
+}
+
+bool StandingsPublisher::refreshSnapshot(int leagueId, LeagueFeed &feed, QJsonArray *changed, QJsonArray *removed)
+{
+    if (!feed.dirty) {
+        return false;
+    }
+    feed.dirty = false;
+
+    const QJsonArray teams = m_leagueManager->getLeagueStandings(leagueId)["teams"].toArray();
+
+    QVector<QJsonArray> rows;
+    QHash<QString, QJsonArray> rowsByTeam;
+    rows.reserve(teams.size());
+
+    int pointsAbove = 0;
+    for (int i = 0; i < teams.size(); ++i) {
+        const QJsonObject team = teams[i].toObject();
+        const QString name = team["team_name"].toString();
+        const int points = team["total_points"].toInt();
+
+        QJsonArray row;
+        row << team["rank"].toInt() << name << points << team["wins"].toInt() << team["losses"].toInt()
+            << (i == 0 ? 0 : pointsAbove - points);
+        pointsAbove = points;
+
+        if (feed.rowsByTeam.value(name) != row) {
+            changed->append(row);
+        }
+        rows.append(row);
+        rowsByTeam.insert(name, row);
+    }
+
+    for (auto it = feed.rowsByTeam.constBegin(); it != feed.rowsByTeam.constEnd(); ++it) {
+        if (!rowsByTeam.contains(it.key())) {
+            removed->append(it.key());
+        }
+    }
+
+    if (feed.version > 0 && changed->isEmpty() && removed->isEmpty()) {
+        return false;
+    }
+
+    feed.rows = rows;
+    feed.rowsByTeam = rowsByTeam;
+    feed.version++;
+    return true;
+}
+
+void StandingsPublisher::flush(int leagueId)
+{
+    auto it = m_feeds.find(leagueId);
+    if (it == m_feeds.end()) {
+        return;
+    }
+
+    LeagueFeed &feed = it.value();
+    feed.flushScheduled = false;
+
+    QJsonArray changed;
+    QJsonArray removed;
+    const bool updated = refreshSnapshot(leagueId, feed, &changed, &removed);
+
+    QVector<int> deltaLanes;
+    QVector<int> fullLanes;
+    for (auto lane = feed.laneVersions.constBegin(); lane != feed.laneVersions.constEnd(); ++lane) {
+        if (lane.value() == feed.version) {
+            continue;
+        }
+        if (updated && lane.value() == feed.version - 1) {
+            deltaLanes.append(lane.key());
+        } else {
+            fullLanes.append(lane.key());
+        }
+    }
+
+    if (!deltaLanes.isEmpty()) {
+        QJsonObject delta;
+        delta["league_id"] = leagueId;
+        delta["version"] = feed.version;
+        delta["base"] = feed.version - 1;
+        delta["count"] = feed.rows.size();
+        delta["rows"] = changed;
+        delta["removed"] = removed;
+
+        m_laneServer->broadcastToLanes(LaneGroup::lanes(deltaLanes), "standings_update", delta);
+        for (int laneId : deltaLanes) {
+            feed.laneVersions[laneId] = feed.version;
+        }
+    }
+
+    if (!fullLanes.isEmpty()) {
+        sendFull(leagueId, feed, fullLanes);
+    }
+
+    feed.lastPush.start();
+}
+
+void StandingsPublisher::sendFull(int leagueId, LeagueFeed &feed, const QVector<int> &laneIds)
+{
+    QJsonArray rows;
+    for (const QJsonArray &row : feed.rows) {
+        rows.append(row);
+    }
+
+    QJsonObject full;
+    full["league_id"] = leagueId;
+    full["version"] = feed.version;
+    full["full"] = true;
+    full["rows"] = rows;
+
+    m_laneServer->broadcastToLanes(LaneGroup::lanes(laneIds), "standings_update", full);
+    for (int laneId : laneIds) {
+        feed.laneVersions[laneId] = feed.version;
+    }
+}
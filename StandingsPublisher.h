@@ -0,0 +1,59 @@
+﻿// StandingsPublisher.h
+#ifndef STANDINGSPUBLISHER_H
+#define STANDINGSPUBLISHER_H
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+#include <QMap>
+#include <QHash>
+#include <QSet>
+#include <QJsonArray>
+#include <QElapsedTimer>
+
+class LaneServer;
+class LeagueManager;
+
+// Pushes league standings to the lanes bowling that league. Standings are
+// computed once per change into a cached snapshot of compact rows
+// [rank, team, points, wins, losses, points behind the team above]. Changes
+// are coalesced and pushed at most once per interval; a lane that already
+// holds the previous version gets only the rows that changed, anything else
+// gets the full snapshot.
+class StandingsPublisher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StandingsPublisher(LaneServer *laneServer, LeagueManager *leagueManager, QObject *parent = nullptr);
+
+    void subscribe(int laneId, int leagueId);
+    void unsubscribe(int laneId);
+    void markChanged(int leagueId);
+
+    void setMinInterval(int ms) { m_minIntervalMs = ms; }
+    int subscriberCount(int leagueId) const { return m_feeds.value(leagueId).laneVersions.size(); }
+
+private:
+    struct LeagueFeed {
+        QVector<QJsonArray> rows;
+        QHash<QString, QJsonArray> rowsByTeam;
+        int version = 0;                // 0 until the first snapshot is built
+        bool dirty = true;
+        bool flushScheduled = false;
+        QElapsedTimer lastPush;
+        QHash<int, int> laneVersions;   // laneId -> version it last received
+    };
+
+    bool refreshSnapshot(int leagueId, LeagueFeed &feed, QJsonArray *changed, QJsonArray *removed);
+    void flush(int leagueId);
+    void sendFull(int leagueId, LeagueFeed &feed, const QVector<int> &laneIds);
+
+    LaneServer *m_laneServer;
+    LeagueManager *m_leagueManager;
+    QMap<int, LeagueFeed> m_feeds;      // leagueId -> feed
+    QHash<int, int> m_laneLeague;       // laneId -> leagueId
+    int m_minIntervalMs;
+};
+
+#endif // STANDINGSPUBLISHER_H
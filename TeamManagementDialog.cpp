@@ -732,7 +732,6 @@ bool AddTeamDialog::validateInput()
 AddBowlersToTeamDialog::AddBowlersToTeamDialog(int teamId, const QVector<BowlerData> &availableBowlers, QWidget *parent)
     : QDialog(parent)
     , m_teamId(teamId)
-    , m_bowlers(availableBowlers)
 {
     setupUI();
     setWindowTitle("Add Bowlers to Team");
@@ -746,7 +745,8 @@ AddBowlersToTeamDialog::AddBowlersToTeamDialog(int teamId, const QVector<BowlerD
     int y = (screenGeometry.height() - height()) / 2;
     move(x, y);
     
-    updateAvailableBowlers();
+    m_bowlersModel->setBowlers(BowlerListModel::fromBowlerData(availableBowlers));
+    updateSelectedCount();
 }
 
 void AddBowlersToTeamDialog::setupUI()
@@ -792,17 +792,23 @@ void AddBowlersToTeamDialog::setupUI()
     listLabel->setStyleSheet("QLabel { color: white; font-weight: bold; }");
     m_mainLayout->addWidget(listLabel);
     
-    m_availableBowlersList = new QListWidget;
-    m_availableBowlersList->setStyleSheet("QListWidget { "
+    m_bowlersModel = new BowlerListModel({BowlerListModel::SummaryColumn}, this);
+    m_bowlersProxy = new BowlerFilterProxyModel(this);
+    m_bowlersProxy->setSourceModel(m_bowlersModel);
+    
+    m_availableBowlersView = new QListView;
+    m_availableBowlersView->setStyleSheet("QListView { "
                                          "background-color: #1a1a1a; "
                                          "color: white; "
                                          "border: 1px solid #333; "
                                          "selection-background-color: #4A90E2; "
                                          "}");
-    m_availableBowlersList->setSelectionMode(QAbstractItemView::MultiSelection);
-    connect(m_availableBowlersList, &QListWidget::itemSelectionChanged, 
+    m_availableBowlersView->setUniformItemSizes(true);
+    m_availableBowlersView->setModel(m_bowlersProxy);
+    m_availableBowlersView->setSelectionMode(QAbstractItemView::MultiSelection);
+    connect(m_availableBowlersView->selectionModel(), &QItemSelectionModel::selectionChanged,
             this, &AddBowlersToTeamDialog::updateSelectedCount);
-    m_mainLayout->addWidget(m_availableBowlersList);
+    m_mainLayout->addWidget(m_availableBowlersView);
     
     // Selection buttons
     QHBoxLayout *selectionLayout = new QHBoxLayout;
@@ -876,13 +882,10 @@ void AddBowlersToTeamDialog::setupUI()
 QVector<int> AddBowlersToTeamDialog::getSelectedBowlerIds() const
 {
     QVector<int> selectedIds;
-    QList<QListWidgetItem*> selectedItems = m_availableBowlersList->selectedItems();
+    const QModelIndexList selectedRows = m_availableBowlersView->selectionModel()->selectedRows();
     
-    for (QListWidgetItem* item : selectedItems) {
-        int row = m_availableBowlersList->row(item);
-        if (m_bowlerIdMap.contains(row)) {
-            selectedIds.append(m_bowlerIdMap[row]);
-        }
+    for (const QModelIndex &index : selectedRows) {
+        selectedIds.append(index.data(BowlerListModel::BowlerIdRole).toInt());
     }
     
     return selectedIds;
@@ -890,18 +893,18 @@ QVector<int> AddBowlersToTeamDialog::getSelectedBowlerIds() const
 
 void AddBowlersToTeamDialog::onSearchTextChanged(const QString &text)
 {
-    Q_UNUSED(text)
-    updateAvailableBowlers();
+    m_bowlersProxy->setSearchText(text);
+    updateSelectedCount();
 }
 
 void AddBowlersToTeamDialog::onSelectAllClicked()
 {
-    m_availableBowlersList->selectAll();
+    m_availableBowlersView->selectAll();
 }
 
 void AddBowlersToTeamDialog::onDeselectAllClicked()
 {
-    m_availableBowlersList->clearSelection();
+    m_availableBowlersView->clearSelection();
 }
 
 void AddBowlersToTeamDialog::onSaveClicked()
@@ -920,38 +923,9 @@ void AddBowlersToTeamDialog::onCancelClicked()
     reject();
 }
 
-void AddBowlersToTeamDialog::updateAvailableBowlers()
-{
-    QString searchFilter = m_searchEdit->text();
-    
-    m_availableBowlersList->clear();
-    m_bowlerIdMap.clear();
-    
-    for (int i = 0; i < m_bowlers.size(); ++i) {
-        const BowlerData &bowler = m_bowlers[i];
-        
-        // Apply search filter
-        QString fullName = QString("%1 %2").arg(bowler.firstName).arg(bowler.lastName);
-        if (!searchFilter.isEmpty() && 
-            !fullName.contains(searchFilter, Qt::CaseInsensitive)) {
-            continue;
-        }
-        
-        QString displayText = QString("%1 %2 - Avg: %3")
-                             .arg(bowler.firstName)
-                             .arg(bowler.lastName)
-                             .arg(bowler.average > 0 ? QString::number(bowler.average) : "N/A");
-        
-        m_availableBowlersList->addItem(displayText);
-        m_bowlerIdMap[m_availableBowlersList->count() - 1] = bowler.id;
-    }
-    
-    updateSelectedCount();
-}
-
 void AddBowlersToTeamDialog::updateSelectedCount()
 {
-    int selectedCount = m_availableBowlersList->selectedItems().size();
+    int selectedCount = m_availableBowlersView->selectionModel()->selectedRows().size();
     m_selectedCountLabel->setText(QString("Selected: %1").arg(selectedCount));
     m_saveBtn->setEnabled(selectedCount > 0);
 }
\ No newline at end of file
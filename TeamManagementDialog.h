@@ -8,6 +8,7 @@
 #include <QGridLayout>
 #include <QSplitter>
 #include <QListWidget>
+#include <QListView>
 #include <QLabel>
 #include <QLineEdit>
 #include <QPushButton>
@@ -22,6 +23,7 @@
 #include <QScreen>
 #include <QAbstractItemView>
 #include "DatabaseManager.h"
+#include "BowlerListModel.h"
 
 class MainWindow; 
 
@@ -137,23 +139,21 @@ private slots:
 
 private:
     void setupUI();
-    void updateAvailableBowlers();
     
     int m_teamId;
-    QVector<BowlerData> m_bowlers;
     QVBoxLayout *m_mainLayout;
     QHBoxLayout *m_searchLayout;
     QHBoxLayout *m_buttonLayout;
     
     QLineEdit *m_searchEdit;
-    QListWidget *m_availableBowlersList;
+    QListView *m_availableBowlersView;
+    BowlerListModel *m_bowlersModel;
+    BowlerFilterProxyModel *m_bowlersProxy;
     QLabel *m_selectedCountLabel;
     QPushButton *m_selectAllBtn;
     QPushButton *m_deselectAllBtn;
     QPushButton *m_saveBtn;
     QPushButton *m_cancelBtn;
-    
-    QMap<int, int> m_bowlerIdMap; // Maps list index to bowler ID
 };
 
 #endif // TEAMMANAGEMENTDIALOG_H
\ No newline at end of file
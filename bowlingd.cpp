@@ -0,0 +1,111 @@
+﻿// bowlingd.cpp
+// Headless lane server for the back-office machine: LaneServer, LeagueManager
+// and the database under a QCoreApplication, linked against bowling_core only.
+//
+// Ports, from the lane port P: consoles on P + 1, a hot standby on P + 2.
+//   bowlingd --port 50005 --data-dir /srv/bowling/a
+//   bowlingd --port 50015 --data-dir /srv/bowling/b --standby-of 127.0.0.1:50005
+// The standby copies the primary's database and lane games. If the primary
+// goes silent it takes over the primary's lane port, consoles on the port
+// above, so lanes reconnect to it as they would to a restarted primary. Only
+// if that port cannot be bound does it serve on its own --port.
+#include <QCoreApplication>
+#include <QTextStream>
+#include <QSqlDatabase>
+#include "DatabaseManager.h"
+#include "LaneServer.h"
+#include "ReplicationLog.h"
+#include "ReplicationServer.h"
+#include "StandbyClient.h"
+
+namespace {
+
+QString argumentValue(const QStringList &arguments, const QString &name)
+{
+    int index = arguments.indexOf(name);
+    return index >= 0 && index + 1 < arguments.size() ? arguments[index + 1] : QString();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // Same names as the GUI so both resolve the same bowling.db
+    app.setApplicationName("Centre Bowling Management");
+    app.setApplicationVersion("1.0");
+    app.setOrganizationName("Centre Bowling");
+
+    // --port N: lane port, 50005 by default
+    QStringList arguments = app.arguments();
+    quint16 port = 50005;
+    if (!argumentValue(arguments, "--port").isEmpty()) {
+        port = static_cast<quint16>(argumentValue(arguments, "--port").toUInt());
+    }
+
+    // --data-dir DIR: somewhere other than the per-user data directory, e.g.
+    // for a primary and a standby on one machine
+    if (!argumentValue(arguments, "--data-dir").isEmpty()) {
+        DatabaseManager::setDataDirectory(argumentValue(arguments, "--data-dir"));
+    }
+
+    DatabaseManager::instance();    // Opens and migrates bowling.db
+
+    ReplicationLog log(QSqlDatabase::database());
+    if (!log.install()) {
+        return 1;
+    }
+
+    LaneServer *server = nullptr;
+    ReplicationServer *replication = nullptr;
+    auto serve = [&](const QJsonArray &laneGames, const QVector<quint16> &ports) {
+        server = new LaneServer();
+        for (const QJsonValue &value : laneGames) {
+            const QJsonObject lane = value.toObject();
+            server->setLaneGame(lane["lane_id"].toInt(), lane["game_type"].toString(), lane["game"].toObject());
+        }
+        const quint16 lanePort = server->startFirstFree(ports);
+        if (lanePort == 0) {
+            QTextStream(stderr) << "bowlingd: cannot listen on port " << ports.last() << "\n";
+            return false;
+        }
+        if (lanePort != ports.first()) {
+            QTextStream(stderr) << "bowlingd: port " << ports.first() << " is taken, serving lanes on "
+                                << lanePort << "\n";
+        }
+        replication = new ReplicationServer(server, &log);
+        replication->listen(lanePort + 2);
+        return true;
+    };
+
+    // --standby-of HOST:PORT: follow the primary whose lane port is PORT
+    StandbyClient *standby = nullptr;
+    const QString primary = argumentValue(arguments, "--standby-of");
+    if (primary.isEmpty()) {
+        if (!serve(QJsonArray(), {port})) {
+            return 1;
+        }
+    } else {
+        const int colon = primary.lastIndexOf(':');
+        const QString host = colon > 0 ? primary.left(colon) : primary;
+        const quint16 primaryPort = colon > 0 ? static_cast<quint16>(primary.mid(colon + 1).toUInt()) : 50005;
+
+        standby = new StandbyClient(&log);
+        QObject::connect(standby, &StandbyClient::takeoverRequired, [&, primaryPort]() {
+            // Lanes keep reconnecting to the primary's port; a standby on
+            // another machine needs the primary's address moved to it
+            if (!serve(standby->laneGames(), {primaryPort, port})) {
+                app.exit(1);
+            }
+        });
+        standby->follow(host, primaryPort + 2);
+    }
+
+    int result = app.exec();
+
+    delete standby;
+    delete replication;
+    delete server;
+    return result;
+}
@@ -2,6 +2,9 @@
 #include <QStyleFactory>
 #include <QDir>
 #include "MainWindow.h"
+#include "DatabaseManager.h"
+#include "QueryPlanAudit.h"
+#include <QTextStream>
 
 int main(int argc, char *argv[])
 {
@@ -12,6 +15,29 @@ int main(int argc, char *argv[])
     app.setApplicationVersion("1.0");
     app.setOrganizationName("Centre Bowling");
     
+    // --audit-queries [--audit-rows N]: report full table scans and exit
+    QStringList arguments = app.arguments();
+    if (arguments.contains("--audit-queries")) {
+        int rows = 20000;
+        int rowsIndex = arguments.indexOf("--audit-rows");
+        if (rowsIndex >= 0 && rowsIndex + 1 < arguments.size()) {
+            rows = qMax(1, arguments[rowsIndex + 1].toInt());
+        }
+        
+        DatabaseManager::instance();    // Opens and migrates bowling.db
+        return QueryPlanAudit::runFromCommandLine(rows);
+    }
+    
+    // --rebuild-rollups: recompute the reporting rollups from all recorded games
+    if (arguments.contains("--rebuild-rollups")) {
+        RollupRebuildResult result = DatabaseManager::instance()->rebuildRollups();
+        QTextStream(stdout) << (result.success ? "Rebuilt" : "Failed to rebuild") << " rollups from "
+                            << result.from.toString(Qt::ISODate) << " to " << result.to.toString(Qt::ISODate)
+                            << ": " << result.gamesRead << " games on " << result.threadCount << " threads in "
+                            << result.elapsedMs << " ms\n";
+        return result.success ? 0 : 1;
+    }
+    
     // Set dark theme
     app.setStyle(QStyleFactory::create("Fusion"));
     QPalette darkPalette;
@@ -30,7 +56,14 @@ int main(int argc, char *argv[])
     darkPalette.setColor(QPalette::HighlightedText, Qt::black);
     app.setPalette(darkPalette);
     
-    MainWindow window;
+    // --attach host[:port]: console of a running bowlingd (console port 50006 by default)
+    QString attachAddress;
+    int attachIndex = arguments.indexOf("--attach");
+    if (attachIndex >= 0 && attachIndex + 1 < arguments.size()) {
+        attachAddress = arguments[attachIndex + 1];
+    }
+    
+    MainWindow window(nullptr, attachAddress);
     window.show();
     
     return app.exec();
@@ -0,0 +1,79 @@
+﻿// bench_leaguescheduler.cpp
+#include <QtTest>
+#include "LeagueScheduler.h"
+
+class LeagueSchedulerBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void buildSeason_data();
+    void buildSeason();
+    void validateSeason_data();
+    void validateSeason();
+};
+
+namespace {
+
+void addSeasonSizes()
+{
+    QTest::addColumn<int>("teams");
+    QTest::addColumn<int>("weeks");
+
+    QTest::newRow("12 teams, 33 weeks") << 12 << 33;
+    QTest::newRow("24 teams, 36 weeks") << 24 << 36;
+    QTest::newRow("41 teams, 52 weeks") << 41 << 52;
+    QTest::newRow("64 teams, 52 weeks") << 64 << 52;
+}
+
+QVector<int> teamRange(int count)
+{
+    QVector<int> teamIds;
+    for (int i = 1; i <= count; ++i) {
+        teamIds.append(i);
+    }
+    return teamIds;
+}
+
+} // namespace
+
+void LeagueSchedulerBenchmark::buildSeason_data()
+{
+    addSeasonSizes();
+}
+
+void LeagueSchedulerBenchmark::buildSeason()
+{
+    QFETCH(int, teams);
+    QFETCH(int, weeks);
+    const QVector<int> teamIds = teamRange(teams);
+
+    QVector<ScheduledWeek> season;
+    QBENCHMARK {
+        season = LeagueScheduler::buildSeason(teamIds, weeks, teams / 2);
+    }
+    QCOMPARE(season.size(), weeks);
+}
+
+void LeagueSchedulerBenchmark::validateSeason_data()
+{
+    addSeasonSizes();
+}
+
+void LeagueSchedulerBenchmark::validateSeason()
+{
+    QFETCH(int, teams);
+    QFETCH(int, weeks);
+    const QVector<int> teamIds = teamRange(teams);
+    const QVector<ScheduledWeek> season = LeagueScheduler::buildSeason(teamIds, weeks, teams / 2);
+
+    QStringList problems;
+    QBENCHMARK {
+        problems = LeagueScheduler::validateSeason(season, teamIds, teams / 2);
+    }
+    QVERIFY(problems.isEmpty());
+}
+
+QTEST_APPLESS_MAIN(LeagueSchedulerBenchmark)
+
+#include "bench_leaguescheduler.moc"
@@ -0,0 +1,114 @@
+﻿// bench_leaguesimulator.cpp
+#include <QtTest>
+#include "LeagueSimulator.h"
+
+class LeagueSimulatorBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void run_data();
+    void run();
+};
+
+namespace {
+
+const int BOWLERS_PER_TEAM = 4;
+
+// A season with every game bowled; about one score in twenty is an absence
+SeasonReplayData buildSeason(int teams, int weeks)
+{
+    SeasonReplayData season;
+    season.leagueId = 1;
+    season.gamesPerWeek = 3;
+    season.teamBowlers.resize(teams);
+    for (int team = 0; team < teams; ++team) {
+        season.teamIds.append(team + 1);
+        season.teamNames.append(QString("Team %1").arg(team + 1));
+        for (int i = 0; i < BOWLERS_PER_TEAM; ++i) {
+            season.teamBowlers[team].append(season.bowlerIds.size());
+            season.bowlerTeam.append(team);
+            season.bowlerIds.append(season.bowlerIds.size() + 1);
+        }
+    }
+
+    quint32 seed = 12345;
+    auto nextRandom = [&seed]() {
+        seed = seed * 1103515245u + 12345u;
+        return int((seed >> 16) & 0x7fff);
+    };
+
+    const int cells = season.bowlerIds.size() * season.gamesPerWeek;
+    for (int w = 0; w < weeks; ++w) {
+        SeasonReplayData::Week week;
+        week.weekNumber = w + 1;
+        // Circle method: team 0 stays put, the rest rotate
+        for (int i = 0; i < teams / 2; ++i) {
+            const int a = i == 0 ? 0 : 1 + (i - 1 + w) % (teams - 1);
+            const int b = 1 + (teams - 2 - i + w) % (teams - 1);
+            week.matchups.append(qMakePair(a, b));
+        }
+        week.scores.resize(cells);
+        week.balls.resize(cells);
+        for (int cell = 0; cell < cells; ++cell) {
+            const bool absent = nextRandom() % 20 == 0;
+            week.scores[cell] = absent ? -1 : 120 + nextRandom() % 130;
+            week.balls[cell] = absent ? 0 : 15 + nextRandom() % 6;
+        }
+        season.weeks.append(week);
+    }
+    return season;
+}
+
+QVector<WhatIfVariant> variants()
+{
+    QVector<WhatIfVariant> list;
+
+    WhatIfVariant ninety{QStringLiteral("90% of 230"), LeagueConfig()};
+    ninety.config.hdcpCalc.highValue = 230;
+    ninety.config.hdcpCalc.percentage = 0.9;
+    list.append(ninety);
+
+    WhatIfVariant perBall{QStringLiteral("Average per ball"), LeagueConfig()};
+    perBall.config.avgCalc.type = LeagueConfig::AverageCalculation::TotalPinsPerBall;
+    list.append(perBall);
+
+    WhatIfVariant teamVs{QStringLiteral("Team vs team points"), LeagueConfig()};
+    teamVs.config.pointSystem.type = LeagueConfig::PointSystem::TeamVsTeam;
+    list.append(teamVs);
+
+    return list;
+}
+
+} // namespace
+
+void LeagueSimulatorBenchmark::run_data()
+{
+    QTest::addColumn<int>("teams");
+    QTest::addColumn<int>("weeks");
+
+    QTest::newRow("12 teams, 33 weeks") << 12 << 33;
+    QTest::newRow("24 teams, 36 weeks") << 24 << 36;
+}
+
+// A full season under the current rules and three variants in under a second
+void LeagueSimulatorBenchmark::run()
+{
+    QFETCH(int, teams);
+    QFETCH(int, weeks);
+    const SeasonReplayData season = buildSeason(teams, weeks);
+    const QVector<WhatIfVariant> alternatives = variants();
+
+    WhatIfReport report;
+    QBENCHMARK {
+        report = LeagueSimulator::run(season, LeagueConfig(), alternatives);
+    }
+    QCOMPARE(report.weeksReplayed, weeks);
+    QCOMPARE(report.results.size(), alternatives.size() + 1);
+    QCOMPARE(report.results[0].standings.size(), teams);
+    QVERIFY2(report.elapsedMs < 1000, qPrintable(QString("%1 ms").arg(report.elapsedMs)));
+}
+
+QTEST_GUILESS_MAIN(LeagueSimulatorBenchmark)
+
+#include "bench_leaguesimulator.moc"
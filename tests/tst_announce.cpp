@@ -0,0 +1,172 @@
+﻿// tst_announce.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include "DatabaseManager.h"
+#include "LaneServer.h"
+
+class AnnounceTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+    void leagueAnnouncementReachesItsLanes();
+    void consoleAnnouncesToAllLanes();
+    void unsubscribedConsoleIgnored();
+
+private:
+    static quint16 freePort();
+    static bool connectTo(QTcpSocket &socket, quint16 port);
+    static void send(QTcpSocket &socket, const QJsonObject &message);
+    static QJsonObject waitForFrame(QTcpSocket &socket, const QString &type, int timeout = 3000);
+    static QJsonObject message(const QString &type, const QJsonObject &data);
+
+    QTemporaryDir m_dataDir;
+    LaneServer *m_server = nullptr;
+    quint16 m_port = 0;
+    QTcpSocket m_lanes[2];
+};
+
+void AnnounceTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    DatabaseManager::setDataDirectory(m_dataDir.path());
+    DatabaseManager::instance();
+    // Keyless, so the hub listens on loopback and takes any subscription
+    qunsetenv("BOWLING_CONSOLE_KEY");
+}
+
+quint16 AnnounceTest::freePort()
+{
+    QTcpServer probe;
+    return probe.listen(QHostAddress::LocalHost, 0) ? probe.serverPort() : 0;
+}
+
+bool AnnounceTest::connectTo(QTcpSocket &socket, quint16 port)
+{
+    socket.connectToHost(QHostAddress::LocalHost, port);
+    return QTest::qWaitFor([&socket]() { return socket.state() == QAbstractSocket::ConnectedState; }, 3000);
+}
+
+void AnnounceTest::send(QTcpSocket &socket, const QJsonObject &message)
+{
+    socket.write(QJsonDocument(message).toJson(QJsonDocument::Compact) + "\n");
+}
+
+QJsonObject AnnounceTest::message(const QString &type, const QJsonObject &data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    return message;
+}
+
+// Skips whatever else the server sends in between, e.g. standings
+QJsonObject AnnounceTest::waitForFrame(QTcpSocket &socket, const QString &type, int timeout)
+{
+    QJsonObject found;
+    QTest::qWaitFor([&]() {
+        while (socket.canReadLine()) {
+            const QJsonObject frame = QJsonDocument::fromJson(socket.readLine()).object();
+            if (frame["type"].toString() == type) {
+                found = frame;
+                return true;
+            }
+        }
+        return false;
+    }, timeout);
+    return found;
+}
+
+// Two lanes registered; lane 1 bowls a game for league 7, lane 2 a quick game
+void AnnounceTest::init()
+{
+    m_port = freePort();
+    QVERIFY(m_port > 0);
+    m_server = new LaneServer();
+    QVERIFY(m_server->start(m_port));
+
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY(connectTo(m_lanes[i], m_port));
+        QJsonObject registration;
+        registration["type"] = "registration";
+        registration["lane_id"] = i + 1;
+        registration["seq"] = 0;
+        send(m_lanes[i], registration);
+        QVERIFY(!waitForFrame(m_lanes[i], "registration_response").isEmpty());
+    }
+    QTRY_COMPARE(m_server->connectedLanes().size(), 2);
+
+    QJsonObject leagueGame;
+    leagueGame["league_id"] = 7;
+    m_server->setLaneGame(1, "league_game", leagueGame);
+    m_server->setLaneGame(2, "quick_game", QJsonObject());
+}
+
+void AnnounceTest::cleanup()
+{
+    for (QTcpSocket &lane : m_lanes) {
+        lane.abort();
+    }
+    delete m_server;
+    m_server = nullptr;
+}
+
+void AnnounceTest::leagueAnnouncementReachesItsLanes()
+{
+    const BroadcastStats stats = m_server->announce(LaneGroup::league(7), "Tournament starts in 5 minutes");
+    QCOMPARE(stats.recipients, 1);
+
+    const QJsonObject frame = waitForFrame(m_lanes[0], "display_message");
+    QCOMPARE(frame["data"].toObject()["text"].toString(), QString("Tournament starts in 5 minutes"));
+    QVERIFY(waitForFrame(m_lanes[1], "display_message", 200).isEmpty());
+}
+
+void AnnounceTest::consoleAnnouncesToAllLanes()
+{
+    QTcpSocket console;
+    QVERIFY(connectTo(console, m_port + 1));
+    QJsonObject subscribe;
+    subscribe["name"] = "front desk";
+    send(console, message("console_subscribe", subscribe));
+    QVERIFY(!waitForFrame(console, "console_snapshot").isEmpty());
+
+    QJsonObject announcement;
+    announcement["text"] = "Kitchen closes at ten";
+    send(console, message("console_announce", announcement));
+
+    const QJsonObject result = waitForFrame(console, "console_announce_result");
+    QCOMPARE(result["data"].toObject()["recipients"].toInt(), 2);
+    for (QTcpSocket &lane : m_lanes) {
+        QCOMPARE(waitForFrame(lane, "display_message")["data"].toObject()["text"].toString(),
+                 QString("Kitchen closes at ten"));
+    }
+
+    // Narrowed to one league from the console as well
+    announcement["text"] = "League tournament starting";
+    announcement["league_id"] = 7;
+    send(console, message("console_announce", announcement));
+    QCOMPARE(waitForFrame(console, "console_announce_result")["data"].toObject()["recipients"].toInt(), 1);
+    QVERIFY(!waitForFrame(m_lanes[0], "display_message").isEmpty());
+    QVERIFY(waitForFrame(m_lanes[1], "display_message", 200).isEmpty());
+}
+
+void AnnounceTest::unsubscribedConsoleIgnored()
+{
+    QTcpSocket console;
+    QVERIFY(connectTo(console, m_port + 1));
+    QJsonObject announcement;
+    announcement["text"] = "Free games for everyone";
+    send(console, message("console_announce", announcement));
+
+    QVERIFY(waitForFrame(console, "console_announce_result", 300).isEmpty());
+    QVERIFY(waitForFrame(m_lanes[0], "display_message", 200).isEmpty());
+}
+
+QTEST_GUILESS_MAIN(AnnounceTest)
+#include "tst_announce.moc"
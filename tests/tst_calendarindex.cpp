@@ -0,0 +1,107 @@
+﻿// tst_calendarindex.cpp
+#include <QtTest>
+#include <QThread>
+#include <memory>
+#include <vector>
+#include "CalendarIndex.h"
+
+class CalendarIndexTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void zeroLengthBookingIsRejected();
+    void bookingCrossesMidnight();
+    void firstFreeSlot();
+    void concurrentQueries();
+};
+
+void CalendarIndexTest::zeroLengthBookingIsRejected()
+{
+    const QDate date(2026, 3, 14);
+    const CalendarBooking empty = CalendarIndex::makeBooking(1, 1, date, QTime(18, 0), QTime(18, 0));
+    QVERIFY(!empty.isValid());
+
+    CalendarIndex index;
+    index.insert(empty);
+    QCOMPARE(index.size(), 0);
+    QVERIFY(index.isFree(1, CalendarIndex::toMinutes(date, QTime(12, 0)),
+                         CalendarIndex::toMinutes(date.addDays(1), QTime(12, 0))));
+}
+
+void CalendarIndexTest::bookingCrossesMidnight()
+{
+    const QDate date(2026, 3, 14);
+    CalendarIndex index;
+    index.insert(CalendarIndex::makeBooking(7, 2, date, QTime(22, 0), QTime(1, 30)));
+
+    const QDate nextDay = date.addDays(1);
+    QCOMPARE(index.conflicts(2, CalendarIndex::toMinutes(nextDay, QTime(1, 0)),
+                             CalendarIndex::toMinutes(nextDay, QTime(2, 0))), QVector<int>{7});
+    QVERIFY(index.isFree(2, CalendarIndex::toMinutes(nextDay, QTime(1, 30)),
+                         CalendarIndex::toMinutes(nextDay, QTime(3, 0))));
+    QVERIFY(index.isFree(2, CalendarIndex::toMinutes(date, QTime(0, 0)),
+                         CalendarIndex::toMinutes(date, QTime(22, 0))));
+    QVERIFY(index.isFree(2, CalendarIndex::toMinutes(date, QTime(21, 0)),
+                         CalendarIndex::toMinutes(date, QTime(23, 0)), 7));
+}
+
+void CalendarIndexTest::firstFreeSlot()
+{
+    const QDate date(2026, 3, 14);
+    CalendarIndex index;
+    index.insert(CalendarIndex::makeBooking(1, 1, date, QTime(17, 0), QTime(19, 0)));
+    index.insert(CalendarIndex::makeBooking(2, 2, date, QTime(17, 30), QTime(18, 30)));
+    index.insert(CalendarIndex::makeBooking(3, 3, date, QTime(16, 0), QTime(20, 0)));
+
+    QVector<int> lanes;
+    const qint64 start = index.firstFreeSlot({1, 2, 3}, 2, 60, CalendarIndex::toMinutes(date, QTime(17, 0)),
+                                             CalendarIndex::toMinutes(date, QTime(23, 0)), &lanes);
+    QCOMPARE(CalendarIndex::fromMinutes(start), QDateTime(date, QTime(19, 0)));
+    QCOMPARE(lanes, QVector<int>({1, 2}));
+
+    QCOMPARE(index.firstFreeSlot({3}, 1, 60, CalendarIndex::toMinutes(date, QTime(17, 0)),
+                                 CalendarIndex::toMinutes(date, QTime(18, 0))), qint64(-1));
+}
+
+void CalendarIndexTest::concurrentQueries()
+{
+    const QDate date(2026, 3, 14);
+    CalendarIndex index;
+    QAtomicInt stop(0);
+    QAtomicInt queries(0);
+
+    // Readers trigger the lazy rebuilds while the writer keeps dirtying the lanes
+    std::vector<std::unique_ptr<QThread>> readers;
+    for (int r = 0; r < 4; ++r) {
+        readers.emplace_back(QThread::create([&index, &stop, &queries, date]() {
+            while (!stop.loadAcquire()) {
+                for (int lane = 1; lane <= 4; ++lane) {
+                    index.conflicts(lane, CalendarIndex::toMinutes(date, QTime(0, 0)),
+                                    CalendarIndex::toMinutes(date.addDays(30), QTime(0, 0)));
+                }
+                queries.fetchAndAddRelaxed(1);
+            }
+        }));
+        readers.back()->start();
+    }
+
+    for (int i = 1; i <= 2000; ++i) {
+        const QDate day = date.addDays(i % 30);
+        index.insert(CalendarIndex::makeBooking(i, 1 + i % 4, day, QTime(i % 20, 0), QTime(i % 20, 30)));
+        if (i % 3 == 0) {
+            index.remove(i - 1);
+        }
+    }
+    stop.storeRelease(1);
+    for (auto &reader : readers) {
+        QVERIFY(reader->wait(10000));
+    }
+
+    QVERIFY(queries.loadRelaxed() > 0);
+    QCOMPARE(index.size(), 2000 - 2000 / 3);
+}
+
+QTEST_APPLESS_MAIN(CalendarIndexTest)
+
+#include "tst_calendarindex.moc"
@@ -0,0 +1,138 @@
+﻿// tst_eventbus.cpp
+#include <QtTest>
+#include <QThread>
+#include <QAtomicInt>
+#include "EventBus.h"
+
+namespace {
+
+struct StressEvent : BusEvent {
+    static constexpr BusChannel channel = BusChannel::System;
+    int sequence = 0;
+};
+
+const int PRODUCERS = 8;
+const int EVENTS_PER_PRODUCER = 20000;
+
+} // namespace
+
+class EventBusTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void deliversInOrder();
+    void multiProducerStress();
+    void crossThreadSubscriber();
+};
+
+void EventBusTest::deliversInOrder()
+{
+    EventBus bus;
+    QObject context;
+    QVector<int> received;
+    bus.subscribe<StressEvent>(&context, BusFilter::lane(2), [&received](const StressEvent &event) {
+        received.append(event.sequence);
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        StressEvent event;
+        event.laneId = 1 + i % 2;
+        event.sequence = i;
+        bus.publish(event);
+    }
+    QTRY_COMPARE(received.size(), 50);
+    for (int i = 0; i < received.size(); ++i) {
+        QCOMPARE(received[i], 2 * i + 1);
+    }
+}
+
+// Every producer's events arrive exactly once and in the order it published them
+void EventBusTest::multiProducerStress()
+{
+    EventBus bus;
+    QObject context;
+    QVector<int> lastSequence(PRODUCERS + 1, -1);
+    int received = 0;
+    int outOfOrder = 0;
+    bus.subscribe<StressEvent>(&context, BusFilter::any(), [&](const StressEvent &event) {
+        if (event.sequence != lastSequence[event.laneId] + 1) {
+            outOfOrder++;
+        }
+        lastSequence[event.laneId] = event.sequence;
+        received++;
+    });
+
+    QAtomicInt ready(0);
+    QList<QThread *> producers;
+    for (int p = 1; p <= PRODUCERS; ++p) {
+        producers.append(QThread::create([&bus, &ready, p]() {
+            // Start together so the head is contended
+            ready.fetchAndAddOrdered(1);
+            while (ready.loadAcquire() < PRODUCERS) {
+                QThread::yieldCurrentThread();
+            }
+            for (int i = 0; i < EVENTS_PER_PRODUCER; ++i) {
+                StressEvent event;
+                event.laneId = p;
+                event.sequence = i;
+                bus.publish(event);
+            }
+        }));
+    }
+    for (QThread *producer : producers) {
+        producer->start();
+    }
+
+    // Flushes run on this thread while the producers are still publishing
+    QTRY_COMPARE_WITH_TIMEOUT(received, PRODUCERS * EVENTS_PER_PRODUCER, 60000);
+    for (QThread *producer : producers) {
+        QVERIFY(producer->wait(10000));
+    }
+    qDeleteAll(producers);
+
+    QCOMPARE(outOfOrder, 0);
+    for (int p = 1; p <= PRODUCERS; ++p) {
+        QCOMPARE(lastSequence[p], EVENTS_PER_PRODUCER - 1);
+    }
+
+    // Nothing left behind once the producers are done
+    QCoreApplication::processEvents();
+    QCOMPARE(received, PRODUCERS * EVENTS_PER_PRODUCER);
+    const BusStats stats = bus.stats();
+    QCOMPARE(stats.published, quint64(PRODUCERS * EVENTS_PER_PRODUCER));
+    QCOMPARE(stats.delivered, stats.published);
+}
+
+void EventBusTest::crossThreadSubscriber()
+{
+    EventBus bus;
+    QThread worker;
+    QObject context;
+    context.moveToThread(&worker);
+    worker.start();
+
+    QAtomicInt received(0);
+    QAtomicInt wrongThread(0);
+    bus.subscribe<StressEvent>(&context, BusFilter::any(), [&](const StressEvent &) {
+        if (QThread::currentThread() != &worker) {
+            wrongThread.fetchAndAddRelaxed(1);
+        }
+        received.fetchAndAddRelaxed(1);
+    });
+
+    for (int i = 0; i < 1000; ++i) {
+        StressEvent event;
+        event.sequence = i;
+        bus.publish(event);
+    }
+    QTRY_COMPARE(received.loadAcquire(), 1000);
+    QCOMPARE(wrongThread.loadAcquire(), 0);
+
+    worker.quit();
+    QVERIFY(worker.wait());
+}
+
+QTEST_GUILESS_MAIN(EventBusTest)
+
+#include "tst_eventbus.moc"
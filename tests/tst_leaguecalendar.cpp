@@ -0,0 +1,80 @@
+﻿// tst_leaguecalendar.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include "DatabaseManager.h"
+
+class LeagueCalendarTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void scheduleAroundMidnight();
+
+private:
+    int book(const QDate &date, const QTime &start, const QTime &end, int laneId);
+
+    QTemporaryDir m_dataDir;
+    DatabaseManager *m_db = nullptr;
+};
+
+void LeagueCalendarTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    DatabaseManager::setDataDirectory(m_dataDir.path());
+    m_db = DatabaseManager::instance();
+    QVERIFY(QSqlDatabase::database().tables().contains("calendar_events"));
+}
+
+int LeagueCalendarTest::book(const QDate &date, const QTime &start, const QTime &end, int laneId)
+{
+    CalendarEventData event;
+    event.date = date;
+    event.startTime = start;
+    event.endTime = end;
+    event.laneId = laneId;
+    event.eventType = "Party";
+    event.title = QString("Lane %1 party").arg(laneId);
+    return m_db->addCalendarEvent(event);
+}
+
+void LeagueCalendarTest::scheduleAroundMidnight()
+{
+    // Three Tuesday nights, 21:00 until 00:30 the next morning
+    const QDate firstNight(2026, 1, 6);
+    const QTime start(21, 0);
+
+    // Lane 3: after midnight, inside week 1's night
+    const int afterMidnight = book(firstNight.addDays(1), QTime(0, 0), QTime(1, 0), 3);
+    // Lane 4: an evening booking that runs into week 2's start
+    const int evening = book(firstNight.addDays(7), QTime(17, 0), QTime(21, 30), 4);
+    // Lane 5: early morning on week 3's date, long before the league starts
+    const int earlyMorning = book(firstNight.addDays(14), QTime(0, 15), QTime(0, 45), 5);
+    // Lane 2: a late booking the night before week 2 that crosses into its date
+    const int nightBefore = book(firstNight.addDays(6), QTime(23, 0), QTime(2, 0), 2);
+    QVERIFY(afterMidnight > 0 && evening > 0 && earlyMorning > 0 && nightBefore > 0);
+
+    QVector<ScheduleConflict> conflicts;
+    const QVector<int> created = m_db->addLeagueSchedule(1, "Tuesday Mixed", firstNight, start, 210, 7, 3,
+                                                         {1, 2, 3, 4, 5}, "Secretary", "555-0100",
+                                                         QString(), QString(), &conflicts);
+
+    QCOMPARE(conflicts.size(), 2);
+    QCOMPARE(created.size(), 3 * 5 - 2);
+
+    QCOMPARE(conflicts[0].weekNumber, 1);
+    QCOMPARE(conflicts[0].laneId, 3);
+    QCOMPARE(conflicts[0].conflictingEventIds, QVector<int>{afterMidnight});
+    QCOMPARE(conflicts[1].weekNumber, 2);
+    QCOMPARE(conflicts[1].laneId, 4);
+    QCOMPARE(conflicts[1].conflictingEventIds, QVector<int>{evening});
+
+    // The new league nights hold their lanes past midnight, and no further
+    QVERIFY(!m_db->isLaneAvailable(firstNight.addDays(1), QTime(0, 10), QTime(0, 20), 1));
+    QVERIFY(m_db->isLaneAvailable(firstNight.addDays(1), QTime(0, 40), QTime(1, 0), 1));
+    QVERIFY(!m_db->isLaneAvailable(firstNight.addDays(15), QTime(0, 0), QTime(0, 30), 5));
+}
+
+QTEST_GUILESS_MAIN(LeagueCalendarTest)
+
+#include "tst_leaguecalendar.moc"
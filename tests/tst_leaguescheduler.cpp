@@ -0,0 +1,212 @@
+﻿// tst_leaguescheduler.cpp
+#include <QtTest>
+#include "LeagueScheduler.h"
+#include <algorithm>
+
+namespace {
+
+QVector<int> teamRange(int count)
+{
+    QVector<int> teamIds;
+    for (int i = 1; i <= count; ++i) {
+        teamIds.append(100 + i);    // Ids unrelated to positions, as in the database
+    }
+    return teamIds;
+}
+
+} // namespace
+
+class LeagueSchedulerTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void circleRoundsPairEveryTeamOnce_data();
+    void circleRoundsPairEveryTeamOnce();
+    void seasonInvariants_data();
+    void seasonInvariants();
+    void byesRotate();
+    void positionRoundWeeksAreLeftOpen();
+    void positionRoundPairsByRank();
+    void tooFewLaneSlots();
+    void validateSeasonReportsProblems();
+};
+
+void LeagueSchedulerTest::circleRoundsPairEveryTeamOnce_data()
+{
+    QTest::addColumn<int>("teams");
+    for (int teams : {2, 3, 4, 7, 10, 41, 48}) {
+        QTest::addRow("%d teams", teams) << teams;
+    }
+}
+
+void LeagueSchedulerTest::circleRoundsPairEveryTeamOnce()
+{
+    QFETCH(int, teams);
+    const QVector<int> teamIds = teamRange(teams);
+    const auto rounds = LeagueScheduler::circleRounds(teamIds);
+
+    const int ringSize = teams + teams % 2;
+    QCOMPARE(rounds.size(), ringSize - 1);
+
+    QHash<QPair<int, int>, int> pairCounts;
+    for (const auto &round : rounds) {
+        QCOMPARE(round.size(), ringSize / 2);
+
+        QSet<int> seen;
+        for (const auto &pair : round) {
+            QVERIFY(pair.first != pair.second);
+            QVERIFY(!seen.contains(pair.first));
+            QVERIFY(!seen.contains(pair.second));
+            seen.insert(pair.first);
+            seen.insert(pair.second);
+            pairCounts[qMakePair(qMin(pair.first, pair.second), qMax(pair.first, pair.second))]++;
+        }
+        QCOMPARE(seen.size(), ringSize);
+    }
+
+    // Every pairing, byes included, exactly once per cycle
+    QCOMPARE(pairCounts.size(), ringSize * (ringSize - 1) / 2);
+    for (int count : qAsConst(pairCounts)) {
+        QCOMPARE(count, 1);
+    }
+}
+
+void LeagueSchedulerTest::seasonInvariants_data()
+{
+    QTest::addColumn<int>("teams");
+    QTest::addColumn<int>("weeks");
+
+    QTest::newRow("8 teams, 30 weeks") << 8 << 30;
+    QTest::newRow("9 teams, 32 weeks") << 9 << 32;
+    QTest::newRow("24 teams, 36 weeks") << 24 << 36;
+    QTest::newRow("40 teams, 52 weeks") << 40 << 52;
+    QTest::newRow("41 teams, 52 weeks") << 41 << 52;
+    QTest::newRow("48 teams, 52 weeks") << 48 << 52;
+}
+
+void LeagueSchedulerTest::seasonInvariants()
+{
+    QFETCH(int, teams);
+    QFETCH(int, weeks);
+
+    const QVector<int> teamIds = teamRange(teams);
+    const int laneSlots = teams / 2;
+    const QVector<ScheduledWeek> season = LeagueScheduler::buildSeason(teamIds, weeks, laneSlots);
+
+    QCOMPARE(season.size(), weeks);
+    const QStringList problems = LeagueScheduler::validateSeason(season, teamIds, laneSlots);
+    QVERIFY2(problems.isEmpty(), qPrintable(problems.join('\n')));
+
+    QHash<int, QVector<int>> laneCounts;    // team -> games per lane slot
+    QHash<int, int> sideBalance;            // team -> team1 games minus team2 games
+    for (const ScheduledWeek &week : season) {
+        QCOMPARE(week.matchups.size(), teams / 2);
+        for (const ScheduledMatchup &matchup : week.matchups) {
+            for (int teamId : {matchup.team1Id, matchup.team2Id}) {
+                QVector<int> &counts = laneCounts[teamId];
+                counts.resize(laneSlots);
+                counts[matchup.slot]++;
+            }
+            sideBalance[matchup.team1Id]++;
+            sideBalance[matchup.team2Id]--;
+        }
+    }
+
+    // Lanes rotate: no team bowls on one slot much more than another
+    for (auto it = laneCounts.constBegin(); it != laneCounts.constEnd(); ++it) {
+        const auto bounds = std::minmax_element(it.value().constBegin(), it.value().constEnd());
+        QVERIFY2(*bounds.second - *bounds.first <= 4,
+                 qPrintable(QString("Team %1 lane counts spread %2..%3")
+                            .arg(it.key()).arg(*bounds.first).arg(*bounds.second)));
+    }
+
+    // Sides alternate between cycles
+    for (auto it = sideBalance.constBegin(); it != sideBalance.constEnd(); ++it) {
+        QVERIFY2(qAbs(it.value()) <= 2, qPrintable(QString("Team %1 side balance %2")
+                                                    .arg(it.key()).arg(it.value())));
+    }
+}
+
+void LeagueSchedulerTest::byesRotate()
+{
+    const QVector<int> teamIds = teamRange(11);
+    const QVector<ScheduledWeek> season = LeagueScheduler::buildSeason(teamIds, 33, 5);
+
+    QHash<int, int> byes;
+    for (const ScheduledWeek &week : season) {
+        QCOMPARE(week.byeTeamIds.size(), 1);
+        byes[week.byeTeamIds.first()]++;
+    }
+
+    // Three full cycles: every team sits out exactly three times
+    QCOMPARE(byes.size(), teamIds.size());
+    for (int count : qAsConst(byes)) {
+        QCOMPARE(count, 3);
+    }
+}
+
+void LeagueSchedulerTest::positionRoundWeeksAreLeftOpen()
+{
+    const QVector<int> teamIds = teamRange(6);
+    const QSet<int> positionRounds = {4, 10};
+    const QVector<ScheduledWeek> season = LeagueScheduler::buildSeason(teamIds, 12, 3, positionRounds);
+
+    QCOMPARE(season.size(), 12);
+    for (const ScheduledWeek &week : season) {
+        QCOMPARE(week.positionRound, positionRounds.contains(week.weekNumber));
+        QCOMPARE(week.matchups.isEmpty(), week.positionRound);
+    }
+
+    // Position rounds don't use up a circle round: the 10 regular weeks are two full cycles
+    QVERIFY(LeagueScheduler::validateSeason(season, teamIds, 3).isEmpty());
+    QHash<QPair<int, int>, int> pairCounts;
+    for (const ScheduledWeek &week : season) {
+        for (const ScheduledMatchup &matchup : week.matchups) {
+            pairCounts[qMakePair(qMin(matchup.team1Id, matchup.team2Id),
+                                 qMax(matchup.team1Id, matchup.team2Id))]++;
+        }
+    }
+    QCOMPARE(pairCounts.size(), 15);
+    for (int count : qAsConst(pairCounts)) {
+        QCOMPARE(count, 2);
+    }
+}
+
+void LeagueSchedulerTest::positionRoundPairsByRank()
+{
+    const auto pairs = LeagueScheduler::positionRoundPairs({7, 3, 9, 1, 5});
+
+    QCOMPARE(pairs.size(), 3);
+    QCOMPARE(pairs[0], qMakePair(7, 3));
+    QCOMPARE(pairs[1], qMakePair(9, 1));
+    QCOMPARE(pairs[2], qMakePair(5, int(LeagueScheduler::BYE_TEAM)));
+}
+
+void LeagueSchedulerTest::tooFewLaneSlots()
+{
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("Cannot schedule"));
+    QVERIFY(LeagueScheduler::buildSeason(teamRange(10), 10, 4).isEmpty());
+    QVERIFY(LeagueScheduler::buildSeason(teamRange(1), 10, 4).isEmpty());
+}
+
+void LeagueSchedulerTest::validateSeasonReportsProblems()
+{
+    const QVector<int> teamIds = teamRange(4);
+    QVector<ScheduledWeek> season = LeagueScheduler::buildSeason(teamIds, 3, 2);
+    QVERIFY(LeagueScheduler::validateSeason(season, teamIds, 2).isEmpty());
+
+    // Same team twice in one week, on a slot already in use
+    ScheduledWeek &week = season[1];
+    week.matchups[1].team1Id = week.matchups[0].team1Id;
+    week.matchups[1].slot = week.matchups[0].slot;
+
+    const QStringList problems = LeagueScheduler::validateSeason(season, teamIds, 2);
+    QVERIFY(problems.filter("scheduled more than once").size() >= 1);
+    QVERIFY(problems.filter("used twice").size() >= 1);
+    QVERIFY(problems.filter("only 3 of 4").size() >= 1);
+}
+
+QTEST_APPLESS_MAIN(LeagueSchedulerTest)
+
+#include "tst_leaguescheduler.moc"
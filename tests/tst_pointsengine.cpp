@@ -0,0 +1,165 @@
+﻿// tst_pointsengine.cpp
+#include <QtTest>
+#include "PointsEngine.h"
+
+class PointsEngineTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void headsUpSeries();
+    void rankingStackedAndLinear_data();
+    void rankingStackedAndLinear();
+    void partialMatrix();
+    void scoredOnceWhenComplete();
+
+private:
+    static LeagueConfig::PointSystem scratchWinLossTie();
+    static MatchupScores matchup(int team1Id, int team2Id, const QVector<int> &team1, const QVector<int> &team2,
+                                 int positions);
+};
+
+// 2 for a win, 1 for a tie, heads-up on scratch
+LeagueConfig::PointSystem PointsEngineTest::scratchWinLossTie()
+{
+    LeagueConfig::PointSystem rules;
+    rules.type = LeagueConfig::PointSystem::WinLossTie;
+    rules.includeHeadsUp = true;
+    rules.headsUpWithHandicap = false;
+    return rules;
+}
+
+MatchupScores PointsEngineTest::matchup(int team1Id, int team2Id, const QVector<int> &team1,
+                                        const QVector<int> &team2, int positions)
+{
+    MatchupScores scores;
+    scores.resize(positions, 3);
+    scores.team1Id = team1Id;
+    scores.team2Id = team2Id;
+    std::copy(team1.begin(), team1.end(), scores.team1Scratch.begin());
+    std::copy(team2.begin(), team2.end(), scores.team2Scratch.begin());
+    return scores;
+}
+
+void PointsEngineTest::headsUpSeries()
+{
+    // Position 1 wins two games and the series; position 2 loses all four
+    const MatchupScores scores = matchup(1, 2, {200, 150, 180, 120, 130, 140},
+                                         {190, 160, 170, 150, 150, 150}, 2);
+    const PointsEngine engine(scratchWinLossTie());
+    QVERIFY(!engine.usesHandicap());
+
+    const MatchupPoints points = engine.scoreMatchup(scores);
+    QCOMPARE(points.team1PositionPoints, (QVector<int>{6, 0}));
+    QCOMPARE(points.team2PositionPoints, (QVector<int>{2, 8}));
+
+    // Team totals 320-340, 280-310, 320-320 and series 920-970 on top
+    QCOMPARE(points.team1Points, 6 + 0 + 1);
+    QCOMPARE(points.team2Points, 2 + 8 + 2 + 2 + 1 + 2);
+    QCOMPARE(points.team1Wins, 3);
+    QCOMPARE(points.team1Losses, 8);
+    QCOMPARE(points.ties, 1);
+    QCOMPARE(points.team1Series, 920);
+    QCOMPARE(points.team2Series, 970);
+    QCOMPARE(points.matchResult, -1);
+}
+
+void PointsEngineTest::rankingStackedAndLinear_data()
+{
+    QTest::addColumn<bool>("stacked");
+    QTest::addColumn<int>("lastPlace");
+
+    QTest::newRow("stacked") << true << 2;
+    QTest::newRow("linear") << false << 1;
+}
+
+void PointsEngineTest::rankingStackedAndLinear()
+{
+    QFETCH(bool, stacked);
+    QFETCH(int, lastPlace);
+
+    LeagueConfig::PointSystem rules;
+    rules.type = LeagueConfig::PointSystem::TeamVsTeam;
+    rules.trackHandicap = false;
+    rules.stackedTiePoints = stacked;
+    const PointsEngine engine(rules);
+
+    // Series 600, 550, 550 and 500; teams 2 and 3 tie for second
+    const QVector<MatchupScores> night = {
+        matchup(1, 2, {200, 200, 200}, {150, 200, 200}, 1),
+        matchup(3, 4, {200, 150, 200}, {100, 200, 200}, 1)
+    };
+    const EventPoints points = engine.scoreEvent(night);
+
+    QCOMPARE(points.rankPoints.value(1), 4);
+    QCOMPARE(points.rankPoints.value(2), 3);
+    QCOMPARE(points.rankPoints.value(3), 3);
+    QCOMPARE(points.rankPoints.value(4), lastPlace);
+    QCOMPARE(points.totals.value(4), lastPlace);
+    QCOMPARE(points.matchups[1].team2Points, lastPlace);
+}
+
+void PointsEngineTest::partialMatrix()
+{
+    // Game 1 only: heads-up and team game 1, but no position series yet
+    const MatchupScores scores = matchup(1, 2, {200, -1, -1}, {180, -1, -1}, 1);
+    QVERIFY(!scores.isComplete(1, 1));
+
+    const MatchupPoints points = PointsEngine(scratchWinLossTie()).scoreMatchup(scores);
+    QCOMPARE(points.team1PositionPoints, QVector<int>{2});
+    QCOMPARE(points.team2PositionPoints, QVector<int>{0});
+    QCOMPARE(points.team1Points, 2 + 2 + 2);
+    QCOMPARE(points.team2Points, 0);
+    QCOMPARE(points.team1Wins, 3);
+    QCOMPARE(points.team1Series, 200);
+    QCOMPARE(points.team2Series, 180);
+
+    // A short roster only has to fill its own positions
+    MatchupScores uneven = matchup(1, 2, {200, 190, 180, 170, 160, 150}, {200, 190, 180, -1, -1, -1}, 2);
+    QVERIFY(uneven.isComplete(2, 1));
+    QVERIFY(!uneven.isComplete(2, 2));
+    QVERIFY(!uneven.isComplete(2, 0));
+}
+
+// Lanes report one game per message, as LeagueManager::processLeagueGame
+// sees them: the night adds to standings once, after the last game is in
+void PointsEngineTest::scoredOnceWhenComplete()
+{
+    const PointsEngine engine(scratchWinLossTie());
+    MatchupScores scores = matchup(1, 2, {}, {}, 2);
+    const QVector<int> team1 = {200, 150, 180, 120, 130, 140};
+    const QVector<int> team2 = {190, 160, 170, 150, 150, 150};
+
+    QMap<int, int> matches;             // teamId -> wins + losses + ties added
+    QMap<int, int> standingPoints;
+    bool eventCompleted = false;
+    int timesScored = 0;
+
+    // Games 1-3, then game 3 sent again after a lane reconnect
+    for (int game : {0, 1, 2, 2}) {
+        for (int position = 0; position < 2; ++position) {
+            scores.team1Scratch[position * 3 + game] = team1[position * 3 + game];
+            scores.team2Scratch[position * 3 + game] = team2[position * 3 + game];
+        }
+        QCOMPARE(scores.isComplete(2, 2), game == 2);
+
+        if (scores.isComplete(2, 2) && !eventCompleted) {
+            eventCompleted = true;
+            ++timesScored;
+            const EventPoints night = engine.scoreEvent({scores});
+            matches[1] += 1;
+            matches[2] += 1;
+            standingPoints[1] += night.totals.value(1);
+            standingPoints[2] += night.totals.value(2);
+        }
+    }
+
+    QCOMPARE(timesScored, 1);
+    QCOMPARE(matches.value(1), 1);
+    QCOMPARE(matches.value(2), 1);
+    QCOMPARE(standingPoints.value(1), 7);
+    QCOMPARE(standingPoints.value(2), 17);
+}
+
+QTEST_APPLESS_MAIN(PointsEngineTest)
+#include "tst_pointsengine.moc"
@@ -0,0 +1,191 @@
+﻿// tst_replication.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QSqlRecord>
+#include <QJsonArray>
+#include "SchemaMigrator.h"
+#include "ReplicationLog.h"
+
+class ReplicationTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void installSkipsVirtualTables();
+    void copyCatchUpApply();
+
+private:
+    QSqlDatabase openMigrated(const QString &name);
+    void exec(QSqlDatabase &db, const QString &sql, const QVariantList &values = {});
+    void copyAll(const ReplicationLog &from, ReplicationLog &to);
+    QStringList rows(QSqlDatabase &db, const QString &table);
+    int searchHits(QSqlDatabase &db, const QString &term);
+
+    QTemporaryDir m_dataDir;
+    QSqlDatabase m_primary;
+    QSqlDatabase m_standby;
+};
+
+void ReplicationTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    m_primary = openMigrated("primary");
+    m_standby = openMigrated("standby");
+}
+
+void ReplicationTest::cleanupTestCase()
+{
+    for (QSqlDatabase *db : {&m_primary, &m_standby}) {
+        const QString name = db->connectionName();
+        db->close();
+        *db = QSqlDatabase();
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+QSqlDatabase ReplicationTest::openMigrated(const QString &name)
+{
+    QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", name);
+    db.setDatabaseName(m_dataDir.filePath(name + ".db"));
+    if (!db.open() || !SchemaMigrator(db).migrate()) {
+        qWarning() << "Failed to open and migrate" << name;
+    }
+    return db;
+}
+
+void ReplicationTest::exec(QSqlDatabase &db, const QString &sql, const QVariantList &values)
+{
+    QSqlQuery query(db);
+    query.prepare(sql);
+    for (const QVariant &value : values) {
+        query.addBindValue(value);
+    }
+    QVERIFY2(query.exec(), qPrintable(sql));
+}
+
+// What ReplicationServer::sendFullCopy sends, two rows a page so paging is covered
+void ReplicationTest::copyAll(const ReplicationLog &from, ReplicationLog &to)
+{
+    for (const QString &table : from.tables()) {
+        qint64 afterRowId = 0;
+        bool reset = true;
+        while (true) {
+            const QJsonObject dump = from.dumpTable(table, afterRowId, 2);
+            const int count = dump["rows"].toArray().size();
+            if (count == 0 && !reset) {
+                break;
+            }
+            QVERIFY2(to.loadTable(dump, reset), qPrintable(table));
+            reset = false;
+            afterRowId = static_cast<qint64>(dump["last_rowid"].toDouble());
+            if (count < 2) {
+                break;
+            }
+        }
+    }
+}
+
+// Rollup rows are keyed by their primary key, not rowid, so compare contents only
+QStringList ReplicationTest::rows(QSqlDatabase &db, const QString &table)
+{
+    QStringList result;
+    QSqlQuery query(db);
+    query.exec(QString("SELECT * FROM %1").arg(table));
+    while (query.next()) {
+        QStringList fields;
+        for (int i = 0; i < query.record().count(); ++i) {
+            fields << query.value(i).toString();
+        }
+        result << fields.join('|');
+    }
+    result.sort();
+    return result;
+}
+
+int ReplicationTest::searchHits(QSqlDatabase &db, const QString &term)
+{
+    QSqlQuery query(db);
+    query.prepare("SELECT COUNT(*) FROM search_index WHERE search_index MATCH ?");
+    query.addBindValue(term);
+    return query.exec() && query.next() ? query.value(0).toInt() : -1;
+}
+
+// bowlingd installs the log on every start, over a fully migrated database
+void ReplicationTest::installSkipsVirtualTables()
+{
+    ReplicationLog log(m_primary);
+    QVERIFY(log.install());
+    QVERIFY(!log.instanceId().isEmpty());
+
+    const QStringList tables = log.tables();
+    QVERIFY(tables.contains("bowlers"));
+    QVERIFY(tables.contains("games"));
+    for (const QString &table : tables) {
+        QVERIFY2(!table.startsWith("search_index"), qPrintable(table));
+        QVERIFY2(!table.startsWith("replication_"), qPrintable(table));
+    }
+    QVERIFY(tables.last().startsWith("rollup_"));
+
+    // A restart reuses the instance id and triggers
+    ReplicationLog again(m_primary);
+    QVERIFY(again.install());
+    QCOMPARE(again.instanceId(), log.instanceId());
+}
+
+void ReplicationTest::copyCatchUpApply()
+{
+    ReplicationLog primary(m_primary);
+    ReplicationLog standby(m_standby);
+    QVERIFY(primary.install());
+    QVERIFY(standby.install());
+
+    const QString addBowler = "INSERT INTO bowlers (first_name, last_name, phone) VALUES (?, ?, ?)";
+    const QString addGame = "INSERT INTO games (lane_id, bowler_id, bowler_name, league_id, score, created_at) "
+                            "VALUES (?, ?, ?, ?, ?, ?)";
+    exec(m_primary, addBowler, {"Kofi", "Mensah", "555-0101"});
+    exec(m_primary, addBowler, {"Ruth", "Okafor", "555-0102"});
+    exec(m_primary, addBowler, {"Emile", "Brandt", "555-0103"});
+    exec(m_primary, addGame, {1, 1, "Kofi Mensah", 3, 180, "2026-01-05 20:00:00"});
+    exec(m_primary, addGame, {1, 2, "Ruth Okafor", 3, 210, "2026-01-05 20:05:00"});
+    exec(m_primary, addGame, {2, 3, "Emile Brandt", 3, 150, "2026-01-05 20:10:00"});
+
+    const qint64 copiedAt = primary.lastId();
+    copyAll(primary, standby);
+
+    // Written on the primary after the copy; the standby catches up from the log
+    exec(m_primary, addBowler, {"Zoe", "Hara", "555-0104"});
+    exec(m_primary, "UPDATE bowlers SET phone = '555-0199' WHERE id = 2");
+    exec(m_primary, "DELETE FROM bowlers WHERE id = 3");
+    exec(m_primary, addGame, {2, 4, "Zoe Hara", 3, 201, "2026-01-05 21:00:00"});
+    exec(m_primary, "UPDATE games SET score = 99 WHERE id = 1");
+    exec(m_primary, "DELETE FROM games WHERE id = 3");
+    exec(m_primary, addGame, {1, 1, "Kofi Mensah", 3, 170, "2026-01-06 19:00:00"});
+
+    const QJsonObject batch = primary.changesSince(copiedAt, 1000);
+    QCOMPARE(static_cast<qint64>(batch["to"].toDouble()), primary.lastId());
+    QVERIFY(standby.applyChanges(batch));
+    // Replaying a batch the standby already has changes nothing
+    QVERIFY(standby.applyChanges(batch));
+
+    for (const QString &table : primary.tables()) {
+        QCOMPARE(rows(m_standby, table), rows(m_primary, table));
+    }
+    QVERIFY(!rows(m_standby, "bowlers").join('\n').contains("Emile"));
+
+    if (!m_standby.tables().contains("search_index")) {
+        QSKIP("SQLite built without FTS5");
+    }
+    exec(m_standby, "DELETE FROM search_index");
+    QCOMPARE(searchHits(m_standby, "Zoe"), 0);
+    QVERIFY(SchemaMigrator(m_standby).rebuildSearchIndex());
+    QCOMPARE(searchHits(m_standby, "Zoe"), 1);
+    QCOMPARE(searchHits(m_standby, "Ruth"), 1);
+    QCOMPARE(searchHits(m_standby, "Emile"), 0);
+}
+
+QTEST_GUILESS_MAIN(ReplicationTest)
+#include "tst_replication.moc"
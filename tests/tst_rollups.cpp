@@ -0,0 +1,116 @@
+﻿// tst_rollups.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "SchemaMigrator.h"
+#include "RollupBuilder.h"
+
+class RollupsTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void nameKeysMatchTheTrigger();
+    void triggersMatchRebuild();
+
+private:
+    void addGame(int laneId, int bowlerId, const QString &name, int leagueId, int score, const QString &createdAt);
+    QStringList rollupRows();
+
+    QTemporaryDir m_dataDir;
+    QSqlDatabase m_db;
+};
+
+void RollupsTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    m_db = QSqlDatabase::addDatabase("QSQLITE", "rollups");
+    m_db.setDatabaseName(m_dataDir.filePath("rollups.db"));
+    QVERIFY(m_db.open());
+    QVERIFY(SchemaMigrator(m_db).migrate());
+}
+
+void RollupsTest::cleanupTestCase()
+{
+    m_db.close();
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase("rollups");
+}
+
+void RollupsTest::addGame(int laneId, int bowlerId, const QString &name, int leagueId, int score,
+                          const QString &createdAt)
+{
+    QSqlQuery query(m_db);
+    query.prepare("INSERT INTO games (lane_id, bowler_id, bowler_name, league_id, score, created_at) "
+                  "VALUES (?, ?, ?, ?, ?, ?)");
+    query.addBindValue(laneId);
+    query.addBindValue(bowlerId);
+    query.addBindValue(name);
+    query.addBindValue(leagueId);
+    query.addBindValue(score);
+    query.addBindValue(createdAt);
+    QVERIFY(query.exec());
+}
+
+// Totals only; bowler_id and bowler_name are display hints
+QStringList RollupsTest::rollupRows()
+{
+    QStringList rows;
+    QSqlQuery query(m_db);
+    const QStringList selects = {
+        "SELECT 'lane', day, lane_id, games, pins, high_game FROM rollup_lane_day",
+        "SELECT 'bowler', day, bowler_key, games, pins, high_game FROM rollup_bowler_day",
+        "SELECT 'league', week_start, league_id, games, pins, high_game FROM rollup_league_week"
+    };
+    for (const QString &select : selects) {
+        query.exec(select);
+        while (query.next()) {
+            QStringList fields;
+            for (int i = 0; i < 6; ++i) {
+                fields << query.value(i).toString();
+            }
+            rows << fields.join('|');
+        }
+    }
+    rows.sort();
+    return rows;
+}
+
+void RollupsTest::nameKeysMatchTheTrigger()
+{
+    QSqlQuery query(m_db);
+    for (const QString &name : {QString("Zoë O'Hara"), QString("ÉMILE Brandt"), QString("İsmail")}) {
+        query.prepare("SELECT 'name:' || lower(?)");
+        query.addBindValue(name);
+        QVERIFY(query.exec() && query.next());
+        QCOMPARE(RollupBuilder::bowlerKey(0, name), query.value(0).toString());
+    }
+    QCOMPARE(RollupBuilder::bowlerKey(12, "Anyone"), QString("id:12"));
+}
+
+void RollupsTest::triggersMatchRebuild()
+{
+    addGame(1, 0, "Émile", 3, 200, "2026-01-05 20:00:00");
+    addGame(1, 0, "ÉMILE", 3, 150, "2026-01-05 21:00:00");
+    addGame(2, 7, "Kofi", 3, 100, "2026-01-06 23:59:59");
+    addGame(2, 7, "Kofi", 0, 120, "2026-01-07 00:00:00");
+    addGame(3, 9, "Ruth", 3, 279, "2026-01-12 19:30:00");
+
+    QSqlQuery query(m_db);
+    QVERIFY(query.exec("UPDATE games SET score = 99 WHERE score = 200"));
+    QVERIFY(query.exec("UPDATE games SET created_at = '2026-01-13 10:00:00' WHERE score = 100"));
+    QVERIFY(query.exec("DELETE FROM games WHERE score = 279"));
+
+    const QStringList fromTriggers = rollupRows();
+    QVERIFY(!fromTriggers.isEmpty());
+    QVERIFY(!fromTriggers.join('\n').contains("279"));
+
+    QVERIFY(RollupBuilder::rebuild(m_db, QDate(2026, 1, 1), QDate(2026, 1, 31), 2).success);
+    QCOMPARE(rollupRows(), fromTriggers);
+}
+
+QTEST_GUILESS_MAIN(RollupsTest)
+#include "tst_rollups.moc"
@@ -0,0 +1,113 @@
+﻿// tst_schemamigrator.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include "SchemaMigrator.h"
+
+class SchemaMigratorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanup();
+    void freshDatabase();
+    void upgradeFromIndexesOnly();
+    void upToDateIsNoOp();
+
+private:
+    QSqlDatabase open(const QString &name);
+    int scalar(QSqlDatabase &database, const QString &sql);
+
+    QTemporaryDir m_dataDir;
+};
+
+void SchemaMigratorTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+}
+
+void SchemaMigratorTest::cleanup()
+{
+    for (const QString &name : QSqlDatabase::connectionNames()) {
+        QSqlDatabase::database(name, false).close();
+        QSqlDatabase::removeDatabase(name);
+    }
+}
+
+QSqlDatabase SchemaMigratorTest::open(const QString &name)
+{
+    QSqlDatabase database = QSqlDatabase::addDatabase("QSQLITE", name);
+    database.setDatabaseName(m_dataDir.filePath(name + ".db"));
+    database.open();
+    return database;
+}
+
+int SchemaMigratorTest::scalar(QSqlDatabase &database, const QString &sql)
+{
+    QSqlQuery query(database);
+    if (!query.exec(sql) || !query.next()) {
+        return -1;
+    }
+    return query.value(0).toInt();
+}
+
+void SchemaMigratorTest::freshDatabase()
+{
+    QSqlDatabase database = open("fresh");
+    QVERIFY(database.isOpen());
+
+    SchemaMigrator migrator(database);
+    QVERIFY(migrator.migrate());
+    QCOMPARE(migrator.currentVersion(), SchemaMigrator::latestVersion());
+
+    const QStringList tables = database.tables();
+    for (const char *table : {"bowlers", "league_teams", "prebowl_games", "games", "rollup_lane_day",
+                              "replication_log"}) {
+        QVERIFY2(tables.contains(table), table);
+    }
+    QCOMPARE(scalar(database, "SELECT COUNT(*) FROM sqlite_master WHERE name = 'idx_team_bowlers_bowler'"), 1);
+    QCOMPARE(scalar(database, "SELECT COUNT(*) FROM pragma_table_info('league_teams') WHERE name = 'total_points'"), 1);
+}
+
+void SchemaMigratorTest::upgradeFromIndexesOnly()
+{
+    // A database left at version 1 when it only added the lookup indexes
+    QSqlDatabase database = open("version1");
+    QSqlQuery query(database);
+    for (const QString &statement : SchemaMigrator::baseline()) {
+        QVERIFY(query.exec(statement));
+    }
+    for (const QString &statement : SchemaMigrator::migrations().first().statements) {
+        QVERIFY(query.exec(statement));
+    }
+    QVERIFY(query.exec("INSERT INTO bowlers (first_name, last_name, phone) VALUES ('Marguerite', 'Oyelaran', NULL)"));
+    QVERIFY(query.exec("PRAGMA user_version = 1"));
+
+    SchemaMigrator migrator(database);
+    QVERIFY(migrator.migrate());
+    QCOMPARE(migrator.currentVersion(), SchemaMigrator::latestVersion());
+
+    if (!database.tables().contains("search_index")) {
+        QSKIP("SQLite was built without FTS5");
+    }
+
+    // Existing rows are indexed and the triggers keep new ones in step
+    QCOMPARE(scalar(database, "SELECT COUNT(*) FROM search_index WHERE search_index MATCH 'oyel*'"), 1);
+    QVERIFY(query.exec("INSERT INTO teams (name) VALUES ('Gutter Kings')"));
+    QCOMPARE(scalar(database, "SELECT COUNT(*) FROM search_index WHERE search_index MATCH 'gutter'"), 1);
+    QVERIFY(query.exec("DELETE FROM bowlers"));
+    QCOMPARE(scalar(database, "SELECT COUNT(*) FROM search_index WHERE search_index MATCH 'oyel*'"), 0);
+}
+
+void SchemaMigratorTest::upToDateIsNoOp()
+{
+    QSqlDatabase database = open("twice");
+    QVERIFY(SchemaMigrator(database).migrate());
+    QVERIFY(SchemaMigrator(database).migrate());
+    QCOMPARE(SchemaMigrator(database).currentVersion(), SchemaMigrator::latestVersion());
+}
+
+QTEST_GUILESS_MAIN(SchemaMigratorTest)
+#include "tst_schemamigrator.moc"
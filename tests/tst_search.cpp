@@ -0,0 +1,120 @@
+﻿// tst_search.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <algorithm>
+#include "DatabaseManager.h"
+
+class SearchTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void bothPathsAgree_data();
+    void bothPathsAgree();
+
+private:
+    static QStringList keys(const QVector<SearchHit> &hits);
+
+    QTemporaryDir m_dataDir;
+    DatabaseManager *m_db = nullptr;
+    QString m_bowler;
+    QString m_team;
+    QString m_booking;
+};
+
+void SearchTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    DatabaseManager::setDataDirectory(m_dataDir.path());
+    m_db = DatabaseManager::instance();
+    if (!m_db->hasFullTextSearch()) {
+        QSKIP("SQLite built without FTS5; only the LIKE path is available");
+    }
+
+    BowlerData bowler;
+    bowler.firstName = "Ada";
+    bowler.lastName = "Lovelace";
+    bowler.sex = "F";
+    bowler.average = 172;
+    bowler.address = "12 Maple Street";
+    bowler.phone = "555-0101";
+    bowler.birthday = "1990-12-10";
+    bowler.over18 = true;
+    const int bowlerId = m_db->addBowler(bowler);
+
+    const int teamId = m_db->addTeam("Maple Pinheads");
+
+    CalendarEventData event;
+    event.date = QDate(2026, 10, 20);
+    event.startTime = QTime(18, 0);
+    event.endTime = QTime(20, 0);
+    event.laneId = 3;
+    event.eventType = "Party";
+    event.title = "Birthday";
+    event.contactName = "Grace Hopper";
+    event.contactPhone = "0123 987654";
+    const int eventId = m_db->addCalendarEvent(event);
+    QVERIFY(bowlerId > 0 && teamId > 0 && eventId > 0);
+
+    m_bowler = QString("%1:%2").arg(SearchHit::Bowler).arg(bowlerId);
+    m_team = QString("%1:%2").arg(SearchHit::Team).arg(teamId);
+    m_booking = QString("%1:%2").arg(SearchHit::CalendarEvent).arg(eventId);
+}
+
+void SearchTest::cleanupTestCase()
+{
+    if (m_db) {
+        m_db->setFullTextSearch(true);
+    }
+}
+
+QStringList SearchTest::keys(const QVector<SearchHit> &hits)
+{
+    QStringList keys;
+    for (const SearchHit &hit : hits) {
+        keys.append(QString("%1:%2").arg(hit.kind).arg(hit.id));
+    }
+    std::sort(keys.begin(), keys.end());
+    return keys;
+}
+
+void SearchTest::bothPathsAgree_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QStringList>("expected");     // Filled in from the ids once they exist
+
+    QTest::newRow("name") << "lovelace" << QStringList{"bowler"};
+    QTest::newRow("bowler phone") << "555-0101" << QStringList{"bowler"};
+    QTest::newRow("bowler address") << "maple street" << QStringList{"bowler"};
+    QTest::newRow("address and team") << "maple" << QStringList{"bowler", "team"};
+    QTest::newRow("contact name") << "hopper" << QStringList{"booking"};
+    QTest::newRow("contact phone") << "987654" << QStringList{"booking"};
+    QTest::newRow("nothing") << "zebra" << QStringList();
+}
+
+void SearchTest::bothPathsAgree()
+{
+    QFETCH(QString, text);
+    QFETCH(QStringList, expected);
+
+    QStringList expectedKeys;
+    for (const QString &name : expected) {
+        expectedKeys.append(name == "bowler" ? m_bowler : name == "team" ? m_team : m_booking);
+    }
+    std::sort(expectedKeys.begin(), expectedKeys.end());
+
+    m_db->setFullTextSearch(true);
+    QVERIFY(m_db->hasFullTextSearch());
+    const QStringList fullText = keys(m_db->search(text));
+
+    m_db->setFullTextSearch(false);
+    const QStringList like = keys(m_db->search(text));
+
+    QCOMPARE(fullText, expectedKeys);
+    QCOMPARE(like, expectedKeys);
+}
+
+QTEST_GUILESS_MAIN(SearchTest)
+#include "tst_search.moc"
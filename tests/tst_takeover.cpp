@@ -0,0 +1,114 @@
+﻿// tst_takeover.cpp
+#include <QtTest>
+#include <QTemporaryDir>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QJsonDocument>
+#include "DatabaseManager.h"
+#include "LaneServer.h"
+
+class TakeoverTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void laneReconnectsToStandby();
+    void fallsBackToOwnPort();
+
+private:
+    static quint16 freePort();
+    static QJsonObject registerLane(QTcpSocket &lane, quint16 port, int laneId, qint64 seq);
+
+    QTemporaryDir m_dataDir;
+};
+
+void TakeoverTest::initTestCase()
+{
+    QVERIFY(m_dataDir.isValid());
+    DatabaseManager::setDataDirectory(m_dataDir.path());
+    DatabaseManager::instance();
+}
+
+quint16 TakeoverTest::freePort()
+{
+    QTcpServer probe;
+    return probe.listen(QHostAddress::LocalHost, 0) ? probe.serverPort() : 0;
+}
+
+// Connects and registers as a lane would; the server answers on the event
+// loop, so nothing here blocks on the socket
+QJsonObject TakeoverTest::registerLane(QTcpSocket &lane, quint16 port, int laneId, qint64 seq)
+{
+    lane.connectToHost(QHostAddress::LocalHost, port);
+    if (!QTest::qWaitFor([&lane]() { return lane.state() == QAbstractSocket::ConnectedState; }, 3000)) {
+        return QJsonObject();
+    }
+
+    QJsonObject registration;
+    registration["type"] = "registration";
+    registration["lane_id"] = laneId;
+    registration["seq"] = seq;
+    lane.write(QJsonDocument(registration).toJson(QJsonDocument::Compact) + "\n");
+
+    if (!QTest::qWaitFor([&lane]() { return lane.canReadLine(); }, 3000)) {
+        return QJsonObject();
+    }
+    return QJsonDocument::fromJson(lane.readLine()).object();
+}
+
+void TakeoverTest::laneReconnectsToStandby()
+{
+    const quint16 primaryPort = freePort();
+    const quint16 standbyPort = freePort();
+    QVERIFY(primaryPort > 0 && standbyPort > 0 && primaryPort != standbyPort);
+
+    LaneServer *primary = new LaneServer();
+    QVERIFY(primary->start(primaryPort));
+
+    QTcpSocket lane;
+    QCOMPARE(registerLane(lane, primaryPort, 3, 0)["type"].toString(), QString("registration_response"));
+    QTRY_VERIFY(primary->connectedLanes().contains(3));
+
+    QJsonObject game;
+    game["bowlers"] = QJsonArray{"Kofi", "Ruth"};
+    primary->setLaneGame(3, "quick_game", game);
+    // What StandbyClient::laneGames() holds once the standby is synced
+    const QJsonArray laneGames = primary->laneGames();
+
+    // The primary dies; the lane sees its connection drop
+    delete primary;
+    QTRY_COMPARE(lane.state(), QAbstractSocket::UnconnectedState);
+
+    // Takeover as bowlingd does it: the primary's port first, then its own
+    LaneServer standby;
+    for (const QJsonValue &value : laneGames) {
+        const QJsonObject copied = value.toObject();
+        standby.setLaneGame(copied["lane_id"].toInt(), copied["game_type"].toString(), copied["game"].toObject());
+    }
+    QCOMPARE(standby.startFirstFree({primaryPort, standbyPort}), primaryPort);
+
+    // Same address as before, and the game it was bowling comes back
+    const QJsonObject response = registerLane(lane, primaryPort, 3, 0);
+    QCOMPARE(response["type"].toString(), QString("registration_response"));
+    QCOMPARE(response["game_type"].toString(), QString("quick_game"));
+    QCOMPARE(response["game"].toObject(), game);
+    QTRY_VERIFY(standby.connectedLanes().contains(3));
+    lane.abort();
+}
+
+void TakeoverTest::fallsBackToOwnPort()
+{
+    // Something else still holds the primary's port
+    QTcpServer squatter;
+    QVERIFY(squatter.listen(QHostAddress::Any, 0));
+    const quint16 standbyPort = freePort();
+    QVERIFY(standbyPort > 0 && standbyPort != squatter.serverPort());
+
+    LaneServer standby;
+    QCOMPARE(standby.startFirstFree({squatter.serverPort(), standbyPort}), standbyPort);
+    QVERIFY(standby.isListening());
+}
+
+QTEST_GUILESS_MAIN(TakeoverTest)
+#include "tst_takeover.moc"